@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONCURRENT_MAP_H
+#define CONCURRENT_MAP_H
+
+#ifdef __cplusplus
+/*C++ has native support for "bool"*/
+#else
+#include <stdbool.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_util/map.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*a map that can be read from any number of threads without locks while writers are serialized. See devdoc/concurrent_map_requirements.md*/
+typedef struct CONCURRENT_MAP_HANDLE_DATA_TAG* CONCURRENT_MAP_HANDLE;
+
+MOCKABLE_FUNCTION(, CONCURRENT_MAP_HANDLE, concurrent_map_create, MAP_FILTER_CALLBACK, mapFilterFunc);
+MOCKABLE_FUNCTION(, void, concurrent_map_destroy, CONCURRENT_MAP_HANDLE, handle);
+
+MOCKABLE_FUNCTION(, MAP_RESULT, concurrent_map_add, CONCURRENT_MAP_HANDLE, handle, const char*, key, const char*, value);
+MOCKABLE_FUNCTION(, MAP_RESULT, concurrent_map_add_or_update, CONCURRENT_MAP_HANDLE, handle, const char*, key, const char*, value);
+MOCKABLE_FUNCTION(, MAP_RESULT, concurrent_map_delete, CONCURRENT_MAP_HANDLE, handle, const char*, key);
+
+MOCKABLE_FUNCTION(, MAP_RESULT, concurrent_map_contains_key, CONCURRENT_MAP_HANDLE, handle, const char*, key, bool*, keyExists);
+/*returns a copy of the value that the caller frees with free*/
+MOCKABLE_FUNCTION(, char*, concurrent_map_get_value_from_key, CONCURRENT_MAP_HANDLE, handle, const char*, key);
+/*returns a map that does not change when the concurrent map changes, the caller destroys it with Map_Destroy*/
+MOCKABLE_FUNCTION(, MAP_HANDLE, concurrent_map_get_snapshot, CONCURRENT_MAP_HANDLE, handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*CONCURRENT_MAP_H*/
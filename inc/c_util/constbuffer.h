@@ -25,6 +25,9 @@ extern "C"
 /*this is the handle*/
 typedef struct CONSTBUFFER_HANDLE_DATA_TAG* CONSTBUFFER_HANDLE;
 
+/*a handle whose content can still be written, it becomes a CONSTBUFFER_HANDLE when sealed*/
+typedef struct CONSTBUFFER_WRITABLE_HANDLE_DATA_TAG* CONSTBUFFER_WRITABLE_HANDLE;
+
 /*this is what is returned when the content of the buffer needs access*/
 typedef struct CONSTBUFFER_TAG
 {
@@ -32,11 +35,24 @@ typedef struct CONSTBUFFER_TAG
     uint32_t size;
 } CONSTBUFFER;
 
+/*a CONSTBUFFER whose size does not fit in 32 bits (for example a memory mapped file). It is ref counted, sliced and freed like a CONSTBUFFER_HANDLE, but only the CONSTBUFFER_LARGE_* APIs accept it*/
+typedef struct CONSTBUFFER_LARGE_HANDLE_DATA_TAG* CONSTBUFFER_LARGE_HANDLE;
+
+typedef struct CONSTBUFFER_LARGE_TAG
+{
+    const unsigned char* buffer;
+    uint64_t size;
+} CONSTBUFFER_LARGE;
+
 typedef void(*CONSTBUFFER_CUSTOM_FREE_FUNC)(void* context);
 
 /*what function should CONSTBUFFER_HANDLE_to_buffer use to allocate the returned serialized form. NULL means malloc from gballoc_hl_malloc_redirect.h of this lib.*/
 typedef void*(*CONSTBUFFER_to_buffer_alloc)(size_t size, void* context);
 
+/*CONSTBUFFER_to_segments describes the serialization with a header (version and size, in a caller owned buffer of this size) followed by the content*/
+#define CONSTBUFFER_SEGMENTS_HEADER_SIZE 5
+#define CONSTBUFFER_SEGMENTS_MAX_COUNT 2
+
 #define CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES \
     CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, \
     CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, \
@@ -68,6 +84,19 @@ MOCKABLE_INTERFACE(constbuffer,
 
     FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAndSizeWithCopy, CONSTBUFFER_HANDLE, handle, uint32_t, offset, uint32_t, size),
 
+    /*same as CONSTBUFFER_Create, but the content (still in the same allocation as the handle) starts at an address that is a multiple of alignment (a power of 2)*/
+    FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithAlignment, const unsigned char*, source, uint32_t, size, uint32_t, alignment),
+
+    /*builds the content in place (1 allocation for handle and content) and then seals it into a CONSTBUFFER_HANDLE without copying*/
+    FUNCTION(, CONSTBUFFER_WRITABLE_HANDLE, CONSTBUFFER_CreateWritableHandle, uint32_t, capacity),
+    FUNCTION(, unsigned char*, CONSTBUFFER_GetWritableBuffer, CONSTBUFFER_WRITABLE_HANDLE, writableHandle),
+    FUNCTION(, uint32_t, CONSTBUFFER_GetWritableBufferCapacity, CONSTBUFFER_WRITABLE_HANDLE, writableHandle),
+    FUNCTION(, uint32_t, CONSTBUFFER_GetWritableBufferSize, CONSTBUFFER_WRITABLE_HANDLE, writableHandle),
+    FUNCTION(, int, CONSTBUFFER_SetWritableBufferSize, CONSTBUFFER_WRITABLE_HANDLE, writableHandle, uint32_t, size),
+    FUNCTION(, int, CONSTBUFFER_AppendToWritableBuffer, CONSTBUFFER_WRITABLE_HANDLE, writableHandle, const unsigned char*, source, uint32_t, size),
+    FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_SealWritableHandle, CONSTBUFFER_WRITABLE_HANDLE, writableHandle),
+    FUNCTION(, void, CONSTBUFFER_DestroyWritableHandle, CONSTBUFFER_WRITABLE_HANDLE, writableHandle),
+
     FUNCTION(, void, CONSTBUFFER_IncRef, CONSTBUFFER_HANDLE, constbufferHandle),
 
     FUNCTION(, void, CONSTBUFFER_DecRef, CONSTBUFFER_HANDLE, constbufferHandle),
@@ -76,13 +105,46 @@ MOCKABLE_INTERFACE(constbuffer,
 
     FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER_HANDLE, left, CONSTBUFFER_HANDLE, right),
 
+    /*the xxhash64 (seed 0) of the content, computed on the first call and stored in the handle. CONSTBUFFER_HANDLE_contain_same uses the stored hashes to reject different content without comparing it*/
+    FUNCTION(, int, CONSTBUFFER_get_content_hash, CONSTBUFFER_HANDLE, source, uint64_t*, content_hash),
+
     FUNCTION(, uint32_t, CONSTBUFFER_get_serialization_size, CONSTBUFFER_HANDLE, source),
 
     FUNCTION(, unsigned char*, CONSTBUFFER_to_buffer, CONSTBUFFER_HANDLE, source, CONSTBUFFER_to_buffer_alloc, alloc, void*, alloc_context, uint32_t*, serialized_size),
 
     FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_to_fixed_size_buffer, CONSTBUFFER_HANDLE, source, unsigned char*, destination, uint32_t, destination_size, uint32_t*, serialized_size),
 
-    FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer, const unsigned char*, source, uint32_t, size, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destination)
+    /*same as the 3 above, but they write version 2 of the serialization (with a CRC32C of the content). Readers older than version 2 cannot read it*/
+    FUNCTION(, uint32_t, CONSTBUFFER_get_serialization_size_v2, CONSTBUFFER_HANDLE, source),
+    FUNCTION(, unsigned char*, CONSTBUFFER_to_buffer_v2, CONSTBUFFER_HANDLE, source, CONSTBUFFER_to_buffer_alloc, alloc, void*, alloc_context, uint32_t*, serialized_size),
+    FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_to_fixed_size_buffer_v2, CONSTBUFFER_HANDLE, source, unsigned char*, destination, uint32_t, destination_size, uint32_t*, serialized_size),
+
+    FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer, const unsigned char*, source, uint32_t, size, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destination),
+
+    /*same as CONSTBUFFER_from_buffer for the serialization at offset in parent, but the content is not copied: the result is a CONSTBUFFER_CreateFromOffsetAndSize of parent*/
+    FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer_no_copy, CONSTBUFFER_HANDLE, parent, uint32_t, offset, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destination),
+
+    /*writes the serialization header in header and fills segments with what writev/sendmsg need to write the serialization without copying the content*/
+    FUNCTION(, int, CONSTBUFFER_to_segments, CONSTBUFFER_HANDLE, source, unsigned char*, header, CONSTBUFFER*, segments, uint32_t*, segment_count),
+
+    /*caches the fixed size handles of CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize. Can be called while other threads create and destroy buffers*/
+    FUNCTION(, int, CONSTBUFFER_header_pool_init),
+
+    FUNCTION(, void, CONSTBUFFER_header_pool_deinit),
+
+    /*64 bit sized buffers. They serialize to version 3 (64 bit size)*/
+    FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_Create, const unsigned char*, source, uint64_t, size),
+    FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateWithMoveMemory, unsigned char*, source, uint64_t, size),
+    FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateWithCustomFree, const unsigned char*, source, uint64_t, size, CONSTBUFFER_CUSTOM_FREE_FUNC, customFreeFunc, void*, customFreeFuncContext),
+    FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateFromOffsetAndSize, CONSTBUFFER_LARGE_HANDLE, handle, uint64_t, offset, uint64_t, size),
+    /*a (up to 4GB) CONSTBUFFER_HANDLE slice of a CONSTBUFFER_LARGE_HANDLE, for the APIs that only take CONSTBUFFER_HANDLEs*/
+    FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromLargeOffsetAndSize, CONSTBUFFER_LARGE_HANDLE, handle, uint64_t, offset, uint32_t, size),
+    FUNCTION(, void, CONSTBUFFER_LARGE_IncRef, CONSTBUFFER_LARGE_HANDLE, constbufferHandle),
+    FUNCTION(, void, CONSTBUFFER_LARGE_DecRef, CONSTBUFFER_LARGE_HANDLE, constbufferHandle),
+    FUNCTION(, const CONSTBUFFER_LARGE*, CONSTBUFFER_LARGE_GetContent, CONSTBUFFER_LARGE_HANDLE, constbufferHandle),
+    FUNCTION(, uint64_t, CONSTBUFFER_LARGE_get_serialization_size, CONSTBUFFER_LARGE_HANDLE, source),
+    FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_LARGE_to_fixed_size_buffer, CONSTBUFFER_LARGE_HANDLE, source, unsigned char*, destination, uint64_t, destination_size, uint64_t*, serialized_size),
+    FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_LARGE_from_buffer_no_copy, CONSTBUFFER_LARGE_HANDLE, parent, uint64_t, offset, uint64_t*, consumed, CONSTBUFFER_LARGE_HANDLE*, destination)
 )
 
 #ifdef __cplusplus
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONSTBUFFER_FILE_H
+#define CONSTBUFFER_FILE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "c_util/constbuffer.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*creates a CONSTBUFFER_HANDLE whose content is a read-only mapping of a file. The last CONSTBUFFER_DecRef unmaps the file*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map, const char*, file_name);
+
+/*same as constbuffer_file_map, but only size bytes starting at offset in the file are mapped*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map_range, const char*, file_name, uint64_t, offset, uint32_t, size);
+
+/*same as constbuffer_file_map, but the file can have more than UINT32_MAX bytes. The last CONSTBUFFER_LARGE_DecRef unmaps the file*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, constbuffer_file_map_large, const char*, file_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CONSTBUFFER_FILE_H */
@@ -12,8 +12,21 @@
 #define CONSTBUFFER_SIZE_OFFSET (CONSTBUFFER_VERSION_OFFSET + CONSTBUFFER_VERSION_SIZE)
 #define CONSTBUFFER_SIZE_SIZE (sizeof(uint32_t))
 
+/*version 1: the content follows the size*/
 #define CONSTBUFFER_CONTENT_OFFSET (CONSTBUFFER_SIZE_OFFSET + CONSTBUFFER_SIZE_SIZE)
 
+/*version 2: the CRC32C of the content follows the size, the content follows the CRC32C*/
+#define CONSTBUFFER_CRC32C_OFFSET (CONSTBUFFER_SIZE_OFFSET + CONSTBUFFER_SIZE_SIZE)
+#define CONSTBUFFER_CRC32C_SIZE (sizeof(uint32_t))
+
+#define CONSTBUFFER_V2_CONTENT_OFFSET (CONSTBUFFER_CRC32C_OFFSET + CONSTBUFFER_CRC32C_SIZE)
+
 #define CONSTBUFFER_MIN_SERIALIZATION_SIZE CONSTBUFFER_CONTENT_OFFSET
 
+/*version 3 (CONSTBUFFER_LARGE_HANDLE): the size is 64 bit, the CRC32C of the content follows the size, the content follows the CRC32C*/
+#define CONSTBUFFER_V3_SIZE_SIZE (sizeof(uint64_t))
+#define CONSTBUFFER_V3_CRC32C_OFFSET (CONSTBUFFER_SIZE_OFFSET + CONSTBUFFER_V3_SIZE_SIZE)
+
+#define CONSTBUFFER_V3_CONTENT_OFFSET (CONSTBUFFER_V3_CRC32C_OFFSET + CONSTBUFFER_CRC32C_SIZE)
+
 #endif  /* CONSTBUFFER_FORMAT_H */
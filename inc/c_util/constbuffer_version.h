@@ -4,7 +4,9 @@
 #ifndef CONSTBUFFER_VERSION_H
 #define CONSTBUFFER_VERSION_H
 
-/*this header only exists to provide the current serialization format of CONSTBUFFER*/
-#define CONSTBUFFER_VERSION_V1 1
+/*this header only exists to provide the serialization formats of CONSTBUFFER*/
+#define CONSTBUFFER_VERSION_V1 1 /*version, size, content. This is what CONSTBUFFER serializes to*/
+#define CONSTBUFFER_VERSION_V2 2 /*version, size, CRC32C of the content, content. This is what the _v2 serialization functions of CONSTBUFFER write*/
+#define CONSTBUFFER_VERSION_V3 3 /*version, 64 bit size, CRC32C of the content, content. This is what CONSTBUFFER_LARGE serializes to*/
 
 #endif  /* CONSTBUFFER_VERSION_H */
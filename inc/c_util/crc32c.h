@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*returns the CRC32C (Castagnoli) of the bytes that produced crc (0 for no bytes) followed by the size bytes at buffer*/
+MOCKABLE_FUNCTION(, uint32_t, crc32c_update, uint32_t, crc, const unsigned char*, buffer, size_t, size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC32C_H */
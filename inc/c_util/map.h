@@ -11,13 +11,18 @@
 
 #ifdef __cplusplus
 #include <cstddef>
+#include <cstdint>
 #else
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #endif
 
 #include "macro_utils/macro_utils.h"
 #include "c_util/strings.h"
+#include "c_util/constbuffer.h"
+#include "c_util/thandle.h"
+#include "c_util/rc_string.h"
 
 #include "umock_c/umock_c_prod.h"
 #ifdef __cplusplus
@@ -42,6 +47,16 @@ typedef struct MAP_HANDLE_DATA_TAG* MAP_HANDLE;
 
 typedef int (*MAP_FILTER_CALLBACK)(const char* mapProperty, const char* mapValue);
 
+#define MAP_FROM_BUFFER_RESULT_VALUES \
+    MAP_FROM_BUFFER_RESULT_OK, \
+    MAP_FROM_BUFFER_RESULT_ERROR, \
+    MAP_FROM_BUFFER_RESULT_INVALID_ARG, \
+    MAP_FROM_BUFFER_RESULT_INVALID_DATA
+
+MU_DEFINE_ENUM(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_VALUES);
+
+typedef void*(*MAP_TO_BUFFER_ALLOC)(size_t size, void* context);
+
 /**
  * @brief   Creates a new, empty map.
  *
@@ -58,6 +73,78 @@ typedef int (*MAP_FILTER_CALLBACK)(const char* mapProperty, const char* mapValue
  */
 MOCKABLE_FUNCTION(, MAP_HANDLE, Map_Create, MAP_FILTER_CALLBACK, mapFilterFunc);
 
+/**
+ * @brief   Creates a new, empty map with room for @p capacity key/value
+ *          pairs.
+ *
+ * @param   mapFilterFunc   Same as for ::Map_Create.
+ * @param   capacity        The number of key/value pairs the map can hold
+ *                          before its storage has to grow.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, MAP_HANDLE, Map_CreateWithCapacity, MAP_FILTER_CALLBACK, mapFilterFunc, size_t, capacity);
+
+/**
+ * @brief   Creates a new, empty map with room for @p capacity key/value
+ *          pairs whose keys and values are stored in an arena owned by the
+ *          map instead of being allocated one by one.
+ *
+ *          The arena is a list of chunks, each at least twice the size of
+ *          the previous one, that are freed together when the map is
+ *          destroyed. Keys and values never move on their own: the bytes
+ *          of deleted or overwritten ones stay in the arena until
+ *          ::Map_CompactArena is called.
+ *
+ * @param   mapFilterFunc   Same as for ::Map_Create.
+ * @param   capacity        Same as for ::Map_CreateWithCapacity.
+ * @param   arenaSize       The number of bytes (null terminators included)
+ *                          of keys and values the map can hold before its
+ *                          arena has to grow.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, MAP_HANDLE, Map_CreateWithArena, MAP_FILTER_CALLBACK, mapFilterFunc, size_t, capacity, size_t, arenaSize);
+
+/**
+ * @brief   Creates a new, empty map with room for @p capacity key/value
+ *          pairs whose keys and values are held as @c THANDLE(RC_STRING)
+ *          references.
+ *
+ *          ::Map_AddRcString and ::Map_AddOrUpdateRcString store a
+ *          reference to the strings they are given instead of copying
+ *          them. ::Map_Add and ::Map_AddOrUpdate copy their strings once,
+ *          into new @c THANDLE(RC_STRING)s. ::Map_Clone and the private copy
+ *          made by the first change to a clone take references too, so the
+ *          strings of such a map are never copied after they are added.
+ *
+ * @param   mapFilterFunc   Same as for ::Map_Create.
+ * @param   capacity        Same as for ::Map_CreateWithCapacity.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, MAP_HANDLE, Map_CreateWithRcStrings, MAP_FILTER_CALLBACK, mapFilterFunc, size_t, capacity);
+
+/**
+ * @brief   Creates a map with the @p count pairs made of @p keys[i] and
+ *          @p values[i], in that order.
+ *
+ *          All the pairs are checked (with @p mapFilterFunc too) before
+ *          anything is allocated, then the map is created once with room
+ *          for all the pairs and all its keys and values in an arena (see
+ *          ::Map_CreateWithArena). Its key index detects repeated keys.
+ *
+ * @param   mapFilterFunc   Same as for ::Map_Create, it is also called for
+ *                          every pair of the arrays.
+ * @param   keys            The keys, none of them @c NULL.
+ * @param   values          The values, none of them @c NULL.
+ * @param   count           The number of pairs.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs, a key
+ *          repeats or @p mapFilterFunc rejects a pair.
+ */
+MOCKABLE_FUNCTION(, MAP_HANDLE, Map_CreateFromArrays, MAP_FILTER_CALLBACK, mapFilterFunc, const char* const*, keys, const char* const*, values, size_t, count);
+
 /**
  * @brief   Release all resources associated with the map.
  *
@@ -69,6 +156,11 @@ MOCKABLE_FUNCTION(, void, Map_Destroy, MAP_HANDLE, handle);
  * @brief   Creates a copy of the map indicated by @p handle and returns a
  *          handle to it.
  *
+ *          The clone shares the keys and values of the original map
+ *          until either of them is changed, so cloning does not copy
+ *          them. The first change to a map that shares them makes a
+ *          private copy for that map.
+ *
  * @param   handle  The handle to an existing map.
  *
  * @return  A valid @c MAP_HANDLE to the cloned copy of the map or @c NULL
@@ -125,6 +217,37 @@ MOCKABLE_FUNCTION(, MAP_RESULT, Map_Add, MAP_HANDLE, handle, const char*, key, c
  */
 MOCKABLE_FUNCTION(, MAP_RESULT, Map_AddOrUpdate, MAP_HANDLE, handle, const char*, key, const char*, value);
 
+/**
+ * @brief   Adds a key/value pair to the map, like ::Map_Add does with the
+ *          strings of @p key and @p value.
+ *
+ *          A map created by ::Map_CreateWithRcStrings keeps a reference to
+ *          @p key and @p value, other maps copy their strings.
+ *
+ * @param   handle  The handle to an existing map.
+ * @param   key     The @c key to be used for this map entry.
+ * @param   value   The @c value to be associated with @p key.
+ *
+ * @return  Same as ::Map_Add.
+ */
+MOCKABLE_FUNCTION(, MAP_RESULT, Map_AddRcString, MAP_HANDLE, handle, THANDLE(RC_STRING), key, THANDLE(RC_STRING), value);
+
+/**
+ * @brief   Adds/updates a key/value pair to the map, like ::Map_AddOrUpdate
+ *          does with the strings of @p key and @p value.
+ *
+ *          A map created by ::Map_CreateWithRcStrings keeps a reference to
+ *          @p key (when the key is new) and @p value, other maps copy their
+ *          strings.
+ *
+ * @param   handle  The handle to an existing map.
+ * @param   key     The @c key to be used for this map entry.
+ * @param   value   The @c value to be associated with @p key.
+ *
+ * @return  Same as ::Map_AddOrUpdate.
+ */
+MOCKABLE_FUNCTION(, MAP_RESULT, Map_AddOrUpdateRcString, MAP_HANDLE, handle, THANDLE(RC_STRING), key, THANDLE(RC_STRING), value);
+
 /**
  * @brief   Removes a key and its associated value from the map.
  *
@@ -167,6 +290,38 @@ MOCKABLE_FUNCTION(, MAP_RESULT, Map_ContainsKey, MAP_HANDLE, handle, const char*
  */
 MOCKABLE_FUNCTION(, MAP_RESULT, Map_ContainsValue, MAP_HANDLE, handle, const char*, value, bool*, valueExists);
 
+/**
+ * @brief   Makes the map maintain an index of its values so that
+ *          ::Map_ContainsValue does not have to scan all of them. The index
+ *          is kept up to date by ::Map_Add, ::Map_AddOrUpdate and
+ *          ::Map_Delete at the cost of some extra work and memory.
+ *
+ * @param   handle  The handle to an existing map.
+ *
+ * @return  Returns @c MAP_OK if the map has a value index or an error code
+ *          otherwise.
+ */
+MOCKABLE_FUNCTION(, MAP_RESULT, Map_EnableValueIndex, MAP_HANDLE, handle);
+
+/**
+ * @brief   Moves the keys and values of a map created by
+ *          ::Map_CreateWithArena to a single new chunk and frees the old
+ *          chunks, reclaiming the bytes of deleted and overwritten keys and
+ *          values.
+ *
+ *          All the pointers returned by ::Map_GetValueFromKey and
+ *          ::Map_GetInternals for the map are invalid afterwards. Does
+ *          nothing for other maps and for a map that shares its store with
+ *          clones.
+ *
+ * @param   handle  The handle to an existing map.
+ *
+ * @return  Returns @c MAP_OK if the arena holds no garbage afterwards or
+ *          nothing had to be done, an error code otherwise (the map is then
+ *          unchanged).
+ */
+MOCKABLE_FUNCTION(, MAP_RESULT, Map_CompactArena, MAP_HANDLE, handle);
+
 /**
  * @brief   Retrieves the value of a stored key.
  *
@@ -175,10 +330,29 @@ MOCKABLE_FUNCTION(, MAP_RESULT, Map_ContainsValue, MAP_HANDLE, handle, const cha
  *
  * @return  Returns @c NULL in case the input arguments are @c NULL or if the
  *          requested key is not found in the map. Returns a pointer to the
- *          key's value otherwise.
+ *          key's value otherwise. The pointer is owned by the map's store,
+ *          which may be shared with clones (see ::Map_Clone): it stays valid
+ *          until the next change to @p handle and, if @p handle shares its
+ *          store, until every map sharing the store has been changed or
+ *          destroyed.
  */
 MOCKABLE_FUNCTION(, const char*, Map_GetValueFromKey, MAP_HANDLE, handle, const char*, key);
 
+/**
+ * @brief   Retrieves the value of a stored key as a @c THANDLE(RC_STRING).
+ *
+ * @param   handle  The handle to an existing map.
+ * @param   key     The key to be looked up in the map.
+ *
+ * @return  Returns @c NULL in case the input arguments are @c NULL, if the
+ *          requested key is not found in the map or in case an error occurs.
+ *          Otherwise returns a reference to the key's value (for a map
+ *          created by ::Map_CreateWithRcStrings) or a new
+ *          @c THANDLE(RC_STRING) with a copy of it. The caller releases it
+ *          with @c THANDLE_ASSIGN(RC_STRING) with @c NULL.
+ */
+MOCKABLE_FUNCTION(, THANDLE(RC_STRING), Map_GetRcStringFromKey, MAP_HANDLE, handle, const char*, key);
+
 /**
  * @brief   Retrieves the complete list of keys and values from the map
  *          in @p values and @p keys. Also writes the size of the list
@@ -191,13 +365,86 @@ MOCKABLE_FUNCTION(, const char*, Map_GetValueFromKey, MAP_HANDLE, handle, const
  *                      location indicated by this pointer.
  *
  * @return  Returns @c MAP_OK if the keys and values are retrieved and written
- *          successfully or an error code otherwise.
+ *          successfully or an error code otherwise. The arrays and the
+ *          strings they point to have the same lifetime as the value
+ *          returned by ::Map_GetValueFromKey.
  */
 MOCKABLE_FUNCTION(, MAP_RESULT, Map_GetInternals, MAP_HANDLE, handle, const char*const**, keys, const char*const**, values, size_t*, count);
 
 /*this API creates a JSON object from the content of the map*/
 MOCKABLE_FUNCTION(, STRING_HANDLE, Map_ToJSON, MAP_HANDLE, handle);
 
+/**
+ * @brief   Writes the JSON object produced by ::Map_ToJSON in a buffer
+ *          supplied by the caller, without allocating memory.
+ *
+ * @param   handle          The handle to an existing map.
+ * @param   buffer          The buffer where the null terminated JSON is
+ *                          written. Can be @c NULL when @p bufferSize is 0.
+ * @param   bufferSize      The size of @p buffer in bytes.
+ * @param   requiredSize    The size of the JSON including its null
+ *                          terminator is written at the location indicated
+ *                          by this pointer, also when @p buffer is too small.
+ *
+ * @return  Returns @c MAP_OK if the JSON was written in @p buffer. Returns
+ *          @c MAP_ERROR if @p bufferSize is smaller than @p *requiredSize
+ *          (call with a 0 @p bufferSize to query the size) or if the map
+ *          cannot be represented in JSON, and @c MAP_INVALIDARG for invalid
+ *          arguments.
+ */
+MOCKABLE_FUNCTION(, MAP_RESULT, Map_ToJSONBuffer, MAP_HANDLE, handle, char*, buffer, size_t, bufferSize, size_t*, requiredSize);
+
+/**
+ * @brief   Creates a const buffer with the JSON object produced by
+ *          ::Map_ToJSON, without a null terminator. The JSON is written in
+ *          a single allocation that the const buffer takes over.
+ *
+ * @param   handle  The handle to an existing map.
+ *
+ * @return  A valid @c CONSTBUFFER_HANDLE or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, Map_ToJSONConstBuffer, MAP_HANDLE, handle);
+
+/**
+ * @brief   Serializes the map in a compact binary format: a version byte,
+ *          the number of pairs and then every key and value prefixed by
+ *          its length (see map_format.h). Lengths and the number of pairs
+ *          are written in network byte order.
+ *
+ * @param   handle          The handle to an existing map.
+ * @param   alloc           The function that allocates the memory for the
+ *                          serialization. When @c NULL, @c malloc is used.
+ * @param   alloc_context   Passed to @p alloc.
+ * @param   serializedSize  The size of the serialization is written at the
+ *                          location indicated by this pointer.
+ *
+ * @return  The memory holding the serialization, to be freed by the
+ *          caller, or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, unsigned char*, Map_ToBuffer, MAP_HANDLE, handle, MAP_TO_BUFFER_ALLOC, alloc, void*, alloc_context, uint32_t*, serializedSize);
+
+/**
+ * @brief   Creates a map from a serialization produced by ::Map_ToBuffer.
+ *
+ *          The whole serialization is validated before the map is built,
+ *          the map is then built with all its keys and values in a single
+ *          arena chunk (see ::Map_CreateWithArena). The map has no filter.
+ *
+ * @param   source          The serialization.
+ * @param   size            The number of bytes available at @p source.
+ * @param   consumed        The number of bytes of @p source that made up
+ *                          the serialization is written at the location
+ *                          indicated by this pointer.
+ * @param   destination     The new map is written at the location
+ *                          indicated by this pointer.
+ *
+ * @return  @c MAP_FROM_BUFFER_RESULT_OK if the map was created,
+ *          @c MAP_FROM_BUFFER_RESULT_INVALID_DATA if @p source is not a
+ *          valid serialization, @c MAP_FROM_BUFFER_RESULT_INVALID_ARG for
+ *          invalid arguments and @c MAP_FROM_BUFFER_RESULT_ERROR otherwise.
+ */
+MOCKABLE_FUNCTION(, MAP_FROM_BUFFER_RESULT, Map_FromBuffer, const unsigned char*, source, uint32_t, size, uint32_t*, consumed, MAP_HANDLE*, destination);
+
 #ifdef __cplusplus
 }
 #endif
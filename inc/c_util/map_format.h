@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MAP_FORMAT_H
+#define MAP_FORMAT_H
+
+#include <stdint.h>
+
+#define MAP_VERSION_OFFSET 0
+#define MAP_VERSION_SIZE (sizeof(uint8_t))
+
+#define MAP_COUNT_OFFSET (MAP_VERSION_OFFSET + MAP_VERSION_SIZE)
+#define MAP_COUNT_SIZE (sizeof(uint32_t))
+
+/*every pair is written as key length, key bytes, value length, value bytes. Lengths are uint32_t, strings have no null terminator*/
+#define MAP_PAIRS_OFFSET (MAP_COUNT_OFFSET + MAP_COUNT_SIZE)
+#define MAP_LENGTH_SIZE (sizeof(uint32_t))
+
+#define MAP_MIN_SERIALIZATION_SIZE MAP_PAIRS_OFFSET
+#define MAP_MIN_PAIR_SIZE (2 * MAP_LENGTH_SIZE)
+
+#endif  /* MAP_FORMAT_H */
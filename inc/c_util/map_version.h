@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MAP_VERSION_H
+#define MAP_VERSION_H
+
+/*this header only exists to provide the current serialization format of MAP*/
+#define MAP_VERSION_V1 1
+
+#endif  /* MAP_VERSION_H */
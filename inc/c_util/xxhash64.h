@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*returns the XXH64 hash of the size bytes at buffer, computed with seed*/
+MOCKABLE_FUNCTION(, uint64_t, xxhash64, const unsigned char*, buffer, size_t, size, uint64_t, seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XXHASH64_H */
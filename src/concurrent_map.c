@@ -0,0 +1,410 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_util/interlocked_hl.h"
+#include "c_util/map.h"
+
+#include "c_util/concurrent_map.h"
+
+#define CONCURRENT_MAP_CACHE_LINE_SIZE 64
+#define CONCURRENT_MAP_READER_SLOT_COUNT 64 /*power of 2*/
+
+/*readers that entered in an even epoch increment readers[0], readers that entered in an odd epoch increment readers[1]*/
+typedef struct CONCURRENT_MAP_READER_SLOT_TAG
+{
+    volatile_atomic int32_t readers[2];
+    uint8_t padding[CONCURRENT_MAP_CACHE_LINE_SIZE - 2 * sizeof(int32_t)]; /*keeps every slot on its own cache line*/
+}CONCURRENT_MAP_READER_SLOT;
+
+typedef struct CONCURRENT_MAP_HANDLE_DATA_TAG
+{
+    /*read by all the readers, written only by writers*/
+    void* volatile_atomic snapshot; /*a MAP_HANDLE that does not change once published*/
+    volatile_atomic int32_t epoch;
+    MAP_FILTER_CALLBACK mapFilterCallback;
+
+    volatile_atomic int32_t writer_lock;
+
+    CONCURRENT_MAP_READER_SLOT* slots; /*CONCURRENT_MAP_READER_SLOT_COUNT slots, at the first cache line boundary in storage*/
+    unsigned char storage[];
+}CONCURRENT_MAP_HANDLE_DATA;
+
+/*malloc only guarantees the alignment of max_align_t, the slots are placed at the first cache line boundary of room that is one cache line larger than they need*/
+#define CONCURRENT_MAP_SLOTS_STORAGE_SIZE (CONCURRENT_MAP_READER_SLOT_COUNT * sizeof(CONCURRENT_MAP_READER_SLOT) + CONCURRENT_MAP_CACHE_LINE_SIZE - 1)
+
+typedef MAP_RESULT(*CONCURRENT_MAP_CHANGE)(MAP_HANDLE handle, const char* key, const char* value);
+
+CONCURRENT_MAP_HANDLE concurrent_map_create(MAP_FILTER_CALLBACK mapFilterFunc)
+{
+    /*Codes_SRS_CONCURRENT_MAP_11_001: [ concurrent_map_create shall allocate memory for the concurrent map and its reader slots in a single allocation and shall place the reader slots at a cache line boundary. ]*/
+    CONCURRENT_MAP_HANDLE_DATA* result = malloc_flex(sizeof(CONCURRENT_MAP_HANDLE_DATA), CONCURRENT_MAP_SLOTS_STORAGE_SIZE, sizeof(unsigned char));
+    if (result == NULL)
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_004: [ If there are any failures then concurrent_map_create shall fail and return NULL. ]*/
+        LogError("failure in malloc_flex(sizeof(CONCURRENT_MAP_HANDLE_DATA)=%zu, CONCURRENT_MAP_SLOTS_STORAGE_SIZE=%zu, sizeof(unsigned char)=%zu)",
+            sizeof(CONCURRENT_MAP_HANDLE_DATA), CONCURRENT_MAP_SLOTS_STORAGE_SIZE, sizeof(unsigned char));
+        /*return as is*/
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_002: [ concurrent_map_create shall create the first snapshot by calling Map_Create with NULL as filter, the filter is applied by concurrent_map_add and concurrent_map_add_or_update. ]*/
+        /*Map_Clone drops the filter of an empty map, so the snapshots never carry it*/
+        MAP_HANDLE snapshot = Map_Create(NULL);
+        if (snapshot == NULL)
+        {
+            /*Codes_SRS_CONCURRENT_MAP_11_004: [ If there are any failures then concurrent_map_create shall fail and return NULL. ]*/
+            LogError("failure in Map_Create(NULL)");
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            uint32_t i;
+            /*every slot is then on a cache line of its own, which no field above shares either*/
+            result->slots = (CONCURRENT_MAP_READER_SLOT*)(result->storage + ((CONCURRENT_MAP_CACHE_LINE_SIZE - ((uintptr_t)result->storage & (CONCURRENT_MAP_CACHE_LINE_SIZE - 1))) & (CONCURRENT_MAP_CACHE_LINE_SIZE - 1)));
+            (void)interlocked_exchange_pointer(&result->snapshot, snapshot);
+            /*Codes_SRS_CONCURRENT_MAP_11_003: [ concurrent_map_create shall set the epoch and all the reader counters to 0. ]*/
+            (void)interlocked_exchange(&result->epoch, 0);
+            (void)interlocked_exchange(&result->writer_lock, 0);
+            for (i = 0; i < CONCURRENT_MAP_READER_SLOT_COUNT; i++)
+            {
+                (void)interlocked_exchange(&result->slots[i].readers[0], 0);
+                (void)interlocked_exchange(&result->slots[i].readers[1], 0);
+            }
+            result->mapFilterCallback = mapFilterFunc;
+            /*return as is*/
+        }
+    }
+    return result;
+}
+
+void concurrent_map_destroy(CONCURRENT_MAP_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_005: [ If handle is NULL then concurrent_map_destroy shall return. ]*/
+        LogError("invalid argument CONCURRENT_MAP_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_006: [ concurrent_map_destroy shall destroy the snapshot by calling Map_Destroy and free all used resources. ]*/
+        Map_Destroy(handle->snapshot);
+        free(handle);
+    }
+}
+
+/*pins the snapshot for the calling thread and returns the counter that unpins it*/
+static volatile_atomic int32_t* concurrent_map_reader_enter(CONCURRENT_MAP_HANDLE_DATA* handleData, int32_t* epoch, MAP_HANDLE* snapshot)
+{
+    volatile_atomic int32_t* result;
+
+    /*Codes_SRS_CONCURRENT_MAP_11_025: [ The reader shall pick a reader slot from the address of its stack. ]*/
+    /*threads have their own stacks, hashing the page of a local variable spreads them over the slots without touching any shared memory*/
+    uint64_t stack_page = (uint64_t)(uintptr_t)&result >> 12;
+    CONCURRENT_MAP_READER_SLOT* slot = &handleData->slots[(stack_page * 0x9E3779B97F4A7C15ULL) >> 58];
+
+    for (;;)
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_026: [ The reader shall read the epoch, increment the slot's counter for the parity of the epoch and read the epoch again. If the epoch changed then the reader shall decrement the counter and start over. ]*/
+        /*plain atomic reads: interlocked_add(&handleData->epoch, 0) would write the cache line that all the readers share*/
+        *epoch = handleData->epoch;
+        result = &slot->readers[*epoch & 1];
+        (void)interlocked_increment(result);
+        if (handleData->epoch == *epoch)
+        {
+            break;
+        }
+        /*a writer has moved to the next epoch and might be waiting for this counter*/
+        if (interlocked_decrement(result) == 0)
+        {
+            wake_by_address_single(result);
+        }
+    }
+
+    /*Codes_SRS_CONCURRENT_MAP_11_027: [ The reader shall read the snapshot only after the counter was incremented in an unchanged epoch. ]*/
+    *snapshot = handleData->snapshot;
+    return result;
+}
+
+static void concurrent_map_reader_exit(CONCURRENT_MAP_HANDLE_DATA* handleData, volatile_atomic int32_t* readers, int32_t epoch)
+{
+    /*Codes_SRS_CONCURRENT_MAP_11_028: [ When the reader is done with the snapshot it shall decrement the counter and, if the counter became 0 and the epoch changed since the reader read it, call wake_by_address_single. ]*/
+    /*only a writer that moved past the reader's epoch waits for the counter, readers of the current epoch do not pay for a wake*/
+    if (
+        (interlocked_decrement(readers) == 0) &&
+        (handleData->epoch != epoch)
+        )
+    {
+        wake_by_address_single(readers);
+    }
+}
+
+/*moves to the next epoch and returns once no reader can reference a snapshot read in the previous epoch*/
+static void concurrent_map_wait_for_readers(CONCURRENT_MAP_HANDLE_DATA* handleData)
+{
+    uint32_t i;
+    /*Codes_SRS_CONCURRENT_MAP_11_021: [ The writer shall increment the epoch and wait with InterlockedHL_WaitForValue for all the reader counters of the previous epoch's parity to become 0. ]*/
+    int32_t parity = (interlocked_increment(&handleData->epoch) - 1) & 1;
+    for (i = 0; i < CONCURRENT_MAP_READER_SLOT_COUNT; i++)
+    {
+        while (InterlockedHL_WaitForValue(&handleData->slots[i].readers[parity], 0, UINT32_MAX) != INTERLOCKED_HL_OK)
+        {
+            /*the previous snapshot cannot be destroyed until the readers are gone, so keep waiting*/
+            LogError("failure in InterlockedHL_WaitForValue(&handleData->slots[%" PRIu32 "].readers[%" PRId32 "], 0, UINT32_MAX)", i, parity);
+        }
+    }
+}
+
+static MAP_RESULT concurrent_map_change(CONCURRENT_MAP_HANDLE_DATA* handleData, CONCURRENT_MAP_CHANGE change, const char* key, const char* value)
+{
+    MAP_RESULT result;
+
+    /*Codes_SRS_CONCURRENT_MAP_11_015: [ The writer shall acquire the writer lock by switching it from 0 to 1 with interlocked_compare_exchange, waiting with InterlockedHL_WaitForValue for the lock to become 0 while it is 1. ]*/
+    while (interlocked_compare_exchange(&handleData->writer_lock, 1, 0) != 0)
+    {
+        (void)InterlockedHL_WaitForValue(&handleData->writer_lock, 0, UINT32_MAX);
+    }
+
+    /*only writers change the snapshot and the writer lock is held*/
+    MAP_HANDLE snapshot = handleData->snapshot;
+
+    /*Codes_SRS_CONCURRENT_MAP_11_016: [ The writer shall clone the snapshot by calling Map_Clone. ]*/
+    MAP_HANDLE clone = Map_Clone(snapshot);
+    if (clone == NULL)
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_024: [ If Map_Clone fails then the writer shall return MAP_ERROR. ]*/
+        LogError("failure in Map_Clone(snapshot=%p)", snapshot);
+        result = MAP_ERROR;
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_017: [ The writer shall apply the change to the clone. ]*/
+        result = change(clone, key, value);
+        if (result != MAP_OK)
+        {
+            /*Codes_SRS_CONCURRENT_MAP_11_018: [ If the change does not return MAP_OK then the writer shall destroy the clone by calling Map_Destroy, leave the snapshot in place and return the result of the change. ]*/
+            Map_Destroy(clone);
+        }
+        else
+        {
+            const char* const* keys;
+            const char* const* values;
+            size_t count;
+
+            /*Codes_SRS_CONCURRENT_MAP_11_019: [ The writer shall compact the clone by calling Map_GetInternals. ]*/
+            /*Map_Clone compacts its source, a published snapshot must not have anything left to compact*/
+            (void)Map_GetInternals(clone, &keys, &values, &count);
+
+            /*Codes_SRS_CONCURRENT_MAP_11_020: [ The writer shall publish the clone as the snapshot by calling interlocked_exchange_pointer. ]*/
+            (void)interlocked_exchange_pointer(&handleData->snapshot, clone);
+
+            concurrent_map_wait_for_readers(handleData);
+
+            /*Codes_SRS_CONCURRENT_MAP_11_022: [ The writer shall destroy the previous snapshot by calling Map_Destroy and return MAP_OK. ]*/
+            Map_Destroy(snapshot);
+        }
+    }
+
+    /*Codes_SRS_CONCURRENT_MAP_11_023: [ The writer shall release the writer lock by calling InterlockedHL_SetAndWake with 0. ]*/
+    (void)InterlockedHL_SetAndWake(&handleData->writer_lock, 0);
+
+    return result;
+}
+
+static MAP_RESULT concurrent_map_delete_change(MAP_HANDLE handle, const char* key, const char* value)
+{
+    (void)value;
+    return Map_Delete(handle, key);
+}
+
+MAP_RESULT concurrent_map_add(CONCURRENT_MAP_HANDLE handle, const char* key, const char* value)
+{
+    MAP_RESULT result;
+    if (
+        /*Codes_SRS_CONCURRENT_MAP_11_007: [ If handle, key or value is NULL then concurrent_map_add shall fail and return MAP_INVALIDARG. ]*/
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        LogError("invalid arguments CONCURRENT_MAP_HANDLE handle=%p, const char* key=%s, const char* value=%s",
+            handle, MU_P_OR_NULL(key), MU_P_OR_NULL(value));
+        result = MAP_INVALIDARG;
+    }
+    /*Codes_SRS_CONCURRENT_MAP_11_008: [ If the filter passed to concurrent_map_create is not NULL and it returns non-zero for key and value then concurrent_map_add shall return MAP_FILTER_REJECT. ]*/
+    else if (
+        (handle->mapFilterCallback != NULL) &&
+        (handle->mapFilterCallback(key, value) != 0)
+        )
+    {
+        result = MAP_FILTER_REJECT;
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_009: [ concurrent_map_add shall change the map as described in "Changing the map" with Map_Add as change. ]*/
+        result = concurrent_map_change(handle, Map_Add, key, value);
+    }
+    return result;
+}
+
+MAP_RESULT concurrent_map_add_or_update(CONCURRENT_MAP_HANDLE handle, const char* key, const char* value)
+{
+    MAP_RESULT result;
+    if (
+        /*Codes_SRS_CONCURRENT_MAP_11_010: [ If handle, key or value is NULL then concurrent_map_add_or_update shall fail and return MAP_INVALIDARG. ]*/
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        LogError("invalid arguments CONCURRENT_MAP_HANDLE handle=%p, const char* key=%s, const char* value=%s",
+            handle, MU_P_OR_NULL(key), MU_P_OR_NULL(value));
+        result = MAP_INVALIDARG;
+    }
+    /*Codes_SRS_CONCURRENT_MAP_11_011: [ If the filter passed to concurrent_map_create is not NULL and it returns non-zero for key and value then concurrent_map_add_or_update shall return MAP_FILTER_REJECT. ]*/
+    else if (
+        (handle->mapFilterCallback != NULL) &&
+        (handle->mapFilterCallback(key, value) != 0)
+        )
+    {
+        result = MAP_FILTER_REJECT;
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_012: [ concurrent_map_add_or_update shall change the map as described in "Changing the map" with Map_AddOrUpdate as change. ]*/
+        result = concurrent_map_change(handle, Map_AddOrUpdate, key, value);
+    }
+    return result;
+}
+
+MAP_RESULT concurrent_map_delete(CONCURRENT_MAP_HANDLE handle, const char* key)
+{
+    MAP_RESULT result;
+    if (
+        /*Codes_SRS_CONCURRENT_MAP_11_013: [ If handle or key is NULL then concurrent_map_delete shall fail and return MAP_INVALIDARG. ]*/
+        (handle == NULL) ||
+        (key == NULL)
+        )
+    {
+        LogError("invalid arguments CONCURRENT_MAP_HANDLE handle=%p, const char* key=%s",
+            handle, MU_P_OR_NULL(key));
+        result = MAP_INVALIDARG;
+    }
+    else
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_014: [ concurrent_map_delete shall change the map as described in "Changing the map" with Map_Delete as change. ]*/
+        result = concurrent_map_change(handle, concurrent_map_delete_change, key, NULL);
+    }
+    return result;
+}
+
+MAP_RESULT concurrent_map_contains_key(CONCURRENT_MAP_HANDLE handle, const char* key, bool* keyExists)
+{
+    MAP_RESULT result;
+    if (
+        /*Codes_SRS_CONCURRENT_MAP_11_029: [ If handle, key or keyExists is NULL then concurrent_map_contains_key shall fail and return MAP_INVALIDARG. ]*/
+        (handle == NULL) ||
+        (key == NULL) ||
+        (keyExists == NULL)
+        )
+    {
+        LogError("invalid arguments CONCURRENT_MAP_HANDLE handle=%p, const char* key=%s, bool* keyExists=%p",
+            handle, MU_P_OR_NULL(key), keyExists);
+        result = MAP_INVALIDARG;
+    }
+    else
+    {
+        int32_t epoch;
+        MAP_HANDLE snapshot;
+        volatile_atomic int32_t* readers = concurrent_map_reader_enter(handle, &epoch, &snapshot);
+
+        /*Codes_SRS_CONCURRENT_MAP_11_030: [ concurrent_map_contains_key shall call Map_ContainsKey on the snapshot as described in "Reading the map" and return its result. ]*/
+        result = Map_ContainsKey(snapshot, key, keyExists);
+
+        concurrent_map_reader_exit(handle, readers, epoch);
+    }
+    return result;
+}
+
+char* concurrent_map_get_value_from_key(CONCURRENT_MAP_HANDLE handle, const char* key)
+{
+    char* result;
+    if (
+        /*Codes_SRS_CONCURRENT_MAP_11_031: [ If handle or key is NULL then concurrent_map_get_value_from_key shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        (key == NULL)
+        )
+    {
+        LogError("invalid arguments CONCURRENT_MAP_HANDLE handle=%p, const char* key=%s",
+            handle, MU_P_OR_NULL(key));
+        result = NULL;
+    }
+    else
+    {
+        int32_t epoch;
+        MAP_HANDLE snapshot;
+        volatile_atomic int32_t* readers = concurrent_map_reader_enter(handle, &epoch, &snapshot);
+
+        /*Codes_SRS_CONCURRENT_MAP_11_032: [ concurrent_map_get_value_from_key shall call Map_GetValueFromKey on the snapshot as described in "Reading the map". ]*/
+        const char* value = Map_GetValueFromKey(snapshot, key);
+        if (value == NULL)
+        {
+            /*Codes_SRS_CONCURRENT_MAP_11_033: [ If Map_GetValueFromKey returns NULL then concurrent_map_get_value_from_key shall return NULL. ]*/
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONCURRENT_MAP_11_034: [ Otherwise concurrent_map_get_value_from_key shall allocate memory for a copy of the value, copy the value before releasing the snapshot and return the copy. ]*/
+            size_t size = strlen(value) + 1;
+            result = malloc(size);
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONCURRENT_MAP_11_035: [ If allocating memory fails then concurrent_map_get_value_from_key shall fail and return NULL. ]*/
+                LogError("failure in malloc(size=%zu)", size);
+            }
+            else
+            {
+                (void)memcpy(result, value, size);
+            }
+        }
+
+        concurrent_map_reader_exit(handle, readers, epoch);
+    }
+    return result;
+}
+
+MAP_HANDLE concurrent_map_get_snapshot(CONCURRENT_MAP_HANDLE handle)
+{
+    MAP_HANDLE result;
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONCURRENT_MAP_11_036: [ If handle is NULL then concurrent_map_get_snapshot shall fail and return NULL. ]*/
+        LogError("invalid argument CONCURRENT_MAP_HANDLE handle=%p", handle);
+        result = NULL;
+    }
+    else
+    {
+        int32_t epoch;
+        MAP_HANDLE snapshot;
+        volatile_atomic int32_t* readers = concurrent_map_reader_enter(handle, &epoch, &snapshot);
+
+        /*Codes_SRS_CONCURRENT_MAP_11_037: [ concurrent_map_get_snapshot shall call Map_Clone on the snapshot as described in "Reading the map" and return its result. ]*/
+        result = Map_Clone(snapshot);
+
+        concurrent_map_reader_exit(handle, readers, epoch);
+    }
+    return result;
+}
@@ -14,6 +14,8 @@
 #include "c_pal/interlocked.h"
 
 #include "c_util/memory_data.h"
+#include "c_util/crc32c.h"
+#include "c_util/xxhash64.h"
 #include "c_util/constbuffer_format.h"
 #include "c_util/constbuffer_version.h"
 #include "c_util/constbuffer.h"
@@ -22,10 +24,17 @@
     CONSTBUFFER_TYPE_COPIED, \
     CONSTBUFFER_TYPE_MEMORY_MOVED, \
     CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, \
-    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE
+    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE, \
+    CONSTBUFFER_TYPE_WRITABLE
 
 MU_DEFINE_ENUM(CONSTBUFFER_TYPE, CONSTBUFFER_TYPE_VALUES)
 
+#define CONSTBUFFER_CONTENT_HASH_STATE_VALUES \
+    CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED, \
+    CONSTBUFFER_CONTENT_HASH_STATE_COMPUTED
+
+MU_DEFINE_ENUM(CONSTBUFFER_CONTENT_HASH_STATE, CONSTBUFFER_CONTENT_HASH_STATE_VALUES)
+
 MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES);
 
 MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES);
@@ -37,10 +46,229 @@ typedef struct CONSTBUFFER_HANDLE_DATA_TAG
     CONSTBUFFER_TYPE buffer_type;
     CONSTBUFFER_CUSTOM_FREE_FUNC custom_free_func;
     void* custom_free_func_context;
-    CONSTBUFFER_HANDLE originalHandle; /*where the CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE was build from*/
+    CONSTBUFFER_HANDLE originalHandle; /*where the CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE was build from, never a CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE itself*/
+    uint32_t writable_capacity; /*number of bytes of storage a CONSTBUFFER_TYPE_WRITABLE can be filled with*/
+    bool is_large; /*true for a CONSTBUFFER_LARGE_HANDLE, whose header is larger than the ones cached in the header pool*/
+    volatile_atomic int32_t content_hash_state; /*CONSTBUFFER_CONTENT_HASH_STATE_COMPUTED once content_hash has been stored*/
+    volatile_atomic int64_t content_hash; /*xxhash64 of alias, computed by the first CONSTBUFFER_get_content_hash*/
     unsigned char storage[]; /*if the memory was copied, this is where the copied memory is. For example in the case of CONSTBUFFER_CreateFromOffsetAndSizeWithCopy. Can have 0 as size.*/
 } CONSTBUFFER_HANDLE_DATA;
 
+#define CONSTBUFFER_CACHE_LINE_SIZE 64
+#define CONSTBUFFER_HEADER_POOL_SHARD_COUNT 64 /*power of 2*/
+#define CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY 16 /*a shard is 128 bytes (2 cache lines) on 64 bit*/
+
+typedef struct CONSTBUFFER_HEADER_POOL_SHARD_TAG
+{
+    void* volatile_atomic headers[CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY]; /*NULL = empty slot*/
+}CONSTBUFFER_HEADER_POOL_SHARD;
+
+typedef struct CONSTBUFFER_HEADER_POOL_TAG
+{
+    CONSTBUFFER_HEADER_POOL_SHARD shards[CONSTBUFFER_HEADER_POOL_SHARD_COUNT];
+}CONSTBUFFER_HEADER_POOL;
+
+/*counts the threads that are using a shard of the header pool, CONSTBUFFER_header_pool_deinit waits for all the counts to drop to 0 before freeing the pool*/
+/*the counts are not part of the pool: a thread increments its count before it knows whether there is a pool at all*/
+typedef struct CONSTBUFFER_HEADER_POOL_USERS_TAG
+{
+    volatile_atomic int32_t count;
+    uint8_t padding[CONSTBUFFER_CACHE_LINE_SIZE - sizeof(int32_t)]; /*keeps every count on its own cache line*/
+}CONSTBUFFER_HEADER_POOL_USERS;
+
+/*a CONSTBUFFER_HEADER_POOL*, NULL when the headers come straight from malloc and go straight back to free*/
+static void* volatile_atomic g_header_pool = NULL;
+static CONSTBUFFER_HEADER_POOL_USERS g_header_pool_users[CONSTBUFFER_HEADER_POOL_SHARD_COUNT];
+
+static uint32_t CONSTBUFFER_header_pool_get_shard_index(void)
+{
+    /*Codes_SRS_CONSTBUFFER_11_008: [ The shard shall be picked by hashing the address of the stack of the calling thread. ]*/
+    /*threads have their own stacks, hashing the 64KB region of a local variable gives every thread its "own" shard without touching any shared memory*/
+    /*the region is larger than a page so that creates and destroys called from different stack depths of the same thread mostly use the same shard*/
+    int stack_variable;
+    uint64_t stack_region = (uint64_t)(uintptr_t)&stack_variable >> 16;
+    return (uint32_t)((stack_region * 0x9E3779B97F4A7C15ULL) >> 58);
+}
+
+static void CONSTBUFFER_header_pool_leave(uint32_t shard_index)
+{
+    /*Codes_SRS_CONSTBUFFER_11_131: [ The creates and destroys shall decrement the count of users of the shard by calling interlocked_decrement when they no longer use the header pool. ]*/
+    (void)interlocked_decrement(&g_header_pool_users[shard_index].count);
+}
+
+/*returns the header pool to use until CONSTBUFFER_header_pool_leave, or NULL (and then there is nothing to leave)*/
+static CONSTBUFFER_HEADER_POOL* CONSTBUFFER_header_pool_enter(uint32_t shard_index)
+{
+    CONSTBUFFER_HEADER_POOL* result;
+    /*the plain read keeps the creates and destroys that run without a header pool free of interlocked operations*/
+    if (g_header_pool == NULL)
+    {
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_130: [ Before using the header pool, the creates and destroys shall increment the count of users of the shard by calling interlocked_increment and read the header pool again. ]*/
+        /*once the count is visible CONSTBUFFER_header_pool_deinit either waits for it or has already unpublished the pool, which the second read sees*/
+        (void)interlocked_increment(&g_header_pool_users[shard_index].count);
+        result = g_header_pool;
+        if (result == NULL)
+        {
+            CONSTBUFFER_header_pool_leave(shard_index);
+        }
+    }
+    return result;
+}
+
+static CONSTBUFFER_HANDLE CONSTBUFFER_header_alloc(void)
+{
+    CONSTBUFFER_HANDLE result = NULL;
+    uint32_t shard_index = CONSTBUFFER_header_pool_get_shard_index();
+    CONSTBUFFER_HEADER_POOL* pool = CONSTBUFFER_header_pool_enter(shard_index);
+    if (pool != NULL)
+    {
+        CONSTBUFFER_HEADER_POOL_SHARD* shard = &pool->shards[shard_index];
+        for (uint32_t i = 0; i < CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY; i++)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_009: [ If the shard has a cached header then the header shall be taken from the shard by calling interlocked_exchange_pointer with NULL. ]*/
+            /*the plain read skips the empty slots without writing to the cache line*/
+            if (shard->headers[i] != NULL)
+            {
+                result = interlocked_exchange_pointer(&shard->headers[i], NULL);
+                if (result != NULL)
+                {
+                    break;
+                }
+            }
+        }
+        CONSTBUFFER_header_pool_leave(shard_index);
+    }
+
+    if (result == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_010: [ Otherwise the header shall be allocated by calling malloc. ]*/
+        result = (CONSTBUFFER_HANDLE)malloc(sizeof(CONSTBUFFER_HANDLE_DATA));
+    }
+
+    if (result != NULL)
+    {
+        result->is_large = false;
+    }
+    return result;
+}
+
+static void CONSTBUFFER_header_free(CONSTBUFFER_HANDLE header)
+{
+    bool cached = false;
+    uint32_t shard_index = CONSTBUFFER_header_pool_get_shard_index();
+    CONSTBUFFER_HEADER_POOL* pool = CONSTBUFFER_header_pool_enter(shard_index);
+    if (pool != NULL)
+    {
+        CONSTBUFFER_HEADER_POOL_SHARD* shard = &pool->shards[shard_index];
+        for (uint32_t i = 0; i < CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY; i++)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_011: [ If the shard has an empty slot then the header shall be cached in the slot by calling interlocked_compare_exchange_pointer. ]*/
+            if (
+                (shard->headers[i] == NULL) &&
+                (interlocked_compare_exchange_pointer(&shard->headers[i], header, NULL) == NULL)
+                )
+            {
+                cached = true;
+                break;
+            }
+        }
+        CONSTBUFFER_header_pool_leave(shard_index);
+    }
+
+    if (!cached)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_012: [ Otherwise the header shall be freed by calling free. ]*/
+        free(header);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, CONSTBUFFER_header_pool_init)
+{
+    int result;
+    if (g_header_pool != NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_001: [ If the header pool is already initialized then CONSTBUFFER_header_pool_init shall fail and return a non-zero value. ]*/
+        LogError("header pool already initialized");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_002: [ CONSTBUFFER_header_pool_init shall allocate memory for the header pool. ]*/
+        CONSTBUFFER_HEADER_POOL* pool = malloc(sizeof(CONSTBUFFER_HEADER_POOL));
+        if (pool == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_003: [ If there are any failures then CONSTBUFFER_header_pool_init shall fail and return a non-zero value. ]*/
+            LogError("failure in malloc(sizeof(CONSTBUFFER_HEADER_POOL)=%zu)", sizeof(CONSTBUFFER_HEADER_POOL));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < CONSTBUFFER_HEADER_POOL_SHARD_COUNT; i++)
+            {
+                for (uint32_t j = 0; j < CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY; j++)
+                {
+                    (void)interlocked_exchange_pointer(&pool->shards[i].headers[j], NULL);
+                }
+            }
+
+            /*Codes_SRS_CONSTBUFFER_11_004: [ CONSTBUFFER_header_pool_init shall set all the slots of all the shards to empty, make the header pool used by all the following creates and destroys by calling interlocked_compare_exchange_pointer and succeed and return 0. ]*/
+            if (interlocked_compare_exchange_pointer(&g_header_pool, pool, NULL) != NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_132: [ If another header pool was made used in the meantime then CONSTBUFFER_header_pool_init shall free the memory it allocated and fail and return a non-zero value. ]*/
+                LogError("header pool initialized concurrently");
+                free(pool);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_header_pool_deinit)
+{
+    /*Codes_SRS_CONSTBUFFER_11_007: [ After CONSTBUFFER_header_pool_deinit headers shall be allocated by calling malloc and freed by calling free. ]*/
+    /*Codes_SRS_CONSTBUFFER_11_133: [ CONSTBUFFER_header_pool_deinit shall stop the creates and destroys from using the header pool by calling interlocked_exchange_pointer with NULL. ]*/
+    CONSTBUFFER_HEADER_POOL* pool = interlocked_exchange_pointer(&g_header_pool, NULL);
+    if (pool == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_005: [ If the header pool is not initialized then CONSTBUFFER_header_pool_deinit shall return. ]*/
+        LogError("header pool not initialized");
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_134: [ CONSTBUFFER_header_pool_deinit shall wait for the count of users of every shard to be 0. ]*/
+        /*a user holds its count for a few instructions and never blocks, spinning is cheaper than making every user wake the deinit*/
+        for (uint32_t i = 0; i < CONSTBUFFER_HEADER_POOL_SHARD_COUNT; i++)
+        {
+            while (interlocked_add(&g_header_pool_users[i].count, 0) != 0)
+            {
+                /*spin*/
+            }
+        }
+
+        /*Codes_SRS_CONSTBUFFER_11_006: [ CONSTBUFFER_header_pool_deinit shall free all the cached headers and the header pool. ]*/
+        for (uint32_t i = 0; i < CONSTBUFFER_HEADER_POOL_SHARD_COUNT; i++)
+        {
+            for (uint32_t j = 0; j < CONSTBUFFER_HEADER_POOL_SHARD_CAPACITY; j++)
+            {
+                if (pool->shards[i].headers[j] != NULL)
+                {
+                    free(pool->shards[i].headers[j]);
+                }
+            }
+        }
+        free(pool);
+    }
+}
+
 static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* source, uint32_t size)
 {
     CONSTBUFFER_HANDLE result;
@@ -60,6 +288,7 @@ static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* sourc
     else
     {
         (void)interlocked_exchange(&result->count, 1);
+        (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
 
         /*Codes_SRS_CONSTBUFFER_02_002: [Otherwise, CONSTBUFFER_Create shall create a copy of the memory area pointed to by source having size bytes.]*/
         result->alias.size = size;
@@ -133,7 +362,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithMoveMemo
     }
     else
     {
-        result = (CONSTBUFFER_HANDLE)malloc(sizeof(CONSTBUFFER_HANDLE_DATA));
+        result = CONSTBUFFER_header_alloc();
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_01_005: [ If any error occurs, CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL. ]*/
@@ -146,6 +375,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithMoveMemo
             result->alias.buffer = source;
             result->alias.size = size;
             result->buffer_type = CONSTBUFFER_TYPE_MEMORY_MOVED;
+            (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
 
             /* Codes_SRS_CONSTBUFFER_01_003: [ The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1". ]*/
             (void)interlocked_exchange(&result->count, 1);
@@ -174,7 +404,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithCustomFr
     }
     else
     {
-        result = (CONSTBUFFER_HANDLE)malloc(sizeof(CONSTBUFFER_HANDLE_DATA));
+        result = CONSTBUFFER_header_alloc();
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_01_011: [ If any error occurs, CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL. ]*/
@@ -187,6 +417,7 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithCustomFr
             result->alias.buffer = source;
             result->alias.size = size;
             result->buffer_type = CONSTBUFFER_TYPE_WITH_CUSTOM_FREE;
+            (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
 
             /* Codes_SRS_CONSTBUFFER_01_009: [ CONSTBUFFER_CreateWithCustomFree shall store customFreeFunc and customFreeFuncContext in order to use them to free the memory when the CONST buffer resources are freed. ]*/
             result->custom_free_func = customFreeFunc;
@@ -200,6 +431,23 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithCustomFr
     return result;
 }
 
+/*makes slice keep alive the handle it was built from. Slices of slices never form chains, they all keep alive the handle that owns the content*/
+static void CONSTBUFFER_reference_original_handle(CONSTBUFFER_HANDLE slice, CONSTBUFFER_HANDLE handle)
+{
+    if (handle->buffer_type == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_037: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of the original handle of handle (and not of handle) so that slices of slices never form chains. ]*/
+        (void)interlocked_increment(&handle->originalHandle->count);
+        slice->originalHandle = handle->originalHandle;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+        (void)interlocked_increment(&handle->count);
+        slice->originalHandle = handle;
+    }
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAndSize, CONSTBUFFER_HANDLE, handle, uint32_t, offset, uint32_t, size)
 {
     CONSTBUFFER_HANDLE result;
@@ -222,11 +470,11 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAn
     else
     {
         /*Codes_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
-        result = (CONSTBUFFER_HANDLE)malloc(sizeof(CONSTBUFFER_HANDLE_DATA));
+        result = CONSTBUFFER_header_alloc();
         if (result == NULL)
         {
             /*Codes_SRS_CONSTBUFFER_02_032: [ If there are any failures then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL. ]*/
-            LogError("failure in malloc(sizeof(CONSTBUFFER_HANDLE_DATA)=%zu)", sizeof(CONSTBUFFER_HANDLE_DATA));
+            LogError("failure in CONSTBUFFER_header_alloc()");
             /*return as is*/
         }
         else
@@ -234,10 +482,9 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAn
             result->buffer_type = CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE;
             result->alias.buffer = handle->alias.buffer+offset;
             result->alias.size = size;
+            (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
 
-            /*Codes_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
-            (void)interlocked_increment(&handle->count);
-            result->originalHandle = handle;
+            CONSTBUFFER_reference_original_handle(result, handle);
 
             /*Codes_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
             (void)interlocked_exchange(&result->count, 1);
@@ -284,6 +531,250 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAn
     return result;
 }
 
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithAlignment, const unsigned char*, source, uint32_t, size, uint32_t, alignment)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_067: [ If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+        ((source == NULL) && (size != 0)) ||
+        /*Codes_SRS_CONSTBUFFER_11_068: [ If alignment is 0 or is not a power of 2 then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0)
+        )
+    {
+        LogError("invalid arguments const unsigned char* source=%p, uint32_t size=%" PRIu32 ", uint32_t alignment=%" PRIu32 "",
+            source, size, alignment);
+        result = NULL;
+    }
+    else
+    {
+        /*the content starts at the first multiple of alignment in storage, which is at most alignment - 1 bytes in*/
+        size_t padding = (size == 0) ? 0 : (size_t)alignment - 1;
+        if (size > SIZE_MAX - padding)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_070: [ If there are any failures then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+            LogError("size=%" PRIu32 " + padding=%zu exceeds SIZE_MAX", size, padding);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_069: [ CONSTBUFFER_CreateWithAlignment shall allocate memory for the handle and size + alignment - 1 bytes of content in a single allocation. ]*/
+            result = (CONSTBUFFER_HANDLE)malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA), size + padding, sizeof(unsigned char));
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_070: [ If there are any failures then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+                LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA)=%zu, size=%" PRIu32 " + padding=%zu, sizeof(unsigned char)=%zu)",
+                    sizeof(CONSTBUFFER_HANDLE_DATA), size, padding, sizeof(unsigned char));
+                /*return as is*/
+            }
+            else
+            {
+                result->alias.size = size;
+                if (size == 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_11_071: [ If size is 0 then CONSTBUFFER_CreateWithAlignment shall set the buffer of the content to NULL. ]*/
+                    result->alias.buffer = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_11_072: [ CONSTBUFFER_CreateWithAlignment shall copy the size bytes of source at the first address in the allocated content that is a multiple of alignment. ]*/
+                    unsigned char* aligned = result->storage + ((alignment - ((uintptr_t)result->storage & (alignment - 1))) & (alignment - 1));
+                    (void)memcpy(aligned, source, size);
+                    result->alias.buffer = aligned;
+                }
+
+                /*the content lives in the same allocation as the handle, same as for CONSTBUFFER_Create*/
+                result->buffer_type = CONSTBUFFER_TYPE_COPIED;
+                (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
+
+                /*Codes_SRS_CONSTBUFFER_11_073: [ CONSTBUFFER_CreateWithAlignment shall set the ref count of the handle to 1, succeed and return it. ]*/
+                (void)interlocked_exchange(&result->count, 1);
+            }
+        }
+    }
+    return result;
+}
+
+/*a CONSTBUFFER_WRITABLE_HANDLE points to a CONSTBUFFER_HANDLE_DATA of type CONSTBUFFER_TYPE_WRITABLE. It has its own handle type so that only CONSTBUFFER_SealWritableHandle can turn it into a CONSTBUFFER_HANDLE*/
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_WRITABLE_HANDLE, CONSTBUFFER_CreateWritableHandle, uint32_t, capacity)
+{
+    CONSTBUFFER_WRITABLE_HANDLE result;
+
+    /*Codes_SRS_CONSTBUFFER_11_038: [ CONSTBUFFER_CreateWritableHandle shall allocate memory for the handle and capacity bytes of content in a single allocation. ]*/
+    CONSTBUFFER_HANDLE_DATA* handle_data = malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA), capacity, sizeof(unsigned char));
+    if (handle_data == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_039: [ If there are any failures then CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
+        LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA)=%zu, capacity=%" PRIu32 ", sizeof(unsigned char)=%zu)",
+            sizeof(CONSTBUFFER_HANDLE_DATA), capacity, sizeof(unsigned char));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_040: [ CONSTBUFFER_CreateWritableHandle shall set the size of the content to 0 and succeed and return a non-NULL value. ]*/
+        handle_data->buffer_type = CONSTBUFFER_TYPE_WRITABLE;
+        handle_data->writable_capacity = capacity;
+        handle_data->alias.buffer = NULL;
+        handle_data->alias.size = 0;
+        (void)interlocked_exchange(&handle_data->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
+        (void)interlocked_exchange(&handle_data->count, 1);
+        result = (CONSTBUFFER_WRITABLE_HANDLE)handle_data;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, unsigned char*, CONSTBUFFER_GetWritableBuffer, CONSTBUFFER_WRITABLE_HANDLE, writableHandle)
+{
+    unsigned char* result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (writableHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_041: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBuffer shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p", writableHandle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_042: [ CONSTBUFFER_GetWritableBuffer shall return the address of the capacity bytes of content of writableHandle. ]*/
+        result = writable->storage;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, uint32_t, CONSTBUFFER_GetWritableBufferCapacity, CONSTBUFFER_WRITABLE_HANDLE, writableHandle)
+{
+    uint32_t result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (writableHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_043: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBufferCapacity shall fail and return 0. ]*/
+        LogError("invalid argument CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p", writableHandle);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_044: [ CONSTBUFFER_GetWritableBufferCapacity shall return the capacity passed to CONSTBUFFER_CreateWritableHandle. ]*/
+        result = writable->writable_capacity;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, uint32_t, CONSTBUFFER_GetWritableBufferSize, CONSTBUFFER_WRITABLE_HANDLE, writableHandle)
+{
+    uint32_t result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (writableHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_045: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBufferSize shall fail and return 0. ]*/
+        LogError("invalid argument CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p", writableHandle);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_046: [ CONSTBUFFER_GetWritableBufferSize shall return the size of the content of writableHandle. ]*/
+        result = writable->alias.size;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, CONSTBUFFER_SetWritableBufferSize, CONSTBUFFER_WRITABLE_HANDLE, writableHandle, uint32_t, size)
+{
+    int result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_047: [ If writableHandle is NULL then CONSTBUFFER_SetWritableBufferSize shall fail and return a non-zero value. ]*/
+        (writableHandle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_048: [ If size is greater than the capacity of writableHandle then CONSTBUFFER_SetWritableBufferSize shall fail and return a non-zero value. ]*/
+        (size > writable->writable_capacity)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p, uint32_t size=%" PRIu32 "",
+            writableHandle, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_049: [ CONSTBUFFER_SetWritableBufferSize shall set the size of the content of writableHandle to size, succeed and return 0. ]*/
+        writable->alias.size = size;
+        result = 0;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, CONSTBUFFER_AppendToWritableBuffer, CONSTBUFFER_WRITABLE_HANDLE, writableHandle, const unsigned char*, source, uint32_t, size)
+{
+    int result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_050: [ If writableHandle is NULL then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+        (writableHandle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_051: [ If source is NULL and size is not 0 then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+        ((source == NULL) && (size != 0))
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p, const unsigned char* source=%p, uint32_t size=%" PRIu32 "",
+            writableHandle, source, size);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_CONSTBUFFER_11_052: [ If size exceeds the capacity of writableHandle that is not used by its content then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+    else if (size > writable->writable_capacity - writable->alias.size)
+    {
+        LogError("cannot append size=%" PRIu32 " bytes to content of size=%" PRIu32 " with capacity=%" PRIu32 "",
+            size, writable->alias.size, writable->writable_capacity);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_053: [ CONSTBUFFER_AppendToWritableBuffer shall copy size bytes from source after the content of writableHandle, add size to the size of the content, succeed and return 0. ]*/
+        if (size != 0)
+        {
+            (void)memcpy(writable->storage + writable->alias.size, source, size);
+            writable->alias.size += size;
+        }
+        result = 0;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_SealWritableHandle, CONSTBUFFER_WRITABLE_HANDLE, writableHandle)
+{
+    CONSTBUFFER_HANDLE result;
+    CONSTBUFFER_HANDLE_DATA* writable = (CONSTBUFFER_HANDLE_DATA*)writableHandle;
+    if (writableHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_054: [ If writableHandle is NULL then CONSTBUFFER_SealWritableHandle shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p", writableHandle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_055: [ CONSTBUFFER_SealWritableHandle shall turn writableHandle into a CONSTBUFFER_HANDLE with the content of writableHandle, without allocating memory and without copying the content. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_056: [ If the size of the content is 0 then CONSTBUFFER_SealWritableHandle shall set the buffer of the CONSTBUFFER_HANDLE to NULL. ]*/
+        writable->alias.buffer = (writable->alias.size == 0) ? NULL : writable->storage;
+        /*the storage is freed together with the handle, same as for CONSTBUFFER_Create*/
+        writable->buffer_type = CONSTBUFFER_TYPE_COPIED;
+
+        /*Codes_SRS_CONSTBUFFER_11_057: [ CONSTBUFFER_SealWritableHandle shall succeed and return the CONSTBUFFER_HANDLE. writableHandle shall not be used after this call. ]*/
+        result = writable;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_DestroyWritableHandle, CONSTBUFFER_WRITABLE_HANDLE, writableHandle)
+{
+    if (writableHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_058: [ If writableHandle is NULL then CONSTBUFFER_DestroyWritableHandle shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_WRITABLE_HANDLE writableHandle=%p", writableHandle);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_059: [ CONSTBUFFER_DestroyWritableHandle shall free the memory used by writableHandle. ]*/
+        free(writableHandle);
+    }
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_IncRef, CONSTBUFFER_HANDLE, constbufferHandle)
 {
     if (constbufferHandle == NULL)
@@ -336,7 +827,19 @@ static void CONSTBUFFER_DecRef_internal(CONSTBUFFER_HANDLE constbufferHandle)
         }
 
         /*Codes_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_DecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
-        free(constbufferHandle);
+        /*Codes_SRS_CONSTBUFFER_11_154: [ CONSTBUFFER_LARGE_DecRef shall free the header of the handle by calling free, it shall never return it to the header pool. ]*/
+        if (
+            (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_COPIED) ||
+            (constbufferHandle->is_large)
+            )
+        {
+            free(constbufferHandle);
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_013: [ If the header pool is initialized then CONSTBUFFER_DecRef shall return the headers of buffers created by CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize to the header pool. ]*/
+            CONSTBUFFER_header_free(constbufferHandle);
+        }
     }
 }
 
@@ -354,18 +857,36 @@ IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_DecRef, CONSTBUFFER_HANDLE, cons
 }
 
 
-IMPLEMENT_MOCKABLE_FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER_HANDLE, left, CONSTBUFFER_HANDLE, right)
+/*returns true and the hash if CONSTBUFFER_get_content_hash already computed it, never computes it*/
+static bool CONSTBUFFER_get_cached_content_hash(CONSTBUFFER_HANDLE handle, uint64_t* content_hash)
 {
     bool result;
-    if (left == NULL)
+    if (interlocked_add(&handle->content_hash_state, 0) != CONSTBUFFER_CONTENT_HASH_STATE_COMPUTED)
     {
-        if (right == NULL)
-        {
-            /*Codes_SRS_CONSTBUFFER_02_018: [ If left is NULL and right is NULL then CONSTBUFFER_HANDLE_contain_same shall return true. ]*/
-            result = true;
-        }
-        else
-        {
+        result = false;
+    }
+    else
+    {
+        *content_hash = (uint64_t)interlocked_add_64(&handle->content_hash, 0);
+        result = true;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER_HANDLE, left, CONSTBUFFER_HANDLE, right)
+{
+    bool result;
+    uint64_t left_hash;
+    uint64_t right_hash;
+    if (left == NULL)
+    {
+        if (right == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_02_018: [ If left is NULL and right is NULL then CONSTBUFFER_HANDLE_contain_same shall return true. ]*/
+            result = true;
+        }
+        else
+        {
             /*Codes_SRS_CONSTBUFFER_02_019: [ If left is NULL and right is not NULL then CONSTBUFFER_HANDLE_contain_same shall return false. ]*/
             result = false;
         }
@@ -384,6 +905,20 @@ IMPLEMENT_MOCKABLE_FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER
                 /*Codes_SRS_CONSTBUFFER_02_021: [ If left's size is different than right's size then CONSTBUFFER_HANDLE_contain_same shall return false. ]*/
                 result = false;
             }
+            else if (left == right)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_060: [ If left and right are the same handle then CONSTBUFFER_HANDLE_contain_same shall return true without comparing the bytes. ]*/
+                result = true;
+            }
+            else if (
+                CONSTBUFFER_get_cached_content_hash(left, &left_hash) &&
+                CONSTBUFFER_get_cached_content_hash(right, &right_hash) &&
+                (left_hash != right_hash)
+                )
+            {
+                /*Codes_SRS_CONSTBUFFER_11_061: [ If the content hashes of both left and right have already been computed by CONSTBUFFER_get_content_hash and they are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+                result = false;
+            }
             else
             {
                 if (memcmp(left->alias.buffer, right->alias.buffer, left->alias.size) != 0)
@@ -402,93 +937,175 @@ IMPLEMENT_MOCKABLE_FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER
     return result;
 }
 
-uint32_t CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source)
+IMPLEMENT_MOCKABLE_FUNCTION(, int, CONSTBUFFER_get_content_hash, CONSTBUFFER_HANDLE, source, uint64_t*, content_hash)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_062: [ If source is NULL then CONSTBUFFER_get_content_hash shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_063: [ If content_hash is NULL then CONSTBUFFER_get_content_hash shall fail and return a non-zero value. ]*/
+        (content_hash == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, uint64_t* content_hash=%p", source, content_hash);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (!CONSTBUFFER_get_cached_content_hash(source, content_hash))
+        {
+            /*Codes_SRS_CONSTBUFFER_11_064: [ If the content hash of source has not been computed yet then CONSTBUFFER_get_content_hash shall compute it by calling xxhash64 with the content of source and seed 0 and store it in source. ]*/
+            /*threads racing here compute the same value, so whichever store lands last is still right*/
+            *content_hash = xxhash64(source->alias.buffer, source->alias.size, 0);
+            (void)interlocked_exchange_64(&source->content_hash, (int64_t)*content_hash);
+            (void)interlocked_exchange(&source->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_COMPUTED);
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_065: [ Otherwise CONSTBUFFER_get_content_hash shall use the content hash stored in source. ]*/
+        }
+
+        /*Codes_SRS_CONSTBUFFER_11_066: [ CONSTBUFFER_get_content_hash shall write the content hash in content_hash, succeed and return 0. ]*/
+        result = 0;
+    }
+    return result;
+}
+
+/*the serialization is a header (version and size for version 1, version, size and CRC32C for version 2) followed by the content*/
+static uint32_t CONSTBUFFER_get_serialization_header_size(uint8_t version)
+{
+    return (version == CONSTBUFFER_VERSION_V1) ? (uint32_t)CONSTBUFFER_CONTENT_OFFSET : (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET;
+}
+
+static uint32_t CONSTBUFFER_get_serialization_size_internal(CONSTBUFFER_HANDLE source, uint8_t version)
 {
     uint32_t result;
     /*Codes_SRS_CONSTBUFFER_02_041: [ If source is NULL then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+    /*Codes_SRS_CONSTBUFFER_11_135: [ If source is NULL then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
     if (source == NULL)
     {
-        LogError("invalid argument CONSTBUFFER_HANDLE source=%p", source);
+        LogError("invalid argument CONSTBUFFER_HANDLE source=%p, uint8_t version=%" PRIu8 "", source, version);
         result = 0;
     }
     else
     {
+        uint32_t header_size = CONSTBUFFER_get_serialization_header_size(version);
         /*Codes_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-        if (source->alias.size > UINT32_MAX - CONSTBUFFER_VERSION_SIZE - CONSTBUFFER_SIZE_SIZE)
+        /*Codes_SRS_CONSTBUFFER_11_136: [ If sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+        if (source->alias.size > UINT32_MAX - header_size)
         {
-            LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". It is the sum of sizeof(uint8_t)=%zu + sizeof(uint32_t)=%zu + source->alias.size=%" PRIu32 "",
-                UINT32_MAX, CONSTBUFFER_VERSION_SIZE, CONSTBUFFER_SIZE_SIZE, source->alias.size);
+            LogError("version %" PRIu8 " serialization size exceeds UINT32_MAX=%" PRIu32 ". It is the sum of the header size=%" PRIu32 " + source->alias.size=%" PRIu32 "",
+                version, UINT32_MAX, header_size, source->alias.size);
             result = 0;
         }
         else
         {
             /*Codes_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
-            result = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + (uint32_t)source->alias.size;
+            /*Codes_SRS_CONSTBUFFER_11_137: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size. ]*/
+            result = header_size + source->alias.size;
         }
     }
     return result;
 }
 
+uint32_t CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source)
+{
+    return CONSTBUFFER_get_serialization_size_internal(source, CONSTBUFFER_VERSION_V1);
+}
+
+uint32_t CONSTBUFFER_get_serialization_size_v2(CONSTBUFFER_HANDLE source)
+{
+    return CONSTBUFFER_get_serialization_size_internal(source, CONSTBUFFER_VERSION_V2);
+}
+
+/*writes the serialization of content in the given version at destination, which has room for all of it*/
+static void CONSTBUFFER_write_serialization(unsigned char* destination, uint8_t version, const CONSTBUFFER* content)
+{
+    /*Codes_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
+    /*Codes_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
+    write_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, version);
+
+    /*Codes_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+    /*Codes_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+    write_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, content->size);
+
+    if (version == CONSTBUFFER_VERSION_V2)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_032: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_033: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+        write_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, crc32c_update(0, content->buffer, content->size));
+    }
+
+    /*Codes_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
+    /*Codes_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
+    /*Codes_SRS_CONSTBUFFER_11_143: [ CONSTBUFFER_to_buffer_v2 shall write starting at offset 9 of the allocated memory the bytes of source->alias.buffer. ]*/
+    /*Codes_SRS_CONSTBUFFER_11_151: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall copy all the bytes of source->alias.buffer in destination starting at offset 9. ]*/
+    (void)memcpy(destination + CONSTBUFFER_get_serialization_header_size(version), content->buffer, content->size);
+}
+
 static void* calls_malloc(size_t size, void* context)
 {
     (void)context;
     return malloc(size); /*in all the contexts where this is called, it is verified that the size is 0..UINT32_MAX, which is a subset of 0..SIZE_MAX*/
 }
 
-unsigned char* CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size)
+static unsigned char* CONSTBUFFER_to_buffer_internal(CONSTBUFFER_HANDLE source, uint8_t version, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size)
 {
     unsigned char* result;
     if (
         /*Codes_SRS_CONSTBUFFER_02_044: [ If source is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_138: [ If source is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
         (source == NULL) ||
         /*Codes_SRS_CONSTBUFFER_02_045: [ If serialized_size is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_139: [ If serialized_size is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
         (serialized_size == NULL)
         )
     {
-        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, CONSTBUFFER_to_buffer_alloc alloc=%p, uint32_t* serialized_size=%p",
-            source, alloc, serialized_size);
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, uint8_t version=%" PRIu8 ", CONSTBUFFER_to_buffer_alloc alloc=%p, uint32_t* serialized_size=%p",
+            source, version, alloc, serialized_size);
         result = NULL;
     }
     else
     {
+        uint32_t header_size = CONSTBUFFER_get_serialization_header_size(version);
+
         /*Codes_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_140: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
         if (alloc == NULL)
         {
             alloc = &calls_malloc;
         }
 
         /*Codes_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-        if (UINT32_MAX - CONSTBUFFER_VERSION_SIZE - CONSTBUFFER_SIZE_SIZE < source->alias.size)
+        /*Codes_SRS_CONSTBUFFER_11_145: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+        if (UINT32_MAX - header_size < source->alias.size)
         {
             /*overflow*/
-            LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". Serialization size is the sum of sizeof(uint8_t)=%zu + sizeof(uint32_t)=%zu + source->alias.size=%" PRIu32 "",
-                UINT32_MAX, CONSTBUFFER_VERSION_SIZE, CONSTBUFFER_SIZE_SIZE, source->alias.size);
+            LogError("version %" PRIu8 " serialization size exceeds UINT32_MAX=%" PRIu32 ". Serialization size is the sum of the header size=%" PRIu32 " + source->alias.size=%" PRIu32 "",
+                version, UINT32_MAX, header_size, source->alias.size);
             result = NULL;
         }
         else
         {
             /*Codes_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
-            result = alloc(CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + source->alias.size, alloc_context);
+            /*Codes_SRS_CONSTBUFFER_11_141: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+            result = alloc(header_size + source->alias.size, alloc_context);
             if (result == NULL)
             {
                 /*Codes_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-                LogError("failure in alloc=%p, (sizeof(uint8_t)=%zu + sizeof(uint32_t)=%zu + source->alias.size=%" PRIu32 " alloc_context=%p);",
-                    alloc, CONSTBUFFER_VERSION_SIZE, CONSTBUFFER_SIZE_SIZE, source->alias.size, alloc_context);
+                /*Codes_SRS_CONSTBUFFER_11_145: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+                LogError("failure in alloc=%p, (header_size=%" PRIu32 " + source->alias.size=%" PRIu32 " alloc_context=%p);",
+                    alloc, header_size, source->alias.size, alloc_context);
                 /*return as is*/
             }
             else
             {
-                /*Codes_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
-                write_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V1);
-
-                /*Codes_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
-                write_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, (uint32_t)source->alias.size);
-                
-                /*Codes_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
-                (void)memcpy(result + CONSTBUFFER_CONTENT_OFFSET, source->alias.buffer, source->alias.size);
+                /*Codes_SRS_CONSTBUFFER_11_142: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2) and at offsets 1-4 the value of source->alias.size in network byte order. ]*/
+                CONSTBUFFER_write_serialization(result, version, &source->alias);
 
                 /*Codes_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
-                *serialized_size = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + (uint32_t)source->alias.size;
+                /*Codes_SRS_CONSTBUFFER_11_144: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+                *serialized_size = header_size + source->alias.size;
                 /*return as is*/
             }
         }
@@ -496,37 +1113,53 @@ unsigned char* CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_b
     return result;
 }
 
-CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
+unsigned char* CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size)
+{
+    return CONSTBUFFER_to_buffer_internal(source, CONSTBUFFER_VERSION_V1, alloc, alloc_context, serialized_size);
+}
+
+unsigned char* CONSTBUFFER_to_buffer_v2(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size)
+{
+    return CONSTBUFFER_to_buffer_internal(source, CONSTBUFFER_VERSION_V2, alloc, alloc_context, serialized_size);
+}
+
+static CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer_internal(CONSTBUFFER_HANDLE source, uint8_t version, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
 {
     CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
-    
+
     if (
         /*Codes_SRS_CONSTBUFFER_02_055: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_146: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
         (source == NULL) ||
         /*Codes_SRS_CONSTBUFFER_02_056: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_147: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
         (destination == NULL) ||
         /*Codes_SRS_CONSTBUFFER_02_057: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_148: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
         (serialized_size == NULL)
         )
     {
-        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, unsigned char* destination=%p, uint32_t destination_size=%" PRIu32 ", uint32_t* serialized_size=%p",
-            source, destination, destination_size, serialized_size);
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, uint8_t version=%" PRIu8 ", unsigned char* destination=%p, uint32_t destination_size=%" PRIu32 ", uint32_t* serialized_size=%p",
+            source, version, destination, destination_size, serialized_size);
         result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG;
     }
     else
     {
-        if (UINT32_MAX - (CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE) < source->alias.size)
+        uint32_t header_size = CONSTBUFFER_get_serialization_header_size(version);
+        if (UINT32_MAX - header_size < source->alias.size)
         {
             /*when this is true, an output for "serialized_size" cannot be provided as the complete serialization would exceed UINT32_MAX*/
             LogError("overflow in computation of output parameter serialized_size");
 
             /*Codes_SRS_CONSTBUFFER_02_074: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+            /*Codes_SRS_CONSTBUFFER_11_153: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
             result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR;
         }
         else
         {
-            *serialized_size = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + (uint32_t)source->alias.size;
+            *serialized_size = header_size + source->alias.size;
             /*Codes_SRS_CONSTBUFFER_02_058: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+            /*Codes_SRS_CONSTBUFFER_11_149: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
             if (destination_size < *serialized_size)
             {
                 LogError("destination=%p does not contain enough bytes for the complete serialization. It only has %" PRIu32 " bytes and there are needed %" PRIu32 " bytes", destination, destination_size, *serialized_size);
@@ -534,16 +1167,11 @@ CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBU
             }
             else
             {
-                /*Codes_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
-                write_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V1);
-
-                /*Codes_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
-                write_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, (uint32_t)source->alias.size);
-
-                /*Codes_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
-                (void)memcpy(destination + CONSTBUFFER_CONTENT_OFFSET, source->alias.buffer, source->alias.size);
+                /*Codes_SRS_CONSTBUFFER_11_150: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2) and at offset 1 the value of source->alias.size in network byte order. ]*/
+                CONSTBUFFER_write_serialization(destination, version, &source->alias);
 
                 /*Codes_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+                /*Codes_SRS_CONSTBUFFER_11_152: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
                 result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK;
             }
         }
@@ -551,6 +1179,142 @@ CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBU
     return result;
 }
 
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
+{
+    return CONSTBUFFER_to_fixed_size_buffer_internal(source, CONSTBUFFER_VERSION_V1, destination, destination_size, serialized_size);
+}
+
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer_v2(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
+{
+    return CONSTBUFFER_to_fixed_size_buffer_internal(source, CONSTBUFFER_VERSION_V2, destination, destination_size, serialized_size);
+}
+
+int CONSTBUFFER_to_segments(CONSTBUFFER_HANDLE source, unsigned char* header, CONSTBUFFER* segments, uint32_t* segment_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_014: [ If source is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_015: [ If header is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+        (header == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_016: [ If segments is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+        (segments == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_017: [ If segment_count is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+        (segment_count == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, unsigned char* header=%p, CONSTBUFFER* segments=%p, uint32_t* segment_count=%p",
+            source, header, segments, segment_count);
+        result = MU_FAILURE;
+    }
+    else if (UINT32_MAX - CONSTBUFFER_CONTENT_OFFSET < source->alias.size)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_018: [ If the size of the serialization exceeds UINT32_MAX then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+        LogError("serialization of source->alias.size=%" PRIu32 " bytes would exceed UINT32_MAX", source->alias.size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_019: [ CONSTBUFFER_to_segments shall write in header the version of serialization (currently 1) followed by the value of source->alias.size in network byte order. ]*/
+        write_uint8_t(header + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V1);
+        write_uint32_t(header + CONSTBUFFER_SIZE_OFFSET, source->alias.size);
+
+        /*Codes_SRS_CONSTBUFFER_11_020: [ CONSTBUFFER_to_segments shall set the first segment to header and CONSTBUFFER_SEGMENTS_HEADER_SIZE bytes. ]*/
+        segments[0].buffer = header;
+        segments[0].size = CONSTBUFFER_CONTENT_OFFSET;
+
+        if (source->alias.size == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_021: [ If the size of source is 0 then CONSTBUFFER_to_segments shall set segment_count to 1. ]*/
+            *segment_count = 1;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_022: [ Otherwise CONSTBUFFER_to_segments shall set the second segment to source->alias.buffer and source->alias.size bytes, without copying them, and set segment_count to 2. ]*/
+            segments[1] = source->alias;
+            *segment_count = 2;
+        }
+
+        /*Codes_SRS_CONSTBUFFER_11_023: [ CONSTBUFFER_to_segments shall succeed and return 0. ]*/
+        result = 0;
+    }
+    return result;
+}
+
+/*validates the version, the size and (for version 2) the CRC32C at source and returns where the content starts and how many bytes it has*/
+static CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_read_serialization_header(const unsigned char* source, uint32_t size, uint32_t* content_offset, uint32_t* content_size)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    if (size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        LogError("cannot deserialize from size=%" PRIu32 "", size);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        uint8_t version;
+        read_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, &version);
+        if (
+            (version != CONSTBUFFER_VERSION_V1) &&
+            (version != CONSTBUFFER_VERSION_V2)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 or 2 (the known versions) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            LogError("different version (%" PRIu8 ") detected. This module only knows about versions %" PRIu8 " and %" PRIu8 "", version, CONSTBUFFER_VERSION_V1, CONSTBUFFER_VERSION_V2);
+            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else
+        {
+            *content_offset = (version == CONSTBUFFER_VERSION_V1) ? (uint32_t)CONSTBUFFER_CONTENT_OFFSET : (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET;
+
+            if (size < *content_offset)
+            {
+                /*Codes_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                /*Codes_SRS_CONSTBUFFER_11_034: [ If the version is 2 and source's size is less than sizeof(uint8_t) + 2 * sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("cannot deserialize when the numbe of serialized bytes cannot be determined. size=%" PRIu32 ", version=%" PRIu8 "", size, version);
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+                read_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, content_size);
+                if (size - *content_offset < *content_size)
+                {
+                    /*Codes_SRS_CONSTBUFFER_02_070: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                    /*Codes_SRS_CONSTBUFFER_11_035: [ If the version is 2 and source's size is less than sizeof(uint8_t) + 2 * sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                    LogError("in the buffer at source=%p of size=%" PRIu32 " there are not enough bytes remaining after the header of version=%" PRIu8 " to construct content from. Serialized content size was computed as %" PRIu32 " but there are only %" PRIu32 " bytes available",
+                        source, size, version, *content_size, size - *content_offset);
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                }
+                else if (version == CONSTBUFFER_VERSION_V1)
+                {
+                    /*version 1 has no integrity check*/
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                    uint32_t serialized_crc;
+                    read_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, &serialized_crc);
+                    uint32_t computed_crc = crc32c_update(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, *content_size);
+                    if (computed_crc != serialized_crc)
+                    {
+                        LogError("the content at source=%p of %" PRIu32 " bytes is corrupted: its CRC32C is 0x%08" PRIx32 " but the serialization says 0x%08" PRIx32 "",
+                            source, *content_size, computed_crc, serialized_crc);
+                        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                    }
+                    else
+                    {
+                        result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
 CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* source, uint32_t size, uint32_t* consumed, CONSTBUFFER_HANDLE* destination)
 {
     CONSTBUFFER_FROM_BUFFER_RESULT result;
@@ -569,60 +1333,513 @@ CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* sour
     }
     else
     {
-        if (size == 0)
+        uint32_t content_offset;
+        uint32_t content_size;
+        result = CONSTBUFFER_read_serialization_header(source, size, &content_offset, &content_size);
+        if (result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+        {
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+            *destination = CONSTBUFFER_Create_Internal(source + content_offset, content_size);
+            if (*destination == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                LogError("failure in CONSTBUFFER_Create(source=%p + content_offset=%" PRIu32 ", content_size=%" PRIu32 ")",
+                    source, content_offset, content_size);
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                *consumed = content_offset + content_size;
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+            }
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer_no_copy(CONSTBUFFER_HANDLE parent, uint32_t offset, uint32_t* consumed, CONSTBUFFER_HANDLE* destination)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_024: [ If parent is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (parent == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_025: [ If consumed is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (consumed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_026: [ If destination is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_027: [ If offset is greater than or equal to the size of parent then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (offset >= parent->alias.size)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE parent=%p, uint32_t offset=%" PRIu32 ", uint32_t* consumed=%p, CONSTBUFFER_HANDLE* destination=%p",
+            parent, offset, consumed, destination);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_028: [ CONSTBUFFER_from_buffer_no_copy shall validate the version, the size and (for version 2) the CRC32C of the serialization starting at offset in parent the same way as CONSTBUFFER_from_buffer does and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA if they are not valid. ]*/
+        uint32_t content_offset;
+        uint32_t content_size;
+        result = CONSTBUFFER_read_serialization_header(parent->alias.buffer + offset, parent->alias.size - offset, &content_offset, &content_size);
+        if (result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+        {
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_029: [ CONSTBUFFER_from_buffer_no_copy shall create the CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateFromOffsetAndSize with parent, offset + the offset of the content (5 for version 1, 9 for version 2) and the number of content bytes. ]*/
+            *destination = CONSTBUFFER_CreateFromOffsetAndSize(parent, offset + content_offset, content_size);
+            if (*destination == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_030: [ If there are any failures then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                LogError("failure in CONSTBUFFER_CreateFromOffsetAndSize(parent=%p, offset=%" PRIu32 " + content_offset=%" PRIu32 ", content_size=%" PRIu32 ")",
+                    parent, offset, content_offset, content_size);
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_11_031: [ CONSTBUFFER_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                *consumed = content_offset + content_size;
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+            }
+        }
+    }
+    return result;
+}
+
+/*a CONSTBUFFER_LARGE_HANDLE points to a CONSTBUFFER_HANDLE_DATA that has its CONSTBUFFER_LARGE at the start of storage (followed by the content when it is copied)*/
+/*it has its own handle type so that it cannot be given to the CONSTBUFFER_HANDLE APIs*/
+static CONSTBUFFER_HANDLE_DATA* CONSTBUFFER_LARGE_get_header(CONSTBUFFER_LARGE_HANDLE handle)
+{
+    return (CONSTBUFFER_HANDLE_DATA*)handle;
+}
+
+/*alias.buffer of the header is the same as the CONSTBUFFER_LARGE's buffer (CONSTBUFFER_DecRef_internal frees it for moved memory) and alias.size is 0*/
+static CONSTBUFFER_LARGE* CONSTBUFFER_LARGE_get_alias(CONSTBUFFER_LARGE_HANDLE handle)
+{
+    return (CONSTBUFFER_LARGE*)(void*)CONSTBUFFER_LARGE_get_header(handle)->storage;
+}
+
+/*allocates the handle, its CONSTBUFFER_LARGE and copied_size bytes of storage in a single allocation*/
+static CONSTBUFFER_LARGE_HANDLE CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE buffer_type, const unsigned char* buffer, uint64_t size, uint64_t copied_size)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+    if (copied_size > SIZE_MAX - sizeof(CONSTBUFFER_LARGE))
+    {
+        LogError("cannot allocate sizeof(CONSTBUFFER_LARGE)=%zu + copied_size=%" PRIu64 " bytes of storage", sizeof(CONSTBUFFER_LARGE), copied_size);
+        result = NULL;
+    }
+    else
+    {
+        CONSTBUFFER_HANDLE_DATA* header = malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA), sizeof(CONSTBUFFER_LARGE) + (size_t)copied_size, sizeof(unsigned char));
+        if (header == NULL)
+        {
+            LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_DATA)=%zu, sizeof(CONSTBUFFER_LARGE)=%zu + copied_size=%" PRIu64 ", sizeof(unsigned char)=%zu)",
+                sizeof(CONSTBUFFER_HANDLE_DATA), sizeof(CONSTBUFFER_LARGE), copied_size, sizeof(unsigned char));
+            result = NULL;
+        }
+        else
+        {
+            result = (CONSTBUFFER_LARGE_HANDLE)header;
+            CONSTBUFFER_LARGE* large_alias = CONSTBUFFER_LARGE_get_alias(result);
+            large_alias->buffer = buffer;
+            large_alias->size = size;
+            header->alias.buffer = buffer;
+            header->alias.size = 0;
+            header->buffer_type = buffer_type;
+            header->is_large = true;
+            (void)interlocked_exchange(&header->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
+            (void)interlocked_exchange(&header->count, 1);
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_Create, const unsigned char*, source, uint64_t, size)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+
+    if ((source == NULL) && (size != 0))
+    {
+        /*Codes_SRS_CONSTBUFFER_11_074: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_Create shall fail and return NULL. ]*/
+        LogError("invalid arguments const unsigned char* source=%p, uint64_t size=%" PRIu64 "", source, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_075: [ CONSTBUFFER_LARGE_Create shall allocate memory for the handle, its CONSTBUFFER_LARGE and size bytes of content in a single allocation. ]*/
+        result = CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_COPIED, NULL, size, size);
+        if (result == NULL)
         {
-            /*Codes_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-            LogError("cannot deserialize from size=%" PRIu32 "", size);
-            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+            /*Codes_SRS_CONSTBUFFER_11_078: [ If there are any failures then CONSTBUFFER_LARGE_Create shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_COPIED, NULL, size=%" PRIu64 ", size=%" PRIu64 ")", size, size);
+            /*return as is*/
         }
         else
         {
-            uint8_t version;
-            read_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, &version);
-            if (version != CONSTBUFFER_VERSION_V1)
+            /*Codes_SRS_CONSTBUFFER_11_077: [ If size is 0 then CONSTBUFFER_LARGE_Create shall set the buffer of the content to NULL. ]*/
+            if (size != 0)
             {
-                /*Codes_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 (current version) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                LogError("different version (%" PRIu8 ") detected. This module only knows about version %" PRIu8 "", version, CONSTBUFFER_VERSION_V1);
+                /*Codes_SRS_CONSTBUFFER_11_076: [ CONSTBUFFER_LARGE_Create shall copy the size bytes of source in the allocated content, set the ref count of the handle to 1 and return it. ]*/
+                CONSTBUFFER_HANDLE_DATA* header = CONSTBUFFER_LARGE_get_header(result);
+                unsigned char* content = header->storage + sizeof(CONSTBUFFER_LARGE);
+                (void)memcpy(content, source, (size_t)size);
+                CONSTBUFFER_LARGE_get_alias(result)->buffer = content;
+                header->alias.buffer = content;
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateWithMoveMemory, unsigned char*, source, uint64_t, size)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+
+    if ((source == NULL) && (size != 0))
+    {
+        /*Codes_SRS_CONSTBUFFER_11_079: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_CreateWithMoveMemory shall fail and return NULL. ]*/
+        LogError("invalid arguments unsigned char* source=%p, uint64_t size=%" PRIu64 "", source, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_080: [ CONSTBUFFER_LARGE_CreateWithMoveMemory shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+        /*Codes_SRS_CONSTBUFFER_11_081: [ CONSTBUFFER_LARGE_CreateWithMoveMemory shall store source and size, take the ownership of source (it is freed with free when the handle is destroyed), set the ref count of the handle to 1 and return it. ]*/
+        result = CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_MEMORY_MOVED, source, size, 0);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_082: [ If there are any failures then CONSTBUFFER_LARGE_CreateWithMoveMemory shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_MEMORY_MOVED, source=%p, size=%" PRIu64 ", 0)", source, size);
+            /*return as is*/
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateWithCustomFree, const unsigned char*, source, uint64_t, size, CONSTBUFFER_CUSTOM_FREE_FUNC, customFreeFunc, void*, customFreeFuncContext)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_083: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+        ((source == NULL) && (size != 0)) ||
+        /*Codes_SRS_CONSTBUFFER_11_084: [ If customFreeFunc is NULL then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+        (customFreeFunc == NULL)
+        )
+    {
+        LogError("invalid arguments const unsigned char* source=%p, uint64_t size=%" PRIu64 ", CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc=%p, void* customFreeFuncContext=%p",
+            source, size, customFreeFunc, customFreeFuncContext);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_085: [ CONSTBUFFER_LARGE_CreateWithCustomFree shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+        result = CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, source, size, 0);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_087: [ If there are any failures then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, source=%p, size=%" PRIu64 ", 0)", source, size);
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_086: [ CONSTBUFFER_LARGE_CreateWithCustomFree shall store source, size, customFreeFunc and customFreeFuncContext (customFreeFunc is called with customFreeFuncContext when the handle is destroyed), set the ref count of the handle to 1 and return it. ]*/
+            CONSTBUFFER_HANDLE_DATA* header = CONSTBUFFER_LARGE_get_header(result);
+            header->custom_free_func = customFreeFunc;
+            header->custom_free_func_context = customFreeFuncContext;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, CONSTBUFFER_LARGE_CreateFromOffsetAndSize, CONSTBUFFER_LARGE_HANDLE, handle, uint64_t, offset, uint64_t, size)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_088: [ If handle is NULL then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_089: [ If offset is greater than the size of handle then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+        (offset > CONSTBUFFER_LARGE_get_alias(handle)->size) ||
+        /*Codes_SRS_CONSTBUFFER_11_090: [ If offset + size exceed the size of handle then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+        (size > CONSTBUFFER_LARGE_get_alias(handle)->size - offset)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_LARGE_HANDLE handle=%p, uint64_t offset=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            handle, offset, size);
+        result = NULL;
+    }
+    else
+    {
+        const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_get_alias(handle);
+
+        /*Codes_SRS_CONSTBUFFER_11_091: [ CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+        result = CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE, content->buffer + offset, size, 0);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_093: [ If there are any failures then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_LARGE_header_alloc(CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE, content->buffer=%p + offset=%" PRIu64 ", size=%" PRIu64 ", 0)",
+                content->buffer, offset, size);
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_092: [ CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall set the content to the size bytes of handle starting at offset, keep alive the original handle the same way CONSTBUFFER_CreateFromOffsetAndSize does, set the ref count of the new handle to 1 and return it. ]*/
+            CONSTBUFFER_reference_original_handle(CONSTBUFFER_LARGE_get_header(result), CONSTBUFFER_LARGE_get_header(handle));
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromLargeOffsetAndSize, CONSTBUFFER_LARGE_HANDLE, handle, uint64_t, offset, uint32_t, size)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_094: [ If handle is NULL then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_095: [ If offset is greater than the size of handle then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+        (offset > CONSTBUFFER_LARGE_get_alias(handle)->size) ||
+        /*Codes_SRS_CONSTBUFFER_11_096: [ If offset + size exceed the size of handle then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+        (size > CONSTBUFFER_LARGE_get_alias(handle)->size - offset)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_LARGE_HANDLE handle=%p, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 "",
+            handle, offset, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_097: [ CONSTBUFFER_CreateFromLargeOffsetAndSize shall allocate the header of a CONSTBUFFER_HANDLE the same way CONSTBUFFER_CreateFromOffsetAndSize does. ]*/
+        result = CONSTBUFFER_header_alloc();
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_099: [ If there are any failures then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_header_alloc()");
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_098: [ CONSTBUFFER_CreateFromLargeOffsetAndSize shall set the content to the size bytes of handle starting at offset, keep alive the original handle the same way CONSTBUFFER_CreateFromOffsetAndSize does, set the ref count of the new handle to 1 and return it. ]*/
+            result->buffer_type = CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE;
+            result->alias.buffer = CONSTBUFFER_LARGE_get_alias(handle)->buffer + offset;
+            result->alias.size = size;
+            (void)interlocked_exchange(&result->content_hash_state, CONSTBUFFER_CONTENT_HASH_STATE_NOT_COMPUTED);
+
+            CONSTBUFFER_reference_original_handle(result, CONSTBUFFER_LARGE_get_header(handle));
+
+            (void)interlocked_exchange(&result->count, 1);
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_LARGE_IncRef, CONSTBUFFER_LARGE_HANDLE, constbufferHandle)
+{
+    if (constbufferHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_100: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_IncRef shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_LARGE_HANDLE constbufferHandle=%p", constbufferHandle);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_101: [ Otherwise CONSTBUFFER_LARGE_IncRef shall increment the reference count. ]*/
+        (void)interlocked_increment(&CONSTBUFFER_LARGE_get_header(constbufferHandle)->count);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, CONSTBUFFER_LARGE_DecRef, CONSTBUFFER_LARGE_HANDLE, constbufferHandle)
+{
+    if (constbufferHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_102: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_DecRef shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_LARGE_HANDLE constbufferHandle=%p", constbufferHandle);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_103: [ Otherwise CONSTBUFFER_LARGE_DecRef shall decrement the reference count and when it reaches 0 free the resources the same way CONSTBUFFER_DecRef does. ]*/
+        CONSTBUFFER_DecRef_internal(CONSTBUFFER_LARGE_get_header(constbufferHandle));
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, const CONSTBUFFER_LARGE*, CONSTBUFFER_LARGE_GetContent, CONSTBUFFER_LARGE_HANDLE, constbufferHandle)
+{
+    const CONSTBUFFER_LARGE* result;
+    if (constbufferHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_104: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_GetContent shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_LARGE_HANDLE constbufferHandle=%p", constbufferHandle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_11_105: [ Otherwise CONSTBUFFER_LARGE_GetContent shall return the buffer and the 64 bit size of the content of constbufferHandle. ]*/
+        result = CONSTBUFFER_LARGE_get_alias(constbufferHandle);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, uint64_t, CONSTBUFFER_LARGE_get_serialization_size, CONSTBUFFER_LARGE_HANDLE, source)
+{
+    uint64_t result;
+    if (source == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_11_106: [ If source is NULL then CONSTBUFFER_LARGE_get_serialization_size shall fail and return 0. ]*/
+        LogError("invalid argument CONSTBUFFER_LARGE_HANDLE source=%p", source);
+        result = 0;
+    }
+    else
+    {
+        uint64_t size = CONSTBUFFER_LARGE_get_alias(source)->size;
+        if (size > UINT64_MAX - CONSTBUFFER_V3_CONTENT_OFFSET)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_107: [ If sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + source's size exceed UINT64_MAX then CONSTBUFFER_LARGE_get_serialization_size shall fail and return 0. ]*/
+            LogError("serialization size exceeds UINT64_MAX. It is the sum of CONSTBUFFER_V3_CONTENT_OFFSET=%zu + size=%" PRIu64 "", CONSTBUFFER_V3_CONTENT_OFFSET, size);
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_11_108: [ Otherwise CONSTBUFFER_LARGE_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + source's size. ]*/
+            result = CONSTBUFFER_V3_CONTENT_OFFSET + size;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_LARGE_to_fixed_size_buffer, CONSTBUFFER_LARGE_HANDLE, source, unsigned char*, destination, uint64_t, destination_size, uint64_t*, serialized_size)
+{
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_109: [ If source is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_110: [ If destination is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_111: [ If serialized_size is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (serialized_size == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_LARGE_HANDLE source=%p, unsigned char* destination=%p, uint64_t destination_size=%" PRIu64 ", uint64_t* serialized_size=%p",
+            source, destination, destination_size, serialized_size);
+        result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_get_alias(source);
+        if (content->size > UINT64_MAX - CONSTBUFFER_V3_CONTENT_OFFSET)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_112: [ If the size of the serialization exceeds UINT64_MAX then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+            LogError("overflow in computation of output parameter serialized_size");
+            result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR;
+        }
+        else
+        {
+            *serialized_size = CONSTBUFFER_V3_CONTENT_OFFSET + content->size;
+            if (destination_size < *serialized_size)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_113: [ If the size of the serialization exceeds destination_size then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+                LogError("destination=%p does not contain enough bytes for the complete serialization. It only has %" PRIu64 " bytes and there are needed %" PRIu64 " bytes", destination, destination_size, *serialized_size);
+                result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_11_114: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (3). ]*/
+                write_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V3);
+
+                /*Codes_SRS_CONSTBUFFER_11_115: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offsets 1-8 of destination the size of the content of source in network byte order. ]*/
+                write_uint64_t(destination + CONSTBUFFER_SIZE_OFFSET, content->size);
+
+                /*Codes_SRS_CONSTBUFFER_11_116: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offsets 9-12 of destination the CRC32C of the content of source, computed by calling crc32c_update, in network byte order. ]*/
+                write_uint32_t(destination + CONSTBUFFER_V3_CRC32C_OFFSET, crc32c_update(0, content->buffer, (size_t)content->size));
+
+                /*Codes_SRS_CONSTBUFFER_11_117: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall copy the content of source in destination starting at offset 13. ]*/
+                (void)memcpy(destination + CONSTBUFFER_V3_CONTENT_OFFSET, content->buffer, (size_t)content->size);
+
+                /*Codes_SRS_CONSTBUFFER_11_118: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+                result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK;
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_LARGE_from_buffer_no_copy, CONSTBUFFER_LARGE_HANDLE, parent, uint64_t, offset, uint64_t*, consumed, CONSTBUFFER_LARGE_HANDLE*, destination)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_11_119: [ If parent is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (parent == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_120: [ If consumed is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (consumed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_121: [ If destination is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_11_122: [ If offset is greater than or equal to the size of parent then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (offset >= CONSTBUFFER_LARGE_get_alias(parent)->size)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_LARGE_HANDLE parent=%p, uint64_t offset=%" PRIu64 ", uint64_t* consumed=%p, CONSTBUFFER_LARGE_HANDLE* destination=%p",
+            parent, offset, consumed, destination);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        const unsigned char* source = CONSTBUFFER_LARGE_get_alias(parent)->buffer + offset;
+        uint64_t size = CONSTBUFFER_LARGE_get_alias(parent)->size - offset;
+        uint8_t version;
+        uint64_t content_size;
+
+        if (size < CONSTBUFFER_V3_CONTENT_OFFSET)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_123: [ If there are less than sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) bytes in parent after offset then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            LogError("cannot deserialize a version %" PRIu8 " header from the %" PRIu64 " bytes after offset=%" PRIu64 "", CONSTBUFFER_VERSION_V3, size, offset);
+            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else if (read_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, &version), version != CONSTBUFFER_VERSION_V3)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_124: [ If the byte at offset in parent is not 3 then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            LogError("different version (%" PRIu8 ") detected. CONSTBUFFER_LARGE only knows about version %" PRIu8 "", version, CONSTBUFFER_VERSION_V3);
+            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else if (read_uint64_t(source + CONSTBUFFER_SIZE_OFFSET, &content_size), content_size > size - CONSTBUFFER_V3_CONTENT_OFFSET)
+        {
+            /*Codes_SRS_CONSTBUFFER_11_125: [ If the size read from offset + 1 in parent exceeds the bytes that follow the header then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            LogError("serialized content size is %" PRIu64 " but there are only %" PRIu64 " bytes after the header", content_size, size - CONSTBUFFER_V3_CONTENT_OFFSET);
+            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else
+        {
+            uint32_t serialized_crc;
+            read_uint32_t(source + CONSTBUFFER_V3_CRC32C_OFFSET, &serialized_crc);
+            uint32_t computed_crc = crc32c_update(0, source + CONSTBUFFER_V3_CONTENT_OFFSET, (size_t)content_size);
+            if (computed_crc != serialized_crc)
+            {
+                /*Codes_SRS_CONSTBUFFER_11_126: [ If the CRC32C of the content (computed by calling crc32c_update) is different than the CRC32C read from offset + 9 in parent then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("the content at source=%p of %" PRIu64 " bytes is corrupted: its CRC32C is 0x%08" PRIx32 " but the serialization says 0x%08" PRIx32 "",
+                    source, content_size, computed_crc, serialized_crc);
                 result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
             }
             else
             {
-                /*Codes_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                if (size < CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE)
+                /*Codes_SRS_CONSTBUFFER_11_127: [ CONSTBUFFER_LARGE_from_buffer_no_copy shall create the CONSTBUFFER_LARGE_HANDLE by calling CONSTBUFFER_LARGE_CreateFromOffsetAndSize with parent, offset + 13 and the number of content bytes. ]*/
+                *destination = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(parent, offset + CONSTBUFFER_V3_CONTENT_OFFSET, content_size);
+                if (*destination == NULL)
                 {
-                    LogError("cannot deserialize when the numbe of serialized bytes cannot be determined. size=%" PRIu32 "", size);
-                    result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                    /*Codes_SRS_CONSTBUFFER_11_128: [ If there are any failures then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                    LogError("failure in CONSTBUFFER_LARGE_CreateFromOffsetAndSize(parent=%p, offset=%" PRIu64 " + CONSTBUFFER_V3_CONTENT_OFFSET=%zu, content_size=%" PRIu64 ")",
+                        parent, offset, CONSTBUFFER_V3_CONTENT_OFFSET, content_size);
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
                 }
                 else
                 {
-                    /*Codes_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-                    uint32_t content_size;
-                    read_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, &content_size);
-                    /*Codes_SRS_CONSTBUFFER_02_070: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                    if (size - (CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE) < content_size)
-                    {
-                        LogError("in the buffer at source=%p of size=%" PRIu32 " there are not enough bytes remaining after version and size to construct content from. Serialized content size was computed as %" PRIu32 " but there are only %" PRIu32 " bytes available",
-                            source, size, content_size, (uint32_t)(size - CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE));
-                        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
-                    }
-                    else
-                    {
-                        /*Codes_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-                        *destination = CONSTBUFFER_Create_Internal(source + CONSTBUFFER_CONTENT_OFFSET, content_size);
-                        if (*destination == NULL)
-                        {
-                            /*Codes_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
-                            LogError("failure in CONSTBUFFER_Create(source=%p + CONSTBUFFER_CONTENT_OFFSET=%zu, content_size=%" PRIu32 ")",
-                                source, CONSTBUFFER_CONTENT_OFFSET, content_size);
-                            result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
-                        }
-                        else
-                        {
-                            /*Codes_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-                            *consumed = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + content_size;
-                            result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
-                        }
-                    }
+                    /*Codes_SRS_CONSTBUFFER_11_129: [ CONSTBUFFER_LARGE_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_LARGE_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                    *consumed = CONSTBUFFER_V3_CONTENT_OFFSET + content_size;
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
                 }
             }
         }
@@ -10,12 +10,18 @@
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
 #include "c_pal/refcount.h"
 
 #include "c_util/constbuffer.h"
+#include "c_util/constbuffer_format.h"
+#include "c_util/constbuffer_version.h"
+#include "c_util/memory_data.h"
 
 #include "c_util/constbuffer_array.h"
 
+#define CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM 4 /*free slots that constbuffer_array_add_front leaves in front of the buffers when it has to copy them*/
+
 typedef void(*CONSTBUFFER_ARRAY_CUSTOM_FREE_FUNC)(void* context);
 
 typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
@@ -23,12 +29,48 @@ typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
     uint32_t nBuffers;
     CONSTBUFFER_ARRAY_CUSTOM_FREE_FUNC custom_free;
     void* custom_free_context;
+    struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG* backing; /*the array that owns the memory of buffers. Itself, unless this array is a view of another array's buffers*/
+    volatile_atomic int32_t headroom; /*only used in a backing with custom_free == NULL: the free slots of buffers_memory in front of the first used one. constbuffer_array_add_front claims them from the back*/
     CONSTBUFFER_HANDLE* buffers;
-    CONSTBUFFER_HANDLE buffers_memory[];
+    uint64_t* remaining_sizes; /*remaining_sizes[i] is the size of buffers[i] plus the sizes of all the buffers that follow it in the memory of backing. remaining_sizes[nBuffers] exists too, so the size of all buffers is remaining_sizes[0] - remaining_sizes[nBuffers]*/
+    CONSTBUFFER_HANDLE* buffers_memory; /*only used in a backing with custom_free == NULL: the handles, stored in memory after the remaining sizes*/
+    uint64_t memory[]; /*in a backing: the remaining sizes (one more than the buffers) followed, when custom_free == NULL, by the handles*/
 } CONSTBUFFER_ARRAY_HANDLE_DATA;
 
 DEFINE_REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA);
 
+/*allocates an array that owns the memory for capacity CONSTBUFFER_HANDLEs and their remaining sizes*/
+static CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_backing(uint32_t capacity)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    /*only possible where size_t has 32 bits*/
+    if ((size_t)capacity + 1 == 0)
+    {
+        LogError("cannot allocate capacity=%" PRIu32 " CONSTBUFFER_HANDLEs", capacity);
+        result = NULL;
+    }
+    else
+    {
+        result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, (size_t)capacity + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE));
+        if (result == NULL)
+        {
+            LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, capacity=%" PRIu32 " + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)=%zu);",
+                capacity, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE));
+            /*return as is*/
+        }
+        else
+        {
+            result->custom_free = NULL;
+            result->backing = result;
+            result->buffers_memory = (CONSTBUFFER_HANDLE*)(void*)&result->memory[(size_t)capacity + 1];
+            result->memory[capacity] = 0;
+        }
+    }
+
+    return result;
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create, const CONSTBUFFER_HANDLE*, buffers, uint32_t, buffer_count)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -44,20 +86,20 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     else
     {
         /* Codes_SRS_CONSTBUFFER_ARRAY_01_009: [ constbuffer_array_create shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold buffer_count buffers. ]*/
-        result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, buffer_count, sizeof(CONSTBUFFER_HANDLE));
+        result = constbuffer_array_create_backing(buffer_count);
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_014: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
-            LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, buffer_count=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu);",
-                buffer_count, sizeof(CONSTBUFFER_HANDLE));
+            LogError("failure in constbuffer_array_create_backing(buffer_count=%" PRIu32 ")", buffer_count);
         }
         else
         {
             uint32_t i;
 
             result->buffers = result->buffers_memory;
+            result->remaining_sizes = result->memory;
             result->nBuffers = buffer_count;
-            result->custom_free = NULL;
+            (void)interlocked_exchange(&result->headroom, 0);
 
             for (i = 0; i < buffer_count; i++)
             {
@@ -66,6 +108,12 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                 result->buffers[i] = buffers[i];
             }
 
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_016: [ constbuffer_array_create shall compute the size of all buffers by calling CONSTBUFFER_GetContent for each buffer, from the last to the first. ]*/
+            for (i = buffer_count; i > 0; i--)
+            {
+                result->remaining_sizes[i - 1] = result->remaining_sizes[i] + CONSTBUFFER_GetContent(result->buffers[i - 1])->size;
+            }
+
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
             goto all_ok;
         }
@@ -82,19 +130,20 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     CONSTBUFFER_ARRAY_HANDLE result;
 
     /*Codes_SRS_CONSTBUFFER_ARRAY_02_004: [ constbuffer_array_create_empty shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
-    result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*implicit 0*/
+    result = constbuffer_array_create_backing(0);
     if (result == NULL)
     {
         /*Codes_SRS_CONSTBUFFER_ARRAY_02_001: [ If are any failure is encountered, constbuffer_array_create_empty shall fail and return NULL. ]*/
-        LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA)");
+        LogError("failure in constbuffer_array_create_backing(0)");
         /*return as is*/
     }
     else
     {
         /*Codes_SRS_CONSTBUFFER_ARRAY_02_041: [ constbuffer_array_create_empty shall succeed and return a non-NULL value. ]*/
-        result->custom_free = NULL;
         result->nBuffers = 0;
         result->buffers = result->buffers_memory;
+        result->remaining_sizes = result->memory;
+        (void)interlocked_exchange(&result->headroom, 0);
     }
     return result;
 }
@@ -123,20 +172,35 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
     else
     {
         /* Codes_SRS_CONSTBUFFER_ARRAY_01_029: [ Otherwise, constbuffer_array_create_with_move_buffers shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that holds the const buffers in buffers. ]*/
-        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*implicit 0*/
+        result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, (size_t)buffer_count + 1, sizeof(uint64_t));
         if (result == NULL)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_030: [ If any error occurs, constbuffer_array_create_with_move_buffers shall fail and return NULL. ]*/
-            LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA);");
+            LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, buffer_count=%" PRIu32 " + 1, sizeof(uint64_t)=%zu);",
+                buffer_count, sizeof(uint64_t));
             /*return as is*/
         }
         else
         {
-            /* Codes_SRS_CONSTBUFFER_ARRAY_01_031: [ On success constbuffer_array_create_with_move_buffers shall return a non-NULL handle. ]*/
+            uint32_t i;
+
             result->custom_free = constbuffer_array_move_buffers_free;
             result->custom_free_context = result;
             result->buffers = buffers;
+            result->buffers_memory = NULL;
+            result->remaining_sizes = result->memory;
             result->nBuffers = buffer_count;
+            result->backing = result;
+            (void)interlocked_exchange(&result->headroom, 0);
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_017: [ constbuffer_array_create_with_move_buffers shall compute the size of all buffers by calling CONSTBUFFER_GetContent for each buffer, from the last to the first. ]*/
+            result->remaining_sizes[buffer_count] = 0;
+            for (i = buffer_count; i > 0; i--)
+            {
+                result->remaining_sizes[i - 1] = result->remaining_sizes[i] + CONSTBUFFER_GetContent(buffers[i - 1])->size;
+            }
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_031: [ On success constbuffer_array_create_with_move_buffers shall return a non-NULL handle. ]*/
         }
     }
 
@@ -191,7 +255,193 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
             result->custom_free = constbuffer_array_buffer_index_and_count_free;
             result->custom_free_context = original;
             result->buffers = &(original->buffers[start_buffer_index]);
+            result->remaining_sizes = &(original->remaining_sizes[start_buffer_index]);
             result->nBuffers = buffer_count;
+            result->backing = original->backing;
+            (void)interlocked_exchange(&result->headroom, 0);
+        }
+    }
+
+    return result;
+}
+
+/*returns the index of the buffer of constbuffer_array_handle that holds the byte at byte_position. byte_position has to be less than the size of all buffers. Buffers of size 0 never hold a byte*/
+static uint32_t constbuffer_array_find_buffer_holding_byte(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t byte_position)
+{
+    /*buffers[i] holds the byte when remaining_sizes[i + 1] < remaining_sizes[0] - byte_position <= remaining_sizes[i]. remaining_sizes does not increase, so the first i that satisfies the left side is the one*/
+    uint64_t remaining_from_byte = constbuffer_array_handle->remaining_sizes[0] - byte_position;
+    uint32_t low = 0;
+    uint32_t high = constbuffer_array_handle->nBuffers - 1;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        if (constbuffer_array_handle->remaining_sizes[middle + 1] < remaining_from_byte)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+/*returns a handle for the size bytes of buffer that start at offset. That is buffer itself (inc_ref-ed) when that is all of it*/
+static CONSTBUFFER_HANDLE constbuffer_array_slice_buffer(CONSTBUFFER_HANDLE buffer, uint32_t buffer_size, uint32_t offset, uint32_t size)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if ((offset == 0) && (size == buffer_size))
+    {
+        CONSTBUFFER_IncRef(buffer);
+        result = buffer;
+    }
+    else
+    {
+        result = CONSTBUFFER_CreateFromOffsetAndSize(buffer, offset, size);
+        if (result == NULL)
+        {
+            LogError("failure in CONSTBUFFER_CreateFromOffsetAndSize(buffer=%p, offset=%" PRIu32 ", size=%" PRIu32 ")",
+                buffer, offset, size);
+            /*return as is*/
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_byte_offset_and_length, CONSTBUFFER_ARRAY_HANDLE, original, uint64_t, byte_offset, uint64_t, byte_length)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (original == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_023: [ If original is NULL then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE original=%p, uint64_t byte_offset=%" PRIu64 ", uint64_t byte_length=%" PRIu64,
+            original, byte_offset, byte_length);
+        result = NULL;
+    }
+    else
+    {
+        uint64_t all_buffers_size = original->remaining_sizes[0] - original->remaining_sizes[original->nBuffers];
+
+        if (
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_024: [ If byte_offset + byte_length is greater than the size of all buffers in original then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+            (byte_offset > all_buffers_size) ||
+            (byte_length > all_buffers_size - byte_offset)
+            )
+        {
+            LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE original=%p (all_buffers_size=%" PRIu64 "), uint64_t byte_offset=%" PRIu64 ", uint64_t byte_length=%" PRIu64,
+                original, all_buffers_size, byte_offset, byte_length);
+            result = NULL;
+        }
+        else if (byte_length == 0)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_025: [ If byte_length is 0 then constbuffer_array_create_from_byte_offset_and_length shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+            result = constbuffer_array_create_empty();
+            if (result == NULL)
+            {
+                /* Codes_SRS_CONSTBUFFER_ARRAY_11_033: [ If there are any failures then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+                LogError("failure in constbuffer_array_create_empty()");
+                /*return as is*/
+            }
+        }
+        else
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_026: [ constbuffer_array_create_from_byte_offset_and_length shall find the buffer that holds the byte at byte_offset and the buffer that holds the byte at byte_offset + byte_length - 1 by binary search. ]*/
+            uint32_t first = constbuffer_array_find_buffer_holding_byte(original, byte_offset);
+            uint32_t last = constbuffer_array_find_buffer_holding_byte(original, byte_offset + byte_length - 1);
+
+            /*the bytes of the first buffer before byte_offset, and the bytes of the last buffer after the range*/
+            uint64_t remaining_from_offset = original->remaining_sizes[0] - byte_offset;
+            uint64_t remaining_after_range = remaining_from_offset - byte_length;
+            uint32_t first_size = (uint32_t)(original->remaining_sizes[first] - original->remaining_sizes[first + 1]);
+            uint32_t first_skipped = (uint32_t)(original->remaining_sizes[first] - remaining_from_offset);
+            uint32_t last_size = (uint32_t)(original->remaining_sizes[last] - original->remaining_sizes[last + 1]);
+            uint32_t last_skipped = (uint32_t)(remaining_after_range - original->remaining_sizes[last + 1]);
+
+            if ((first_skipped == 0) && (last_skipped == 0))
+            {
+                /* Codes_SRS_CONSTBUFFER_ARRAY_11_027: [ If both buffers are entirely in the range then constbuffer_array_create_from_byte_offset_and_length shall return the result of calling constbuffer_array_create_from_buffer_index_and_count with the buffers from the first to the last. ]*/
+                result = constbuffer_array_create_from_buffer_index_and_count(original, first, last - first + 1);
+                if (result == NULL)
+                {
+                    /* Codes_SRS_CONSTBUFFER_ARRAY_11_033: [ If there are any failures then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+                    LogError("failure in constbuffer_array_create_from_buffer_index_and_count(original=%p, first=%" PRIu32 ", last - first + 1=%" PRIu32 ")",
+                        original, first, last - first + 1);
+                    /*return as is*/
+                }
+            }
+            else
+            {
+                uint32_t buffer_count = last - first + 1;
+
+                /* Codes_SRS_CONSTBUFFER_ARRAY_11_028: [ Otherwise constbuffer_array_create_from_byte_offset_and_length shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold the buffers from the first to the last. ]*/
+                result = constbuffer_array_create_backing(buffer_count);
+                if (result == NULL)
+                {
+                    /* Codes_SRS_CONSTBUFFER_ARRAY_11_033: [ If there are any failures then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+                    LogError("failure in constbuffer_array_create_backing(buffer_count=%" PRIu32 ")", buffer_count);
+                    /*return as is*/
+                }
+                else
+                {
+                    result->buffers = result->buffers_memory;
+                    result->remaining_sizes = result->memory;
+                    result->nBuffers = buffer_count;
+                    (void)interlocked_exchange(&result->headroom, 0);
+
+                    /* Codes_SRS_CONSTBUFFER_ARRAY_11_029: [ For the first and the last buffer, constbuffer_array_create_from_byte_offset_and_length shall call CONSTBUFFER_CreateFromOffsetAndSize with the part of the buffer that is in the range, or CONSTBUFFER_IncRef if the entire buffer is in the range. ]*/
+                    if (first == last)
+                    {
+                        result->buffers[0] = constbuffer_array_slice_buffer(original->buffers[first], first_size, first_skipped, (uint32_t)byte_length);
+                    }
+                    else
+                    {
+                        result->buffers[0] = constbuffer_array_slice_buffer(original->buffers[first], first_size, first_skipped, first_size - first_skipped);
+                        if (result->buffers[0] != NULL)
+                        {
+                            result->buffers[buffer_count - 1] = constbuffer_array_slice_buffer(original->buffers[last], last_size, 0, last_size - last_skipped);
+                            if (result->buffers[buffer_count - 1] == NULL)
+                            {
+                                CONSTBUFFER_DecRef(result->buffers[0]);
+                                result->buffers[0] = NULL;
+                            }
+                        }
+                    }
+
+                    if (result->buffers[0] == NULL)
+                    {
+                        /* Codes_SRS_CONSTBUFFER_ARRAY_11_033: [ If there are any failures then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+                        LogError("failure in creating the buffers at the edges of byte_offset=%" PRIu64 ", byte_length=%" PRIu64, byte_offset, byte_length);
+                        REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
+                        result = NULL;
+                    }
+                    else
+                    {
+                        uint32_t i;
+
+                        for (i = 1; i < buffer_count - 1; i++)
+                        {
+                            /* Codes_SRS_CONSTBUFFER_ARRAY_11_030: [ constbuffer_array_create_from_byte_offset_and_length shall inc_ref all the other buffers and store them. ]*/
+                            CONSTBUFFER_IncRef(original->buffers[first + i]);
+                            result->buffers[i] = original->buffers[first + i];
+                        }
+
+                        /* Codes_SRS_CONSTBUFFER_ARRAY_11_031: [ constbuffer_array_create_from_byte_offset_and_length shall compute the size of all buffers from the sizes already known by original. ]*/
+                        result->remaining_sizes[0] = byte_length;
+                        for (i = 1; i < buffer_count; i++)
+                        {
+                            result->remaining_sizes[i] = original->remaining_sizes[first + i] - remaining_after_range;
+                        }
+
+                        /* Codes_SRS_CONSTBUFFER_ARRAY_11_032: [ constbuffer_array_create_from_byte_offset_and_length shall succeed and return a non-NULL value. ]*/
+                    }
+                }
+            }
         }
     }
 
@@ -256,12 +506,11 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
             else
             {
                 /*Codes_SRS_CONSTBUFFER_ARRAY_42_003: [ constbuffer_array_create_from_array_array shall allocate memory to hold all of the CONSTBUFFER_HANDLES from buffer_arrays. ]*/
-                result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, total_buffer_count, sizeof(CONSTBUFFER_HANDLE));
+                result = constbuffer_array_create_backing(total_buffer_count);
                 if (result == NULL)
                 {
                     /*Codes_SRS_CONSTBUFFER_ARRAY_42_008: [ If there are any failures then constbuffer_array_create_from_array_array shall fail and return NULL. ]*/
-                    LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, total_buffer_count=%" PRIu32 ",  sizeof(CONSTBUFFER_HANDLE)=%zu)",
-                        total_buffer_count, sizeof(CONSTBUFFER_HANDLE));
+                    LogError("failure in constbuffer_array_create_backing(total_buffer_count=%" PRIu32 ")", total_buffer_count);
                 }
                 else
                 {
@@ -270,8 +519,9 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                     uint32_t source_idx;
 
                     result->nBuffers = total_buffer_count;
-                    result->custom_free = NULL;
                     result->buffers = result->buffers_memory;
+                    result->remaining_sizes = result->memory;
+                    (void)interlocked_exchange(&result->headroom, 0);
 
                     for (dest_idx = 0, array_idx = 0; array_idx < buffer_array_count; ++array_idx)
                     {
@@ -280,9 +530,17 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create
                             /*Codes_SRS_CONSTBUFFER_ARRAY_42_004: [ constbuffer_array_create_from_array_array shall copy all of the CONSTBUFFER_HANDLES from each const buffer array in buffer_arrays to the newly constructed array by calling CONSTBUFFER_IncRef. ]*/
                             CONSTBUFFER_IncRef(buffer_arrays[array_idx]->buffers[source_idx]);
                             result->buffers[dest_idx] = buffer_arrays[array_idx]->buffers[source_idx];
+                            /*for now only the size of the buffer*/
+                            result->remaining_sizes[dest_idx] = buffer_arrays[array_idx]->remaining_sizes[source_idx] - buffer_arrays[array_idx]->remaining_sizes[source_idx + 1];
                         }
                     }
 
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_018: [ constbuffer_array_create_from_array_array shall compute the size of all buffers from the sizes already known by buffer_arrays. ]*/
+                    for (dest_idx = total_buffer_count; dest_idx > 0; dest_idx--)
+                    {
+                        result->remaining_sizes[dest_idx - 1] += result->remaining_sizes[dest_idx];
+                    }
+
                     /*Codes_SRS_CONSTBUFFER_ARRAY_42_007: [ constbuffer_array_create_from_array_array shall succeed and return a non-NULL value. ]*/
                     goto allOk;
                 }
@@ -294,6 +552,331 @@ allOk:;
     return result;
 }
 
+static int constbuffer_array_count_serialized_buffers(const CONSTBUFFER* content, uint32_t* buffer_count)
+{
+    int result;
+    uint32_t offset = 0;
+    uint32_t count = 0;
+
+    while (offset < content->size)
+    {
+        uint32_t remaining = content->size - offset;
+        uint32_t content_offset;
+        uint8_t version;
+        uint32_t content_size;
+
+        if (remaining < CONSTBUFFER_MIN_SERIALIZATION_SIZE)
+        {
+            LogError("truncated serialization header at offset=%" PRIu32 ", remaining=%" PRIu32 " bytes, at least %" PRIu32 " bytes are needed",
+                offset, remaining, (uint32_t)CONSTBUFFER_MIN_SERIALIZATION_SIZE);
+            break;
+        }
+
+        read_uint8_t(content->buffer + offset + CONSTBUFFER_VERSION_OFFSET, &version);
+        if (version == CONSTBUFFER_VERSION_V1)
+        {
+            content_offset = CONSTBUFFER_CONTENT_OFFSET;
+        }
+        else if (version == CONSTBUFFER_VERSION_V2)
+        {
+            content_offset = CONSTBUFFER_V2_CONTENT_OFFSET;
+        }
+        else
+        {
+            LogError("unknown version=%" PRIu8 " at offset=%" PRIu32 "", version, offset);
+            break;
+        }
+
+        if (remaining < content_offset)
+        {
+            LogError("truncated serialization header at offset=%" PRIu32 ", remaining=%" PRIu32 " bytes, version %" PRIu8 " header needs %" PRIu32 " bytes",
+                offset, remaining, version, content_offset);
+            break;
+        }
+
+        read_uint32_t(content->buffer + offset + CONSTBUFFER_SIZE_OFFSET, &content_size);
+        if (content_size > remaining - content_offset)
+        {
+            LogError("record at offset=%" PRIu32 " claims content_size=%" PRIu32 " but only %" PRIu32 " bytes follow the header",
+                offset, content_size, remaining - content_offset);
+            break;
+        }
+
+        offset += content_offset + content_size;
+        count++;
+    }
+
+    if (offset != content->size)
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        *buffer_count = count;
+        result = 0;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_serialized_buffers, CONSTBUFFER_HANDLE, parent)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (parent == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_11_001: [ If parent is NULL then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_HANDLE parent=%p", parent);
+        result = NULL;
+    }
+    else
+    {
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(parent);
+        uint32_t buffer_count;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_11_002: [ constbuffer_array_create_from_serialized_buffers shall scan the content of parent and validate the version (1 or 2) and the size of every record before creating any CONSTBUFFER_HANDLE. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_11_003: [ If any record has an unknown version, a truncated header or a size that exceeds the remaining bytes of parent then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+        if (constbuffer_array_count_serialized_buffers(content, &buffer_count) != 0)
+        {
+            LogError("failure in constbuffer_array_count_serialized_buffers(content=%p (size=%" PRIu32 "), &buffer_count=%p)",
+                content, content->size, &buffer_count);
+            result = NULL;
+        }
+        else if (buffer_count == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_11_004: [ If parent has no content then constbuffer_array_create_from_serialized_buffers shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+            result = constbuffer_array_create_empty();
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+                LogError("failure in constbuffer_array_create_empty()");
+                /*return as is*/
+            }
+            else
+            {
+                /*return as is*/
+            }
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_11_005: [ constbuffer_array_create_from_serialized_buffers shall allocate memory to hold one CONSTBUFFER_HANDLE for each record. ]*/
+            CONSTBUFFER_HANDLE* buffers = malloc_2(buffer_count, sizeof(CONSTBUFFER_HANDLE));
+            if (buffers == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+                LogError("failure in malloc_2(buffer_count=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)",
+                    buffer_count, sizeof(CONSTBUFFER_HANDLE));
+                result = NULL;
+            }
+            else
+            {
+                uint32_t offset = 0;
+                uint32_t i;
+
+                for (i = 0; i < buffer_count; i++)
+                {
+                    uint32_t consumed;
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_006: [ For each record constbuffer_array_create_from_serialized_buffers shall call CONSTBUFFER_from_buffer_no_copy with parent and the offset of the record. ]*/
+                    CONSTBUFFER_FROM_BUFFER_RESULT from_buffer_result = CONSTBUFFER_from_buffer_no_copy(parent, offset, &consumed, &buffers[i]);
+                    if (from_buffer_result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+                        LogError("failure in CONSTBUFFER_from_buffer_no_copy(parent=%p, offset=%" PRIu32 ", &consumed=%p, &buffers[%" PRIu32 "]=%p), result %" PRI_MU_ENUM "",
+                            parent, offset, &consumed, i, &buffers[i], MU_ENUM_VALUE(CONSTBUFFER_FROM_BUFFER_RESULT, from_buffer_result));
+                        break;
+                    }
+                    offset += consumed;
+                }
+
+                if (i == buffer_count)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_007: [ constbuffer_array_create_from_serialized_buffers shall create the CONSTBUFFER_ARRAY_HANDLE by calling constbuffer_array_create_with_move_buffers. ]*/
+                    result = constbuffer_array_create_with_move_buffers(buffers, buffer_count);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+                        LogError("failure in constbuffer_array_create_with_move_buffers(buffers=%p, buffer_count=%" PRIu32 ")",
+                            buffers, buffer_count);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_11_008: [ constbuffer_array_create_from_serialized_buffers shall succeed and return a non-NULL value. ]*/
+                        goto allOk;
+                    }
+                }
+
+                while (i > 0)
+                {
+                    i--;
+                    CONSTBUFFER_DecRef(buffers[i]);
+                }
+                free(buffers);
+                result = NULL;
+            }
+        }
+    }
+allOk:;
+    return result;
+}
+
+/*returns the end (exclusive) of the group of buffers of original that starts at start_buffer_index and becomes 1 buffer of the coalesced array. A buffer of at least small_buffer_size bytes is a group of its own. Otherwise the group takes the following small buffers until it has small_buffer_size bytes*/
+static uint32_t constbuffer_array_get_coalesced_group_end(CONSTBUFFER_ARRAY_HANDLE original, uint32_t start_buffer_index, uint32_t small_buffer_size)
+{
+    uint64_t group_size = original->remaining_sizes[start_buffer_index] - original->remaining_sizes[start_buffer_index + 1];
+    uint32_t result = start_buffer_index + 1;
+
+    while (
+        (group_size < small_buffer_size) &&
+        (result < original->nBuffers)
+        )
+    {
+        uint64_t buffer_size = original->remaining_sizes[result] - original->remaining_sizes[result + 1];
+        if (
+            (buffer_size >= small_buffer_size) ||
+            (group_size + buffer_size > UINT32_MAX)
+            )
+        {
+            break;
+        }
+        group_size += buffer_size;
+        result++;
+    }
+
+    return result;
+}
+
+/*returns 1 CONSTBUFFER_HANDLE with the content of buffers[0]...buffers[buffer_count - 1], which have group_size bytes together*/
+static CONSTBUFFER_HANDLE constbuffer_array_merge_buffers(const CONSTBUFFER_HANDLE* buffers, uint32_t buffer_count, uint32_t group_size)
+{
+    CONSTBUFFER_HANDLE result;
+    CONSTBUFFER_WRITABLE_HANDLE writable_handle = CONSTBUFFER_CreateWritableHandle(group_size);
+    if (writable_handle == NULL)
+    {
+        LogError("failure in CONSTBUFFER_CreateWritableHandle(group_size=%" PRIu32 ")", group_size);
+        result = NULL;
+    }
+    else
+    {
+        uint32_t i;
+        for (i = 0; i < buffer_count; i++)
+        {
+            const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffers[i]);
+            if (CONSTBUFFER_AppendToWritableBuffer(writable_handle, content->buffer, content->size) != 0)
+            {
+                LogError("failure in CONSTBUFFER_AppendToWritableBuffer(writable_handle=%p, content->buffer=%p, content->size=%" PRIu32 ")",
+                    writable_handle, content->buffer, content->size);
+                break;
+            }
+        }
+
+        if (i < buffer_count)
+        {
+            CONSTBUFFER_DestroyWritableHandle(writable_handle);
+            result = NULL;
+        }
+        else
+        {
+            result = CONSTBUFFER_SealWritableHandle(writable_handle);
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_coalesced, CONSTBUFFER_ARRAY_HANDLE, original, uint32_t, small_buffer_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (original == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_034: [ If original is NULL then constbuffer_array_create_coalesced shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE original=%p, uint32_t small_buffer_size=%" PRIu32,
+            original, small_buffer_size);
+        result = NULL;
+    }
+    else
+    {
+        uint32_t coalesced_count = 0;
+        uint32_t i;
+
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_035: [ constbuffer_array_create_coalesced shall group the buffers of original: a buffer of at least small_buffer_size bytes is a group of its own, and a smaller buffer starts a group that takes the following smaller buffers until the group has at least small_buffer_size bytes. ]*/
+        for (i = 0; i < original->nBuffers; i = constbuffer_array_get_coalesced_group_end(original, i, small_buffer_size))
+        {
+            coalesced_count++;
+        }
+
+        if (coalesced_count == original->nBuffers)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_036: [ If every group has 1 buffer then constbuffer_array_create_coalesced shall increment the reference count of original and return original. ]*/
+            constbuffer_array_inc_ref(original);
+            result = original;
+        }
+        else
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_11_037: [ Otherwise constbuffer_array_create_coalesced shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold 1 buffer for each group. ]*/
+            result = constbuffer_array_create_backing(coalesced_count);
+            if (result == NULL)
+            {
+                /* Codes_SRS_CONSTBUFFER_ARRAY_11_041: [ If there are any failures then constbuffer_array_create_coalesced shall fail and return NULL. ]*/
+                LogError("failure in constbuffer_array_create_backing(coalesced_count=%" PRIu32 ")", coalesced_count);
+                /*return as is*/
+            }
+            else
+            {
+                uint32_t coalesced_index;
+                uint32_t end;
+
+                result->buffers = result->buffers_memory;
+                result->remaining_sizes = result->memory;
+                result->nBuffers = coalesced_count;
+                (void)interlocked_exchange(&result->headroom, 0);
+
+                for (coalesced_index = 0, i = 0; i < original->nBuffers; coalesced_index++, i = end)
+                {
+                    end = constbuffer_array_get_coalesced_group_end(original, i, small_buffer_size);
+                    if (end - i == 1)
+                    {
+                        /* Codes_SRS_CONSTBUFFER_ARRAY_11_038: [ For a group of 1 buffer constbuffer_array_create_coalesced shall inc_ref the buffer and store it. ]*/
+                        CONSTBUFFER_IncRef(original->buffers[i]);
+                        result->buffers[coalesced_index] = original->buffers[i];
+                    }
+                    else
+                    {
+                        /* Codes_SRS_CONSTBUFFER_ARRAY_11_039: [ For a group of more buffers constbuffer_array_create_coalesced shall create 1 buffer by calling CONSTBUFFER_CreateWritableHandle, CONSTBUFFER_GetContent and CONSTBUFFER_AppendToWritableBuffer for each buffer of the group, and CONSTBUFFER_SealWritableHandle. ]*/
+                        result->buffers[coalesced_index] = constbuffer_array_merge_buffers(&original->buffers[i], end - i, (uint32_t)(original->remaining_sizes[i] - original->remaining_sizes[end]));
+                        if (result->buffers[coalesced_index] == NULL)
+                        {
+                            /* Codes_SRS_CONSTBUFFER_ARRAY_11_041: [ If there are any failures then constbuffer_array_create_coalesced shall fail and return NULL. ]*/
+                            LogError("failure in constbuffer_array_merge_buffers for buffers %" PRIu32 "...%" PRIu32, i, end - 1);
+                            break;
+                        }
+                    }
+
+                    /* Codes_SRS_CONSTBUFFER_ARRAY_11_040: [ constbuffer_array_create_coalesced shall compute the size of all buffers from the sizes already known by original. ]*/
+                    result->remaining_sizes[coalesced_index] = original->remaining_sizes[i] - original->remaining_sizes[original->nBuffers];
+                }
+
+                if (i < original->nBuffers)
+                {
+                    while (coalesced_index > 0)
+                    {
+                        coalesced_index--;
+                        CONSTBUFFER_DecRef(result->buffers[coalesced_index]);
+                    }
+                    REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
+                    result = NULL;
+                }
+                else
+                {
+                    /* Codes_SRS_CONSTBUFFER_ARRAY_11_042: [ constbuffer_array_create_coalesced shall succeed and return a non-NULL value. ]*/
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_front, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -315,34 +898,97 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_fr
         }
         else
         {
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_042: [ constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle. ]*/
-            result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers + 1, sizeof(CONSTBUFFER_HANDLE));
-            if (result == NULL)
+            CONSTBUFFER_ARRAY_HANDLE backing = constbuffer_array_handle->backing;
+            /*when backing owns the memory of its buffers, slot_index is where the buffers of constbuffer_array_handle start in that memory*/
+            uint32_t slot_index = (backing->custom_free == NULL) ? (uint32_t)(constbuffer_array_handle->buffers - backing->buffers_memory) : 0;
+
+            if (
+                (slot_index > 0) &&
+                (slot_index <= INT32_MAX) &&
+                /*Codes_SRS_CONSTBUFFER_ARRAY_11_010: [ If the slot in front of the first CONSTBUFFER_HANDLE of constbuffer_array_handle is free headroom of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers then constbuffer_array_add_front shall claim the slot by calling interlocked_compare_exchange. ]*/
+                (interlocked_compare_exchange(&backing->headroom, (int32_t)slot_index - 1, (int32_t)slot_index) == (int32_t)slot_index)
+                )
             {
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
-                LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers=%" PRIu32 " + 1, sizeof(CONSTBUFFER_HANDLE)=%zu);",
-                    constbuffer_array_handle->nBuffers, sizeof(CONSTBUFFER_HANDLE));
-                /*return as is*/
+                /*Codes_SRS_CONSTBUFFER_ARRAY_11_011: [ constbuffer_array_add_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle. ]*/
+                result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+                    LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA)");
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_013: [ If allocating memory fails after the slot was claimed then constbuffer_array_add_front shall release the slot. ]*/
+                    /*no array starts at the claimed slot, so nobody else could have claimed the slots in front of it*/
+                    (void)interlocked_increment(&backing->headroom);
+                }
+                else
+                {
+                    result->nBuffers = constbuffer_array_handle->nBuffers + 1;
+                    result->custom_free = constbuffer_array_buffer_index_and_count_free;
+                    result->custom_free_context = backing;
+                    result->buffers = &(backing->buffers_memory[slot_index - 1]);
+                    result->remaining_sizes = constbuffer_array_handle->remaining_sizes - 1;
+                    result->backing = backing;
+                    (void)interlocked_exchange(&result->headroom, 0);
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_012: [ constbuffer_array_add_front shall inc_ref constbuffer_handle, store it in the claimed slot and increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
+                    CONSTBUFFER_IncRef(constbuffer_handle);
+                    backing->buffers_memory[slot_index - 1] = constbuffer_handle;
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_019: [ constbuffer_array_add_front shall compute the size of all buffers by adding the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) to the size of the buffers of constbuffer_array_handle. ]*/
+                    result->remaining_sizes[0] = constbuffer_array_handle->remaining_sizes[0] + CONSTBUFFER_GetContent(constbuffer_handle)->size;
+                    INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, backing);
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+                    goto allOk;
+                }
             }
             else
             {
-                uint32_t i;
+                uint32_t new_buffer_count = constbuffer_array_handle->nBuffers + 1;
+                /*leave as many free slots in front as there are buffers, so that a sequence of add_front copies the buffers an amortized constant number of times*/
+                uint32_t new_headroom = (new_buffer_count < CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM) ? CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM : new_buffer_count;
+                if (new_headroom > UINT32_MAX - new_buffer_count)
+                {
+                    new_headroom = UINT32_MAX - new_buffer_count;
+                }
+                if (new_headroom > INT32_MAX)
+                {
+                    new_headroom = INT32_MAX;
+                }
 
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
-                result->nBuffers = constbuffer_array_handle->nBuffers + 1;
-                result->custom_free = NULL;
-                result->buffers = result->buffers_memory;
-                CONSTBUFFER_IncRef(constbuffer_handle);
-                result->buffers_memory[0] = constbuffer_handle;
-                for (i = 1; i < result->nBuffers; i++)
+                /*Codes_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE, constbuffer_handle and headroom for at least CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM CONSTBUFFER_HANDLEs to be added in front later. ]*/
+                result = constbuffer_array_create_backing(new_headroom + new_buffer_count);
+                if (result == NULL)
                 {
-                    CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i - 1]);
-                    result->buffers[i] = constbuffer_array_handle->buffers[i - 1];
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+                    LogError("failure in constbuffer_array_create_backing(new_headroom=%" PRIu32 " + new_buffer_count=%" PRIu32 ")",
+                        new_headroom, new_buffer_count);
+                    /*return as is*/
                 }
+                else
+                {
+                    uint32_t i;
+
+                    result->nBuffers = new_buffer_count;
+                    result->buffers = &(result->buffers_memory[new_headroom]);
+                    result->remaining_sizes = &(result->memory[new_headroom]);
+                    (void)interlocked_exchange(&result->headroom, (int32_t)new_headroom);
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+                    CONSTBUFFER_IncRef(constbuffer_handle);
+                    result->buffers[0] = constbuffer_handle;
+                    for (i = 1; i < result->nBuffers; i++)
+                    {
+                        CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i - 1]);
+                        result->buffers[i] = constbuffer_array_handle->buffers[i - 1];
+                        result->remaining_sizes[i] = constbuffer_array_handle->remaining_sizes[i - 1] - constbuffer_array_handle->remaining_sizes[constbuffer_array_handle->nBuffers];
+                    }
 
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
-                goto allOk;
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_11_019: [ constbuffer_array_add_front shall compute the size of all buffers by adding the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) to the size of the buffers of constbuffer_array_handle. ]*/
+                    result->remaining_sizes[0] = result->remaining_sizes[1] + CONSTBUFFER_GetContent(constbuffer_handle)->size;
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+                    goto allOk;
+                }
             }
         }
     }
@@ -376,32 +1022,31 @@ IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove
         }
         else
         {
-            /*Codes_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-            result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers - 1, sizeof(CONSTBUFFER_HANDLE));
+            /*Codes_SRS_CONSTBUFFER_ARRAY_11_014: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle and holds all of its CONSTBUFFER_HANDLEs except the front one. ]*/
+            result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA);
             if (result == NULL)
             {
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_036: [ If there are any failures then constbuffer_array_remove_front shall fail and return NULL. ]*/
-                LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers=%" PRIu32 " - 1, sizeof(CONSTBUFFER_HANDLE)=%zu);",
-                    constbuffer_array_handle->nBuffers, sizeof(CONSTBUFFER_HANDLE));
+                LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA)");
                 /*return as is*/
             }
             else
             {
-                uint32_t i;
+                CONSTBUFFER_ARRAY_HANDLE backing = constbuffer_array_handle->backing;
+
+                result->nBuffers = constbuffer_array_handle->nBuffers - 1;
+                result->custom_free = constbuffer_array_buffer_index_and_count_free;
+                result->custom_free_context = backing;
+                result->buffers = constbuffer_array_handle->buffers + 1;
+                result->remaining_sizes = constbuffer_array_handle->remaining_sizes + 1;
+                result->backing = backing;
+                (void)interlocked_exchange(&result->headroom, 0);
 
                 /* Codes_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
                 CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[0]);
-                result->nBuffers = constbuffer_array_handle->nBuffers - 1;
-                result->custom_free = NULL;
-                result->buffers = result->buffers_memory;
 
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-                /*Codes_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
-                for (i = 1; i < constbuffer_array_handle->nBuffers; i++)
-                {
-                    CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i]);
-                    result->buffers[i - 1] = constbuffer_array_handle->buffers[i];
-                }
+                /*Codes_SRS_CONSTBUFFER_ARRAY_11_015: [ constbuffer_array_remove_front shall increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
+                INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, backing);
 
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
                 *constbuffer_handle = constbuffer_array_handle->buffers[0];
@@ -525,9 +1170,11 @@ IMPLEMENT_MOCKABLE_FUNCTION(, void, constbuffer_array_dec_ref, CONSTBUFFER_ARRAY
             /*Codes_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
             if (constbuffer_array_handle->custom_free == NULL)
             {
-                for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
+                /*the reference count is 0, so no more slots can be claimed: the used slots start at headroom and end where the buffers of constbuffer_array_handle end*/
+                uint32_t end_index = (uint32_t)(constbuffer_array_handle->buffers - constbuffer_array_handle->buffers_memory) + constbuffer_array_handle->nBuffers;
+                for (i = (uint32_t)constbuffer_array_handle->headroom; i < end_index; i++)
                 {
-                    CONSTBUFFER_DecRef(constbuffer_array_handle->buffers[i]);
+                    CONSTBUFFER_DecRef(constbuffer_array_handle->buffers_memory[i]);
                 }
             }
             else
@@ -557,36 +1204,18 @@ IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONST
     }
     else
     {
-        uint32_t i;
-        uint32_t total_size = 0;
+        uint64_t total_size = constbuffer_array_handle->remaining_sizes[0] - constbuffer_array_handle->remaining_sizes[constbuffer_array_handle->nBuffers];
 
-        for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
-        {
-            const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
-#if SIZE_MAX > UINT32_MAX
-            if (content->size > UINT32_MAX)
-            {
-                break;
-            }
-#endif
-            if (total_size + (uint32_t)content->size < total_size)
-            {
-                break;
-            }
-
-            total_size += (uint32_t)content->size;
-        }
-
-        if (i < constbuffer_array_handle->nBuffers)
+        if (total_size > UINT32_MAX)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-            LogError("Overflow in computing all buffers size");
+            LogError("Overflow in computing all buffers size, total_size=%" PRIu64 " does not fit in uint32_t", total_size);
             result = MU_FAILURE;
         }
         else
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-            *all_buffers_size = total_size;
+            *all_buffers_size = (uint32_t)total_size;
             result = 0;
         }
     }
@@ -594,6 +1223,31 @@ IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONST
     return result;
 }
 
+IMPLEMENT_MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size_u64, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint64_t*, all_buffers_size)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_020: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size_u64 shall fail and return a non-zero value. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_021: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size_u64 shall fail and return a non-zero value. ]*/
+        (all_buffers_size == NULL)
+        )
+    {
+        LogError("CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint64_t* all_buffers_size=%p",
+            constbuffer_array_handle, all_buffers_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_11_022: [ Otherwise constbuffer_array_get_all_buffers_size_u64 shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+        *all_buffers_size = constbuffer_array_handle->remaining_sizes[0] - constbuffer_array_handle->remaining_sizes[constbuffer_array_handle->nBuffers];
+        result = 0;
+    }
+
+    return result;
+}
+
 IMPLEMENT_MOCKABLE_FUNCTION(, const CONSTBUFFER_HANDLE*, constbuffer_array_get_const_buffer_handle_array, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle)
 {
     const CONSTBUFFER_HANDLE* result;
@@ -0,0 +1,317 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+
+#include "c_util/constbuffer_file.h"
+
+typedef struct CONSTBUFFER_FILE_MAPPING_TAG
+{
+    void* base; /*what mmap returned, page aligned*/
+    size_t length; /*number of mapped bytes starting at base*/
+}CONSTBUFFER_FILE_MAPPING;
+
+static void constbuffer_file_unmap(void* context)
+{
+    CONSTBUFFER_FILE_MAPPING* mapping = context;
+    /*Codes_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the handle (CONSTBUFFER_HANDLE or CONSTBUFFER_LARGE_HANDLE) is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+    if (munmap(mapping->base, mapping->length) != 0)
+    {
+        LogError("failure in munmap(base=%p, length=%zu), errno=%d", mapping->base, mapping->length, errno);
+    }
+    free(mapping);
+}
+
+/*maps size bytes of fd starting at offset, size is not 0. Fails if the mapped length (offset - (offset rounded down to the page size) + size) exceeds SIZE_MAX*/
+/*on success *content is where the byte at offset is mapped and the returned mapping is released by constbuffer_file_unmap*/
+static CONSTBUFFER_FILE_MAPPING* constbuffer_file_mapping_create(int fd, uint64_t offset, uint64_t size, const unsigned char** content)
+{
+    CONSTBUFFER_FILE_MAPPING* result;
+    /*Codes_SRS_CONSTBUFFER_FILE_11_009: [ The mapping shall start at offset rounded down to the mapping granularity of the platform (the page size on Linux, the allocation granularity on Windows). ]*/
+    uint64_t granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t delta = offset % granularity;
+
+    if (size > SIZE_MAX - delta)
+    {
+        /*only on 32 bit: the length passed to mmap would wrap and map fewer bytes than size*/
+        LogError("cannot map offset=%" PRIu64 ", size=%" PRIu64 ", the mapped length %" PRIu64 " + %" PRIu64 " exceeds SIZE_MAX=%zu", offset, size, delta, size, (size_t)SIZE_MAX);
+        result = NULL;
+    }
+    else
+    {
+        result = malloc(sizeof(CONSTBUFFER_FILE_MAPPING));
+        if (result == NULL)
+        {
+            LogError("failure in malloc(sizeof(CONSTBUFFER_FILE_MAPPING)=%zu)", sizeof(CONSTBUFFER_FILE_MAPPING));
+            /*return as is*/
+        }
+        else
+        {
+            result->length = (size_t)(delta + size);
+            /*Codes_SRS_CONSTBUFFER_FILE_11_010: [ The file shall be mapped read-only (mmap with PROT_READ and MAP_PRIVATE on Linux, MapViewOfFile with FILE_MAP_READ on Windows). ]*/
+            result->base = mmap(NULL, result->length, PROT_READ, MAP_PRIVATE, fd, (off_t)(offset - delta));
+            if (result->base == MAP_FAILED)
+            {
+                LogError("failure in mmap(NULL, length=%zu, PROT_READ, MAP_PRIVATE, fd=%d, offset=%" PRIu64 "), errno=%d", result->length, fd, offset - delta, errno);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                *content = (const unsigned char*)result->base + delta;
+            }
+        }
+    }
+    return result;
+}
+
+/*maps size bytes of fd starting at offset, size is not 0*/
+static CONSTBUFFER_HANDLE constbuffer_file_map_fd(int fd, uint64_t offset, uint32_t size)
+{
+    CONSTBUFFER_HANDLE result;
+    const unsigned char* content;
+    CONSTBUFFER_FILE_MAPPING* mapping = constbuffer_file_mapping_create(fd, offset, size, &content);
+    if (mapping == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("failure in constbuffer_file_mapping_create(fd=%d, offset=%" PRIu64 ", size=%" PRIu32 ", &content)", fd, offset, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_011: [ The CONSTBUFFER_HANDLE shall be created by calling CONSTBUFFER_CreateWithCustomFree with the mapped bytes that correspond to offset and size and a free function that unmaps the file. ]*/
+        result = CONSTBUFFER_CreateWithCustomFree(content, size, constbuffer_file_unmap, mapping);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_CreateWithCustomFree(content=%p, size=%" PRIu32 ", constbuffer_file_unmap, mapping=%p)", content, size, mapping);
+            constbuffer_file_unmap(mapping);
+        }
+        else
+        {
+            /*the CONSTBUFFER_HANDLE owns the mapping*/
+        }
+    }
+    return result;
+}
+
+/*opens file_name for reading and gets its size, returns -1 if that fails*/
+static int constbuffer_file_open(const char* file_name, uint64_t* file_size)
+{
+    /*Codes_SRS_CONSTBUFFER_FILE_11_003: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall open the file for reading (open with O_RDONLY on Linux, CreateFileA with GENERIC_READ on Windows) and get its size. ]*/
+    int result = open(file_name, O_RDONLY | O_CLOEXEC);
+    if (result == -1)
+    {
+        LogError("failure in open(file_name=%s, O_RDONLY | O_CLOEXEC), errno=%d", file_name, errno);
+    }
+    else
+    {
+        struct stat file_stat;
+        if (fstat(result, &file_stat) != 0)
+        {
+            LogError("failure in fstat(fd=%d), errno=%d", result, errno);
+            if (close(result) != 0)
+            {
+                LogError("failure in close(fd=%d), errno=%d", result, errno);
+            }
+            result = -1;
+        }
+        else
+        {
+            *file_size = (uint64_t)file_stat.st_size;
+        }
+    }
+    return result;
+}
+
+static void constbuffer_file_close(int fd)
+{
+    /*Codes_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall close the file before returning, the mapping stays valid after that. ]*/
+    if (close(fd) != 0)
+    {
+        LogError("failure in close(fd=%d), errno=%d", fd, errno);
+    }
+}
+
+/*opens file_name and maps size bytes starting at offset, map_to_end means "until the end of the file" and then size is ignored*/
+static CONSTBUFFER_HANDLE constbuffer_file_map_internal(const char* file_name, uint64_t offset, uint32_t size, bool map_to_end)
+{
+    CONSTBUFFER_HANDLE result;
+    uint64_t file_size;
+    int fd = constbuffer_file_open(file_name, &file_size);
+    if (fd == -1)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("failure in constbuffer_file_open(file_name=%s, &file_size)", file_name);
+        result = NULL;
+    }
+    else
+    {
+        if (
+            map_to_end &&
+            (file_size > UINT32_MAX)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_004: [ If the size of the file exceeds UINT32_MAX then constbuffer_file_map shall fail and return NULL. ]*/
+            LogError("file_name=%s has %" PRIu64 " bytes, a CONSTBUFFER_HANDLE cannot have more than UINT32_MAX=%" PRIu32 " bytes", file_name, file_size, UINT32_MAX);
+            result = NULL;
+        }
+        else
+        {
+            if (map_to_end)
+            {
+                size = (uint32_t)file_size;
+            }
+
+            if (
+                (offset > file_size) ||
+                (file_size - offset < size)
+                )
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+                LogError("cannot map offset=%" PRIu64 ", size=%" PRIu32 " of file_name=%s that has %" PRIu64 " bytes", offset, size, file_name, file_size);
+                result = NULL;
+            }
+            else if (size == 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_008: [ If there are no bytes to map then constbuffer_file_map and constbuffer_file_map_range shall return an empty CONSTBUFFER_HANDLE created by calling CONSTBUFFER_Create with NULL and 0. ]*/
+                result = CONSTBUFFER_Create(NULL, 0);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_Create(NULL, 0)");
+                }
+            }
+            else
+            {
+                result = constbuffer_file_map_fd(fd, offset, size);
+            }
+        }
+
+        constbuffer_file_close(fd);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map, const char*, file_name)
+{
+    CONSTBUFFER_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_001: [ If file_name is NULL then constbuffer_file_map shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s", MU_P_OR_NULL(file_name));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_002: [ constbuffer_file_map shall map all the bytes of the file. ]*/
+        result = constbuffer_file_map_internal(file_name, 0, 0, true);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map_range, const char*, file_name, uint64_t, offset, uint32_t, size)
+{
+    CONSTBUFFER_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_005: [ If file_name is NULL then constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 "", MU_P_OR_NULL(file_name), offset, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+        result = constbuffer_file_map_internal(file_name, offset, size, false);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, constbuffer_file_map_large, const char*, file_name)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_015: [ If file_name is NULL then constbuffer_file_map_large shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s", MU_P_OR_NULL(file_name));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_016: [ constbuffer_file_map_large shall map all the bytes of the file. ]*/
+        uint64_t file_size;
+        int fd = constbuffer_file_open(file_name, &file_size);
+        if (fd == -1)
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_file_open(file_name=%s, &file_size)", file_name);
+            result = NULL;
+        }
+        else
+        {
+            if (file_size > SIZE_MAX)
+            {
+                /*only on 32 bit: the file does not fit in the address space*/
+                /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                LogError("file_name=%s has %" PRIu64 " bytes, it cannot be mapped in an address space of SIZE_MAX=%zu bytes", file_name, file_size, (size_t)SIZE_MAX);
+                result = NULL;
+            }
+            else if (file_size == 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_018: [ If the file is empty then constbuffer_file_map_large shall return an empty CONSTBUFFER_LARGE_HANDLE created by calling CONSTBUFFER_LARGE_Create with NULL and 0. ]*/
+                result = CONSTBUFFER_LARGE_Create(NULL, 0);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_LARGE_Create(NULL, 0)");
+                }
+            }
+            else
+            {
+                const unsigned char* content;
+                CONSTBUFFER_FILE_MAPPING* mapping = constbuffer_file_mapping_create(fd, 0, file_size, &content);
+                if (mapping == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                    LogError("failure in constbuffer_file_mapping_create(fd=%d, 0, file_size=%" PRIu64 ", &content)", fd, file_size);
+                    result = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_019: [ The CONSTBUFFER_LARGE_HANDLE shall be created by calling CONSTBUFFER_LARGE_CreateWithCustomFree with the mapped bytes and a free function that unmaps the file. ]*/
+                    result = CONSTBUFFER_LARGE_CreateWithCustomFree(content, file_size, constbuffer_file_unmap, mapping);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                        LogError("failure in CONSTBUFFER_LARGE_CreateWithCustomFree(content=%p, file_size=%" PRIu64 ", constbuffer_file_unmap, mapping=%p)", content, file_size, mapping);
+                        constbuffer_file_unmap(mapping);
+                    }
+                    else
+                    {
+                        /*the CONSTBUFFER_LARGE_HANDLE owns the mapping*/
+                    }
+                }
+            }
+
+            constbuffer_file_close(fd);
+        }
+    }
+    return result;
+}
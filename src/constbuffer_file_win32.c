@@ -0,0 +1,301 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "windows.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+
+#include "c_util/constbuffer_file.h"
+
+static void constbuffer_file_unmap(void* context)
+{
+    /*Codes_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the handle (CONSTBUFFER_HANDLE or CONSTBUFFER_LARGE_HANDLE) is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+    if (!UnmapViewOfFile(context))
+    {
+        LogLastError("failure in UnmapViewOfFile(base=%p)", context);
+    }
+}
+
+/*maps size bytes of file starting at offset, size is not 0. Fails if the mapped length (offset - (offset rounded down to the allocation granularity) + size) exceeds SIZE_MAX*/
+/*on success *content is where the byte at offset is mapped and the returned view is released by constbuffer_file_unmap*/
+static void* constbuffer_file_view_create(HANDLE file, uint64_t offset, uint64_t size, const unsigned char** content)
+{
+    void* result;
+    /*Codes_SRS_CONSTBUFFER_FILE_11_009: [ The mapping shall start at offset rounded down to the mapping granularity of the platform (the page size on Linux, the allocation granularity on Windows). ]*/
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    uint64_t delta = offset % system_info.dwAllocationGranularity;
+    uint64_t view_offset = offset - delta;
+
+    if (size > SIZE_MAX - delta)
+    {
+        /*only on 32 bit: the length passed to MapViewOfFile would wrap and map fewer bytes than size*/
+        LogError("cannot map offset=%" PRIu64 ", size=%" PRIu64 ", the mapped length %" PRIu64 " + %" PRIu64 " exceeds SIZE_MAX=%zu", offset, size, delta, size, (size_t)SIZE_MAX);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_010: [ The file shall be mapped read-only (mmap with PROT_READ and MAP_PRIVATE on Linux, MapViewOfFile with FILE_MAP_READ on Windows). ]*/
+        HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (file_mapping == NULL)
+        {
+            LogLastError("failure in CreateFileMappingA(file=%p, NULL, PAGE_READONLY, 0, 0, NULL)", file);
+            result = NULL;
+        }
+        else
+        {
+            result = MapViewOfFile(file_mapping, FILE_MAP_READ, (DWORD)(view_offset >> 32), (DWORD)view_offset, (SIZE_T)(delta + size));
+            if (result == NULL)
+            {
+                LogLastError("failure in MapViewOfFile(file_mapping=%p, FILE_MAP_READ, offset=%" PRIu64 ", length=%" PRIu64 ")", file_mapping, view_offset, delta + size);
+            }
+            else
+            {
+                *content = (const unsigned char*)result + delta;
+            }
+
+            /*the view keeps the file mapping object alive*/
+            (void)CloseHandle(file_mapping);
+        }
+    }
+    return result;
+}
+
+/*maps size bytes of file starting at offset, size is not 0*/
+static CONSTBUFFER_HANDLE constbuffer_file_map_handle(HANDLE file, uint64_t offset, uint32_t size)
+{
+    CONSTBUFFER_HANDLE result;
+    const unsigned char* content;
+    void* base = constbuffer_file_view_create(file, offset, size, &content);
+    if (base == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("failure in constbuffer_file_view_create(file=%p, offset=%" PRIu64 ", size=%" PRIu32 ", &content)", file, offset, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_011: [ The CONSTBUFFER_HANDLE shall be created by calling CONSTBUFFER_CreateWithCustomFree with the mapped bytes that correspond to offset and size and a free function that unmaps the file. ]*/
+        result = CONSTBUFFER_CreateWithCustomFree(content, size, constbuffer_file_unmap, base);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+            LogError("failure in CONSTBUFFER_CreateWithCustomFree(content=%p, size=%" PRIu32 ", constbuffer_file_unmap, base=%p)", content, size, base);
+            constbuffer_file_unmap(base);
+        }
+        else
+        {
+            /*the CONSTBUFFER_HANDLE owns the view*/
+        }
+    }
+    return result;
+}
+
+/*opens file_name for reading and gets its size, returns INVALID_HANDLE_VALUE if that fails*/
+static HANDLE constbuffer_file_open(const char* file_name, uint64_t* file_size)
+{
+    /*Codes_SRS_CONSTBUFFER_FILE_11_003: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall open the file for reading (open with O_RDONLY on Linux, CreateFileA with GENERIC_READ on Windows) and get its size. ]*/
+    HANDLE result = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (result == INVALID_HANDLE_VALUE)
+    {
+        LogLastError("failure in CreateFileA(file_name=%s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)", file_name);
+    }
+    else
+    {
+        LARGE_INTEGER file_size_li;
+        if (!GetFileSizeEx(result, &file_size_li))
+        {
+            LogLastError("failure in GetFileSizeEx(file=%p)", result);
+            (void)CloseHandle(result);
+            result = INVALID_HANDLE_VALUE;
+        }
+        else
+        {
+            *file_size = (uint64_t)file_size_li.QuadPart;
+        }
+    }
+    return result;
+}
+
+static void constbuffer_file_close(HANDLE file)
+{
+    /*Codes_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall close the file before returning, the mapping stays valid after that. ]*/
+    (void)CloseHandle(file);
+}
+
+/*opens file_name and maps size bytes starting at offset, map_to_end means "until the end of the file" and then size is ignored*/
+static CONSTBUFFER_HANDLE constbuffer_file_map_internal(const char* file_name, uint64_t offset, uint32_t size, bool map_to_end)
+{
+    CONSTBUFFER_HANDLE result;
+    uint64_t file_size;
+    HANDLE file = constbuffer_file_open(file_name, &file_size);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("failure in constbuffer_file_open(file_name=%s, &file_size)", file_name);
+        result = NULL;
+    }
+    else
+    {
+        if (
+            map_to_end &&
+            (file_size > UINT32_MAX)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_004: [ If the size of the file exceeds UINT32_MAX then constbuffer_file_map shall fail and return NULL. ]*/
+            LogError("file_name=%s has %" PRIu64 " bytes, a CONSTBUFFER_HANDLE cannot have more than UINT32_MAX=%" PRIu32 " bytes", file_name, file_size, UINT32_MAX);
+            result = NULL;
+        }
+        else
+        {
+            if (map_to_end)
+            {
+                size = (uint32_t)file_size;
+            }
+
+            if (
+                (offset > file_size) ||
+                (file_size - offset < size)
+                )
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+                LogError("cannot map offset=%" PRIu64 ", size=%" PRIu32 " of file_name=%s that has %" PRIu64 " bytes", offset, size, file_name, file_size);
+                result = NULL;
+            }
+            else if (size == 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_008: [ If there are no bytes to map then constbuffer_file_map and constbuffer_file_map_range shall return an empty CONSTBUFFER_HANDLE created by calling CONSTBUFFER_Create with NULL and 0. ]*/
+                result = CONSTBUFFER_Create(NULL, 0);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_Create(NULL, 0)");
+                }
+            }
+            else
+            {
+                result = constbuffer_file_map_handle(file, offset, size);
+            }
+        }
+
+        constbuffer_file_close(file);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map, const char*, file_name)
+{
+    CONSTBUFFER_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_001: [ If file_name is NULL then constbuffer_file_map shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s", MU_P_OR_NULL(file_name));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_002: [ constbuffer_file_map shall map all the bytes of the file. ]*/
+        result = constbuffer_file_map_internal(file_name, 0, 0, true);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_file_map_range, const char*, file_name, uint64_t, offset, uint32_t, size)
+{
+    CONSTBUFFER_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_005: [ If file_name is NULL then constbuffer_file_map_range shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 "", MU_P_OR_NULL(file_name), offset, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+        result = constbuffer_file_map_internal(file_name, offset, size, false);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, CONSTBUFFER_LARGE_HANDLE, constbuffer_file_map_large, const char*, file_name)
+{
+    CONSTBUFFER_LARGE_HANDLE result;
+    if (file_name == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_015: [ If file_name is NULL then constbuffer_file_map_large shall fail and return NULL. ]*/
+        LogError("invalid arguments const char* file_name=%s", MU_P_OR_NULL(file_name));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_FILE_11_016: [ constbuffer_file_map_large shall map all the bytes of the file. ]*/
+        uint64_t file_size;
+        HANDLE file = constbuffer_file_open(file_name, &file_size);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_file_open(file_name=%s, &file_size)", file_name);
+            result = NULL;
+        }
+        else
+        {
+            if (file_size > SIZE_MAX)
+            {
+                /*only on 32 bit: the file does not fit in the address space*/
+                /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                LogError("file_name=%s has %" PRIu64 " bytes, it cannot be mapped in an address space of SIZE_MAX=%zu bytes", file_name, file_size, (size_t)SIZE_MAX);
+                result = NULL;
+            }
+            else if (file_size == 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_FILE_11_018: [ If the file is empty then constbuffer_file_map_large shall return an empty CONSTBUFFER_LARGE_HANDLE created by calling CONSTBUFFER_LARGE_Create with NULL and 0. ]*/
+                result = CONSTBUFFER_LARGE_Create(NULL, 0);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_LARGE_Create(NULL, 0)");
+                }
+            }
+            else
+            {
+                const unsigned char* content;
+                void* base = constbuffer_file_view_create(file, 0, file_size, &content);
+                if (base == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                    LogError("failure in constbuffer_file_view_create(file=%p, 0, file_size=%" PRIu64 ", &content)", file, file_size);
+                    result = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_FILE_11_019: [ The CONSTBUFFER_LARGE_HANDLE shall be created by calling CONSTBUFFER_LARGE_CreateWithCustomFree with the mapped bytes and a free function that unmaps the file. ]*/
+                    result = CONSTBUFFER_LARGE_CreateWithCustomFree(content, file_size, constbuffer_file_unmap, base);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+                        LogError("failure in CONSTBUFFER_LARGE_CreateWithCustomFree(content=%p, file_size=%" PRIu64 ", constbuffer_file_unmap, base=%p)", content, file_size, base);
+                        constbuffer_file_unmap(base);
+                    }
+                    else
+                    {
+                        /*the CONSTBUFFER_LARGE_HANDLE owns the view*/
+                    }
+                }
+            }
+
+            constbuffer_file_close(file);
+        }
+    }
+    return result;
+}
@@ -2,42 +2,358 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
 #include "macro_utils/macro_utils.h"
 
 #include "c_logging/xlogging.h"
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
 #include "c_pal/string_utils.h"
 
 #include "c_util/strings.h"
+#include "c_util/constbuffer.h"
+#include "c_util/thandle.h"
+#include "c_util/rc_string.h"
+#include "c_util/memory_data.h"
 
+#include "c_util/map_format.h"
+#include "c_util/map_version.h"
 #include "c_util/map.h"
 
 
 MU_DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
+MU_DEFINE_ENUM_STRINGS(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_VALUES);
 
-typedef struct MAP_HANDLE_DATA_TAG
+/*maps with fewer keys than this are searched linearly, a strcmp scan over a handful of keys beats hashing them*/
+#define MAP_KEY_INDEX_MIN_COUNT 8
+/*smallest number of slots in the key index, always a power of 2*/
+#define MAP_KEY_INDEX_MIN_SIZE 16
+/*value of an unused slot in the key index. Used slots store the position of the key in "keys" + 1*/
+#define MAP_KEY_INDEX_EMPTY 0
+/*smallest number of slots in the value index, always a power of 2. The value index is rebuilt once it is half full and sized to be at most a quarter full after the rebuild*/
+#define MAP_VALUE_INDEX_MIN_SIZE 16
+/*number of slots allocated in keys/values by the first insert, storage doubles from there*/
+#define MAP_MIN_CAPACITY 1
+/*smallest number of bytes in an arena chunk, every new chunk is at least twice the size of the previous one*/
+#define MAP_ARENA_MIN_CHUNK_SIZE 256
+
+#define MAP_STORAGE_TYPE_VALUES \
+    MAP_STORAGE_TYPE_COPIED, \
+    MAP_STORAGE_TYPE_ARENA, \
+    MAP_STORAGE_TYPE_RC_STRING
+
+/*how the keys and values of a store are held: allocated one by one (Map_Create), carved from an arena (Map_CreateWithArena) or referenced as THANDLE(RC_STRING) (Map_CreateWithRcStrings)*/
+MU_DEFINE_ENUM(MAP_STORAGE_TYPE, MAP_STORAGE_TYPE_VALUES)
+
+/*a block of memory from which the keys and values of a map created by Map_CreateWithArena are carved. Strings are never freed one by one: their bytes are accounted as garbage and the arena is repacked once garbage dominates*/
+typedef struct MAP_ARENA_CHUNK_TAG
+{
+    struct MAP_ARENA_CHUNK_TAG* next; /*the chunk allocated before this one*/
+    size_t size; /*number of bytes in data*/
+    size_t used; /*number of bytes of data handed out*/
+    char data[];
+}MAP_ARENA_CHUNK;
+
+/*the pairs of a map and the indexes over them. Map_Clone makes the clone share the store of the original, a store shared by more than one map is never modified: the first change to either map gives it a private copy*/
+typedef struct MAP_STORE_TAG
 {
-    char** keys;
+    volatile_atomic int32_t refCount; /*number of maps sharing this store*/
+    char** keys; /*deleted entries leave a NULL (tombstone) behind until the storage is compacted*/
     char** values;
-    size_t count;
+    size_t count; /*number of <key,value> pairs in the map*/
+    size_t used; /*number of slots of keys/values in use, count + number of tombstones*/
+    size_t capacity; /*number of slots allocated in keys/values*/
+    size_t* keyIndex; /*open addressing (linear probing) hash table over "keys", NULL until the map has MAP_KEY_INDEX_MIN_COUNT keys*/
+    size_t keyIndexSize; /*number of slots in keyIndex, a power of 2 kept at least twice the number of keys*/
+    size_t* valueIndex; /*open addressing hash table over "values", NULL unless Map_EnableValueIndex was called. Slots of overwritten or deleted values go stale and are dropped at the next rebuild*/
+    size_t valueIndexSize; /*number of slots in valueIndex, a power of 2*/
+    size_t valueIndexUsed; /*number of slots of valueIndex in use, including the stale ones*/
+    MAP_STORAGE_TYPE storageType;
+    MAP_ARENA_CHUNK* arena; /*the chunk strings are carved from, followed by the older chunks. NULL until the first string is added*/
+    size_t arenaUsed; /*number of bytes handed out by all the chunks*/
+    size_t arenaLive; /*number of bytes of arenaUsed still holding keys and values, the rest is garbage*/
+    THANDLE(RC_STRING)* rcKeys; /*MAP_STORAGE_TYPE_RC_STRING only: parallel to keys, keys[i] is rcKeys[i]->string. Tombstones are NULL*/
+    THANDLE(RC_STRING)* rcValues; /*MAP_STORAGE_TYPE_RC_STRING only: parallel to values, values[i] is rcValues[i]->string*/
+}MAP_STORE;
+
+typedef struct MAP_HANDLE_DATA_TAG
+{
+    MAP_STORE* store;
     MAP_FILTER_CALLBACK mapFilterCallback;
 }MAP_HANDLE_DATA;
 
 #define LOG_MAP_ERROR LogError("result = %" PRI_MU_ENUM "", MU_ENUM_VALUE(MAP_RESULT, result));
 
+static MAP_STORE* Map_StoreCreate(MAP_STORAGE_TYPE storageType)
+{
+    MAP_STORE* result = malloc(sizeof(MAP_STORE));
+    if (result == NULL)
+    {
+        LogError("failure in malloc(sizeof(MAP_STORE)=%zu)", sizeof(MAP_STORE));
+    }
+    else
+    {
+        result->keys = NULL;
+        result->values = NULL;
+        result->count = 0;
+        result->used = 0;
+        result->capacity = 0;
+        result->keyIndex = NULL;
+        result->keyIndexSize = 0;
+        result->valueIndex = NULL;
+        result->valueIndexSize = 0;
+        result->valueIndexUsed = 0;
+        result->storageType = storageType;
+        result->arena = NULL;
+        result->arenaUsed = 0;
+        result->arenaLive = 0;
+        result->rcKeys = NULL;
+        result->rcValues = NULL;
+        (void)interlocked_exchange(&result->refCount, 1);
+    }
+    return result;
+}
+
+static void Map_ArenaFree(MAP_ARENA_CHUNK* chunk)
+{
+    while (chunk != NULL)
+    {
+        MAP_ARENA_CHUNK* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+static MAP_ARENA_CHUNK* Map_ArenaCreateChunk(size_t size, MAP_ARENA_CHUNK* next)
+{
+    MAP_ARENA_CHUNK* result = malloc_flex(sizeof(MAP_ARENA_CHUNK), size, 1);
+    if (result == NULL)
+    {
+        LogError("failure in malloc_flex(sizeof(MAP_ARENA_CHUNK)=%zu, size=%zu, 1)", sizeof(MAP_ARENA_CHUNK), size);
+    }
+    else
+    {
+        result->next = next;
+        result->size = size;
+        result->used = 0;
+    }
+    return result;
+}
+
+/*makes a copy of source that belongs to the store: carved from the arena or allocated by itself*/
+static char* Map_StoreCopyString(MAP_STORE* store, const char* source)
+{
+    char* result;
+    if (store->storageType != MAP_STORAGE_TYPE_ARENA)
+    {
+        result = sprintf_char("%s", source);
+        if (result == NULL)
+        {
+            LogError("failure in sprintf_char(\"%%s\", source)");
+        }
+    }
+    else
+    {
+        size_t size = strlen(source) + 1;
+        if (
+            (store->arena != NULL) &&
+            (store->arena->size - store->arena->used >= size)
+            )
+        {
+            /*there is room in the current chunk*/
+        }
+        else
+        {
+            /*Codes_SRS_MAP_11_044: [ When the arena has no room for a key or value, the map shall add a chunk of at least twice the size of the last chunk to the arena. ]*/
+            size_t newSize = (store->arena == NULL) ? MAP_ARENA_MIN_CHUNK_SIZE : store->arena->size * 2;
+            MAP_ARENA_CHUNK* newChunk;
+            if (newSize < size)
+            {
+                newSize = size;
+            }
+            newChunk = Map_ArenaCreateChunk(newSize, store->arena);
+            if (newChunk == NULL)
+            {
+                LogError("unable to make room for %zu bytes in the arena", size);
+            }
+            else
+            {
+                store->arena = newChunk;
+            }
+        }
+
+        if (
+            (store->arena == NULL) ||
+            (store->arena->size - store->arena->used < size)
+            )
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = store->arena->data + store->arena->used;
+            (void)memcpy(result, source, size);
+            store->arena->used += size;
+            store->arenaUsed += size;
+            store->arenaLive += size;
+        }
+    }
+    return result;
+}
+
+/*releases a key or value of the store. Strings carved from the arena become garbage*/
+static void Map_StoreReleaseString(MAP_STORE* store, char* source)
+{
+    if (store->storageType != MAP_STORAGE_TYPE_ARENA)
+    {
+        free(source);
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_046: [ Map_Delete and Map_AddOrUpdate shall not move the keys and values of a map created by Map_CreateWithArena, the bytes of the keys and values they release stay in the arena until Map_CompactArena is called. ]*/
+        store->arenaLive -= strlen(source) + 1;
+    }
+}
+
+/*copies the keys and values of source into a single new chunk of "extra" more bytes than they need and makes keys/values (which can be those of source) point at the copies. Returns NULL if it fails or if there is nothing to copy*/
+static MAP_ARENA_CHUNK* Map_ArenaCopyStrings(const MAP_STORE* source, char** keys, char** values, size_t extra)
+{
+    MAP_ARENA_CHUNK* result;
+    if (source->arenaLive == 0)
+    {
+        result = NULL;
+    }
+    else if ((result = Map_ArenaCreateChunk(source->arenaLive + extra, NULL)) == NULL)
+    {
+        LogError("failure in Map_ArenaCreateChunk(source->arenaLive=%zu + extra=%zu, NULL)", source->arenaLive, extra);
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < source->used; i++)
+        {
+            if (source->keys[i] != NULL)
+            {
+                size_t keySize = strlen(source->keys[i]) + 1;
+                size_t valueSize = strlen(source->values[i]) + 1;
+                (void)memcpy(result->data + result->used, source->keys[i], keySize);
+                keys[i] = result->data + result->used;
+                result->used += keySize;
+                (void)memcpy(result->data + result->used, source->values[i], valueSize);
+                values[i] = result->data + result->used;
+                result->used += valueSize;
+            }
+        }
+    }
+    return result;
+}
+
+/*moves the keys and values of the store to a new chunk and frees the old chunks, nothing to do if the arena holds no garbage*/
+static int Map_ArenaCompact(MAP_STORE* store)
+{
+    int result;
+    if (store->arenaUsed == store->arenaLive)
+    {
+        result = 0;
+    }
+    else
+    {
+        MAP_ARENA_CHUNK* newChunk = Map_ArenaCopyStrings(store, store->keys, store->values, store->arenaLive);
+        if (
+            (newChunk == NULL) &&
+            (store->arenaLive != 0)
+            )
+        {
+            LogError("failure in Map_ArenaCopyStrings(store=%p, store->keys=%p, store->values=%p, store->arenaLive=%zu)",
+                store, (void*)store->keys, (void*)store->values, store->arenaLive);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            Map_ArenaFree(store->arena);
+            store->arena = newChunk;
+            store->arenaUsed = store->arenaLive;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static void Map_StoreDestroy(MAP_STORE* store)
+{
+    if (store->storageType == MAP_STORAGE_TYPE_ARENA)
+    {
+        /*Codes_SRS_MAP_11_045: [ Map_Destroy shall free the chunks of the arena instead of freeing keys and values one by one. ]*/
+        Map_ArenaFree(store->arena);
+    }
+    else if (store->storageType == MAP_STORAGE_TYPE_RC_STRING)
+    {
+        size_t i;
+        for (i = 0; i < store->used; i++)
+        {
+            if (store->keys[i] != NULL)
+            {
+                /*Codes_SRS_MAP_11_059: [ Map_Destroy shall release the references to the keys and values of a map created by Map_CreateWithRcStrings by calling THANDLE_ASSIGN(RC_STRING) with NULL. ]*/
+                THANDLE_ASSIGN(RC_STRING)(&store->rcKeys[i], NULL);
+                THANDLE_ASSIGN(RC_STRING)(&store->rcValues[i], NULL);
+            }
+        }
+        free((void*)store->rcKeys);
+        free((void*)store->rcValues);
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < store->used; i++)
+        {
+            if (store->keys[i] != NULL)
+            {
+                free(store->keys[i]);
+                free(store->values[i]);
+            }
+        }
+    }
+    free(store->keys);
+    free(store->values);
+    free(store->keyIndex);
+    free(store->valueIndex);
+    free(store);
+}
+
+/*releases the reference of one map to the store, the last one destroys it*/
+static void Map_StoreDecRef(MAP_STORE* store)
+{
+    if (interlocked_decrement(&store->refCount) == 0)
+    {
+        Map_StoreDestroy(store);
+    }
+}
+
 MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
 {
     /*Codes_SRS_MAP_02_001: [Map_Create shall create a new, empty map.]*/
     MAP_HANDLE_DATA* result = malloc(sizeof(MAP_HANDLE_DATA));
     /*Codes_SRS_MAP_02_002: [If during creation there are any error, then Map_Create shall return NULL.]*/
-    if (result != NULL)
+    if (result == NULL)
+    {
+        LogError("failure in malloc(sizeof(MAP_HANDLE_DATA)=%zu)", sizeof(MAP_HANDLE_DATA));
+    }
+    /*Codes_SRS_MAP_11_023: [ Map_Create shall create a store for the pairs of the map. ]*/
+    else if ((result->store = Map_StoreCreate(MAP_STORAGE_TYPE_COPIED)) == NULL)
+    {
+        /*Codes_SRS_MAP_02_002: [If during creation there are any error, then Map_Create shall return NULL.]*/
+        LogError("failure in Map_StoreCreate(MAP_STORAGE_TYPE_COPIED)");
+        free(result);
+        result = NULL;
+    }
+    else
     {
         /*Codes_SRS_MAP_02_003: [Otherwise, it shall return a non-NULL handle that can be used in subsequent calls.] */
-        result->keys = NULL;
-        result->values = NULL;
-        result->count = 0;
         result->mapFilterCallback = mapFilterFunc;
     }
     return (MAP_HANDLE)result;
@@ -50,405 +366,1858 @@ void Map_Destroy(MAP_HANDLE handle)
     {
         /*Codes_SRS_MAP_02_004: [Map_Destroy shall release all resources associated with the map.] */
         MAP_HANDLE_DATA* handleData = handle;
-        size_t i;
+        /*Codes_SRS_MAP_11_024: [ Map_Destroy shall release the store of the map only if no clone of the map shares it. ]*/
+        Map_StoreDecRef(handleData->store);
+        free(handleData);
+    }
+}
+
+/*FNV-1a, the key index only needs a cheap hash with good dispersion for short strings*/
+static size_t Map_HashString(const char* source)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    while (*source != '\0')
+    {
+        hash ^= (unsigned char)*source;
+        hash *= 1099511628211ULL;
+        source++;
+    }
+    return (size_t)hash;
+}
+
+/*places the string at "position" in keys (or values) in the key (or value) index. The index always has at least one empty slot*/
+static void Map_IndexInsert(size_t* index, size_t indexSize, const char* source, size_t position)
+{
+    size_t slot = Map_HashString(source) & (indexSize - 1);
+    while (index[slot] != MAP_KEY_INDEX_EMPTY)
+    {
+        slot = (slot + 1) & (indexSize - 1);
+    }
+    index[slot] = position + 1;
+}
 
-        for (i = 0; i < handleData->count; i++)
+/*rebuilds the key index in place from the current content of keys. Used when positions of keys change*/
+static void Map_KeyIndexRebuild(MAP_STORE* store)
+{
+    size_t i;
+    (void)memset(store->keyIndex, 0, store->keyIndexSize * sizeof(size_t));
+    for (i = 0; i < store->used; i++)
+    {
+        if (store->keys[i] != NULL)
         {
-            free(handleData->keys[i]);
-            free(handleData->values[i]);
+            Map_IndexInsert(store->keyIndex, store->keyIndexSize, store->keys[i], i);
         }
-        free(handleData->keys);
-        free(handleData->values);
-        free(handleData);
     }
 }
 
-/*makes a copy of a vector of const char*, having size "size". source cannot be NULL*/
-/*returns NULL if it fails*/
-static char** Map_CloneVector(const char*const * source, size_t count)
+/*makes sure that the key index can accommodate "newCount" keys while staying at most half full. Does nothing for small maps*/
+static int Map_KeyIndexReserve(MAP_STORE* store, size_t newCount)
 {
-    char** result;
-    result = malloc_2(count, sizeof(char*));
-    if (result == NULL)
+    int result;
+    if (
+        (newCount < MAP_KEY_INDEX_MIN_COUNT) ||
+        ((store->keyIndex != NULL) && (newCount <= store->keyIndexSize / 2))
+        )
     {
-        LogError("failure in malloc_2(count=%zu, sizeof(char*)=%zu);",
-            count, sizeof(char*));
-        /*do nothing, just return it (NULL)*/
+        /*nothing to do, either the map is small or the key index is big enough*/
+        result = 0;
     }
     else
     {
-        size_t i;
-        for (i = 0; i < count; i++)
+        size_t newSize = (store->keyIndexSize == 0) ? MAP_KEY_INDEX_MIN_SIZE : store->keyIndexSize;
+        while (newSize / 2 < newCount)
         {
-            if ((result[i] = sprintf_char("%s", source[i])) == NULL)
-            {
-                break;
-            }
+            newSize *= 2;
         }
 
-        if (i == count)
+        size_t* newKeyIndex = malloc_2(newSize, sizeof(size_t));
+        if (newKeyIndex == NULL)
         {
-            /*it is all good, proceed to return result*/
+            LogError("failure in malloc_2(newSize=%zu, sizeof(size_t)=%zu);",
+                newSize, sizeof(size_t));
+            result = MU_FAILURE;
         }
         else
         {
-            size_t j;
-            for (j = 0; j < i; j++)
-            {
-                free(result[j]);
-            }
-            free(result);
-            result = NULL;
+            free(store->keyIndex);
+            store->keyIndex = newKeyIndex;
+            store->keyIndexSize = newSize;
+            Map_KeyIndexRebuild(store);
+            result = 0;
         }
     }
     return result;
 }
 
-/*Codes_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
-MAP_HANDLE Map_Clone(MAP_HANDLE handle)
+/*rebuilds the value index in place from the current content of values, dropping the stale slots*/
+static void Map_ValueIndexRebuild(MAP_STORE* store)
 {
-    MAP_HANDLE_DATA* result;
-    if (handle == NULL)
+    size_t i;
+    (void)memset(store->valueIndex, 0, store->valueIndexSize * sizeof(size_t));
+    for (i = 0; i < store->used; i++)
     {
-        /*Codes_SRS_MAP_02_038: [Map_Clone returns NULL if parameter handle is NULL.]*/
-        result = NULL;
-        LogError("invalid arg to Map_Clone (NULL)");
+        if (store->values[i] != NULL)
+        {
+            Map_IndexInsert(store->valueIndex, store->valueIndexSize, store->values[i], i);
+        }
+    }
+    store->valueIndexUsed = store->count;
+}
+
+/*returns the number of slots of a value index that can hold "count" values while being at most a quarter full*/
+static size_t Map_ValueIndexSizeFor(size_t count)
+{
+    size_t result = MAP_VALUE_INDEX_MIN_SIZE;
+    while (result / 4 < count)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+/*makes sure that one more slot can be used in the value index while keeping it at most half full. Does nothing if the map has no value index*/
+static int Map_ValueIndexReserve(MAP_STORE* store)
+{
+    int result;
+    if (
+        (store->valueIndex == NULL) ||
+        (store->valueIndexUsed + 1 <= store->valueIndexSize / 2)
+        )
+    {
+        result = 0;
     }
     else
     {
-        MAP_HANDLE_DATA * handleData = handle;
-        result = malloc(sizeof(MAP_HANDLE_DATA));
-        if (result == NULL)
+        size_t newSize = Map_ValueIndexSizeFor(store->count + 1);
+        if (newSize == store->valueIndexSize)
         {
-            /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-            /*do nothing, proceed to return it, this is an error case*/
-            LogError("unable to malloc");
+            /*the index is clogged by stale slots, dropping them makes enough room*/
+            Map_ValueIndexRebuild(store);
+            result = 0;
         }
         else
         {
-            if (handleData->count == 0)
+            size_t* newValueIndex = malloc_2(newSize, sizeof(size_t));
+            if (newValueIndex == NULL)
             {
-                result->count = 0;
-                result->keys = NULL;
-                result->values = NULL;
-                result->mapFilterCallback = NULL;
+                LogError("failure in malloc_2(newSize=%zu, sizeof(size_t)=%zu);",
+                    newSize, sizeof(size_t));
+                result = MU_FAILURE;
             }
             else
             {
-                result->mapFilterCallback = handleData->mapFilterCallback;
-                result->count = handleData->count;
-                if( (result->keys = Map_CloneVector((const char* const*)handleData->keys, handleData->count))==NULL)
-                {
-                    /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-                    LogError("unable to clone keys");
-                    free(result);
-                    result = NULL;
-                }
-                else if ((result->values = Map_CloneVector((const char* const*)handleData->values, handleData->count)) == NULL)
-                {
-                    size_t i;
-                    /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-                    LogError("unable to clone values");
-                    for (i = 0; i < result->count; i++)
-                    {
-                        free(result->keys[i]);
-                    }
-                    free(result->keys);
-                    free(result);
-                    result = NULL;
-                }
-                else
-                {
-                    /*all fine, return it*/
-                }
+                free(store->valueIndex);
+                store->valueIndex = newValueIndex;
+                store->valueIndexSize = newSize;
+                Map_ValueIndexRebuild(store);
+                result = 0;
             }
         }
     }
-    return (MAP_HANDLE)result;
+    return result;
+}
+
+/*records that the value at "position" has just been written*/
+static void Map_ValueIndexAdd(MAP_STORE* store, size_t position)
+{
+    if (store->valueIndex != NULL)
+    {
+        Map_IndexInsert(store->valueIndex, store->valueIndexSize, store->values[position], position);
+        store->valueIndexUsed++;
+    }
 }
 
-static int Map_IncreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
+/*grows (or allocates, if they are NULL) rcKeys and rcValues to "capacity" slots. If growing rcValues fails then rcKeys stays bigger than rcValues, the next growth reallocs it to the same size*/
+static int Map_RcStringsReserve(MAP_STORE* store, size_t capacity)
 {
     int result;
-    char** newKeys = realloc_flex(handleData->keys, sizeof(char*), handleData->count , sizeof(char*));
-    if (newKeys == NULL)
+    THANDLE(RC_STRING)* newRcKeys = realloc_2((void*)store->rcKeys, capacity, sizeof(THANDLE(RC_STRING)));
+    if (newRcKeys == NULL)
     {
-        LogError("failure in realloc_flex(handleData->keys=%p, sizeof(char*)=%zu, handleData->count=%zu , sizeof(char*)=%zu);",
-            handleData->keys, sizeof(char*), handleData->count, sizeof(char*));
+        LogError("failure in realloc_2(store->rcKeys=%p, capacity=%zu, sizeof(THANDLE(RC_STRING))=%zu);",
+            (void*)store->rcKeys, capacity, sizeof(THANDLE(RC_STRING)));
         result = MU_FAILURE;
     }
     else
     {
-        char** newValues;
-        handleData->keys = newKeys;
-        handleData->keys[handleData->count] = NULL;
-        newValues = realloc_flex(handleData->values, sizeof(char*), handleData->count, sizeof(char*));
-        if (newValues == NULL)
+        THANDLE(RC_STRING)* newRcValues;
+        store->rcKeys = newRcKeys;
+        newRcValues = realloc_2((void*)store->rcValues, capacity, sizeof(THANDLE(RC_STRING)));
+        if (newRcValues == NULL)
         {
-            LogError("failure in realloc_flex(handleData->values=%p, sizeof(char*)=%zu, handleData->count=%zu, sizeof(char*)=%zu);",
-                handleData->values, sizeof(char*), handleData->count, sizeof(char*));
-            if (handleData->count == 0) /*avoiding an implementation defined behavior */
-            {
-                free(handleData->keys);
-                handleData->keys = NULL;
-            }
-            else
-            {
-                char** undoneKeys = realloc_2(handleData->keys, handleData->count, sizeof(char*));
-                if (undoneKeys == NULL)
-                {
-                    LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size");
-                }
-                else
-                {
-                    handleData->keys = undoneKeys;
-                }
-            }
+            LogError("failure in realloc_2(store->rcValues=%p, capacity=%zu, sizeof(THANDLE(RC_STRING))=%zu);",
+                (void*)store->rcValues, capacity, sizeof(THANDLE(RC_STRING)));
             result = MU_FAILURE;
         }
         else
         {
-            handleData->values = newValues;
-            handleData->values[handleData->count] = NULL;
-            handleData->count++;
-            result = 0;
+            store->rcValues = newRcValues;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*stores in *destination a new reference to source or, when source is NULL, a THANDLE(RC_STRING) holding a copy of string*/
+static int Map_RcStringInitialize(THANDLE(RC_STRING)* destination, THANDLE(RC_STRING) source, const char* string)
+{
+    int result;
+    if (source != NULL)
+    {
+        THANDLE_INITIALIZE(RC_STRING)(destination, source);
+        result = 0;
+    }
+    else
+    {
+        THANDLE(RC_STRING) temp = rc_string_create(string);
+        if (temp == NULL)
+        {
+            LogError("failure in rc_string_create(string=%s)", string);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            THANDLE_INITIALIZE_MOVE(RC_STRING)(destination, &temp);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*squeezes out the tombstones left by Map_Delete so that keys and values are dense again, keeping the order of the pairs. Does not allocate*/
+static void Map_Compact(MAP_STORE* store)
+{
+    if (store->used != store->count)
+    {
+        size_t i;
+        size_t j = 0;
+        for (i = 0; i < store->used; i++)
+        {
+            if (store->keys[i] != NULL)
+            {
+                store->keys[j] = store->keys[i];
+                store->values[j] = store->values[i];
+                if (
+                    (store->storageType == MAP_STORAGE_TYPE_RC_STRING) &&
+                    (j != i)
+                    )
+                {
+                    THANDLE_INITIALIZE_MOVE(RC_STRING)(&store->rcKeys[j], &store->rcKeys[i]);
+                    THANDLE_INITIALIZE_MOVE(RC_STRING)(&store->rcValues[j], &store->rcValues[i]);
+                }
+                j++;
+            }
+        }
+        store->used = store->count;
+        if (store->keyIndex != NULL)
+        {
+            Map_KeyIndexRebuild(store);
+        }
+        if (store->valueIndex != NULL)
+        {
+            Map_ValueIndexRebuild(store);
+        }
+    }
+}
+
+MAP_HANDLE Map_CreateWithCapacity(MAP_FILTER_CALLBACK mapFilterFunc, size_t capacity)
+{
+    /*Codes_SRS_MAP_11_006: [ Map_CreateWithCapacity shall create a new, empty map that can hold capacity pairs without growing its storage. ]*/
+    MAP_HANDLE_DATA* result = (MAP_HANDLE_DATA*)Map_Create(mapFilterFunc);
+    if (result == NULL)
+    {
+        /*Codes_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+        LogError("failure in Map_Create(mapFilterFunc), capacity=%zu", capacity);
+    }
+    else
+    {
+        MAP_STORE* store = result->store;
+        if (capacity == 0)
+        {
+            /*Codes_SRS_MAP_11_007: [ If capacity is 0 then Map_CreateWithCapacity shall not allocate storage for keys and values. ]*/
+        }
+        else if ((store->keys = malloc_2(capacity, sizeof(char*))) == NULL)
+        {
+            /*Codes_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+            LogError("failure in malloc_2(capacity=%zu, sizeof(char*)=%zu);",
+                capacity, sizeof(char*));
+            Map_Destroy(result);
+            result = NULL;
+        }
+        else if ((store->values = malloc_2(capacity, sizeof(char*))) == NULL)
+        {
+            /*Codes_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+            LogError("failure in malloc_2(capacity=%zu, sizeof(char*)=%zu);",
+                capacity, sizeof(char*));
+            Map_Destroy(result);
+            result = NULL;
+        }
+        /*Codes_SRS_MAP_11_008: [ If capacity is at least 8 then Map_CreateWithCapacity shall also create a key index that can hold capacity keys. ]*/
+        else if (Map_KeyIndexReserve(store, capacity) != 0)
+        {
+            /*Codes_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+            LogError("failure in Map_KeyIndexReserve(store=%p, capacity=%zu)", store, capacity);
+            Map_Destroy(result);
+            result = NULL;
+        }
+        else
+        {
+            store->capacity = capacity;
+        }
+    }
+    return (MAP_HANDLE)result;
+}
+
+MAP_HANDLE Map_CreateWithArena(MAP_FILTER_CALLBACK mapFilterFunc, size_t capacity, size_t arenaSize)
+{
+    /*Codes_SRS_MAP_11_042: [ Map_CreateWithArena shall create a new, empty map like Map_CreateWithCapacity does, whose keys and values are stored in an arena of arenaSize bytes owned by the map. ]*/
+    MAP_HANDLE_DATA* result = (MAP_HANDLE_DATA*)Map_CreateWithCapacity(mapFilterFunc, capacity);
+    if (result == NULL)
+    {
+        /*Codes_SRS_MAP_11_049: [ If there are any failures then Map_CreateWithArena shall fail and return NULL. ]*/
+        LogError("failure in Map_CreateWithCapacity(mapFilterFunc, capacity=%zu), arenaSize=%zu", capacity, arenaSize);
+    }
+    else
+    {
+        result->store->storageType = MAP_STORAGE_TYPE_ARENA;
+        if (arenaSize == 0)
+        {
+            /*Codes_SRS_MAP_11_050: [ If arenaSize is 0 then Map_CreateWithArena shall not allocate the arena, the first key added allocates it. ]*/
+        }
+        else if ((result->store->arena = Map_ArenaCreateChunk(arenaSize, NULL)) == NULL)
+        {
+            /*Codes_SRS_MAP_11_049: [ If there are any failures then Map_CreateWithArena shall fail and return NULL. ]*/
+            LogError("failure in Map_ArenaCreateChunk(arenaSize=%zu, NULL)", arenaSize);
+            Map_Destroy(result);
+            result = NULL;
+        }
+        else
+        {
+            /*all done*/
+        }
+    }
+    return (MAP_HANDLE)result;
+}
+
+MAP_HANDLE Map_CreateWithRcStrings(MAP_FILTER_CALLBACK mapFilterFunc, size_t capacity)
+{
+    /*Codes_SRS_MAP_11_051: [ Map_CreateWithRcStrings shall create a new, empty map like Map_CreateWithCapacity does, whose keys and values are stored as THANDLE(RC_STRING). ]*/
+    MAP_HANDLE_DATA* result = (MAP_HANDLE_DATA*)Map_CreateWithCapacity(mapFilterFunc, capacity);
+    if (result == NULL)
+    {
+        /*Codes_SRS_MAP_11_053: [ If there are any failures then Map_CreateWithRcStrings shall fail and return NULL. ]*/
+        LogError("failure in Map_CreateWithCapacity(mapFilterFunc, capacity=%zu)", capacity);
+    }
+    else
+    {
+        result->store->storageType = MAP_STORAGE_TYPE_RC_STRING;
+        if (capacity == 0)
+        {
+            /*nothing to allocate, the first key added allocates it*/
+        }
+        /*Codes_SRS_MAP_11_052: [ If capacity is not 0 then Map_CreateWithRcStrings shall allocate room for capacity THANDLE(RC_STRING) keys and values. ]*/
+        else if (Map_RcStringsReserve(result->store, capacity) != 0)
+        {
+            /*Codes_SRS_MAP_11_053: [ If there are any failures then Map_CreateWithRcStrings shall fail and return NULL. ]*/
+            LogError("failure in Map_RcStringsReserve(result->store=%p, capacity=%zu)", result->store, capacity);
+            Map_Destroy(result);
+            result = NULL;
+        }
+        else
+        {
+            /*all done*/
+        }
+    }
+    return (MAP_HANDLE)result;
+}
+
+/*makes a copy of a vector of const char*, having size "size". source cannot be NULL*/
+/*returns NULL if it fails*/
+static char** Map_CloneVector(const char*const * source, size_t count)
+{
+    char** result;
+    result = malloc_2(count, sizeof(char*));
+    if (result == NULL)
+    {
+        LogError("failure in malloc_2(count=%zu, sizeof(char*)=%zu);",
+            count, sizeof(char*));
+        /*do nothing, just return it (NULL)*/
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < count; i++)
+        {
+            if ((result[i] = sprintf_char("%s", source[i])) == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i == count)
+        {
+            /*it is all good, proceed to return result*/
+        }
+        else
+        {
+            size_t j;
+            for (j = 0; j < i; j++)
+            {
+                free(result[j]);
+            }
+            free(result);
+            result = NULL;
+        }
+    }
+    return result;
+}
+
+/*copies the keys and values of source (which has no tombstones) in destination, an empty store in the same mode as source*/
+static int Map_StoreCloneStrings(MAP_STORE* destination, const MAP_STORE* source)
+{
+    int result;
+    if (source->storageType == MAP_STORAGE_TYPE_COPIED)
+    {
+        if ((destination->keys = Map_CloneVector((const char* const*)source->keys, source->count)) == NULL)
+        {
+            LogError("unable to clone keys");
+            result = MU_FAILURE;
+        }
+        else if ((destination->values = Map_CloneVector((const char* const*)source->values, source->count)) == NULL)
+        {
+            size_t i;
+            LogError("unable to clone values");
+            for (i = 0; i < source->count; i++)
+            {
+                free(destination->keys[i]);
+            }
+            free(destination->keys);
+            destination->keys = NULL;
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    else if (source->storageType == MAP_STORAGE_TYPE_ARENA)
+    {
+        /*Codes_SRS_MAP_11_047: [ The private copy of the store of a map created by Map_CreateWithArena shall have its keys and values copied in a single chunk. ]*/
+        if ((destination->keys = malloc_2(source->count, sizeof(char*))) == NULL)
+        {
+            LogError("failure in malloc_2(source->count=%zu, sizeof(char*)=%zu);",
+                source->count, sizeof(char*));
+            result = MU_FAILURE;
+        }
+        else if ((destination->values = malloc_2(source->count, sizeof(char*))) == NULL)
+        {
+            LogError("failure in malloc_2(source->count=%zu, sizeof(char*)=%zu);",
+                source->count, sizeof(char*));
+            free(destination->keys);
+            destination->keys = NULL;
+            result = MU_FAILURE;
+        }
+        else if ((destination->arena = Map_ArenaCopyStrings(source, destination->keys, destination->values, 0)) == NULL)
+        {
+            LogError("failure in Map_ArenaCopyStrings(source=%p, destination->keys=%p, destination->values=%p, 0)",
+                source, destination->keys, destination->values);
+            free(destination->values);
+            destination->values = NULL;
+            free(destination->keys);
+            destination->keys = NULL;
+            result = MU_FAILURE;
+        }
+        else
+        {
+            destination->arenaUsed = source->arenaLive;
+            destination->arenaLive = source->arenaLive;
+            result = 0;
+        }
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_058: [ The private copy of the store of a map created by Map_CreateWithRcStrings shall take new references to the keys and values of the shared store by calling THANDLE_INITIALIZE(RC_STRING) instead of copying them. ]*/
+        if ((destination->keys = malloc_2(source->count, sizeof(char*))) == NULL)
+        {
+            LogError("failure in malloc_2(source->count=%zu, sizeof(char*)=%zu);",
+                source->count, sizeof(char*));
+            result = MU_FAILURE;
+        }
+        else if ((destination->values = malloc_2(source->count, sizeof(char*))) == NULL)
+        {
+            LogError("failure in malloc_2(source->count=%zu, sizeof(char*)=%zu);",
+                source->count, sizeof(char*));
+            free(destination->keys);
+            destination->keys = NULL;
+            result = MU_FAILURE;
+        }
+        else if (Map_RcStringsReserve(destination, source->count) != 0)
+        {
+            LogError("failure in Map_RcStringsReserve(destination=%p, source->count=%zu)", destination, source->count);
+            free((void*)destination->rcKeys);
+            destination->rcKeys = NULL;
+            free(destination->values);
+            destination->values = NULL;
+            free(destination->keys);
+            destination->keys = NULL;
+            result = MU_FAILURE;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; i < source->count; i++)
+            {
+                THANDLE_INITIALIZE(RC_STRING)(&destination->rcKeys[i], source->rcKeys[i]);
+                THANDLE_INITIALIZE(RC_STRING)(&destination->rcValues[i], source->rcValues[i]);
+                /*the strings belong to the RC_STRINGs, both stores point at them*/
+                destination->keys[i] = source->keys[i];
+                destination->values[i] = source->values[i];
+            }
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*makes a private copy of a store that is shared by several maps. A shared store has no tombstones*/
+/*returns NULL if it fails*/
+static MAP_STORE* Map_StoreClone(const MAP_STORE* source)
+{
+    MAP_STORE* result = Map_StoreCreate(source->storageType);
+    if (result == NULL)
+    {
+        LogError("failure in Map_StoreCreate(source->storageType=%d)", (int)source->storageType);
+    }
+    else if (source->count == 0)
+    {
+        /*nothing to copy, only the value index is kept (below)*/
+    }
+    else if (Map_StoreCloneStrings(result, source) != 0)
+    {
+        LogError("failure in Map_StoreCloneStrings(result=%p, source=%p)", result, source);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->count = source->count;
+        result->used = source->count;
+        result->capacity = source->count;
+        if (source->keyIndex != NULL)
+        {
+            /*Codes_SRS_MAP_11_004: [ If the map has a key index then the private copy of the store shall have a copy of the key index. ]*/
+            if ((result->keyIndex = malloc_2(source->keyIndexSize, sizeof(size_t))) == NULL)
+            {
+                LogError("failure in malloc_2(source->keyIndexSize=%zu, sizeof(size_t)=%zu);",
+                    source->keyIndexSize, sizeof(size_t));
+                Map_StoreDestroy(result);
+                result = NULL;
+            }
+            else
+            {
+                (void)memcpy(result->keyIndex, source->keyIndex, source->keyIndexSize * sizeof(size_t));
+                result->keyIndexSize = source->keyIndexSize;
+            }
+        }
+    }
+
+    if (
+        (result != NULL) &&
+        (source->valueIndex != NULL)
+        )
+    {
+        /*Codes_SRS_MAP_11_021: [ If the map has a value index then the private copy of the store shall have a copy of the value index. ]*/
+        if ((result->valueIndex = malloc_2(source->valueIndexSize, sizeof(size_t))) == NULL)
+        {
+            LogError("failure in malloc_2(source->valueIndexSize=%zu, sizeof(size_t)=%zu);",
+                source->valueIndexSize, sizeof(size_t));
+            Map_StoreDestroy(result);
+            result = NULL;
+        }
+        else
+        {
+            (void)memcpy(result->valueIndex, source->valueIndex, source->valueIndexSize * sizeof(size_t));
+            result->valueIndexSize = source->valueIndexSize;
+            result->valueIndexUsed = source->valueIndexUsed;
+        }
+    }
+    return result;
+}
+
+/*gives the map a store of its own before the store is modified. Does nothing if the map is the only user of its store*/
+static int Map_UnshareStore(MAP_HANDLE_DATA* handleData)
+{
+    int result;
+    /*the count can drop concurrently (a clone is destroyed) but it cannot rise to more than 1 without going through this map*/
+    if (interlocked_add(&handleData->store->refCount, 0) == 1)
+    {
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+        MAP_STORE* newStore = Map_StoreClone(handleData->store);
+        if (newStore == NULL)
+        {
+            LogError("failure in Map_StoreClone(handleData->store=%p)", handleData->store);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            Map_StoreDecRef(handleData->store);
+            handleData->store = newStore;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*Codes_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+MAP_HANDLE Map_Clone(MAP_HANDLE handle)
+{
+    MAP_HANDLE_DATA* result;
+    if (handle == NULL)
+    {
+        /*Codes_SRS_MAP_02_038: [Map_Clone returns NULL if parameter handle is NULL.]*/
+        result = NULL;
+        LogError("invalid arg to Map_Clone (NULL)");
+    }
+    else
+    {
+        MAP_HANDLE_DATA * handleData = handle;
+        /*Codes_SRS_MAP_11_014: [ Map_GetInternals, Map_ToJSON and Map_Clone shall first compact the storage so that keys and values contain no tombstones. ]*/
+        Map_Compact(handleData->store);
+        result = malloc(sizeof(MAP_HANDLE_DATA));
+        if (result == NULL)
+        {
+            /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
+            /*do nothing, proceed to return it, this is an error case*/
+            LogError("unable to malloc");
+        }
+        else
+        {
+            /*Codes_SRS_MAP_11_025: [ Map_Clone shall not copy the pairs of the map, the clone shall share the store of the map indicated by handle. ]*/
+            (void)interlocked_increment(&handleData->store->refCount);
+            result->store = handleData->store;
+            result->mapFilterCallback = (handleData->store->count == 0) ? NULL : handleData->mapFilterCallback;
+        }
+    }
+    return (MAP_HANDLE)result;
+}
+
+/*makes room in keys and values for one more pair at position "used"*/
+static int Map_IncreaseStorageKeysValues(MAP_STORE* store)
+{
+    int result;
+    if (store->used < store->capacity)
+    {
+        /*there is room already*/
+        result = 0;
+    }
+    else if (
+        (store->used > store->count) &&
+        ((store->used - store->count) * 4 >= store->capacity)
+        )
+    {
+        /*Codes_SRS_MAP_11_011: [ When the storage is full and at least a quarter of it holds tombstones, Map_Add and Map_AddOrUpdate shall compact the storage instead of growing it. ]*/
+        Map_Compact(store);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_010: [ When the storage is full, Map_Add and Map_AddOrUpdate shall double the capacity of keys and values. ]*/
+        size_t newCapacity = (store->capacity == 0) ? MAP_MIN_CAPACITY : store->capacity * 2;
+        char** newKeys = realloc_2(store->keys, newCapacity, sizeof(char*));
+        if (newKeys == NULL)
+        {
+            LogError("failure in realloc_2(store->keys=%p, newCapacity=%zu, sizeof(char*)=%zu);",
+                store->keys, newCapacity, sizeof(char*));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            char** newValues;
+            /*if growing values fails then keys stays bigger than capacity, the next growth reallocs it to the same size*/
+            store->keys = newKeys;
+            newValues = realloc_2(store->values, newCapacity, sizeof(char*));
+            if (newValues == NULL)
+            {
+                LogError("failure in realloc_2(store->values=%p, newCapacity=%zu, sizeof(char*)=%zu);",
+                    store->values, newCapacity, sizeof(char*));
+                result = MU_FAILURE;
+            }
+            else
+            {
+                store->values = newValues;
+                if (
+                    (store->storageType == MAP_STORAGE_TYPE_RC_STRING) &&
+                    (Map_RcStringsReserve(store, newCapacity) != 0)
+                    )
+                {
+                    LogError("failure in Map_RcStringsReserve(store=%p, newCapacity=%zu)", store, newCapacity);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    store->capacity = newCapacity;
+                    result = 0;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static char** findKey(MAP_STORE* store, const char* key)
+{
+    char** result;
+    if (store->keys == NULL)
+    {
+        result = NULL;
+    }
+    else if (store->keyIndex != NULL)
+    {
+        /*Codes_SRS_MAP_11_003: [ Once the key index exists, Map_Add, Map_AddOrUpdate, Map_Delete, Map_ContainsKey and Map_GetValueFromKey shall locate keys by probing the key index. ]*/
+        size_t slot = Map_HashString(key) & (store->keyIndexSize - 1);
+        result = NULL;
+        while (store->keyIndex[slot] != MAP_KEY_INDEX_EMPTY)
+        {
+            size_t position = store->keyIndex[slot] - 1;
+            /*slots of deleted keys point to a tombstone, probing continues past them*/
+            if (
+                (store->keys[position] != NULL) &&
+                (strcmp(store->keys[position], key) == 0)
+                )
+            {
+                result = store->keys + position;
+                break;
+            }
+            slot = (slot + 1) & (store->keyIndexSize - 1);
+        }
+    }
+    else
+    {
+        size_t i;
+        result = NULL;
+        for (i = 0; i < store->used; i++)
+        {
+            if (
+                (store->keys[i] != NULL) &&
+                (strcmp(store->keys[i], key) == 0)
+                )
+            {
+                result = store->keys + i;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+static char** findValue(MAP_STORE* store, const char* value)
+{
+    char** result;
+    if (store->values == NULL)
+    {
+        result = NULL;
+    }
+    else if (store->valueIndex != NULL)
+    {
+        /*Codes_SRS_MAP_11_018: [ If the map has a value index then Map_ContainsValue shall locate the value by probing the value index. ]*/
+        size_t slot = Map_HashString(value) & (store->valueIndexSize - 1);
+        result = NULL;
+        while (store->valueIndex[slot] != MAP_KEY_INDEX_EMPTY)
+        {
+            size_t position = store->valueIndex[slot] - 1;
+            /*stale slots point to a tombstone or to a value that has been overwritten since, probing continues past them*/
+            if (
+                (store->values[position] != NULL) &&
+                (strcmp(store->values[position], value) == 0)
+                )
+            {
+                result = store->values + position;
+                break;
+            }
+            slot = (slot + 1) & (store->valueIndexSize - 1);
+        }
+    }
+    else
+    {
+        size_t i;
+        result = NULL;
+        for (i = 0; i < store->used; i++)
+        {
+            if (
+                (store->values[i] != NULL) &&
+                (strcmp(store->values[i], value) == 0)
+                )
+            {
+                result = store->values + i;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/*overwrites the value at "index" with a copy of value or, for MAP_STORAGE_TYPE_RC_STRING, a reference to rcValue (which is NULL when the caller only has the string)*/
+static int Map_StoreReplaceValue(MAP_STORE* store, size_t index, const char* value, THANDLE(RC_STRING) rcValue)
+{
+    int result;
+    size_t valueLength = strlen(value);
+    if (store->storageType == MAP_STORAGE_TYPE_RC_STRING)
+    {
+        THANDLE(RC_STRING) newValue = NULL;
+        if (Map_RcStringInitialize(&newValue, rcValue, value) != 0)
+        {
+            LogError("failure in Map_RcStringInitialize(&newValue, rcValue=%p, value=%s)", (void*)rcValue, value);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_MAP_11_057: [ Map_AddOrUpdate and Map_AddOrUpdateRcString shall release the reference to the value they overwrite in a map created by Map_CreateWithRcStrings by calling THANDLE_MOVE(RC_STRING). ]*/
+            THANDLE_MOVE(RC_STRING)(&store->rcValues[index], &newValue);
+            store->values[index] = (char*)store->rcValues[index]->string;
+            result = 0;
+        }
+    }
+    else if (store->storageType == MAP_STORAGE_TYPE_COPIED)
+    {
+        /*try to realloc value of this key*/
+        char* newValue = realloc_flex(store->values[index], 1, valueLength, 1);
+        if (newValue == NULL)
+        {
+            LogError("failure in realloc_flex(store->values[index], 1, valueLength=%zu, 1);",
+                valueLength);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            (void)memcpy(newValue, value, valueLength + 1);
+            store->values[index] = newValue;
+            result = 0;
+        }
+    }
+    else
+    {
+        size_t oldValueLength = strlen(store->values[index]);
+        if (valueLength <= oldValueLength)
+        {
+            /*Codes_SRS_MAP_11_048: [ Map_AddOrUpdate shall overwrite the value of a map created by Map_CreateWithArena in place when the new value is not longer than the old one. ]*/
+            (void)memcpy(store->values[index], value, valueLength + 1);
+            store->arenaLive -= oldValueLength - valueLength;
+            result = 0;
+        }
+        else
+        {
+            char* newValue = Map_StoreCopyString(store, value);
+            if (newValue == NULL)
+            {
+                LogError("failure in Map_StoreCopyString(store=%p, value=%s)", store, value);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                Map_StoreReleaseString(store, store->values[index]);
+                store->values[index] = newValue;
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+/*stores key and value in the slot at position "used", copied or, for MAP_STORAGE_TYPE_RC_STRING, referenced. rcKey and rcValue are NULL when the caller only has the strings*/
+static int Map_StoreSetPair(MAP_STORE* store, const char* key, const char* value, THANDLE(RC_STRING) rcKey, THANDLE(RC_STRING) rcValue)
+{
+    int result;
+    if (store->storageType == MAP_STORAGE_TYPE_RC_STRING)
+    {
+        /*Codes_SRS_MAP_11_054: [ Map_AddRcString and Map_AddOrUpdateRcString shall store in a map created by Map_CreateWithRcStrings new references to key and value obtained by calling THANDLE_INITIALIZE(RC_STRING) instead of copying them. ]*/
+        /*Codes_SRS_MAP_11_055: [ Map_Add and Map_AddOrUpdate shall store in a map created by Map_CreateWithRcStrings the THANDLE(RC_STRING)s created by calling rc_string_create with key and value. ]*/
+        if (Map_RcStringInitialize(&store->rcKeys[store->used], rcKey, key) != 0)
+        {
+            LogError("failure in Map_RcStringInitialize(&store->rcKeys[store->used=%zu], rcKey=%p, key=%s)", store->used, (void*)rcKey, key);
+            result = MU_FAILURE;
+        }
+        else if (Map_RcStringInitialize(&store->rcValues[store->used], rcValue, value) != 0)
+        {
+            LogError("failure in Map_RcStringInitialize(&store->rcValues[store->used=%zu], rcValue=%p, value=%s)", store->used, (void*)rcValue, value);
+            THANDLE_ASSIGN(RC_STRING)(&store->rcKeys[store->used], NULL);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            store->keys[store->used] = (char*)store->rcKeys[store->used]->string;
+            store->values[store->used] = (char*)store->rcValues[store->used]->string;
+            result = 0;
+        }
+    }
+    else
+    {
+        char* newKey;
+        char* newValue;
+        /*Codes_SRS_MAP_11_043: [ Map_Add and Map_AddOrUpdate shall copy the keys and values of a map created by Map_CreateWithArena into its arena instead of allocating them one by one. ]*/
+        if ((newKey = Map_StoreCopyString(store, key)) == NULL)
+        {
+            LogError("failure in Map_StoreCopyString(store=%p, key=%s)", store, key);
+            result = MU_FAILURE;
+        }
+        else if ((newValue = Map_StoreCopyString(store, value)) == NULL)
+        {
+            Map_StoreReleaseString(store, newKey);
+            LogError("failure in Map_StoreCopyString(store=%p, value=%s)", store, value);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            store->keys[store->used] = newKey;
+            store->values[store->used] = newValue;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static int insertNewKeyValue(MAP_STORE* store, const char* key, const char* value, THANDLE(RC_STRING) rcKey, THANDLE(RC_STRING) rcValue)
+{
+    int result;
+    /*Codes_SRS_MAP_11_001: [ When the number of keys reaches 8, Map_Add and Map_AddOrUpdate shall build a key index: an open addressing hash table that maps keys to their position in the keys array. ]*/
+    /*Codes_SRS_MAP_11_002: [ Map_Add and Map_AddOrUpdate shall grow the key index so that it is never more than half full. ]*/
+    if (Map_KeyIndexReserve(store, store->used + 1) != 0)
+    {
+        LogError("failure in Map_KeyIndexReserve(store=%p, store->used=%zu + 1)", store, store->used);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    else if (Map_ValueIndexReserve(store) != 0)
+    {
+        LogError("failure in Map_ValueIndexReserve(store=%p)", store);
+        result = MU_FAILURE;
+    }
+    else if (Map_IncreaseStorageKeysValues(store) != 0)
+    {
+        result = MU_FAILURE;
+    }
+    else if (Map_StoreSetPair(store, key, value, rcKey, rcValue) != 0)
+    {
+        LogError("failure in Map_StoreSetPair(store=%p, key=%s, value=%s, rcKey=%p, rcValue=%p)", store, key, value, (void*)rcKey, (void*)rcValue);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (store->keyIndex != NULL)
+        {
+            Map_IndexInsert(store->keyIndex, store->keyIndexSize, store->keys[store->used], store->used);
+        }
+        Map_ValueIndexAdd(store, store->used);
+        store->used++;
+        store->count++;
+        result = 0;
+    }
+    return result;
+}
+
+/*copies "length" bytes from source to the arena of the store, which has room for them and a null terminator*/
+static char* Map_ArenaCopyBytes(MAP_STORE* store, const void* source, size_t length)
+{
+    char* result = store->arena->data + store->arena->used;
+    (void)memcpy(result, source, length);
+    result[length] = '\0';
+    store->arena->used += length + 1;
+    store->arenaUsed += length + 1;
+    store->arenaLive += length + 1;
+    return result;
+}
+
+/*appends a pair whose strings already belong to the store to a store that has room for it (and for it in its key index) without allocating. Fails if the key is already in the store*/
+static int Map_StoreAppendPair(MAP_STORE* store, char* key, char* value)
+{
+    int result;
+    if (findKey(store, key) != NULL)
+    {
+        LogError("key %s appears more than once", key);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        store->keys[store->used] = key;
+        store->values[store->used] = value;
+        if (store->keyIndex != NULL)
+        {
+            Map_IndexInsert(store->keyIndex, store->keyIndexSize, key, store->used);
+        }
+        store->used++;
+        store->count++;
+        result = 0;
+    }
+    return result;
+}
+
+MAP_HANDLE Map_CreateFromArrays(MAP_FILTER_CALLBACK mapFilterFunc, const char* const* keys, const char* const* values, size_t count)
+{
+    MAP_HANDLE_DATA* result;
+    /*Codes_SRS_MAP_11_088: [ If count is not 0 and keys or values is NULL then Map_CreateFromArrays shall fail and return NULL. ]*/
+    if (
+        (count != 0) &&
+        ((keys == NULL) || (values == NULL))
+        )
+    {
+        LogError("invalid arg MAP_FILTER_CALLBACK mapFilterFunc=%p, const char* const* keys=%p, const char* const* values=%p, size_t count=%zu",
+            mapFilterFunc, keys, values, count);
+        result = NULL;
+    }
+    else
+    {
+        size_t arenaSize = 0;
+        size_t i;
+        /*Codes_SRS_MAP_11_089: [ Before allocating any memory, Map_CreateFromArrays shall fail and return NULL if any key or value is NULL or if mapFilterFunc is not NULL and returns non-zero for any pair. ]*/
+        for (i = 0; i < count; i++)
+        {
+            size_t pairSize;
+            if (
+                (keys[i] == NULL) ||
+                (values[i] == NULL)
+                )
+            {
+                LogError("pair %zu has keys[i]=%p, values[i]=%p", i, keys[i], values[i]);
+                break;
+            }
+            else if (
+                (mapFilterFunc != NULL) &&
+                (mapFilterFunc(keys[i], values[i]) != 0)
+                )
+            {
+                LogError("mapFilterFunc=%p rejected pair %zu, key=%s", mapFilterFunc, i, keys[i]);
+                break;
+            }
+            else if ((pairSize = strlen(keys[i]) + strlen(values[i])) > SIZE_MAX - 2 - arenaSize)
+            {
+                LogError("overflow: keys and values of pair %zu exceed SIZE_MAX=%zu bytes", i, SIZE_MAX);
+                break;
+            }
+            else
+            {
+                arenaSize += pairSize + 2;
+            }
+        }
+
+        if (i < count)
+        {
+            result = NULL;
+        }
+        /*Codes_SRS_MAP_11_090: [ Map_CreateFromArrays shall create the map by calling Map_CreateWithArena with mapFilterFunc, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+        else if ((result = (MAP_HANDLE_DATA*)Map_CreateWithArena(mapFilterFunc, count, arenaSize)) == NULL)
+        {
+            /*Codes_SRS_MAP_11_093: [ If there are any failures then Map_CreateFromArrays shall fail and return NULL. ]*/
+            LogError("failure in Map_CreateWithArena(mapFilterFunc=%p, count=%zu, arenaSize=%zu)", mapFilterFunc, count, arenaSize);
+        }
+        else
+        {
+            MAP_STORE* store = result->store;
+            /*Codes_SRS_MAP_11_091: [ Map_CreateFromArrays shall copy the keys and values in the arena and add them to the map in the order of the arrays, without allocating memory. ]*/
+            for (i = 0; i < count; i++)
+            {
+                char* key = Map_ArenaCopyBytes(store, keys[i], strlen(keys[i]));
+                char* value = Map_ArenaCopyBytes(store, values[i], strlen(values[i]));
+                /*the key index of the new map detects the repeated keys*/
+                if (Map_StoreAppendPair(store, key, value) != 0)
+                {
+                    /*Codes_SRS_MAP_11_092: [ If a key appears more than once then Map_CreateFromArrays shall destroy the map and return NULL. ]*/
+                    LogError("failure in Map_StoreAppendPair(store=%p, key=%s, value=%s), pair %zu", store, key, value, i);
+                    Map_Destroy(result);
+                    result = NULL;
+                    break;
+                }
+            }
+        }
+    }
+    return (MAP_HANDLE)result;
+}
+
+/*adds the pair to the map, handleData, key and value are not NULL. rcKey and rcValue are NULL when the caller only has the strings*/
+static MAP_RESULT Map_AddPair(MAP_HANDLE_DATA* handleData, const char* key, const char* value, THANDLE(RC_STRING) rcKey, THANDLE(RC_STRING) rcValue)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_009: [If the key already exists, then Map_Add shall return MAP_KEYEXISTS.] */
+    if (findKey(handleData->store, key) != NULL)
+    {
+        result = MAP_KEYEXISTS;
+    }
+    else
+    {
+        /* Codes_SRS_MAP_07_009: [If the mapFilterCallback function is not NULL, then the return value will be check and if it is not zero then Map_Add shall return MAP_FILTER_REJECT.] */
+        if ( (handleData->mapFilterCallback != NULL) && (handleData->mapFilterCallback(key, value) != 0) )
+        {
+            result = MAP_FILTER_REJECT;
+        }
+        else
+        {
+            /*Codes_SRS_MAP_02_010: [Otherwise, Map_Add shall add the pair <key,value> to the map.] */
+            if (
+                (Map_UnshareStore(handleData) != 0) ||
+                (insertNewKeyValue(handleData->store, key, value, rcKey, rcValue) != 0)
+                )
+            {
+                /*Codes_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_MAP_02_012: [Otherwise, Map_Add shall return MAP_OK.] */
+                result = MAP_OK;
+            }
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_Add(MAP_HANDLE handle, const char* key, const char* value)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_006: [If parameter handle is NULL then Map_Add shall return MAP_INVALID_ARG.] */
+    /*Codes_SRS_MAP_02_007: [If parameter key is NULL then Map_Add shall return MAP_INVALID_ARG.]*/
+    /*Codes_SRS_MAP_02_008: [If parameter value is NULL then Map_Add shall return MAP_INVALID_ARG.] */
+    if (
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        result = Map_AddPair(handle, key, value, NULL, NULL);
+    }
+    return result;
+}
+
+MAP_RESULT Map_AddRcString(MAP_HANDLE handle, THANDLE(RC_STRING) key, THANDLE(RC_STRING) value)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_11_060: [ If parameter handle, key or value is NULL then Map_AddRcString shall return MAP_INVALIDARG. ]*/
+    if (
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_061: [ Otherwise, Map_AddRcString shall behave like Map_Add called with the strings of key and value. ]*/
+        result = Map_AddPair(handle, key->string, value->string, key, value);
+    }
+    return result;
+}
+
+/*adds or updates the pair, handleData, key and value are not NULL. rcKey and rcValue are NULL when the caller only has the strings*/
+static MAP_RESULT Map_AddOrUpdatePair(MAP_HANDLE_DATA* handleData, const char* key, const char* value, THANDLE(RC_STRING) rcKey, THANDLE(RC_STRING) rcValue)
+{
+    MAP_RESULT result;
+    /* Codes_SRS_MAP_07_008: [If the mapFilterCallback function is not NULL, then the return value will be check and if it is not zero then Map_AddOrUpdate shall return MAP_FILTER_REJECT.] */
+    if (handleData->mapFilterCallback != NULL && handleData->mapFilterCallback(key, value) != 0)
+    {
+        result = MAP_FILTER_REJECT;
+    }
+    else
+    {
+        char** whereIsIt = findKey(handleData->store, key);
+        if (whereIsIt == NULL)
+        {
+            /*Codes_SRS_MAP_02_017: [Otherwise, Map_AddOrUpdate shall add the pair <key,value> to the map.]*/
+            if (
+                (Map_UnshareStore(handleData) != 0) ||
+                (insertNewKeyValue(handleData->store, key, value, rcKey, rcValue) != 0)
+                )
+            {
+                /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                result = MAP_OK;
+            }
+        }
+        else
+        {
+            /*Codes_SRS_MAP_02_016: [If the key already exists, then Map_AddOrUpdate shall overwrite the value of the existing key with parameter value.]*/
+            /*a shared store has no tombstones, the private copy keeps the pair at the same index*/
+            size_t index = whereIsIt - handleData->store->keys;
+            if (Map_UnshareStore(handleData) != 0)
+            {
+                /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+                LogError("failure in Map_UnshareStore(handleData=%p)", handleData);
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            /*Codes_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+            else if (Map_ValueIndexReserve(handleData->store) != 0)
+            {
+                /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+                LogError("failure in Map_ValueIndexReserve(handleData->store=%p)", handleData->store);
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else if (Map_StoreReplaceValue(handleData->store, index, value, rcValue) != 0)
+            {
+                /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+                LogError("failure in Map_StoreReplaceValue(handleData->store=%p, index=%zu, value=%s, rcValue=%p)", handleData->store, index, value, (void*)rcValue);
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                /*the slot of the old value goes stale*/
+                Map_ValueIndexAdd(handleData->store, index);
+                /*Codes_SRS_MAP_02_019: [Otherwise, Map_AddOrUpdate shall return MAP_OK.] */
+                result = MAP_OK;
+            }
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_013: [If parameter handle is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.]*/
+    /*Codes_SRS_MAP_02_014: [If parameter key is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.]*/
+    /*Codes_SRS_MAP_02_015: [If parameter value is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.] */
+    if (
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        result = Map_AddOrUpdatePair(handle, key, value, NULL, NULL);
+    }
+    return result;
+}
+
+MAP_RESULT Map_AddOrUpdateRcString(MAP_HANDLE handle, THANDLE(RC_STRING) key, THANDLE(RC_STRING) value)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_11_062: [ If parameter handle, key or value is NULL then Map_AddOrUpdateRcString shall return MAP_INVALIDARG. ]*/
+    if (
+        (handle == NULL) ||
+        (key == NULL) ||
+        (value == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_11_063: [ Otherwise, Map_AddOrUpdateRcString shall behave like Map_AddOrUpdate called with the strings of key and value. ]*/
+        result = Map_AddOrUpdatePair(handle, key->string, value->string, key, value);
+    }
+    return result;
+}
+
+MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_020: [If parameter handle is NULL then Map_Delete shall return MAP_INVALIDARG.]*/
+    /*Codes_SRS_MAP_02_021: [If parameter key is NULL then Map_Delete shall return MAP_INVALIDARG.]*/
+    if (
+        (handle == NULL) ||
+        (key == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        char** whereIsIt = findKey(handleData->store, key);
+        if (whereIsIt == NULL)
+        {
+            /*Codes_SRS_MAP_02_022: [If key does not exist then Map_Delete shall return MAP_KEYNOTFOUND.]*/
+            result = MAP_KEYNOTFOUND;
+        }
+        else
+        {
+            /*a shared store has no tombstones, the private copy keeps the pair at the same index*/
+            size_t index = whereIsIt - handleData->store->keys;
+            if (Map_UnshareStore(handleData) != 0)
+            {
+                /*Codes_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
+                MAP_STORE* store = handleData->store;
+                if (store->storageType == MAP_STORAGE_TYPE_RC_STRING)
+                {
+                    /*Codes_SRS_MAP_11_056: [ Map_Delete shall release the references to the key and value it deletes from a map created by Map_CreateWithRcStrings by calling THANDLE_ASSIGN(RC_STRING) with NULL. ]*/
+                    THANDLE_ASSIGN(RC_STRING)(&store->rcKeys[index], NULL);
+                    THANDLE_ASSIGN(RC_STRING)(&store->rcValues[index], NULL);
+                }
+                else
+                {
+                    Map_StoreReleaseString(store, store->keys[index]);
+                    Map_StoreReleaseString(store, store->values[index]);
+                }
+                /*Codes_SRS_MAP_11_012: [ Map_Delete shall leave a tombstone in the place of the deleted pair and shall not shrink the storage. ]*/
+                /*Codes_SRS_MAP_11_005: [ Map_Delete shall leave the key index slot of the deleted key in place, probing for other keys shall continue past it. ]*/
+                /*Codes_SRS_MAP_11_020: [ Map_Delete shall leave the value index slot of the deleted value in place, probing for other values shall continue past it. ]*/
+                store->keys[index] = NULL;
+                store->values[index] = NULL;
+                store->count--;
+                /*Codes_SRS_MAP_11_013: [ When more than half of the used slots of the storage are tombstones, Map_Delete shall compact the storage. ]*/
+                if (store->used - store->count > store->count)
+                {
+                    Map_Compact(store);
+                }
+                result = MAP_OK;
+            }
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_ContainsKey(MAP_HANDLE handle, const char* key, bool* keyExists)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_024: [If parameter handle, key or keyExists are NULL then Map_ContainsKey shall return MAP_INVALIDARG.]*/
+    if (
+        (handle ==NULL) ||
+        (key == NULL) ||
+        (keyExists == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        /*Codes_SRS_MAP_02_025: [Otherwise if a key exists then Map_ContainsKey shall return MAP_OK and shall write in keyExists "true".]*/
+        /*Codes_SRS_MAP_02_026: [If a key doesn't exist, then Map_ContainsKey shall return MAP_OK and write in keyExists "false".] */
+        *keyExists = (findKey(handleData->store, key) != NULL) ? true: false;
+        result = MAP_OK;
+    }
+    return result;
+}
+
+MAP_RESULT Map_EnableValueIndex(MAP_HANDLE handle)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_11_015: [ If parameter handle is NULL then Map_EnableValueIndex shall return MAP_INVALIDARG. ]*/
+    if (handle == NULL)
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        if (handleData->store->valueIndex != NULL)
+        {
+            /*Codes_SRS_MAP_11_016: [ If the map already has a value index then Map_EnableValueIndex shall return MAP_OK. ]*/
+            result = MAP_OK;
+        }
+        else if (Map_UnshareStore(handleData) != 0)
+        {
+            /*Codes_SRS_MAP_11_022: [ If there are any failures then Map_EnableValueIndex shall return MAP_ERROR. ]*/
+            LogError("failure in Map_UnshareStore(handleData=%p)", handleData);
+            result = MAP_ERROR;
+            LOG_MAP_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_MAP_11_017: [ Otherwise, Map_EnableValueIndex shall build a value index: an open addressing hash table that maps values to their positions in the values array, and return MAP_OK. ]*/
+            MAP_STORE* store = handleData->store;
+            size_t newSize = Map_ValueIndexSizeFor(store->count);
+            store->valueIndex = malloc_2(newSize, sizeof(size_t));
+            if (store->valueIndex == NULL)
+            {
+                /*Codes_SRS_MAP_11_022: [ If there are any failures then Map_EnableValueIndex shall return MAP_ERROR. ]*/
+                LogError("failure in malloc_2(newSize=%zu, sizeof(size_t)=%zu);",
+                    newSize, sizeof(size_t));
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                store->valueIndexSize = newSize;
+                Map_ValueIndexRebuild(store);
+                result = MAP_OK;
+            }
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_CompactArena(MAP_HANDLE handle)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_11_094: [ If parameter handle is NULL then Map_CompactArena shall return MAP_INVALIDARG. ]*/
+    if (handle == NULL)
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        MAP_STORE* store = handleData->store;
+        if (
+            (store->storageType != MAP_STORAGE_TYPE_ARENA) ||
+            (interlocked_add(&store->refCount, 0) != 1)
+            )
+        {
+            /*Codes_SRS_MAP_11_095: [ If the map was not created by Map_CreateWithArena or if it shares its store with other maps then Map_CompactArena shall return MAP_OK without changing the map. ]*/
+            result = MAP_OK;
+        }
+        /*Codes_SRS_MAP_11_096: [ Otherwise, if the arena holds bytes of deleted or overwritten keys and values, Map_CompactArena shall move the keys and values to a single new chunk with as much free room as they take and free the old chunks. ]*/
+        else if (Map_ArenaCompact(store) != 0)
+        {
+            /*Codes_SRS_MAP_11_097: [ If there are any failures then Map_CompactArena shall keep the old chunks and return MAP_ERROR. ]*/
+            LogError("failure in Map_ArenaCompact(store=%p)", store);
+            result = MAP_ERROR;
+            LOG_MAP_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_MAP_11_098: [ Map_CompactArena shall return MAP_OK. ]*/
+            result = MAP_OK;
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_ContainsValue(MAP_HANDLE handle, const char* value, bool* valueExists)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_027: [If parameter handle, value or valueExists is NULL then Map_ContainsValue shall return MAP_INVALIDARG.] */
+    if (
+        (handle == NULL) ||
+        (value == NULL) ||
+        (valueExists == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        /*Codes_SRS_MAP_02_028: [Otherwise, if a pair <key, value> has its value equal to the parameter value, the Map_ContainsValue shall return MAP_OK and shall write in valueExists "true".]*/
+        /*Codes_SRS_MAP_02_029: [Otherwise, if such a <key, value> does not exist, then Map_ContainsValue shall return MAP_OK and shall write in valueExists "false".] */
+        *valueExists = (findValue(handleData->store, value) != NULL) ? true : false;
+        result = MAP_OK;
+    }
+    return result;
+}
+
+const char* Map_GetValueFromKey(MAP_HANDLE handle, const char* key)
+{
+    const char* result;
+    /*Codes_SRS_MAP_02_040: [If parameter handle or key is NULL then Map_GetValueFromKey returns NULL.]*/
+    if (
+        (handle == NULL) ||
+        (key == NULL)
+        )
+    {
+        result = NULL;
+        LogError("invalid parameter to Map_GetValueFromKey");
+    }
+    else
+    {
+        MAP_HANDLE_DATA * handleData = (MAP_HANDLE_DATA *)handle;
+        char** whereIsIt = findKey(handleData->store, key);
+        if(whereIsIt == NULL)
+        {
+            /*Codes_SRS_MAP_02_041: [If the key is not found, then Map_GetValueFromKey returns NULL.]*/
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_MAP_02_042: [Otherwise, Map_GetValueFromKey returns the key's value.] */
+            size_t index = whereIsIt - handleData->store->keys;
+            result = handleData->store->values[index];
+        }
+    }
+    return result;
+}
+
+THANDLE(RC_STRING) Map_GetRcStringFromKey(MAP_HANDLE handle, const char* key)
+{
+    THANDLE(RC_STRING) result = NULL;
+    /*Codes_SRS_MAP_11_064: [ If parameter handle or key is NULL then Map_GetRcStringFromKey shall return NULL. ]*/
+    if (
+        (handle == NULL) ||
+        (key == NULL)
+        )
+    {
+        LogError("invalid parameter to Map_GetRcStringFromKey");
+    }
+    else
+    {
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
+        char** whereIsIt = findKey(handleData->store, key);
+        if (whereIsIt == NULL)
+        {
+            /*Codes_SRS_MAP_11_065: [ If the key is not found, then Map_GetRcStringFromKey shall return NULL. ]*/
+        }
+        else
+        {
+            size_t index = whereIsIt - handleData->store->keys;
+            if (handleData->store->storageType == MAP_STORAGE_TYPE_RC_STRING)
+            {
+                /*Codes_SRS_MAP_11_066: [ If the map was created by Map_CreateWithRcStrings then Map_GetRcStringFromKey shall return a new reference to the stored value obtained by calling THANDLE_INITIALIZE(RC_STRING). ]*/
+                THANDLE_INITIALIZE(RC_STRING)(&result, handleData->store->rcValues[index]);
+            }
+            else
+            {
+                /*Codes_SRS_MAP_11_067: [ Otherwise, Map_GetRcStringFromKey shall return the THANDLE(RC_STRING) created by calling rc_string_create with the key's value. ]*/
+                THANDLE(RC_STRING) temp = rc_string_create(handleData->store->values[index]);
+                if (temp == NULL)
+                {
+                    /*Codes_SRS_MAP_11_068: [ If rc_string_create fails then Map_GetRcStringFromKey shall return NULL. ]*/
+                    LogError("failure in rc_string_create(handleData->store->values[index=%zu]=%s)", index, handleData->store->values[index]);
+                }
+                THANDLE_INITIALIZE_MOVE(RC_STRING)(&result, &temp);
+            }
+        }
+    }
+    return result;
+}
+
+MAP_RESULT Map_GetInternals(MAP_HANDLE handle, const char*const** keys, const char*const** values, size_t* count)
+{
+    MAP_RESULT result;
+    /*Codes_SRS_MAP_02_046: [If parameter handle, keys, values or count is NULL then Map_GetInternals shall return MAP_INVALIDARG.] */
+    if (
+        (handle == NULL) ||
+        (keys == NULL) ||
+        (values == NULL) ||
+        (count == NULL)
+        )
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_02_043: [Map_GetInternals shall produce in *keys an pointer to an array of const char* having all the keys stored so far by the map.]*/
+        /*Codes_SRS_MAP_02_044: [Map_GetInternals shall produce in *values a pointer to an array of const char* having all the values stored so far by the map.]*/
+        /*Codes_SRS_MAP_02_045: [  Map_GetInternals shall produce in *count the number of stored keys and values.]*/
+        MAP_HANDLE_DATA * handleData = (MAP_HANDLE_DATA *)handle;
+        /*Codes_SRS_MAP_11_014: [ Map_GetInternals, Map_ToJSON and Map_Clone shall first compact the storage so that keys and values contain no tombstones. ]*/
+        Map_Compact(handleData->store);
+        *keys =(const char* const*)(handleData->store->keys);
+        *values = (const char* const*)(handleData->store->values);
+        *count = handleData->store->count;
+        result = MAP_OK;
+    }
+    return result;
+}
+
+static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+/*returns the length of source once escaped and quoted the way STRING_new_JSON does it, 0 if source cannot be represented (a quoted string is never shorter than 2)*/
+static size_t Map_JSONStringLength(const char* source)
+{
+    size_t result = 2; /*the quotes*/
+    size_t i;
+    for (i = 0; source[i] != '\0'; i++)
+    {
+        if ((unsigned char)source[i] >= 128)
+        {
+            LogError("invalid character in input string");
+            result = 0;
+            break;
+        }
+        else if (source[i] <= 0x1F)
+        {
+            result += 6; /*\u00xx*/
+        }
+        else if (
+            (source[i] == '"') ||
+            (source[i] == '\\') ||
+            (source[i] == '/')
+            )
+        {
+            result += 2;
+        }
+        else
+        {
+            result++;
         }
     }
     return result;
 }
 
-static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
+/*writes source escaped and quoted at destination, returns the position after the closing quote*/
+static char* Map_JSONStringWrite(char* destination, const char* source)
 {
-    if (handleData->count == 1)
-    {
-        free(handleData->keys);
-        handleData->keys = NULL;
-        free(handleData->values);
-        handleData->values = NULL;
-        handleData->count = 0;
-        handleData->mapFilterCallback = NULL;
-    }
-    else
+    size_t i;
+    *destination++ = '"';
+    for (i = 0; source[i] != '\0'; i++)
     {
-        /*certainly > 1...*/
-        char** undoneValues;
-        char** undoneKeys = realloc_2(handleData->keys, handleData->count - 1, sizeof(char*));
-        if (undoneKeys == NULL)
-        {
-            LogError("CATASTROPHIC error, realloc_2(handleData->keys, handleData->count=%zu - 1, sizeof(char*)=%zu);",
-                handleData->count, sizeof(char*));
-        }
-        else
+        if (source[i] <= 0x1F)
         {
-            handleData->keys = undoneKeys;
+            *destination++ = '\\';
+            *destination++ = 'u';
+            *destination++ = '0';
+            *destination++ = '0';
+            *destination++ = hexToASCII[(source[i] & 0xF0) >> 4];
+            *destination++ = hexToASCII[source[i] & 0x0F];
         }
-
-        undoneValues = realloc_2(handleData->values, handleData->count - 1, sizeof(char*));
-        if (undoneValues == NULL)
+        else if (
+            (source[i] == '"') ||
+            (source[i] == '\\') ||
+            (source[i] == '/')
+            )
         {
-            LogError("CATASTROPHIC error, realloc_2(handleData->values=%p, handleData->count=%zu - 1, sizeof(char*)=%zu);",
-                handleData->values, handleData->count, sizeof(char*));
+            *destination++ = '\\';
+            *destination++ = source[i];
         }
         else
         {
-            handleData->values = undoneValues;
+            *destination++ = source[i];
         }
-
-        handleData->count--;
     }
+    *destination++ = '"';
+    return destination;
 }
 
-static char** findKey(MAP_HANDLE_DATA* handleData, const char* key)
+/*computes in *length the number of characters of the JSON representation of the store (without a '\0' terminator)*/
+static int Map_JSONLength(const MAP_STORE* store, size_t* length)
 {
-    char** result;
-    if (handleData->keys == NULL)
-    {
-        result = NULL;
-    }
-    else
+    int result = 0;
+    size_t total = 2; /*{}*/
+    size_t pairs = 0;
+    size_t i;
+    for (i = 0; i < store->used; i++)
     {
-        size_t i;
-        result = NULL;
-        for (i = 0; i < handleData->count; i++)
+        if (store->keys[i] != NULL)
         {
-            if (strcmp(handleData->keys[i], key) == 0)
+            size_t keyLength = Map_JSONStringLength(store->keys[i]);
+            size_t valueLength = Map_JSONStringLength(store->values[i]);
+            if ((keyLength == 0) || (valueLength == 0))
+            {
+                LogError("unable to represent pair %zu in JSON", i);
+                result = MU_FAILURE;
+                break;
+            }
+            /*":" and the "," separating it from the previous pair*/
+            else if (SIZE_MAX - total < keyLength + valueLength + 2)
             {
-                result = handleData->keys + i;
+                LogError("overflow: JSON length would exceed SIZE_MAX=%zu", SIZE_MAX);
+                result = MU_FAILURE;
                 break;
             }
+            else
+            {
+                total += keyLength + valueLength + ((pairs > 0) ? 2 : 1);
+                pairs++;
+            }
         }
     }
+    if (result == 0)
+    {
+        *length = total;
+    }
     return result;
 }
 
-static char** findValue(MAP_HANDLE_DATA* handleData, const char* value)
+/*writes the JSON representation of the store at destination, the caller has made room for it with Map_JSONLength*/
+static void Map_JSONWrite(const MAP_STORE* store, char* destination)
 {
-    char** result;
-    if (handleData->values == NULL)
-    {
-        result = NULL;
-    }
-    else
+    bool first = true;
+    size_t i;
+    *destination++ = '{';
+    for (i = 0; i < store->used; i++)
     {
-        size_t i;
-        result = NULL;
-        for (i = 0; i < handleData->count; i++)
+        if (store->keys[i] != NULL)
         {
-            if (strcmp(handleData->values[i], value) == 0)
+            if (!first)
             {
-                result = handleData->values + i;
-                break;
+                *destination++ = ',';
             }
+            first = false;
+            destination = Map_JSONStringWrite(destination, store->keys[i]);
+            *destination++ = ':';
+            destination = Map_JSONStringWrite(destination, store->values[i]);
         }
     }
-    return result;
+    *destination = '}';
 }
 
-static int insertNewKeyValue(MAP_HANDLE_DATA* handleData, const char* key, const char* value)
+STRING_HANDLE Map_ToJSON(MAP_HANDLE handle)
 {
-    int result;
-    if (Map_IncreaseStorageKeysValues(handleData) != 0) /*this increases handleData->count*/
+    STRING_HANDLE result;
+    /*Codes_SRS_MAP_02_052: [If parameter handle is NULL then Map_ToJSON shall return NULL.] */
+    if (handle == NULL)
     {
-        result = MU_FAILURE;
+        /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
+        result = NULL;
+        LogError("invalid arg (NULL)");
     }
     else
     {
-        if ((handleData->keys[handleData->count - 1] = sprintf_char("%s", key)) == NULL)
+        MAP_STORE* store = ((MAP_HANDLE_DATA *)handle)->store;
+        size_t length;
+        /*Codes_SRS_MAP_11_014: [ Map_GetInternals, Map_ToJSON and Map_Clone shall first compact the storage so that keys and values contain no tombstones. ]*/
+        Map_Compact(store);
+        /*Codes_SRS_MAP_11_028: [ Map_ToJSON shall compute the length of the JSON representation of the map, with keys and values escaped the way STRING_new_JSON escapes them. ]*/
+        if (Map_JSONLength(store, &length) != 0)
         {
-            Map_DecreaseStorageKeysValues(handleData);
-            LogError("unable to mallocAndStrcpy_s");
-            result = MU_FAILURE;
+            /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
+            LogError("failure in Map_JSONLength");
+            result = NULL;
         }
         else
         {
-            if((handleData->values[handleData->count - 1] = sprintf_char("%s", value)) == NULL)
+            /*Codes_SRS_MAP_11_029: [ Map_ToJSON shall allocate memory for the JSON representation and its null terminator once and write the JSON representation there. ]*/
+            char* json = malloc_flex(1, length, 1);
+            if (json == NULL)
             {
-                free(handleData->keys[handleData->count - 1]);
-                Map_DecreaseStorageKeysValues(handleData);
-                LogError("unable to mallocAndStrcpy_s");
-                result = MU_FAILURE;
+                /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
+                LogError("failure in malloc_flex(1, length=%zu, 1)", length);
+                result = NULL;
             }
             else
             {
-                result = 0;
+                /*Codes_SRS_MAP_02_048: [Map_ToJSON shall produce a STRING_HANDLE representing the content of the MAP.] */
+                /*Codes_SRS_MAP_02_049: [If the MAP is empty, then Map_ToJSON shall produce the string "{}".*/
+                /*Codes_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}]*/
+                Map_JSONWrite(store, json);
+                json[length] = '\0';
+
+                /*Codes_SRS_MAP_11_030: [ Map_ToJSON shall hand the memory over to a STRING_HANDLE by calling STRING_new_with_memory. ]*/
+                result = STRING_new_with_memory(json);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
+                    LogError("failure in STRING_new_with_memory");
+                    free(json);
+                }
             }
         }
     }
     return result;
 }
 
-MAP_RESULT Map_Add(MAP_HANDLE handle, const char* key, const char* value)
+MAP_RESULT Map_ToJSONBuffer(MAP_HANDLE handle, char* buffer, size_t bufferSize, size_t* requiredSize)
 {
     MAP_RESULT result;
-    /*Codes_SRS_MAP_02_006: [If parameter handle is NULL then Map_Add shall return MAP_INVALID_ARG.] */
-    /*Codes_SRS_MAP_02_007: [If parameter key is NULL then Map_Add shall return MAP_INVALID_ARG.]*/
-    /*Codes_SRS_MAP_02_008: [If parameter value is NULL then Map_Add shall return MAP_INVALID_ARG.] */
     if (
+        /*Codes_SRS_MAP_11_031: [ If handle is NULL or requiredSize is NULL then Map_ToJSONBuffer shall fail and return MAP_INVALIDARG. ]*/
         (handle == NULL) ||
-        (key == NULL) ||
-        (value == NULL)
+        (requiredSize == NULL) ||
+        /*Codes_SRS_MAP_11_032: [ If buffer is NULL and bufferSize is not 0 then Map_ToJSONBuffer shall fail and return MAP_INVALIDARG. ]*/
+        ((buffer == NULL) && (bufferSize != 0))
         )
     {
         result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
+        LogError("invalid arg MAP_HANDLE handle=%p, char* buffer=%p, size_t bufferSize=%zu, size_t* requiredSize=%p",
+            handle, buffer, bufferSize, requiredSize);
     }
     else
     {
-        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        /*Codes_SRS_MAP_02_009: [If the key already exists, then Map_Add shall return MAP_KEYEXISTS.] */
-        if (findKey(handleData, key) != NULL)
+        MAP_STORE* store = ((MAP_HANDLE_DATA *)handle)->store;
+        size_t length;
+        if (Map_JSONLength(store, &length) != 0)
         {
-            result = MAP_KEYEXISTS;
+            /*Codes_SRS_MAP_11_033: [ If any key or value cannot be represented in JSON then Map_ToJSONBuffer shall fail and return MAP_ERROR. ]*/
+            result = MAP_ERROR;
+            LOG_MAP_ERROR;
+        }
+        else if (length == SIZE_MAX)
+        {
+            /*Codes_SRS_MAP_11_033: [ If any key or value cannot be represented in JSON then Map_ToJSONBuffer shall fail and return MAP_ERROR. ]*/
+            result = MAP_ERROR;
+            LogError("overflow: JSON length=%zu + 1 exceeds SIZE_MAX", length);
         }
         else
         {
-            /* Codes_SRS_MAP_07_009: [If the mapFilterCallback function is not NULL, then the return value will be check and if it is not zero then Map_Add shall return MAP_FILTER_REJECT.] */
-            if ( (handleData->mapFilterCallback != NULL) && (handleData->mapFilterCallback(key, value) != 0) )
+            /*Codes_SRS_MAP_11_034: [ Map_ToJSONBuffer shall write in *requiredSize the size of the JSON representation of the map including its null terminator. ]*/
+            *requiredSize = length + 1;
+            if (bufferSize < length + 1)
             {
-                result = MAP_FILTER_REJECT;
+                /*Codes_SRS_MAP_11_035: [ If bufferSize is smaller than *requiredSize then Map_ToJSONBuffer shall return MAP_ERROR and shall not write to buffer. ]*/
+                result = MAP_ERROR;
+                LogError("bufferSize=%zu is too small, %zu bytes are required", bufferSize, length + 1);
             }
             else
             {
-                /*Codes_SRS_MAP_02_010: [Otherwise, Map_Add shall add the pair <key,value> to the map.] */
-                if (insertNewKeyValue(handleData, key, value) != 0)
-                {
-                    /*Codes_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
-                    result = MAP_ERROR;
-                    LOG_MAP_ERROR;
-                }
-                else
-                {
-                    /*Codes_SRS_MAP_02_012: [Otherwise, Map_Add shall return MAP_OK.] */
-                    result = MAP_OK;
-                }
+                /*Codes_SRS_MAP_11_036: [ Otherwise Map_ToJSONBuffer shall write the null terminated JSON representation of the map in buffer, without allocating memory, and return MAP_OK. ]*/
+                Map_JSONWrite(store, buffer);
+                buffer[length] = '\0';
+                result = MAP_OK;
             }
         }
     }
     return result;
 }
 
-MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value)
+CONSTBUFFER_HANDLE Map_ToJSONConstBuffer(MAP_HANDLE handle)
 {
-    MAP_RESULT result;
-    /*Codes_SRS_MAP_02_013: [If parameter handle is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.]*/
-    /*Codes_SRS_MAP_02_014: [If parameter key is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.]*/
-    /*Codes_SRS_MAP_02_015: [If parameter value is NULL then Map_AddOrUpdate shall return MAP_INVALID_ARG.] */
-    if (
-        (handle == NULL) ||
-        (key == NULL) ||
-        (value == NULL)
-        )
+    CONSTBUFFER_HANDLE result;
+    if (handle == NULL)
     {
-        result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
+        /*Codes_SRS_MAP_11_037: [ If handle is NULL then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+        result = NULL;
+        LogError("invalid arg (NULL)");
     }
     else
     {
-        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-
-        /* Codes_SRS_MAP_07_008: [If the mapFilterCallback function is not NULL, then the return value will be check and if it is not zero then Map_AddOrUpdate shall return MAP_FILTER_REJECT.] */
-        if (handleData->mapFilterCallback != NULL && handleData->mapFilterCallback(key, value) != 0)
+        MAP_STORE* store = ((MAP_HANDLE_DATA *)handle)->store;
+        size_t length;
+        if (Map_JSONLength(store, &length) != 0)
         {
-            result = MAP_FILTER_REJECT;
+            /*Codes_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+            LogError("failure in Map_JSONLength");
+            result = NULL;
+        }
+        else if (length > UINT32_MAX)
+        {
+            /*a CONSTBUFFER holds at most UINT32_MAX bytes*/
+            /*Codes_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+            LogError("JSON length=%zu does not fit a CONSTBUFFER", length);
+            result = NULL;
         }
         else
         {
-            char** whereIsIt = findKey(handleData, key);
-            if (whereIsIt == NULL)
+            /*Codes_SRS_MAP_11_039: [ Map_ToJSONConstBuffer shall allocate memory for the JSON representation once and write the JSON representation there, without a null terminator. ]*/
+            unsigned char* json = malloc(length);
+            if (json == NULL)
             {
-                /*Codes_SRS_MAP_02_017: [Otherwise, Map_AddOrUpdate shall add the pair <key,value> to the map.]*/
-                if (insertNewKeyValue(handleData, key, value) != 0)
-                {
-                    /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
-                    result = MAP_ERROR;
-                    LOG_MAP_ERROR;
-                }
-                else
-                {
-                    result = MAP_OK;
-                }
+                /*Codes_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+                LogError("failure in malloc(length=%zu)", length);
+                result = NULL;
             }
             else
             {
-                /*Codes_SRS_MAP_02_016: [If the key already exists, then Map_AddOrUpdate shall overwrite the value of the existing key with parameter value.]*/
-                size_t index = whereIsIt - handleData->keys;
-                size_t valueLength = strlen(value);
-                /*try to realloc value of this key*/
-                char* newValue = realloc_flex(handleData->values[index], 1, valueLength, 1);
-                if (newValue == NULL)
-                {
-                    /*Codes_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
-                    LogError("failure in realloc_flex(handleData->values[index], 1, valueLength=%zu, 1);",
-                        valueLength);
-                    result = MAP_ERROR;
-                    LOG_MAP_ERROR;
-                }
-                else
+                Map_JSONWrite(store, (char*)json);
+
+                /*Codes_SRS_MAP_11_040: [ Map_ToJSONConstBuffer shall hand the memory over to a CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateWithMoveMemory and return it. ]*/
+                result = CONSTBUFFER_CreateWithMoveMemory(json, (uint32_t)length);
+                if (result == NULL)
                 {
-                    (void)memcpy(newValue, value, valueLength + 1);
-                    handleData->values[index] = newValue;
-                    /*Codes_SRS_MAP_02_019: [Otherwise, Map_AddOrUpdate shall return MAP_OK.] */
-                    result = MAP_OK;
+                    /*Codes_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_CreateWithMoveMemory(json=%p, length=%zu)", json, length);
+                    free(json);
                 }
             }
         }
@@ -456,245 +2225,278 @@ MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value
     return result;
 }
 
-MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
+static void* Map_CallsMalloc(size_t size, void* context)
 {
-    MAP_RESULT result;
-    /*Codes_SRS_MAP_02_020: [If parameter handle is NULL then Map_Delete shall return MAP_INVALIDARG.]*/
-    /*Codes_SRS_MAP_02_021: [If parameter key is NULL then Map_Delete shall return MAP_INVALIDARG.]*/
-    if (
-        (handle == NULL) ||
-        (key == NULL)
-        )
+    (void)context;
+    return malloc(size); /*the size has been verified to be at most UINT32_MAX*/
+}
+
+/*computes in *size the number of bytes of the binary serialization of the store, fails if that exceeds UINT32_MAX*/
+static int Map_SerializationSize(const MAP_STORE* store, uint32_t* size)
+{
+    int result;
+    if (store->count > UINT32_MAX)
     {
-        result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
+        LogError("count=%zu pairs cannot be serialized, at most UINT32_MAX=%" PRIu32 " can", store->count, UINT32_MAX);
+        result = MU_FAILURE;
     }
     else
     {
-        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        char** whereIsIt = findKey(handleData,key);
-        if (whereIsIt == NULL)
+        /*summed in 64 bits: one pair adds at most 2 * UINT32_MAX + MAP_MIN_PAIR_SIZE to a total that is never more than UINT32_MAX*/
+        uint64_t total = MAP_MIN_SERIALIZATION_SIZE;
+        size_t i;
+        result = 0;
+        for (i = 0; i < store->used; i++)
         {
-            /*Codes_SRS_MAP_02_022: [If key does not exist then Map_Delete shall return MAP_KEYNOTFOUND.]*/
-            result = MAP_KEYNOTFOUND;
+            if (store->keys[i] != NULL)
+            {
+                size_t keyLength = strlen(store->keys[i]);
+                size_t valueLength = strlen(store->values[i]);
+                if (
+                    (keyLength > UINT32_MAX) ||
+                    (valueLength > UINT32_MAX)
+                    )
+                {
+                    LogError("overflow: key length=%zu or value length=%zu of pair %zu exceeds UINT32_MAX=%" PRIu32, keyLength, valueLength, i, UINT32_MAX);
+                    result = MU_FAILURE;
+                    break;
+                }
+                total += MAP_MIN_PAIR_SIZE + (uint64_t)keyLength + (uint64_t)valueLength;
+                if (total > UINT32_MAX)
+                {
+                    LogError("overflow: serialization size would exceed UINT32_MAX=%" PRIu32 " at pair %zu", UINT32_MAX, i);
+                    result = MU_FAILURE;
+                    break;
+                }
+            }
         }
-        else
+        if (result == 0)
         {
-            /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
-            size_t index = whereIsIt - handleData->keys;
-            free(handleData->keys[index]);
-            free(handleData->values[index]);
-            memmove(handleData->keys + index, handleData->keys + index + 1, (handleData->count - index - 1)*sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
-            memmove(handleData->values + index, handleData->values + index + 1, (handleData->count - index - 1)*sizeof(char*));
-            Map_DecreaseStorageKeysValues(handleData);
-            result = MAP_OK;
+            *size = (uint32_t)total;
         }
-
     }
     return result;
 }
 
-MAP_RESULT Map_ContainsKey(MAP_HANDLE handle, const char* key, bool* keyExists)
+unsigned char* Map_ToBuffer(MAP_HANDLE handle, MAP_TO_BUFFER_ALLOC alloc, void* alloc_context, uint32_t* serializedSize)
 {
-    MAP_RESULT result;
-    /*Codes_SRS_MAP_02_024: [If parameter handle, key or keyExists are NULL then Map_ContainsKey shall return MAP_INVALIDARG.]*/
+    unsigned char* result;
     if (
-        (handle ==NULL) ||
-        (key == NULL) ||
-        (keyExists == NULL)
+        /*Codes_SRS_MAP_11_069: [ If handle is NULL or serializedSize is NULL then Map_ToBuffer shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        (serializedSize == NULL)
         )
     {
-        result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
+        LogError("invalid arg MAP_HANDLE handle=%p, MAP_TO_BUFFER_ALLOC alloc=%p, void* alloc_context=%p, uint32_t* serializedSize=%p",
+            handle, alloc, alloc_context, serializedSize);
+        result = NULL;
     }
     else
     {
-        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        /*Codes_SRS_MAP_02_025: [Otherwise if a key exists then Map_ContainsKey shall return MAP_OK and shall write in keyExists "true".]*/
-        /*Codes_SRS_MAP_02_026: [If a key doesn't exist, then Map_ContainsKey shall return MAP_OK and write in keyExists "false".] */
-        *keyExists = (findKey(handleData, key) != NULL) ? true: false;
-        result = MAP_OK;
+        /*the serialization skips tombstones, so the store is not compacted: it might be shared and it is not changed*/
+        const MAP_STORE* store = ((MAP_HANDLE_DATA*)handle)->store;
+        uint32_t size;
+
+        /*Codes_SRS_MAP_11_070: [ If alloc is NULL then Map_ToBuffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+        if (alloc == NULL)
+        {
+            alloc = &Map_CallsMalloc;
+        }
+
+        /*Codes_SRS_MAP_11_071: [ If the serialization of the map would be larger than UINT32_MAX bytes then Map_ToBuffer shall fail and return NULL. ]*/
+        if (Map_SerializationSize(store, &size) != 0)
+        {
+            LogError("failure in Map_SerializationSize(store=%p, &size)", store);
+            result = NULL;
+        }
+        /*Codes_SRS_MAP_11_072: [ Map_ToBuffer shall allocate memory for the complete serialization once, by calling alloc. ]*/
+        else if ((result = alloc(size, alloc_context)) == NULL)
+        {
+            /*Codes_SRS_MAP_11_077: [ If there are any failures then Map_ToBuffer shall fail and return NULL. ]*/
+            LogError("failure in alloc=%p(size=%" PRIu32 ", alloc_context=%p)", alloc, size, alloc_context);
+        }
+        else
+        {
+            unsigned char* destination = result + MAP_PAIRS_OFFSET;
+            size_t i;
+
+            /*Codes_SRS_MAP_11_073: [ Map_ToBuffer shall write at offset 0 the version of the serialization (currently 1). ]*/
+            write_uint8_t(result + MAP_VERSION_OFFSET, MAP_VERSION_V1);
+
+            /*Codes_SRS_MAP_11_074: [ Map_ToBuffer shall write at offset 1 the number of pairs in network byte order. ]*/
+            write_uint32_t(result + MAP_COUNT_OFFSET, (uint32_t)store->count);
+
+            /*Codes_SRS_MAP_11_075: [ Starting at offset 5, Map_ToBuffer shall write for every pair, in the order of Map_GetInternals, the length of the key in network byte order, the key without its null terminator, the length of the value in network byte order and the value without its null terminator. ]*/
+            for (i = 0; i < store->used; i++)
+            {
+                if (store->keys[i] != NULL)
+                {
+                    uint32_t keyLength = (uint32_t)strlen(store->keys[i]);
+                    uint32_t valueLength = (uint32_t)strlen(store->values[i]);
+                    write_uint32_t(destination, keyLength);
+                    destination += MAP_LENGTH_SIZE;
+                    (void)memcpy(destination, store->keys[i], keyLength);
+                    destination += keyLength;
+                    write_uint32_t(destination, valueLength);
+                    destination += MAP_LENGTH_SIZE;
+                    (void)memcpy(destination, store->values[i], valueLength);
+                    destination += valueLength;
+                }
+            }
+
+            /*Codes_SRS_MAP_11_076: [ Map_ToBuffer shall succeed, write in *serializedSize the size of the serialization and return the allocated memory. ]*/
+            *serializedSize = size;
+        }
     }
     return result;
 }
 
-MAP_RESULT Map_ContainsValue(MAP_HANDLE handle, const char* value, bool* valueExists)
+/*validates "count" pairs starting at source, of which "size" bytes can be read. Computes in *pairsSize the number of bytes the pairs take and in *stringsSize the number of bytes of their keys and values with null terminators*/
+static int Map_ValidatePairs(const unsigned char* source, uint32_t size, uint32_t count, uint32_t* pairsSize, size_t* stringsSize)
 {
-    MAP_RESULT result;
-    /*Codes_SRS_MAP_02_027: [If parameter handle, value or valueExists is NULL then Map_ContainsValue shall return MAP_INVALIDARG.] */
-    if (
-        (handle == NULL) ||
-        (value == NULL) ||
-        (valueExists == NULL)
-        )
+    int result = 0;
+    uint32_t position = 0;
+    size_t strings = 0;
+    uint32_t i;
+    for (i = 0; i < count * 2; i++)
     {
-        result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
+        /*even: key, odd: value*/
+        uint32_t length;
+        if (size - position < MAP_LENGTH_SIZE)
+        {
+            LogError("not enough bytes for the length of string %" PRIu32 " of %" PRIu32 " pairs, size=%" PRIu32 ", position=%" PRIu32 "", i, count, size, position);
+            result = MU_FAILURE;
+            break;
+        }
+        read_uint32_t(source + position, &length);
+        position += MAP_LENGTH_SIZE;
+        if (size - position < length)
+        {
+            LogError("string %" PRIu32 " has length=%" PRIu32 " but only %" PRIu32 " bytes remain", i, length, size - position);
+            result = MU_FAILURE;
+            break;
+        }
+        if (memchr(source + position, '\0', length) != NULL)
+        {
+            LogError("string %" PRIu32 " contains a null character", i);
+            result = MU_FAILURE;
+            break;
+        }
+        position += length;
+        strings += (size_t)length + 1;
     }
-    else
+    if (result == 0)
     {
-        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        /*Codes_SRS_MAP_02_028: [Otherwise, if a pair <key, value> has its value equal to the parameter value, the Map_ContainsValue shall return MAP_OK and shall write in valueExists "true".]*/
-        /*Codes_SRS_MAP_02_029: [Otherwise, if such a <key, value> does not exist, then Map_ContainsValue shall return MAP_OK and shall write in valueExists "false".] */
-        *valueExists = (findValue(handleData, value) != NULL) ? true : false;
-        result = MAP_OK;
+        *pairsSize = position;
+        *stringsSize = strings;
     }
     return result;
 }
 
-const char* Map_GetValueFromKey(MAP_HANDLE handle, const char* key)
+/*appends the "count" pairs (already validated) at source to the empty store, which has room for all of them. Fails if a key repeats*/
+static int Map_StoreReadPairs(MAP_STORE* store, const unsigned char* source, uint32_t count)
 {
-    const char* result;
-    /*Codes_SRS_MAP_02_040: [If parameter handle or key is NULL then Map_GetValueFromKey returns NULL.]*/
-    if (
-        (handle == NULL) ||
-        (key == NULL)
-        )
-    {
-        result = NULL;
-        LogError("invalid parameter to Map_GetValueFromKey");
-    }
-    else
+    int result = 0;
+    uint32_t i;
+    for (i = 0; i < count; i++)
     {
-        MAP_HANDLE_DATA * handleData = (MAP_HANDLE_DATA *)handle;
-        char** whereIsIt = findKey(handleData, key);
-        if(whereIsIt == NULL)
-        {
-            /*Codes_SRS_MAP_02_041: [If the key is not found, then Map_GetValueFromKey returns NULL.]*/
-            result = NULL;
-        }
-        else
+        uint32_t length;
+        char* key;
+        char* value;
+        read_uint32_t(source, &length);
+        key = Map_ArenaCopyBytes(store, source + MAP_LENGTH_SIZE, length);
+        source += MAP_LENGTH_SIZE + length;
+        read_uint32_t(source, &length);
+        value = Map_ArenaCopyBytes(store, source + MAP_LENGTH_SIZE, length);
+        source += MAP_LENGTH_SIZE + length;
+        if (Map_StoreAppendPair(store, key, value) != 0)
         {
-            /*Codes_SRS_MAP_02_042: [Otherwise, Map_GetValueFromKey returns the key's value.] */
-            size_t index = whereIsIt - handleData->keys;
-            result = handleData->values[index];
+            LogError("failure in Map_StoreAppendPair(store=%p, key=%s, value=%s)", store, key, value);
+            result = MU_FAILURE;
+            break;
         }
     }
     return result;
 }
 
-MAP_RESULT Map_GetInternals(MAP_HANDLE handle, const char*const** keys, const char*const** values, size_t* count)
+MAP_FROM_BUFFER_RESULT Map_FromBuffer(const unsigned char* source, uint32_t size, uint32_t* consumed, MAP_HANDLE* destination)
 {
-    MAP_RESULT result;
-    /*Codes_SRS_MAP_02_046: [If parameter handle, keys, values or count is NULL then Map_GetInternals shall return MAP_INVALIDARG.] */
+    MAP_FROM_BUFFER_RESULT result;
     if (
-        (handle == NULL) ||
-        (keys == NULL) ||
-        (values == NULL) ||
-        (count == NULL)
+        /*Codes_SRS_MAP_11_078: [ If source, consumed or destination is NULL then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        (consumed == NULL) ||
+        (destination == NULL)
         )
     {
-        result = MAP_INVALIDARG;
-        LOG_MAP_ERROR;
-    }
-    else
-    {
-        /*Codes_SRS_MAP_02_043: [Map_GetInternals shall produce in *keys an pointer to an array of const char* having all the keys stored so far by the map.]*/
-        /*Codes_SRS_MAP_02_044: [Map_GetInternals shall produce in *values a pointer to an array of const char* having all the values stored so far by the map.]*/
-        /*Codes_SRS_MAP_02_045: [  Map_GetInternals shall produce in *count the number of stored keys and values.]*/
-        MAP_HANDLE_DATA * handleData = (MAP_HANDLE_DATA *)handle;
-        *keys =(const char* const*)(handleData->keys);
-        *values = (const char* const*)(handleData->values);
-        *count = handleData->count;
-        result = MAP_OK;
+        LogError("invalid arguments const unsigned char* source=%p, uint32_t size=%" PRIu32 ", uint32_t* consumed=%p, MAP_HANDLE* destination=%p",
+            source, size, consumed, destination);
+        result = MAP_FROM_BUFFER_RESULT_INVALID_ARG;
     }
-    return result;
-}
-
-STRING_HANDLE Map_ToJSON(MAP_HANDLE handle)
-{
-    STRING_HANDLE result;
-    /*Codes_SRS_MAP_02_052: [If parameter handle is NULL then Map_ToJSON shall return NULL.] */
-    if (handle == NULL)
+    /*Codes_SRS_MAP_11_079: [ If size is less than sizeof(uint8_t) + sizeof(uint32_t) then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    else if (size < MAP_MIN_SERIALIZATION_SIZE)
     {
-        /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-        result = NULL;
-        LogError("invalid arg (NULL)");
+        LogError("size=%" PRIu32 " is less than the smallest serialization, %zu bytes", size, MAP_MIN_SERIALIZATION_SIZE);
+        result = MAP_FROM_BUFFER_RESULT_INVALID_DATA;
     }
     else
     {
-        /*Codes_SRS_MAP_02_048: [Map_ToJSON shall produce a STRING_HANDLE representing the content of the MAP.] */
-        result = STRING_construct("{");
-        if (result == NULL)
+        uint8_t version;
+        read_uint8_t(source + MAP_VERSION_OFFSET, &version);
+        if (version != MAP_VERSION_V1)
         {
-            /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-            LogError("STRING_construct failed");
+            /*Codes_SRS_MAP_11_080: [ If the byte at offset 0 of source is not 1 (current version) then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            LogError("different version (%" PRIu8 ") detected. This module only knows about version %" PRIu8 "", version, MAP_VERSION_V1);
+            result = MAP_FROM_BUFFER_RESULT_INVALID_DATA;
         }
         else
         {
-            size_t i;
-            MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA *)handle;
-            /*Codes_SRS_MAP_02_049: [If the MAP is empty, then Map_ToJSON shall produce the string "{}".*/
-            bool breakFor = false; /*used to break out of for*/
-            for (i = 0; (i < handleData->count) && (!breakFor); i++)
+            uint32_t count;
+            uint32_t pairsSize;
+            size_t stringsSize;
+            /*Codes_SRS_MAP_11_081: [ Map_FromBuffer shall read the number of pairs from offset 1 of source. ]*/
+            read_uint32_t(source + MAP_COUNT_OFFSET, &count);
+            if (count > (size - MAP_MIN_SERIALIZATION_SIZE) / MAP_MIN_PAIR_SIZE)
             {
-                /*add one entry to the JSON*/
-                /*Codes_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}]*/
-                STRING_HANDLE key = STRING_new_JSON(handleData->keys[i]);
-                if (key == NULL)
-                {
-                    /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-                    LogError("STRING_new_JSON failed");
-                    STRING_delete(result);
-                    result = NULL;
-                    breakFor = true;
-                }
-                else
-                {
-                    STRING_HANDLE value = STRING_new_JSON(handleData->values[i]);
-                    if (value == NULL)
-                    {
-                        /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-                        LogError("STRING_new_JSON failed");
-                        STRING_delete(result);
-                        result = NULL;
-                        breakFor = true;
-                    }
-                    else
-                    {
-                        if (!(
-                            ((i>0) ? (STRING_concat(result, ",") == 0) : 1) &&
-                            (STRING_concat_with_STRING(result, key) == 0) &&
-                            (STRING_concat(result, ":") == 0) &&
-                            (STRING_concat_with_STRING(result, value) == 0)
-                            ))
-                        {
-                            /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-                            LogError("failed to build the JSON");
-                            STRING_delete(result);
-                            result = NULL;
-                            breakFor = true;
-                        }
-                        else
-                        {
-                            /*all nice, go to the next element in the map*/
-                        }
-                        STRING_delete(value);
-                    }
-                    STRING_delete(key);
-                }
+                /*Codes_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("count=%" PRIu32 " pairs cannot fit in size=%" PRIu32 " bytes", count, size);
+                result = MAP_FROM_BUFFER_RESULT_INVALID_DATA;
             }
-
-            if (breakFor)
+            else if (Map_ValidatePairs(source + MAP_PAIRS_OFFSET, size - (uint32_t)MAP_PAIRS_OFFSET, count, &pairsSize, &stringsSize) != 0)
             {
-                LogError("error happened during JSON string builder");
+                /*Codes_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("failure in Map_ValidatePairs(source=%p + MAP_PAIRS_OFFSET=%zu, size=%" PRIu32 " - MAP_PAIRS_OFFSET, count=%" PRIu32 ", &pairsSize, &stringsSize)",
+                    source, MAP_PAIRS_OFFSET, size, count);
+                result = MAP_FROM_BUFFER_RESULT_INVALID_DATA;
             }
             else
             {
-                if (STRING_concat(result, "}") != 0)
+                /*Codes_SRS_MAP_11_083: [ Map_FromBuffer shall create the map by calling Map_CreateWithArena with no filter, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+                MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)Map_CreateWithArena(NULL, count, stringsSize);
+                if (handleData == NULL)
                 {
-                    /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-                    LogError("failed to build the JSON");
-                    STRING_delete(result);
-                    result = NULL;
+                    /*Codes_SRS_MAP_11_086: [ If there are any failures then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_ERROR. ]*/
+                    LogError("failure in Map_CreateWithArena(NULL, count=%" PRIu32 ", stringsSize=%zu)", count, stringsSize);
+                    result = MAP_FROM_BUFFER_RESULT_ERROR;
+                }
+                /*Codes_SRS_MAP_11_084: [ Map_FromBuffer shall copy the keys and values in the arena, adding their null terminators, without allocating memory. ]*/
+                else if (Map_StoreReadPairs(handleData->store, source + MAP_PAIRS_OFFSET, count) != 0)
+                {
+                    /*Codes_SRS_MAP_11_085: [ If a key appears more than once then Map_FromBuffer shall destroy the map and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                    LogError("failure in Map_StoreReadPairs(handleData->store=%p, source=%p + MAP_PAIRS_OFFSET=%zu, count=%" PRIu32 ")",
+                        handleData->store, source, MAP_PAIRS_OFFSET, count);
+                    Map_Destroy(handleData);
+                    result = MAP_FROM_BUFFER_RESULT_INVALID_DATA;
                 }
                 else
                 {
-                    /*return as is, JSON has been build*/
+                    /*Codes_SRS_MAP_11_087: [ Map_FromBuffer shall succeed, write in *consumed the number of bytes of the serialization, write in *destination the map and return MAP_FROM_BUFFER_RESULT_OK. ]*/
+                    *consumed = (uint32_t)MAP_PAIRS_OFFSET + pairsSize;
+                    *destination = handleData;
+                    result = MAP_FROM_BUFFER_RESULT_OK;
                 }
             }
         }
     }
     return result;
-
 }
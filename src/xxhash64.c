@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_util/xxhash64.h"
+
+#define XXHASH64_PRIME_1 0x9E3779B185EBCA87ULL
+#define XXHASH64_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define XXHASH64_PRIME_3 0x165667B19E3779F9ULL
+#define XXHASH64_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define XXHASH64_PRIME_5 0x27D4EB2F165667C5ULL
+
+#define XXHASH64_STRIPE_SIZE 32
+
+static uint64_t xxhash64_rotl(uint64_t value, uint32_t bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/*the input is read as little endian regardless of the platform, compilers turn these into a single (unaligned) load on little endian targets*/
+static uint64_t xxhash64_read_64(const unsigned char* source)
+{
+    return
+        ((uint64_t)source[0]) |
+        ((uint64_t)source[1] << 8) |
+        ((uint64_t)source[2] << 16) |
+        ((uint64_t)source[3] << 24) |
+        ((uint64_t)source[4] << 32) |
+        ((uint64_t)source[5] << 40) |
+        ((uint64_t)source[6] << 48) |
+        ((uint64_t)source[7] << 56);
+}
+
+static uint32_t xxhash64_read_32(const unsigned char* source)
+{
+    return
+        ((uint32_t)source[0]) |
+        ((uint32_t)source[1] << 8) |
+        ((uint32_t)source[2] << 16) |
+        ((uint32_t)source[3] << 24);
+}
+
+static uint64_t xxhash64_round(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * XXHASH64_PRIME_2;
+    accumulator = xxhash64_rotl(accumulator, 31);
+    return accumulator * XXHASH64_PRIME_1;
+}
+
+static uint64_t xxhash64_merge_round(uint64_t hash, uint64_t accumulator)
+{
+    hash ^= xxhash64_round(0, accumulator);
+    return hash * XXHASH64_PRIME_1 + XXHASH64_PRIME_4;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, uint64_t, xxhash64, const unsigned char*, buffer, size_t, size, uint64_t, seed)
+{
+    uint64_t result;
+    if ((buffer == NULL) && (size != 0))
+    {
+        /*Codes_SRS_XXHASH64_11_001: [ If buffer is NULL and size is not 0 then xxhash64 shall fail and return 0. ]*/
+        LogError("invalid arguments const unsigned char* buffer=%p, size_t size=%zu, uint64_t seed=%" PRIu64 "", buffer, size, seed);
+        result = 0;
+    }
+    else
+    {
+        const unsigned char* current = buffer;
+        const unsigned char* end = buffer + size;
+
+        if (size >= XXHASH64_STRIPE_SIZE)
+        {
+            /*Codes_SRS_XXHASH64_11_002: [ xxhash64 shall consume the bytes of buffer in stripes of 32 bytes with 4 independent accumulators and merge the accumulators into the hash. ]*/
+            const unsigned char* last_stripe = end - XXHASH64_STRIPE_SIZE;
+            uint64_t accumulator_1 = seed + XXHASH64_PRIME_1 + XXHASH64_PRIME_2;
+            uint64_t accumulator_2 = seed + XXHASH64_PRIME_2;
+            uint64_t accumulator_3 = seed;
+            uint64_t accumulator_4 = seed - XXHASH64_PRIME_1;
+
+            do
+            {
+                accumulator_1 = xxhash64_round(accumulator_1, xxhash64_read_64(current));
+                accumulator_2 = xxhash64_round(accumulator_2, xxhash64_read_64(current + 8));
+                accumulator_3 = xxhash64_round(accumulator_3, xxhash64_read_64(current + 16));
+                accumulator_4 = xxhash64_round(accumulator_4, xxhash64_read_64(current + 24));
+                current += XXHASH64_STRIPE_SIZE;
+            } while (current <= last_stripe);
+
+            result = xxhash64_rotl(accumulator_1, 1) + xxhash64_rotl(accumulator_2, 7) + xxhash64_rotl(accumulator_3, 12) + xxhash64_rotl(accumulator_4, 18);
+            result = xxhash64_merge_round(result, accumulator_1);
+            result = xxhash64_merge_round(result, accumulator_2);
+            result = xxhash64_merge_round(result, accumulator_3);
+            result = xxhash64_merge_round(result, accumulator_4);
+        }
+        else
+        {
+            result = seed + XXHASH64_PRIME_5;
+        }
+
+        result += (uint64_t)size;
+
+        /*Codes_SRS_XXHASH64_11_003: [ xxhash64 shall mix in the remaining bytes 8 bytes at a time, then 4 bytes at a time, then 1 byte at a time. ]*/
+        while (end - current >= 8)
+        {
+            result ^= xxhash64_round(0, xxhash64_read_64(current));
+            result = xxhash64_rotl(result, 27) * XXHASH64_PRIME_1 + XXHASH64_PRIME_4;
+            current += 8;
+        }
+
+        if (end - current >= 4)
+        {
+            result ^= (uint64_t)xxhash64_read_32(current) * XXHASH64_PRIME_1;
+            result = xxhash64_rotl(result, 23) * XXHASH64_PRIME_2 + XXHASH64_PRIME_3;
+            current += 4;
+        }
+
+        while (current < end)
+        {
+            result ^= (uint64_t)(*current) * XXHASH64_PRIME_5;
+            result = xxhash64_rotl(result, 11) * XXHASH64_PRIME_1;
+            current++;
+        }
+
+        /*Codes_SRS_XXHASH64_11_004: [ xxhash64 shall finish the hash with the XXH64 avalanche and return it. ]*/
+        result ^= result >> 33;
+        result *= XXHASH64_PRIME_2;
+        result ^= result >> 29;
+        result *= XXHASH64_PRIME_3;
+        result ^= result >> 32;
+    }
+    return result;
+}
@@ -0,0 +1,273 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/string_utils.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/timer.h"
+
+#include "c_util/concurrent_map.h"
+#include "c_util/map.h"
+
+TEST_DEFINE_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+#define N_KEYS 1000 /*number of keys in the map*/
+#define N_MAX_READERS 64 /*the scaling runs go from 1 to this many reader threads*/
+#define RUN_TIME_MS 1000 /*how long every run reads the map*/
+#define WRITE_PERIOD_MS 10 /*the writer thread changes the map this often, the workload is read-mostly*/
+#define LOCKED_MAP_WRITER 0x40000000 /*added to the lock word by a writer, new readers wait while it is there*/
+
+/*the way a MAP_HANDLE is shared without concurrent_map: a reader/writer lock kept in a single word, like an SRW lock*/
+typedef struct LOCKED_MAP_TAG
+{
+    volatile_atomic int32_t lock; /*number of readers, plus LOCKED_MAP_WRITER while a writer waits or writes*/
+    MAP_HANDLE map;
+}LOCKED_MAP;
+
+typedef struct SCALING_RUN_TAG
+{
+    char** keys;
+    CONCURRENT_MAP_HANDLE concurrent_map;
+    LOCKED_MAP* locked_map; /*NULL when the run measures concurrent_map*/
+    volatile_atomic int32_t stop;
+    volatile_atomic int64_t n_reads;
+    volatile_atomic int32_t n_writes;
+}SCALING_RUN;
+
+static char** create_keys(size_t count)
+{
+    char** result = malloc_2(count, sizeof(char*));
+    ASSERT_IS_NOT_NULL(result);
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = sprintf_char("property_%zu", i);
+        ASSERT_IS_NOT_NULL(result[i]);
+    }
+    return result;
+}
+
+static void destroy_keys(char** keys, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        free(keys[i]);
+    }
+    free(keys);
+}
+
+static void locked_map_read_begin(LOCKED_MAP* locked_map)
+{
+    for (;;)
+    {
+        int32_t lock = interlocked_add(&locked_map->lock, 0);
+        if (lock >= LOCKED_MAP_WRITER)
+        {
+            ThreadAPI_Sleep(0);
+        }
+        else if (interlocked_compare_exchange(&locked_map->lock, lock + 1, lock) == lock)
+        {
+            break;
+        }
+    }
+}
+
+static void locked_map_read_end(LOCKED_MAP* locked_map)
+{
+    (void)interlocked_decrement(&locked_map->lock);
+}
+
+static void locked_map_write_begin(LOCKED_MAP* locked_map)
+{
+    /*there is only 1 writer thread*/
+    (void)interlocked_add(&locked_map->lock, LOCKED_MAP_WRITER);
+    while (interlocked_add(&locked_map->lock, 0) != LOCKED_MAP_WRITER)
+    {
+        ThreadAPI_Sleep(0);
+    }
+}
+
+static void locked_map_write_end(LOCKED_MAP* locked_map)
+{
+    (void)interlocked_add(&locked_map->lock, -LOCKED_MAP_WRITER);
+}
+
+static int reader_thread(void* context)
+{
+    SCALING_RUN* run = context;
+    uint32_t seed = (uint32_t)(uintptr_t)&seed;
+    int64_t n_reads = 0;
+    while (interlocked_add(&run->stop, 0) == 0)
+    {
+        /*a batch of reads between 2 looks at the stop flag*/
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            const char* key = run->keys[(seed >> 8) % N_KEYS];
+            bool keyExists;
+            if (run->locked_map == NULL)
+            {
+                ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, concurrent_map_contains_key(run->concurrent_map, key, &keyExists));
+            }
+            else
+            {
+                locked_map_read_begin(run->locked_map);
+                ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(run->locked_map->map, key, &keyExists));
+                locked_map_read_end(run->locked_map);
+            }
+            ASSERT_IS_TRUE(keyExists);
+        }
+        n_reads += 100;
+    }
+    (void)interlocked_add_64(&run->n_reads, n_reads);
+    return 0;
+}
+
+static int writer_thread(void* context)
+{
+    SCALING_RUN* run = context;
+    uint32_t i = 0;
+    while (interlocked_add(&run->stop, 0) == 0)
+    {
+        const char* key = run->keys[i % N_KEYS];
+        const char* value = run->keys[(i + 1) % N_KEYS];
+        if (run->locked_map == NULL)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, concurrent_map_add_or_update(run->concurrent_map, key, value));
+        }
+        else
+        {
+            locked_map_write_begin(run->locked_map);
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(run->locked_map->map, key, value));
+            locked_map_write_end(run->locked_map);
+        }
+        (void)interlocked_increment(&run->n_writes);
+        i++;
+        ThreadAPI_Sleep(WRITE_PERIOD_MS);
+    }
+    return 0;
+}
+
+/*returns the number of reads per ms that n_readers threads did while 1 thread was changing the map*/
+static double run_readers(char** keys, CONCURRENT_MAP_HANDLE concurrent_map, LOCKED_MAP* locked_map, uint32_t n_readers, int32_t* n_writes)
+{
+    SCALING_RUN* run = malloc(sizeof(SCALING_RUN));
+    ASSERT_IS_NOT_NULL(run);
+    run->keys = keys;
+    run->concurrent_map = concurrent_map;
+    run->locked_map = locked_map;
+    (void)interlocked_exchange(&run->stop, 0);
+    (void)interlocked_exchange_64(&run->n_reads, 0);
+    (void)interlocked_exchange(&run->n_writes, 0);
+
+    THREAD_HANDLE readers[N_MAX_READERS];
+    THREAD_HANDLE writer;
+
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < n_readers; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&readers[i], reader_thread, run));
+    }
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&writer, writer_thread, run));
+
+    ThreadAPI_Sleep(RUN_TIME_MS);
+    (void)interlocked_exchange(&run->stop, 1);
+
+    int dont_care;
+    for (uint32_t i = 0; i < n_readers; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(readers[i], &dont_care));
+    }
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(writer, &dont_care));
+    double elapsed_ms = timer_global_get_elapsed_ms() - start;
+
+    double n_reads = (double)interlocked_add_64(&run->n_reads, 0);
+    *n_writes = interlocked_add(&run->n_writes, 0);
+    free(run);
+    return n_reads / elapsed_ms;
+}
+
+static void measure_scaling(void)
+{
+    ///arrange
+    char** keys = create_keys(N_KEYS);
+
+    CONCURRENT_MAP_HANDLE concurrent_map = concurrent_map_create(NULL);
+    ASSERT_IS_NOT_NULL(concurrent_map);
+
+    LOCKED_MAP locked_map;
+    (void)interlocked_exchange(&locked_map.lock, 0);
+    locked_map.map = Map_CreateWithCapacity(NULL, N_KEYS);
+    ASSERT_IS_NOT_NULL(locked_map.map);
+
+    for (size_t i = 0; i < N_KEYS; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, concurrent_map_add(concurrent_map, keys[i], keys[i]));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(locked_map.map, keys[i], keys[i]));
+    }
+
+    ///act
+    for (uint32_t n_readers = 1; n_readers <= N_MAX_READERS; n_readers *= 2)
+    {
+        int32_t locked_writes;
+        int32_t concurrent_writes;
+        double locked_reads_per_ms = run_readers(keys, NULL, &locked_map, n_readers, &locked_writes);
+        double concurrent_reads_per_ms = run_readers(keys, concurrent_map, NULL, n_readers, &concurrent_writes);
+
+        ///assert
+        LogInfo("%" PRIu32 " readers: Map behind a reader/writer lock did %.0f reads/ms (%" PRId32 " writes), concurrent_map did %.0f reads/ms (%" PRId32 " writes), %.2fx",
+            n_readers, locked_reads_per_ms, locked_writes, concurrent_reads_per_ms, concurrent_writes, concurrent_reads_per_ms / locked_reads_per_ms);
+        ASSERT_IS_TRUE(concurrent_writes > 0);
+    }
+
+    ///cleanup
+    Map_Destroy(locked_map.map);
+    concurrent_map_destroy(concurrent_map);
+    destroy_keys(keys, N_KEYS);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(function_initialize)
+{
+}
+
+TEST_FUNCTION_CLEANUP(function_cleanup)
+{
+}
+
+TEST_FUNCTION(concurrent_map_perf_scaling_from_1_to_64_readers)
+{
+    measure_scaling();
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
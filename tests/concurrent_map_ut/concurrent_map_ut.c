@@ -0,0 +1,868 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_charptr.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umocktypes_bool.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+#include "c_pal/interlocked.h" /*included for mocking reasons - it will prohibit creation of mocks belonging to interlocked.h*/
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_util/interlocked_hl.h"
+#include "c_util/map.h"
+#undef ENABLE_MOCKS
+
+// Must include umock_c_prod so mocks are not expanded in the reals
+#include "umock_c/umock_c_prod.h"
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked_hl.h"
+
+#include "c_util/concurrent_map.h"
+
+#define TEST_READER_SLOT_COUNT 64 /*the number of reader slots the writer waits on*/
+
+static MAP_HANDLE TEST_SNAPSHOT_1 = (MAP_HANDLE)0x4201;
+static MAP_HANDLE TEST_SNAPSHOT_2 = (MAP_HANDLE)0x4202;
+static MAP_HANDLE TEST_SNAPSHOT_3 = (MAP_HANDLE)0x4203;
+
+static const char* TEST_VALUE = "value";
+
+static bool g_keyExists;
+
+static MAP_RESULT my_Map_ContainsKey(MAP_HANDLE handle, const char* key, bool* keyExists)
+{
+    (void)handle;
+    (void)key;
+    *keyExists = g_keyExists;
+    return MAP_OK;
+}
+
+static int test_filter_rejects_all(const char* mapProperty, const char* mapValue)
+{
+    (void)mapProperty;
+    (void)mapValue;
+    return 1;
+}
+
+static int test_filter_accepts_all(const char* mapProperty, const char* mapValue)
+{
+    (void)mapProperty;
+    (void)mapValue;
+    return 0;
+}
+
+MU_DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
+
+MU_DEFINE_ENUM_STRINGS(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT_VALUES);
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static CONCURRENT_MAP_HANDLE TEST_concurrent_map_create(MAP_FILTER_CALLBACK mapFilterFunc)
+{
+    CONCURRENT_MAP_HANDLE result;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    result = concurrent_map_create(mapFilterFunc);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+    return result;
+}
+
+/*the calls a writer makes once the change was applied to the clone*/
+static void setup_publish_expectations(MAP_HANDLE oldSnapshot, MAP_HANDLE newSnapshot)
+{
+    uint32_t i;
+    STRICT_EXPECTED_CALL(Map_GetInternals(newSnapshot, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    for (i = 0; i < TEST_READER_SLOT_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(InterlockedHL_WaitForValue(IGNORED_ARG, 0, UINT32_MAX));
+    }
+    STRICT_EXPECTED_CALL(Map_Destroy(oldSnapshot));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+
+    REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
+    REGISTER_TYPE(MAP_RESULT, MAP_RESULT);
+    REGISTER_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT);
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_INTERLOCKED_HL_GLOBAL_MOCK_HOOK();
+
+    REGISTER_GLOBAL_MOCK_RETURNS(Map_Create, TEST_SNAPSHOT_1, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(Map_Clone, TEST_SNAPSHOT_2, NULL);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_Add, MAP_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_AddOrUpdate, MAP_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_Delete, MAP_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_GetInternals, MAP_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_GetValueFromKey, TEST_VALUE);
+    REGISTER_GLOBAL_MOCK_HOOK(Map_ContainsKey, my_Map_ContainsKey);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    g_keyExists = false;
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* concurrent_map_create */
+
+/*Tests_SRS_CONCURRENT_MAP_11_001: [ concurrent_map_create shall allocate memory for the concurrent map and its reader slots in a single allocation and shall place the reader slots at a cache line boundary. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_002: [ concurrent_map_create shall create the first snapshot by calling Map_Create with NULL as filter, the filter is applied by concurrent_map_add and concurrent_map_add_or_update. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_003: [ concurrent_map_create shall set the epoch and all the reader counters to 0. ]*/
+TEST_FUNCTION(concurrent_map_create_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(Map_Create(NULL));
+
+    ///act
+    CONCURRENT_MAP_HANDLE handle = concurrent_map_create(test_filter_accepts_all);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_004: [ If there are any failures then concurrent_map_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_concurrent_map_create_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONCURRENT_MAP_HANDLE handle = concurrent_map_create(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_004: [ If there are any failures then concurrent_map_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_Map_Create_fails_concurrent_map_create_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(Map_Create(NULL))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONCURRENT_MAP_HANDLE handle = concurrent_map_create(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* concurrent_map_destroy */
+
+/*Tests_SRS_CONCURRENT_MAP_11_005: [ If handle is NULL then concurrent_map_destroy shall return. ]*/
+TEST_FUNCTION(concurrent_map_destroy_with_NULL_handle_returns)
+{
+    ///act
+    concurrent_map_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_006: [ concurrent_map_destroy shall destroy the snapshot by calling Map_Destroy and free all used resources. ]*/
+TEST_FUNCTION(concurrent_map_destroy_frees_resources)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Destroy(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(free(handle));
+
+    ///act
+    concurrent_map_destroy(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* concurrent_map_add */
+
+/*Tests_SRS_CONCURRENT_MAP_11_007: [ If handle, key or value is NULL then concurrent_map_add shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_with_NULL_handle_fails)
+{
+    ///act
+    MAP_RESULT result = concurrent_map_add(NULL, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_007: [ If handle, key or value is NULL then concurrent_map_add shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_with_NULL_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, NULL, "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_007: [ If handle, key or value is NULL then concurrent_map_add shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_with_NULL_value_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_008: [ If the filter passed to concurrent_map_create is not NULL and it returns non-zero for key and value then concurrent_map_add shall return MAP_FILTER_REJECT. ]*/
+TEST_FUNCTION(concurrent_map_add_when_the_filter_rejects_returns_MAP_FILTER_REJECT)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(test_filter_rejects_all);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_FILTER_REJECT, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_009: [ concurrent_map_add shall change the map as described in "Changing the map" with Map_Add as change. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_015: [ The writer shall acquire the writer lock by switching it from 0 to 1 with interlocked_compare_exchange, waiting with InterlockedHL_WaitForValue for the lock to become 0 while it is 1. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_016: [ The writer shall clone the snapshot by calling Map_Clone. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_017: [ The writer shall apply the change to the clone. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_019: [ The writer shall compact the clone by calling Map_GetInternals. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_020: [ The writer shall publish the clone as the snapshot by calling interlocked_exchange_pointer. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_021: [ The writer shall increment the epoch and wait with InterlockedHL_WaitForValue for all the reader counters of the previous epoch's parity to become 0. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_022: [ The writer shall destroy the previous snapshot by calling Map_Destroy and return MAP_OK. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_023: [ The writer shall release the writer lock by calling InterlockedHL_SetAndWake with 0. ]*/
+TEST_FUNCTION(concurrent_map_add_succeeds)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(test_filter_accepts_all);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_Add(TEST_SNAPSHOT_2, "key", "value"));
+    setup_publish_expectations(TEST_SNAPSHOT_1, TEST_SNAPSHOT_2);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_018: [ If the change does not return MAP_OK then the writer shall destroy the clone by calling Map_Destroy, leave the snapshot in place and return the result of the change. ]*/
+TEST_FUNCTION(when_Map_Add_returns_MAP_KEYEXISTS_concurrent_map_add_returns_MAP_KEYEXISTS)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_Add(TEST_SNAPSHOT_2, "key", "value"))
+        .SetReturn(MAP_KEYEXISTS);
+    STRICT_EXPECTED_CALL(Map_Destroy(TEST_SNAPSHOT_2));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_018: [ If the change does not return MAP_OK then the writer shall destroy the clone by calling Map_Destroy, leave the snapshot in place and return the result of the change. ]*/
+TEST_FUNCTION(when_Map_Add_fails_concurrent_map_add_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_Add(TEST_SNAPSHOT_2, "key", "value"))
+        .SetReturn(MAP_ERROR);
+    STRICT_EXPECTED_CALL(Map_Destroy(TEST_SNAPSHOT_2));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_024: [ If Map_Clone fails then the writer shall return MAP_ERROR. ]*/
+TEST_FUNCTION(when_Map_Clone_fails_concurrent_map_add_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_022: [ The writer shall destroy the previous snapshot by calling Map_Destroy and return MAP_OK. ]*/
+TEST_FUNCTION(concurrent_map_add_twice_clones_the_published_snapshot)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, concurrent_map_add(handle, "key1", "value1"));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_2))
+        .SetReturn(TEST_SNAPSHOT_3);
+    STRICT_EXPECTED_CALL(Map_Add(TEST_SNAPSHOT_3, "key2", "value2"));
+    setup_publish_expectations(TEST_SNAPSHOT_2, TEST_SNAPSHOT_3);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add(handle, "key2", "value2");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/* concurrent_map_add_or_update */
+
+/*Tests_SRS_CONCURRENT_MAP_11_010: [ If handle, key or value is NULL then concurrent_map_add_or_update shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_or_update_with_NULL_handle_fails)
+{
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(NULL, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_010: [ If handle, key or value is NULL then concurrent_map_add_or_update shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_or_update_with_NULL_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(handle, NULL, "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_010: [ If handle, key or value is NULL then concurrent_map_add_or_update shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_add_or_update_with_NULL_value_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(handle, "key", NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_011: [ If the filter passed to concurrent_map_create is not NULL and it returns non-zero for key and value then concurrent_map_add_or_update shall return MAP_FILTER_REJECT. ]*/
+TEST_FUNCTION(concurrent_map_add_or_update_when_the_filter_rejects_returns_MAP_FILTER_REJECT)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(test_filter_rejects_all);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_FILTER_REJECT, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_012: [ concurrent_map_add_or_update shall change the map as described in "Changing the map" with Map_AddOrUpdate as change. ]*/
+TEST_FUNCTION(concurrent_map_add_or_update_succeeds)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(test_filter_accepts_all);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_AddOrUpdate(TEST_SNAPSHOT_2, "key", "value"));
+    setup_publish_expectations(TEST_SNAPSHOT_1, TEST_SNAPSHOT_2);
+
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_018: [ If the change does not return MAP_OK then the writer shall destroy the clone by calling Map_Destroy, leave the snapshot in place and return the result of the change. ]*/
+TEST_FUNCTION(when_Map_AddOrUpdate_fails_concurrent_map_add_or_update_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_AddOrUpdate(TEST_SNAPSHOT_2, "key", "value"))
+        .SetReturn(MAP_ERROR);
+    STRICT_EXPECTED_CALL(Map_Destroy(TEST_SNAPSHOT_2));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+
+    ///act
+    MAP_RESULT result = concurrent_map_add_or_update(handle, "key", "value");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/* concurrent_map_delete */
+
+/*Tests_SRS_CONCURRENT_MAP_11_013: [ If handle or key is NULL then concurrent_map_delete shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_delete_with_NULL_handle_fails)
+{
+    ///act
+    MAP_RESULT result = concurrent_map_delete(NULL, "key");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_013: [ If handle or key is NULL then concurrent_map_delete shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_delete_with_NULL_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_delete(handle, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_014: [ concurrent_map_delete shall change the map as described in "Changing the map" with Map_Delete as change. ]*/
+TEST_FUNCTION(concurrent_map_delete_succeeds)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_Delete(TEST_SNAPSHOT_2, "key"));
+    setup_publish_expectations(TEST_SNAPSHOT_1, TEST_SNAPSHOT_2);
+
+    ///act
+    MAP_RESULT result = concurrent_map_delete(handle, "key");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_018: [ If the change does not return MAP_OK then the writer shall destroy the clone by calling Map_Destroy, leave the snapshot in place and return the result of the change. ]*/
+TEST_FUNCTION(when_Map_Delete_returns_MAP_KEYNOTFOUND_concurrent_map_delete_returns_MAP_KEYNOTFOUND)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1));
+    STRICT_EXPECTED_CALL(Map_Delete(TEST_SNAPSHOT_2, "key"))
+        .SetReturn(MAP_KEYNOTFOUND);
+    STRICT_EXPECTED_CALL(Map_Destroy(TEST_SNAPSHOT_2));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, 0));
+
+    ///act
+    MAP_RESULT result = concurrent_map_delete(handle, "key");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYNOTFOUND, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/* concurrent_map_contains_key */
+
+/*Tests_SRS_CONCURRENT_MAP_11_029: [ If handle, key or keyExists is NULL then concurrent_map_contains_key shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_contains_key_with_NULL_handle_fails)
+{
+    ///arrange
+    bool keyExists;
+
+    ///act
+    MAP_RESULT result = concurrent_map_contains_key(NULL, "key", &keyExists);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_029: [ If handle, key or keyExists is NULL then concurrent_map_contains_key shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_contains_key_with_NULL_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+    bool keyExists;
+
+    ///act
+    MAP_RESULT result = concurrent_map_contains_key(handle, NULL, &keyExists);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_029: [ If handle, key or keyExists is NULL then concurrent_map_contains_key shall fail and return MAP_INVALIDARG. ]*/
+TEST_FUNCTION(concurrent_map_contains_key_with_NULL_keyExists_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    MAP_RESULT result = concurrent_map_contains_key(handle, "key", NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_025: [ The reader shall pick a reader slot from the address of its stack. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_026: [ The reader shall read the epoch, increment the slot's counter for the parity of the epoch and read the epoch again. If the epoch changed then the reader shall decrement the counter and start over. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_027: [ The reader shall read the snapshot only after the counter was incremented in an unchanged epoch. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_028: [ When the reader is done with the snapshot it shall decrement the counter and, if the counter became 0 and the epoch changed since the reader read it, call wake_by_address_single. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_030: [ concurrent_map_contains_key shall call Map_ContainsKey on the snapshot as described in "Reading the map" and return its result. ]*/
+TEST_FUNCTION(concurrent_map_contains_key_succeeds)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+    bool keyExists = false;
+    g_keyExists = true;
+
+    STRICT_EXPECTED_CALL(Map_ContainsKey(TEST_SNAPSHOT_1, "key", &keyExists));
+
+    ///act
+    MAP_RESULT result = concurrent_map_contains_key(handle, "key", &keyExists);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_IS_TRUE(keyExists);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_027: [ The reader shall read the snapshot only after the counter was incremented in an unchanged epoch. ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_028: [ When the reader is done with the snapshot it shall decrement the counter and, if the counter became 0 and the epoch changed since the reader read it, call wake_by_address_single. ]*/
+TEST_FUNCTION(concurrent_map_contains_key_after_a_change_reads_the_published_snapshot)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+    bool keyExists = true;
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, concurrent_map_add(handle, "key", "value"));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Map_ContainsKey(TEST_SNAPSHOT_2, "other key", &keyExists));
+
+    ///act
+    MAP_RESULT result = concurrent_map_contains_key(handle, "other key", &keyExists);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+    ASSERT_IS_FALSE(keyExists);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/* concurrent_map_get_value_from_key */
+
+/*Tests_SRS_CONCURRENT_MAP_11_031: [ If handle or key is NULL then concurrent_map_get_value_from_key shall fail and return NULL. ]*/
+TEST_FUNCTION(concurrent_map_get_value_from_key_with_NULL_handle_fails)
+{
+    ///act
+    char* result = concurrent_map_get_value_from_key(NULL, "key");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_031: [ If handle or key is NULL then concurrent_map_get_value_from_key shall fail and return NULL. ]*/
+TEST_FUNCTION(concurrent_map_get_value_from_key_with_NULL_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    ///act
+    char* result = concurrent_map_get_value_from_key(handle, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_032: [ concurrent_map_get_value_from_key shall call Map_GetValueFromKey on the snapshot as described in "Reading the map". ]*/
+/*Tests_SRS_CONCURRENT_MAP_11_034: [ Otherwise concurrent_map_get_value_from_key shall allocate memory for a copy of the value, copy the value before releasing the snapshot and return the copy. ]*/
+TEST_FUNCTION(concurrent_map_get_value_from_key_returns_a_copy_of_the_value)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_GetValueFromKey(TEST_SNAPSHOT_1, "key"));
+    STRICT_EXPECTED_CALL(malloc(strlen(TEST_VALUE) + 1));
+
+    ///act
+    char* result = concurrent_map_get_value_from_key(handle, "key");
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, TEST_VALUE, result);
+    ASSERT_ARE_EQUAL(char_ptr, TEST_VALUE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    free(result);
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_033: [ If Map_GetValueFromKey returns NULL then concurrent_map_get_value_from_key shall return NULL. ]*/
+TEST_FUNCTION(concurrent_map_get_value_from_key_with_a_missing_key_returns_NULL)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_GetValueFromKey(TEST_SNAPSHOT_1, "key"))
+        .SetReturn(NULL);
+
+    ///act
+    char* result = concurrent_map_get_value_from_key(handle, "key");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_035: [ If allocating memory fails then concurrent_map_get_value_from_key shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_concurrent_map_get_value_from_key_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_GetValueFromKey(TEST_SNAPSHOT_1, "key"));
+    STRICT_EXPECTED_CALL(malloc(strlen(TEST_VALUE) + 1))
+        .SetReturn(NULL);
+
+    ///act
+    char* result = concurrent_map_get_value_from_key(handle, "key");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/* concurrent_map_get_snapshot */
+
+/*Tests_SRS_CONCURRENT_MAP_11_036: [ If handle is NULL then concurrent_map_get_snapshot shall fail and return NULL. ]*/
+TEST_FUNCTION(concurrent_map_get_snapshot_with_NULL_handle_fails)
+{
+    ///act
+    MAP_HANDLE result = concurrent_map_get_snapshot(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_037: [ concurrent_map_get_snapshot shall call Map_Clone on the snapshot as described in "Reading the map" and return its result. ]*/
+TEST_FUNCTION(concurrent_map_get_snapshot_succeeds)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1))
+        .SetReturn(TEST_SNAPSHOT_3);
+
+    ///act
+    MAP_HANDLE result = concurrent_map_get_snapshot(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_SNAPSHOT_3, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+/*Tests_SRS_CONCURRENT_MAP_11_037: [ concurrent_map_get_snapshot shall call Map_Clone on the snapshot as described in "Reading the map" and return its result. ]*/
+TEST_FUNCTION(when_Map_Clone_fails_concurrent_map_get_snapshot_fails)
+{
+    ///arrange
+    CONCURRENT_MAP_HANDLE handle = TEST_concurrent_map_create(NULL);
+
+    STRICT_EXPECTED_CALL(Map_Clone(TEST_SNAPSHOT_1))
+        .SetReturn(NULL);
+
+    ///act
+    MAP_HANDLE result = concurrent_map_get_snapshot(handle);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    concurrent_map_destroy(handle);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
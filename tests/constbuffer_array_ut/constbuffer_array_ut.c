@@ -3,10 +3,12 @@
 #ifdef __cplusplus
 #include <cinttypes>
 #include <cstdlib>
+#include <cstring>
 #else
 #include <inttypes.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #endif
 
 #include "real_gballoc_ll.h"
@@ -36,6 +38,8 @@ static void my_gballoc_free(void* s)
 #include "c_util/constbuffer.h"
 #undef ENABLE_MOCKS
 
+#include "c_util/constbuffer_version.h"
+
 #include "real_interlocked.h"
 #include "real_constbuffer.h"
 #include "real_gballoc_hl.h"
@@ -46,6 +50,9 @@ static TEST_MUTEX_HANDLE test_serialize_mutex;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -67,9 +74,11 @@ static CONSTBUFFER_HANDLE TEST_CONSTBUFFER_HANDLE_6;
 
 static void constbuffer_array_create_empty_inert_path(void)
 {
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
 }
 
 static void constbuffer_array_create_from_buffer_index_and_count_inert_path(void)
@@ -79,31 +88,50 @@ static void constbuffer_array_create_from_buffer_index_and_count_inert_path(void
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
 }
 
 static void constbuffer_array_add_front_inert_path(void)
 {
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, sizeof(CONSTBUFFER_HANDLE)));
+    /*adding to an empty array copies into new memory with headroom for CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM buffers*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4 + 1 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 4))
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+}
+
+static void constbuffer_array_add_front_in_headroom_inert_path(int32_t slot_index, CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, slot_index - 1, slot_index))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(constbuffer_handle));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(constbuffer_handle))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
 }
 
-static void constbuffer_array_remove_front_inert_path(uint32_t nExistingItems)
+static void constbuffer_array_remove_front_inert_path(void)
 {
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, nExistingItems - 1, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
     // clone front buffer
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
-    if (nExistingItems > 0)
-    {
-        uint32_t i;
-        for (i = 0; i < nExistingItems - 1; i++)
-        {
-            STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
-        }
-    }
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
 }
 
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create_empty(void)
@@ -135,6 +163,31 @@ static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create(uint32_t size, uin
     return result;
 }
 
+/*creates an array of TEST_CONSTBUFFER_HANDLE_1 and TEST_CONSTBUFFER_HANDLE_2 that sees the sizes of fake_content_1 and fake_content_2*/
+static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create_with_fake_sizes(const CONSTBUFFER* fake_content_1, const CONSTBUFFER* fake_content_2)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE test_buffers[2];
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(fake_content_2);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(fake_content_1);
+
+    result = constbuffer_array_create(test_buffers, 2);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+    return result;
+}
+
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_front(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, uint32_t nExistingBuffers, CONSTBUFFER_HANDLE constbuffer_handle)
 {
     uint32_t i;
@@ -187,9 +240,11 @@ static void TEST_constbuffer_array_dec_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_
 
 static void constbuffer_array_create_from_array_array_inert_path(uint32_t existing_item_count)
 {
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, existing_item_count, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, existing_item_count + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
     for (uint32_t i = 0; i < existing_item_count; i++)
     {
         STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
@@ -249,12 +304,20 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
 
     REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_WRITABLE_HANDLE, void*);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_GetContent, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateFromOffsetAndSize, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWritableHandle, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_AppendToWritableBuffer, MU_FAILURE);
+
+    REGISTER_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_from_buffer_no_copy, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR);
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
 
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
 }
@@ -313,6 +376,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_009: [ constbuffer_array_create shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold buffer_count buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_010: [ constbuffer_array_create shall clone the buffers in buffers and store them. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_016: [ constbuffer_array_create shall compute the size of all buffers by calling CONSTBUFFER_GetContent for each buffer, from the last to the first. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
 TEST_FUNCTION(constbuffer_array_create_succeeds)
 {
@@ -323,10 +387,13 @@ TEST_FUNCTION(constbuffer_array_create_succeeds)
     test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
     test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]), sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]) + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
 
     ///act
     constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
@@ -368,8 +435,9 @@ TEST_FUNCTION(constbuffer_array_create_with_0_buffer_count_succeeds)
 
     test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
 
     ///act
     constbuffer_array = constbuffer_array_create(test_buffers, 0);
@@ -392,7 +460,7 @@ TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_fails)
     test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
     test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]), sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]) + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
 
@@ -432,6 +500,7 @@ TEST_FUNCTION(constbuffer_array_create_with_move_buffers_with_NULL_buffers_fails
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_029: [ Otherwise, constbuffer_array_create_with_move_buffers shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that holds the const buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_017: [ constbuffer_array_create_with_move_buffers shall compute the size of all buffers by calling CONSTBUFFER_GetContent for each buffer, from the last to the first. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_031: [ On success constbuffer_array_create_with_move_buffers shall return a non-NULL handle. ]*/
 TEST_FUNCTION(constbuffer_array_create_with_move_buffers_succeeds)
 {
@@ -446,8 +515,11 @@ TEST_FUNCTION(constbuffer_array_create_with_move_buffers_succeeds)
     test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 1, sizeof(uint64_t)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
 
     ///act
     constbuffer_array = constbuffer_array_create_with_move_buffers(test_buffers, 2);
@@ -841,6 +913,256 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_fails_when_un
     constbuffer_array_dec_ref(original);
 }
 
+/* constbuffer_array_create_from_byte_offset_and_length */
+
+/*the arrays in these tests are made by TEST_constbuffer_array_create(4, 0): TEST_CONSTBUFFER_HANDLE_1 holds byte 0, TEST_CONSTBUFFER_HANDLE_2 bytes 1..2, TEST_CONSTBUFFER_HANDLE_3 bytes 3..5 and TEST_CONSTBUFFER_HANDLE_4 bytes 6..9*/
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_023: [ If original is NULL then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_with_NULL_original_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(NULL, 0, 0);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_024: [ If byte_offset + byte_length is greater than the size of all buffers in original then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_with_range_past_the_end_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 4, 7);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_024: [ If byte_offset + byte_length is greater than the size of all buffers in original then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_with_byte_offset_plus_byte_length_overflowing_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 1, UINT64_MAX);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_025: [ If byte_length is 0 then constbuffer_array_create_from_byte_offset_and_length shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_with_0_byte_length_creates_empty_array)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+
+    constbuffer_array_create_empty_inert_path();
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 10, 0);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_026: [ constbuffer_array_create_from_byte_offset_and_length shall find the buffer that holds the byte at byte_offset and the buffer that holds the byte at byte_offset + byte_length - 1 by binary search. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_027: [ If both buffers are entirely in the range then constbuffer_array_create_from_byte_offset_and_length shall return the result of calling constbuffer_array_create_from_buffer_index_and_count with the buffers from the first to the last. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_on_buffer_boundaries_does_not_copy_the_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+
+    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 1, 5);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(constbuffer_array_get_const_buffer_handle_array(original) + 1), (void*)constbuffer_array_get_const_buffer_handle_array(result));
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_026: [ constbuffer_array_create_from_byte_offset_and_length shall find the buffer that holds the byte at byte_offset and the buffer that holds the byte at byte_offset + byte_length - 1 by binary search. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_028: [ Otherwise constbuffer_array_create_from_byte_offset_and_length shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold the buffers from the first to the last. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_029: [ For the first and the last buffer, constbuffer_array_create_from_byte_offset_and_length shall call CONSTBUFFER_CreateFromOffsetAndSize with the part of the buffer that is in the range, or CONSTBUFFER_IncRef if the entire buffer is in the range. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_030: [ constbuffer_array_create_from_byte_offset_and_length shall inc_ref all the other buffers and store them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_031: [ constbuffer_array_create_from_byte_offset_and_length shall compute the size of all buffers from the sizes already known by original. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_032: [ constbuffer_array_create_from_byte_offset_and_length shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_slices_the_edge_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    uint64_t all_buffers_size;
+    const CONSTBUFFER* content;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_2, 1, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_4, 0, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 2, 6);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint64_t, 6, all_buffers_size);
+
+    content = real_CONSTBUFFER_GetContent(constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, real_CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2)->buffer + 1, content->buffer); /*zero-copy*/
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, constbuffer_array_get_const_buffer_handle_array(result)[1]);
+    content = real_CONSTBUFFER_GetContent(constbuffer_array_get_const_buffer_handle_array(result)[2]);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, real_CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_4)->buffer, content->buffer); /*zero-copy*/
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_029: [ For the first and the last buffer, constbuffer_array_create_from_byte_offset_and_length shall call CONSTBUFFER_CreateFromOffsetAndSize with the part of the buffer that is in the range, or CONSTBUFFER_IncRef if the entire buffer is in the range. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_032: [ constbuffer_array_create_from_byte_offset_and_length shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_with_entire_first_buffer_inc_refs_it)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint64_t all_buffers_size;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_3, 0, 1));
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 1, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint64_t, 3, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_029: [ For the first and the last buffer, constbuffer_array_create_from_byte_offset_and_length shall call CONSTBUFFER_CreateFromOffsetAndSize with the part of the buffer that is in the range, or CONSTBUFFER_IncRef if the entire buffer is in the range. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_032: [ constbuffer_array_create_from_byte_offset_and_length shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_inside_one_buffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    const CONSTBUFFER* content;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_3, 1, 1));
+
+    ///act
+    result = constbuffer_array_create_from_byte_offset_and_length(original, 4, 1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    content = real_CONSTBUFFER_GetContent(constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, real_CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3)->buffer + 1, content->buffer);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_033: [ If there are any failures then constbuffer_array_create_from_byte_offset_and_length shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_byte_offset_and_length_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    size_t i;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_2, 1, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(TEST_CONSTBUFFER_HANDLE_4, 0, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_create_from_byte_offset_and_length(original, 2, 6);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
 /* constbuffer_array_create_empty */
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_004: [ constbuffer_array_create_empty shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
@@ -1307,6 +1629,55 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_2_2_element_arrays_
     constbuffer_array_dec_ref(test_array);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_018: [ constbuffer_array_create_from_array_array shall compute the size of all buffers from the sizes already known by buffer_arrays. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_array_array_computes_the_size_of_all_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const uint32_t array_count = 3;
+    CONSTBUFFER_ARRAY_HANDLE buffer_array[3];
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE empty = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(empty, 0, TEST_CONSTBUFFER_HANDLE_6);
+    CONSTBUFFER_ARRAY_HANDLE view;
+    uint32_t all_buffers_size;
+    uint64_t all_buffers_size_u64;
+    /*TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_3 follows it in the memory*/
+    buffer_array[0] = constbuffer_array_create_from_buffer_index_and_count(original, 1, 1);
+    ASSERT_IS_NOT_NULL(buffer_array[0]);
+    buffer_array[1] = TEST_constbuffer_array_create(2, 3);
+    /*TEST_CONSTBUFFER_HANDLE_1 then TEST_CONSTBUFFER_HANDLE_6, in the headroom of afterAdd1*/
+    buffer_array[2] = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_1);
+    ASSERT_IS_NOT_NULL(buffer_array[2]);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_create_from_array_array(buffer_array, array_count);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 2 + 4 + 5 + 1 + 6, all_buffers_size);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(result, &all_buffers_size_u64));
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 4 + 5 + 1 + 6, all_buffers_size_u64);
+    /*every buffer has its own size, not only the total*/
+    view = constbuffer_array_create_from_buffer_index_and_count(result, 1, 3);
+    ASSERT_IS_NOT_NULL(view);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(view, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 4 + 5 + 1, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(view);
+    constbuffer_array_dec_ref(result);
+    for (uint32_t i = 0; i < array_count; ++i)
+    {
+        constbuffer_array_dec_ref(buffer_array[i]);
+    }
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(empty);
+    constbuffer_array_dec_ref(original);
+}
+
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_008: [ If there are any failures then constbuffer_array_create_from_array_array shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_create_from_array_array_fails_if_malloc_fails)
 {
@@ -1317,7 +1688,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_fails_if_malloc_fails)
     buffer_array[0] = TEST_constbuffer_array_create(2, 0);
     buffer_array[1] = TEST_constbuffer_array_create(2, 2);
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 2, sizeof(CONSTBUFFER_HANDLE)))
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 2 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)))
         .SetReturn(NULL);
 
     ///act
@@ -1334,90 +1705,809 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_fails_if_malloc_fails)
     }
 }
 
-/*constbuffer_array_add_front*/
+/* constbuffer_array_create_from_serialized_buffers */
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_006: [ If constbuffer_array_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
-TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_array_handle_NULL_fails)
+/*3 version 1 records: "ab", "" and "c"*/
+static const unsigned char TEST_SERIALIZED_V1_RECORDS[] =
 {
-    ///arrange
+    CONSTBUFFER_VERSION_V1, 0, 0, 0, 2, 'a', 'b',
+    CONSTBUFFER_VERSION_V1, 0, 0, 0, 0,
+    CONSTBUFFER_VERSION_V1, 0, 0, 0, 1, 'c'
+};
 
-    ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(NULL, TEST_CONSTBUFFER_HANDLE_1);
+static void* test_serialized_alloc(size_t size, void* context)
+{
+    (void)context;
+    return my_gballoc_malloc(size);
+}
 
-    ///assert
-    ASSERT_IS_NULL(result);
+/*builds a parent made of a version 1 record of "ab" followed by the version 2 serialization of TEST_CONSTBUFFER_HANDLE_3*/
+static CONSTBUFFER_HANDLE TEST_create_mixed_version_parent(uint32_t* v1_size)
+{
+    CONSTBUFFER_HANDLE result;
+    uint32_t v2_size;
+    unsigned char* v2 = real_CONSTBUFFER_to_buffer_v2(TEST_CONSTBUFFER_HANDLE_3, test_serialized_alloc, NULL, &v2_size);
+    ASSERT_IS_NOT_NULL(v2);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, v2[0]);
+
+    *v1_size = 7;
+    unsigned char* all = my_gballoc_malloc(*v1_size + v2_size);
+    ASSERT_IS_NOT_NULL(all);
+    (void)memcpy(all, TEST_SERIALIZED_V1_RECORDS, *v1_size);
+    (void)memcpy(all + *v1_size, v2, v2_size);
+
+    result = real_CONSTBUFFER_Create(all, *v1_size + v2_size);
+    ASSERT_IS_NOT_NULL(result);
+
+    my_gballoc_free(all);
+    my_gballoc_free(v2);
+    return result;
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_007: [ If constbuffer_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
-TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_handle_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_001: [ If parent is NULL then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_NULL_parent_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_004: [ If parent has no content then constbuffer_array_create_from_serialized_buffers shall create a new, empty CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_empty_parent_creates_empty_array)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+    constbuffer_array_create_empty_inert_path();
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    ///clean
+    constbuffer_array_dec_ref(result);
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_002: [ constbuffer_array_create_from_serialized_buffers shall scan the content of parent and validate the version (1 or 2) and the size of every record before creating any CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_005: [ constbuffer_array_create_from_serialized_buffers shall allocate memory to hold one CONSTBUFFER_HANDLE for each record. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_006: [ For each record constbuffer_array_create_from_serialized_buffers shall call CONSTBUFFER_from_buffer_no_copy with parent and the offset of the record. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_007: [ constbuffer_array_create_from_serialized_buffers shall create the CONSTBUFFER_ARRAY_HANDLE by calling constbuffer_array_create_with_move_buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_008: [ constbuffer_array_create_from_serialized_buffers shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_3_v1_records_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(TEST_SERIALIZED_V1_RECORDS, sizeof(TEST_SERIALIZED_V1_RECORDS));
+    ASSERT_IS_NOT_NULL(parent);
+    const CONSTBUFFER* parent_content = real_CONSTBUFFER_GetContent(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 0, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 7, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 12, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+
+    const CONSTBUFFER* content = constbuffer_array_get_buffer_content(result, 0);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, parent_content->buffer + 5, content->buffer); /*zero-copy*/
+    ASSERT_ARE_EQUAL(int, 0, memcmp("ab", content->buffer, 2));
+
+    content = constbuffer_array_get_buffer_content(result, 1);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+
+    content = constbuffer_array_get_buffer_content(result, 2);
+    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, parent_content->buffer + 17, content->buffer); /*zero-copy*/
+    ASSERT_ARE_EQUAL(uint8_t, 'c', content->buffer[0]);
+
+    ///clean
+    constbuffer_array_dec_ref(result);
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_002: [ constbuffer_array_create_from_serialized_buffers shall scan the content of parent and validate the version (1 or 2) and the size of every record before creating any CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_008: [ constbuffer_array_create_from_serialized_buffers shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_v1_and_v2_records_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    uint32_t v1_size;
+    CONSTBUFFER_HANDLE parent = TEST_create_mixed_version_parent(&v1_size);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+    STRICT_EXPECTED_CALL(malloc_2(2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 0, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, v1_size, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 + 1, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+
+    const CONSTBUFFER* content = constbuffer_array_get_buffer_content(result, 1);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(three), content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(three, content->buffer, sizeof(three)));
+
+    ///clean
+    constbuffer_array_dec_ref(result);
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_003: [ If any record has an unknown version, a truncated header or a size that exceeds the remaining bytes of parent then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_unknown_version_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    unsigned char serialized[sizeof(TEST_SERIALIZED_V1_RECORDS)];
+    (void)memcpy(serialized, TEST_SERIALIZED_V1_RECORDS, sizeof(serialized));
+    serialized[12] = 0xFF; /*version of the third record*/
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_003: [ If any record has an unknown version, a truncated header or a size that exceeds the remaining bytes of parent then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_truncated_header_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(TEST_SERIALIZED_V1_RECORDS, 7 + 3); /*first record and 3 bytes of the second header*/
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_003: [ If any record has an unknown version, a truncated header or a size that exceeds the remaining bytes of parent then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_truncated_content_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(TEST_SERIALIZED_V1_RECORDS, sizeof(TEST_SERIALIZED_V1_RECORDS) - 1); /*last record misses its content*/
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_with_v2_crc_mismatch_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t v1_size;
+    CONSTBUFFER_HANDLE mixed = TEST_create_mixed_version_parent(&v1_size);
+    const CONSTBUFFER* mixed_content = real_CONSTBUFFER_GetContent(mixed);
+    unsigned char* serialized = my_gballoc_malloc(mixed_content->size);
+    ASSERT_IS_NOT_NULL(serialized);
+    (void)memcpy(serialized, mixed_content->buffer, mixed_content->size);
+    serialized[mixed_content->size - 1] ^= 0xFF; /*corrupt the content of the version 2 record*/
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(serialized, mixed_content->size);
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent));
+    STRICT_EXPECTED_CALL(malloc_2(2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 0, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, v1_size, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_from_serialized_buffers(parent);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    real_CONSTBUFFER_DecRef(parent);
+    my_gballoc_free(serialized);
+    real_CONSTBUFFER_DecRef(mixed);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_009: [ If there are any failures then constbuffer_array_create_from_serialized_buffers shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_serialized_buffers_unhappy_paths)
+{
+    ///arrange
+    size_t i;
+    CONSTBUFFER_HANDLE parent = real_CONSTBUFFER_Create(TEST_SERIALIZED_V1_RECORDS, sizeof(TEST_SERIALIZED_V1_RECORDS));
+    ASSERT_IS_NOT_NULL(parent);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(parent))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 0, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 7, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_from_buffer_no_copy(parent, 12, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_create_from_serialized_buffers(parent);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    ///clean
+    real_CONSTBUFFER_DecRef(parent);
+}
+
+/* constbuffer_array_create_coalesced */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_034: [ If original is NULL then constbuffer_array_create_coalesced shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_coalesced_with_NULL_original_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    ///act
+    result = constbuffer_array_create_coalesced(NULL, 4);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_035: [ constbuffer_array_create_coalesced shall group the buffers of original: a buffer of at least small_buffer_size bytes is a group of its own, and a smaller buffer starts a group that takes the following smaller buffers until the group has at least small_buffer_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_036: [ If every group has 1 buffer then constbuffer_array_create_coalesced shall increment the reference count of original and return original. ]*/
+TEST_FUNCTION(constbuffer_array_create_coalesced_without_small_buffers_returns_original)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_coalesced(original, 1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, original, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_035: [ constbuffer_array_create_coalesced shall group the buffers of original: a buffer of at least small_buffer_size bytes is a group of its own, and a smaller buffer starts a group that takes the following smaller buffers until the group has at least small_buffer_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_036: [ If every group has 1 buffer then constbuffer_array_create_coalesced shall increment the reference count of original and return original. ]*/
+TEST_FUNCTION(constbuffer_array_create_coalesced_with_small_buffers_that_are_not_adjacent_returns_original)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    ///act
+    result = constbuffer_array_create_coalesced(original, 2); /*only TEST_CONSTBUFFER_HANDLE_1 is small*/
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, original, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_035: [ constbuffer_array_create_coalesced shall group the buffers of original: a buffer of at least small_buffer_size bytes is a group of its own, and a smaller buffer starts a group that takes the following smaller buffers until the group has at least small_buffer_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_037: [ Otherwise constbuffer_array_create_coalesced shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold 1 buffer for each group. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_038: [ For a group of 1 buffer constbuffer_array_create_coalesced shall inc_ref the buffer and store it. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_039: [ For a group of more buffers constbuffer_array_create_coalesced shall create 1 buffer by calling CONSTBUFFER_CreateWritableHandle, CONSTBUFFER_GetContent and CONSTBUFFER_AppendToWritableBuffer for each buffer of the group, and CONSTBUFFER_SealWritableHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_040: [ constbuffer_array_create_coalesced shall compute the size of all buffers from the sizes already known by original. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_042: [ constbuffer_array_create_coalesced shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_create_coalesced_merges_adjacent_small_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    uint64_t all_buffers_size;
+    const CONSTBUFFER* content;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(1 + 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_AppendToWritableBuffer(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_AppendToWritableBuffer(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_4));
+
+    ///act
+    result = constbuffer_array_create_coalesced(original, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint64_t, 1 + 2 + 3 + 4, all_buffers_size);
+
+    content = real_CONSTBUFFER_GetContent(constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 3, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("122", content->buffer, 3));
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, constbuffer_array_get_const_buffer_handle_array(result)[1]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_4, constbuffer_array_get_const_buffer_handle_array(result)[2]);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_041: [ If there are any failures then constbuffer_array_create_coalesced shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_coalesced_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    size_t i;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(1 + 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_AppendToWritableBuffer(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_AppendToWritableBuffer(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_4));
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_create_coalesced(original, 3);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
+/*constbuffer_array_add_front*/
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_006: [ If constbuffer_array_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
+TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_array_handle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(NULL, TEST_CONSTBUFFER_HANDLE_1);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_007: [ If constbuffer_handle is NULL then constbuffer_array_add_front shall fail and return NULL ]*/
+TEST_FUNCTION(constbuffer_array_add_front_with_constbuffer_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE, constbuffer_handle and headroom for at least CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM CONSTBUFFER_HANDLEs to be added in front later. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    constbuffer_array_add_front_inert_path();
+
+    ///act
+    result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    size_t i;
+
+    constbuffer_array_add_front_inert_path();
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE, constbuffer_handle and headroom for at least CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM CONSTBUFFER_HANDLEs to be added in front later. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_to_array_without_headroom_copies_the_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER_HANDLE* buffers;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4 + 3 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    buffers = constbuffer_array_get_const_buffer_handle_array(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffers[1]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, buffers[2]);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_010: [ If the slot in front of the first CONSTBUFFER_HANDLE of constbuffer_array_handle is free headroom of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers then constbuffer_array_add_front shall claim the slot by calling interlocked_compare_exchange. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_011: [ constbuffer_array_add_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_012: [ constbuffer_array_add_front shall inc_ref constbuffer_handle, store it in the claimed slot and increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_claims_the_headroom_without_copying_the_buffers)
 {
     ///arrange
     CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER_HANDLE* buffers;
+
+    constbuffer_array_add_front_in_headroom_inert_path(4, TEST_CONSTBUFFER_HANDLE_2);
 
     ///act
-    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
 
     ///assert
-    ASSERT_IS_NULL(result);
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    buffers = constbuffer_array_get_const_buffer_handle_array(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffers[1]);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)constbuffer_array_get_const_buffer_handle_array(afterAdd1), (void*)(buffers + 1));
 
     ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE and constbuffer_handle. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
-TEST_FUNCTION(constbuffer_array_add_front_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_010: [ If the slot in front of the first CONSTBUFFER_HANDLE of constbuffer_array_handle is free headroom of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers then constbuffer_array_add_front shall claim the slot by calling interlocked_compare_exchange. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_042: [ Otherwise constbuffer_array_add_front shall allocate enough memory to hold all of constbuffer_array_handle existing CONSTBUFFER_HANDLE, constbuffer_handle and headroom for at least CONSTBUFFER_ARRAY_ADD_FRONT_MIN_HEADROOM CONSTBUFFER_HANDLEs to be added in front later. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_when_the_slot_was_already_claimed_copies_the_buffers)
 {
     ///arrange
     CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
     CONSTBUFFER_ARRAY_HANDLE result;
+    const CONSTBUFFER_HANDLE* buffers;
 
-    constbuffer_array_add_front_inert_path();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 3, 4));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4 + 2 + 1, sizeof(uint64_t) + sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
 
     ///act
-    result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_3);
 
     ///assert
     ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    buffers = constbuffer_array_get_const_buffer_handle_array(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffers[1]);
+    buffers = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, buffers[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, buffers[1]);
 
     ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
     constbuffer_array_dec_ref(result);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_013: [ If allocating memory fails after the slot was claimed then constbuffer_array_add_front shall release the slot. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
+TEST_FUNCTION(constbuffer_array_add_front_in_headroom_unhappy_paths)
 {
     ///arrange
     CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE result;
     size_t i;
 
-    constbuffer_array_add_front_inert_path();
+    constbuffer_array_add_front_in_headroom_inert_path(4, TEST_CONSTBUFFER_HANDLE_2);
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
     {
         if (umock_c_negative_tests_can_call_fail(i))
         {
-            CONSTBUFFER_ARRAY_HANDLE result;
-
             umock_c_negative_tests_reset();
             umock_c_negative_tests_fail_call(i);
 
             ///act
-            result = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+            result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
 
             ///assert
             ASSERT_IS_NULL(result);
         }
     }
 
+    /*the slot was released, so it can be claimed again*/
+    umock_c_negative_tests_reset();
+    result = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_019: [ constbuffer_array_add_front shall compute the size of all buffers by adding the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) to the size of the buffers of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_in_the_headroom_computes_the_size_of_all_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2;
+    CONSTBUFFER_ARRAY_HANDLE afterAdd3;
+    uint32_t all_buffers_size;
+    uint64_t all_buffers_size_u64;
+
+    ///act
+    afterAdd2 = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+    afterAdd3 = constbuffer_array_add_front(afterAdd2, TEST_CONSTBUFFER_HANDLE_3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(afterAdd2);
+    ASSERT_IS_NOT_NULL(afterAdd3);
+    /*both add_front used the headroom of afterAdd1*/
+    ASSERT_ARE_EQUAL(void_ptr, (void*)constbuffer_array_get_const_buffer_handle_array(afterAdd1), (void*)(constbuffer_array_get_const_buffer_handle_array(afterAdd3) + 2));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(afterAdd3, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 3 + 2 + 1, all_buffers_size);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(afterAdd3, &all_buffers_size_u64));
+    ASSERT_ARE_EQUAL(uint64_t, 3 + 2 + 1, all_buffers_size_u64);
+    /*the arrays that share the memory still see their own sizes*/
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 2 + 1, all_buffers_size);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(afterAdd3);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_019: [ constbuffer_array_add_front shall compute the size of all buffers by adding the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) to the size of the buffers of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_in_the_headroom_of_a_view_that_does_not_end_the_buffers_computes_the_size_of_all_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = constbuffer_array_add_front(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+    ASSERT_IS_NOT_NULL(afterAdd2);
+    /*only TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_1 follows it in the memory*/
+    CONSTBUFFER_ARRAY_HANDLE view = constbuffer_array_create_from_buffer_index_and_count(afterAdd2, 0, 1);
+    ASSERT_IS_NOT_NULL(view);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t buffer_count;
+    uint32_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_add_front(view, TEST_CONSTBUFFER_HANDLE_3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)constbuffer_array_get_const_buffer_handle_array(afterAdd2), (void*)(constbuffer_array_get_const_buffer_handle_array(result) + 1));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 3 + 2, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(view);
+    constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_019: [ constbuffer_array_add_front shall compute the size of all buffers by adding the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) to the size of the buffers of constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_that_copies_a_view_that_does_not_end_the_buffers_computes_the_size_of_all_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    /*TEST_CONSTBUFFER_HANDLE_1 and TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_3 follows them in the memory*/
+    CONSTBUFFER_ARRAY_HANDLE view = constbuffer_array_create_from_buffer_index_and_count(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, 2);
+    ASSERT_IS_NOT_NULL(view);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    uint32_t all_buffers_size;
+    uint64_t all_buffers_size_u64;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_add_front(view, TEST_CONSTBUFFER_HANDLE_4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint32_t, 4 + 1 + 2, all_buffers_size);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_u64(result, &all_buffers_size_u64));
+    ASSERT_ARE_EQUAL(uint64_t, 4 + 1 + 2, all_buffers_size_u64);
+
     ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(view);
+    constbuffer_array_dec_ref(result);
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_012: [ If constbuffer_array_handle is NULL then constbuffer_array_remove_front shall fail and return NULL. ]*/
@@ -1495,9 +2585,8 @@ TEST_FUNCTION(constbuffer_array_remove_front_with_constbuffer_array_handle_empty
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_014: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle and holds all of its CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_015: [ constbuffer_array_remove_front shall increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
 TEST_FUNCTION(constbuffer_array_remove_front_with_1_item_succeeds)
@@ -1510,7 +2599,7 @@ TEST_FUNCTION(constbuffer_array_remove_front_with_1_item_succeeds)
 
     umock_c_reset_all_calls();
 
-    constbuffer_array_remove_front_inert_path(1);
+    constbuffer_array_remove_front_inert_path();
 
     ///act
     afterRemove = constbuffer_array_remove_front(afterAdd, &removed);
@@ -1528,9 +2617,8 @@ TEST_FUNCTION(constbuffer_array_remove_front_with_1_item_succeeds)
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_046: [ constbuffer_array_remove_front shall allocate memory to hold all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_014: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle and holds all of its CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_015: [ constbuffer_array_remove_front shall increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
 TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
@@ -1543,7 +2631,7 @@ TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
     CONSTBUFFER_ARRAY_HANDLE afterRemove1;
     umock_c_reset_all_calls();
 
-    constbuffer_array_remove_front_inert_path(2);
+    constbuffer_array_remove_front_inert_path();
 
     ///act
     afterRemove1 = constbuffer_array_remove_front(afterAdd2, &removed);
@@ -1571,7 +2659,7 @@ TEST_FUNCTION(constbuffer_array_remove_front_unhappy_paths)
     size_t i;
     umock_c_reset_all_calls();
 
-    constbuffer_array_remove_front_inert_path(1);
+    constbuffer_array_remove_front_inert_path();
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -1597,6 +2685,40 @@ TEST_FUNCTION(constbuffer_array_remove_front_unhappy_paths)
     constbuffer_array_dec_ref(afterAdd);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_014: [ constbuffer_array_remove_front shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that shares the memory of constbuffer_array_handle and holds all of its CONSTBUFFER_HANDLEs except the front one. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_11_015: [ constbuffer_array_remove_front shall increment the reference count of the CONSTBUFFER_ARRAY_HANDLE that owns the memory of the buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_does_not_copy_the_remaining_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+    uint32_t buffer_count;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    ///act
+    afterRemove = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(afterRemove);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, removed);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(afterRemove, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(constbuffer_array_get_const_buffer_handle_array(TEST_CONSTBUFFER_ARRAY_HANDLE) + 1), (void*)constbuffer_array_get_const_buffer_handle_array(afterRemove));
+
+    ///cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterRemove);
+    CONSTBUFFER_DecRef(removed);
+}
+
 /* constbuffer_array_get_buffer_count */
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
@@ -2064,27 +3186,45 @@ TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
 TEST_FUNCTION(constbuffer_array_dec_ref_frees)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_of_the_last_array_sharing_the_memory_frees_the_buffers_added_in_front)
 {
     ///arrange
     CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
     CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
     CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(free(afterAdd1));
+    STRICT_EXPECTED_CALL(free(afterAdd2));
 
     ///act
     constbuffer_array_dec_ref(afterAdd2);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    ///cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
 /* constbuffer_array_get_all_buffers_size */
@@ -2126,21 +3266,14 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_
 TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
     const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
     const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_fake_sizes(&fake_const_buffer_1, &fake_const_buffer_2);
+    uint32_t all_buffers_size;
+    int result;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -2148,29 +3281,20 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails
 
     // cleanup
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
 TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
     const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX - 1 };
     const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_fake_sizes(&fake_const_buffer_1, &fake_const_buffer_2);
+    uint32_t all_buffers_size;
+    int result;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -2179,8 +3303,6 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
 
     // cleanup
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
@@ -2212,8 +3334,6 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds)
     uint32_t all_buffers_size;
     int result;
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
-
     ///act
     result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
 
@@ -2237,9 +3357,6 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
     uint32_t all_buffers_size;
     int result;
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
-
     ///act
     result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
 
@@ -2254,6 +3371,117 @@ TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
     constbuffer_array_dec_ref(afterAdd2);
 }
 
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_of_a_view_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE view;
+    uint32_t all_buffers_size;
+    int result;
+
+    view = constbuffer_array_create_from_buffer_index_and_count(TEST_CONSTBUFFER_ARRAY_HANDLE, 1, 1);
+    ASSERT_IS_NOT_NULL(view);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(view, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(view);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* constbuffer_array_get_all_buffers_size_u64 */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_020: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size_u64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_u64_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    uint64_t all_buffers_size;
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_u64(NULL, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_021: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size_u64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_u64_with_NULL_all_buffers_size_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_u64(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_022: [ Otherwise constbuffer_array_get_all_buffers_size_u64 shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_u64_above_UINT32_MAX_succeeds)
+{
+    ///arrange
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, UINT32_MAX };
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_fake_sizes(&fake_const_buffer_1, &fake_const_buffer_2);
+    uint64_t all_buffers_size;
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_u64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)UINT32_MAX * 2, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_11_022: [ Otherwise constbuffer_array_get_all_buffers_size_u64 shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_u64_after_remove_front_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+    CONSTBUFFER_HANDLE removed;
+    uint64_t all_buffers_size;
+    int result;
+
+    afterRemove = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_u64(afterRemove, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 3, all_buffers_size);
+
+    // cleanup
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(afterRemove);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
 /* constbuffer_array_get_const_buffer_handle_array */
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+
+#include "c_util/constbuffer_file.h"
+
+#define FILE_SIZE (3 * 65536 + 100) /*spans a few pages and a few Windows allocation granularities*/
+
+static char temp_file_name[L_tmpnam];
+static unsigned char* file_content;
+
+static unsigned char byte_at(uint32_t position)
+{
+    return (unsigned char)((position * 31) ^ (position >> 8));
+}
+
+static void write_temp_file(uint32_t size)
+{
+    FILE* temp = fopen(temp_file_name, "wb");
+    ASSERT_IS_NOT_NULL(temp);
+    if (size > 0)
+    {
+        ASSERT_ARE_EQUAL(size_t, size, fwrite(file_content, 1, size, temp));
+    }
+    ASSERT_ARE_EQUAL(int, 0, fclose(temp));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+
+    file_content = malloc(FILE_SIZE);
+    ASSERT_IS_NOT_NULL(file_content);
+    for (uint32_t i = 0; i < FILE_SIZE; i++)
+    {
+        file_content[i] = byte_at(i);
+    }
+
+    ASSERT_IS_NOT_NULL(tmpnam(temp_file_name));
+    write_temp_file(FILE_SIZE);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)remove(temp_file_name);
+    free(file_content);
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(function_initialize)
+{
+}
+
+TEST_FUNCTION_CLEANUP(function_cleanup)
+{
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_002: [ constbuffer_file_map shall map all the bytes of the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the CONSTBUFFER_HANDLE is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+TEST_FUNCTION(constbuffer_file_map_maps_the_whole_file)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE mapped = constbuffer_file_map(temp_file_name);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(mapped);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(mapped);
+    ASSERT_ARE_EQUAL(uint32_t, FILE_SIZE, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(file_content, content->buffer, FILE_SIZE));
+
+    ///clean
+    CONSTBUFFER_DecRef(mapped);
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_009: [ The mapping shall start at offset rounded down to the mapping granularity of the platform (the page size on Linux, the allocation granularity on Windows). ]*/
+TEST_FUNCTION(constbuffer_file_map_range_maps_ranges_at_any_offset)
+{
+    ///arrange
+    static const struct
+    {
+        uint32_t offset;
+        uint32_t size;
+    } ranges[] =
+    {
+        { 0, 1 },
+        { 1, 4095 },
+        { 4095, 2 },
+        { 4096, 4096 },
+        { 65535, 65538 },
+        { 65536 + 17, 2 * 65536 + 83 },
+        { FILE_SIZE - 1, 1 }
+    };
+
+    for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++)
+    {
+        ///act
+        CONSTBUFFER_HANDLE mapped = constbuffer_file_map_range(temp_file_name, ranges[i].offset, ranges[i].size);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(mapped);
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(mapped);
+        ASSERT_ARE_EQUAL(uint32_t, ranges[i].size, content->size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(file_content + ranges[i].offset, content->buffer, ranges[i].size));
+
+        ///clean
+        CONSTBUFFER_DecRef(mapped);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_011: [ The CONSTBUFFER_HANDLE shall be created by calling CONSTBUFFER_CreateWithCustomFree with the mapped bytes that correspond to offset and size and a free function that unmaps the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map and constbuffer_file_map_range shall close the file before returning, the mapping stays valid after that. ]*/
+TEST_FUNCTION(constbuffer_file_map_slices_outlive_the_mapped_handle)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE mapped = constbuffer_file_map_range(temp_file_name, 100, FILE_SIZE - 200);
+    ASSERT_IS_NOT_NULL(mapped);
+
+    ///act
+    CONSTBUFFER_HANDLE slice = CONSTBUFFER_CreateFromOffsetAndSize(mapped, 65536, 1000);
+    ASSERT_IS_NOT_NULL(slice);
+    CONSTBUFFER_DecRef(mapped);
+
+    ///assert - the slice keeps the mapping alive
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(slice);
+    ASSERT_ARE_EQUAL(uint32_t, 1000, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(file_content + 100 + 65536, content->buffer, 1000));
+
+    ///clean
+    CONSTBUFFER_DecRef(slice);
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_008: [ If there are no bytes to map then constbuffer_file_map and constbuffer_file_map_range shall return an empty CONSTBUFFER_HANDLE created by calling CONSTBUFFER_Create with NULL and 0. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_size_0_returns_an_empty_buffer)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE mapped = constbuffer_file_map_range(temp_file_name, FILE_SIZE, 0);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(mapped);
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetContent(mapped)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(mapped);
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_beyond_the_end_of_the_file_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE mapped_1 = constbuffer_file_map_range(temp_file_name, FILE_SIZE - 10, 11);
+    CONSTBUFFER_HANDLE mapped_2 = constbuffer_file_map_range(temp_file_name, FILE_SIZE + 1, 0);
+    CONSTBUFFER_HANDLE mapped_3 = constbuffer_file_map_range(temp_file_name, UINT64_MAX, UINT32_MAX);
+
+    ///assert
+    ASSERT_IS_NULL(mapped_1);
+    ASSERT_IS_NULL(mapped_2);
+    ASSERT_IS_NULL(mapped_3);
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_of_a_file_that_does_not_exist_fails)
+{
+    ///arrange
+    char missing_file_name[L_tmpnam];
+    ASSERT_IS_NOT_NULL(tmpnam(missing_file_name));
+
+    ///act
+    CONSTBUFFER_HANDLE mapped_1 = constbuffer_file_map(missing_file_name);
+    CONSTBUFFER_HANDLE mapped_2 = constbuffer_file_map_range(missing_file_name, 0, 1);
+
+    ///assert
+    ASSERT_IS_NULL(mapped_1);
+    ASSERT_IS_NULL(mapped_2);
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_001: [ If file_name is NULL then constbuffer_file_map shall fail and return NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_005: [ If file_name is NULL then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_NULL_file_name_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE mapped_1 = constbuffer_file_map(NULL);
+    CONSTBUFFER_HANDLE mapped_2 = constbuffer_file_map_range(NULL, 0, 1);
+
+    ///assert
+    ASSERT_IS_NULL(mapped_1);
+    ASSERT_IS_NULL(mapped_2);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
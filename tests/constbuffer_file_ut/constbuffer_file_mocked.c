@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+int mocked_open(const char* pathname, int flags);
+int mocked_fstat(int fd, struct stat* buf);
+long mocked_sysconf(int name);
+void* mocked_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+int mocked_munmap(void* addr, size_t length);
+int mocked_close(int fd);
+
+#define open mocked_open
+#define fstat mocked_fstat
+#define sysconf mocked_sysconf
+#define mmap mocked_mmap
+#define munmap mocked_munmap
+#define close mocked_close
+
+#include "../../src/constbuffer_file_linux.c"
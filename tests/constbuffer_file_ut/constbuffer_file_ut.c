@@ -0,0 +1,824 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_util/constbuffer.h"
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_util/constbuffer_file.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+#define TEST_FD 42
+#define TEST_PAGE_SIZE 4096
+
+static const char* TEST_FILE_NAME = "some_file.bin";
+static CONSTBUFFER_HANDLE TEST_CONSTBUFFER_HANDLE = (CONSTBUFFER_HANDLE)0x4242;
+static CONSTBUFFER_LARGE_HANDLE TEST_CONSTBUFFER_LARGE_HANDLE = (CONSTBUFFER_LARGE_HANDLE)0x4343;
+static unsigned char test_mapped_bytes[3 * TEST_PAGE_SIZE];
+
+static uint64_t test_file_size;
+static CONSTBUFFER_CUSTOM_FREE_FUNC test_custom_free_func;
+static void* test_custom_free_func_context;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MOCK_FUNCTION_WITH_CODE(, int, mocked_open, const char*, pathname, int, flags)
+MOCK_FUNCTION_END(TEST_FD)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_fstat, int, fd, struct stat*, buf)
+    buf->st_size = (off_t)test_file_size;
+MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, long, mocked_sysconf, int, name)
+MOCK_FUNCTION_END(TEST_PAGE_SIZE)
+MOCK_FUNCTION_WITH_CODE(, void*, mocked_mmap, void*, addr, size_t, length, int, prot, int, flags, int, fd, off_t, offset)
+MOCK_FUNCTION_END(test_mapped_bytes)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_munmap, void*, addr, size_t, length)
+MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_close, int, fd)
+MOCK_FUNCTION_END(0)
+
+#ifdef __cplusplus
+}
+#endif
+
+static CONSTBUFFER_HANDLE hook_CONSTBUFFER_CreateWithCustomFree(const unsigned char* source, uint32_t size, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc, void* customFreeFuncContext)
+{
+    (void)source;
+    (void)size;
+    test_custom_free_func = customFreeFunc;
+    test_custom_free_func_context = customFreeFuncContext;
+    return TEST_CONSTBUFFER_HANDLE;
+}
+
+static CONSTBUFFER_LARGE_HANDLE hook_CONSTBUFFER_LARGE_CreateWithCustomFree(const unsigned char* source, uint64_t size, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc, void* customFreeFuncContext)
+{
+    (void)source;
+    (void)size;
+    test_custom_free_func = customFreeFunc;
+    test_custom_free_func_context = customFreeFuncContext;
+    return TEST_CONSTBUFFER_LARGE_HANDLE;
+}
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static void setup_open_and_fstat(uint64_t file_size)
+{
+    test_file_size = file_size;
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mocked_fstat(TEST_FD, IGNORED_ARG));
+}
+
+static void setup_map(uint64_t offset, uint32_t size)
+{
+    uint64_t delta = offset % TEST_PAGE_SIZE;
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, (size_t)(delta + size), PROT_READ, MAP_PRIVATE, TEST_FD, (off_t)(offset - delta)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(test_mapped_bytes + delta, size, IGNORED_ARG, IGNORED_ARG));
+}
+
+static void setup_map_large(uint64_t file_size)
+{
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, (size_t)file_size, PROT_READ, MAP_PRIVATE, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_LARGE_CreateWithCustomFree(test_mapped_bytes, file_size, IGNORED_ARG, IGNORED_ARG));
+}
+
+static void unmap_test_buffer(void)
+{
+    ASSERT_IS_NOT_NULL(test_custom_free_func);
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(test_custom_free_func_context));
+    test_custom_free_func(test_custom_free_func_context);
+    test_custom_free_func = NULL;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types(), "umocktypes_charptr_register_types");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_LARGE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_CUSTOM_FREE_FUNC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(struct stat*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(off_t, int64_t);
+    REGISTER_UMOCK_ALIAS_TYPE(long, int64_t);
+
+    REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_CreateWithCustomFree, hook_CONSTBUFFER_CreateWithCustomFree);
+    REGISTER_GLOBAL_MOCK_RETURN(CONSTBUFFER_Create, TEST_CONSTBUFFER_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_LARGE_CreateWithCustomFree, hook_CONSTBUFFER_LARGE_CreateWithCustomFree);
+    REGISTER_GLOBAL_MOCK_RETURN(CONSTBUFFER_LARGE_Create, TEST_CONSTBUFFER_LARGE_HANDLE);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    test_file_size = 0;
+    test_custom_free_func = NULL;
+    test_custom_free_func_context = NULL;
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* constbuffer_file_map */
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_001: [ If file_name is NULL then constbuffer_file_map shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_file_name_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_002: [ constbuffer_file_map shall map all the bytes of the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_003: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall open the file for reading (open with O_RDONLY on Linux, CreateFileA with GENERIC_READ on Windows) and get its size. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_009: [ The mapping shall start at offset rounded down to the mapping granularity of the platform (the page size on Linux, the allocation granularity on Windows). ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_010: [ The file shall be mapped read-only (mmap with PROT_READ and MAP_PRIVATE on Linux, MapViewOfFile with FILE_MAP_READ on Windows). ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_011: [ The CONSTBUFFER_HANDLE shall be created by calling CONSTBUFFER_CreateWithCustomFree with the mapped bytes that correspond to offset and size and a free function that unmaps the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall close the file before returning, the mapping stays valid after that. ]*/
+TEST_FUNCTION(constbuffer_file_map_succeeds)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    setup_map(0, 1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_002: [ constbuffer_file_map shall map all the bytes of the file. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_a_file_of_UINT32_MAX_bytes_succeeds)
+{
+    ///arrange
+    setup_open_and_fstat(UINT32_MAX);
+    setup_map(0, UINT32_MAX);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_008: [ If there are no bytes to map then constbuffer_file_map and constbuffer_file_map_range shall return an empty CONSTBUFFER_HANDLE created by calling CONSTBUFFER_Create with NULL and 0. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_an_empty_file_creates_an_empty_CONSTBUFFER)
+{
+    ///arrange
+    setup_open_and_fstat(0);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(NULL, 0));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_004: [ If the size of the file exceeds UINT32_MAX then constbuffer_file_map shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_a_file_of_UINT32_MAX_plus_1_bytes_fails)
+{
+    ///arrange
+    setup_open_and_fstat((uint64_t)UINT32_MAX + 1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_004: [ If the size of the file exceeds UINT32_MAX then constbuffer_file_map shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_with_a_file_of_a_multiple_of_4GB_fails)
+{
+    ///arrange
+    setup_open_and_fstat((uint64_t)UINT32_MAX + 1 + UINT32_MAX + 1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_open_fails_constbuffer_file_map_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC))
+        .SetReturn(-1);
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_fstat_fails_constbuffer_file_map_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mocked_fstat(TEST_FD, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_constbuffer_file_map_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_mmap_fails_constbuffer_file_map_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 1000, PROT_READ, MAP_PRIVATE, TEST_FD, 0))
+        .SetReturn(MAP_FAILED);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_CONSTBUFFER_CreateWithCustomFree_fails_constbuffer_file_map_unmaps_and_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 1000, PROT_READ, MAP_PRIVATE, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(test_mapped_bytes, 1000, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, 1000));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_CONSTBUFFER_Create_fails_constbuffer_file_map_fails)
+{
+    ///arrange
+    setup_open_and_fstat(0);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(NULL, 0))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall close the file before returning, the mapping stays valid after that. ]*/
+TEST_FUNCTION(when_close_fails_constbuffer_file_map_still_succeeds)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    setup_map(0, 1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD))
+        .SetReturn(-1);
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/* constbuffer_file_map_range */
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_005: [ If file_name is NULL then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_file_name_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(NULL, 0, 1);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_009: [ The mapping shall start at offset rounded down to the mapping granularity of the platform (the page size on Linux, the allocation granularity on Windows). ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_011: [ The CONSTBUFFER_HANDLE shall be created by calling CONSTBUFFER_CreateWithCustomFree with the mapped bytes that correspond to offset and size and a free function that unmaps the file. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_an_unaligned_offset_maps_from_the_page_before)
+{
+    ///arrange
+    setup_open_and_fstat(10 * TEST_PAGE_SIZE);
+    setup_map(2 * TEST_PAGE_SIZE + 100, 200);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, 2 * TEST_PAGE_SIZE + 100, 200);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_can_map_past_4GB_of_a_large_file)
+{
+    ///arrange
+    uint64_t offset = (uint64_t)UINT32_MAX + 1 + TEST_PAGE_SIZE + 1;
+    setup_open_and_fstat((uint64_t)UINT32_MAX * 4);
+    setup_map(offset, 10);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, offset, 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_006: [ constbuffer_file_map_range shall map size bytes of the file starting at offset. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_of_the_last_bytes_of_the_file_succeeds)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    setup_map(900, 100);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, 900, 100);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_past_the_end_of_the_file_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, 900, 101);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_offset_past_the_end_of_the_file_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, 1001, 0);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_007: [ If offset + size exceeds the size of the file then constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_offset_UINT64_MAX_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, UINT64_MAX, 1);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_008: [ If there are no bytes to map then constbuffer_file_map and constbuffer_file_map_range shall return an empty CONSTBUFFER_HANDLE created by calling CONSTBUFFER_Create with NULL and 0. ]*/
+TEST_FUNCTION(constbuffer_file_map_range_with_size_0_creates_an_empty_CONSTBUFFER)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(NULL, 0));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, 1000, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_013: [ If there are any failures then constbuffer_file_map and constbuffer_file_map_range shall fail and return NULL. ]*/
+TEST_FUNCTION(when_mmap_fails_constbuffer_file_map_range_fails)
+{
+    ///arrange
+    setup_open_and_fstat(10 * TEST_PAGE_SIZE);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 110, PROT_READ, MAP_PRIVATE, TEST_FD, TEST_PAGE_SIZE))
+        .SetReturn(MAP_FAILED);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, TEST_PAGE_SIZE + 100, 10);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_file_map_large */
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_015: [ If file_name is NULL then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_file_map_large_with_file_name_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_016: [ constbuffer_file_map_large shall map all the bytes of the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_003: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall open the file for reading (open with O_RDONLY on Linux, CreateFileA with GENERIC_READ on Windows) and get its size. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_010: [ The file shall be mapped read-only (mmap with PROT_READ and MAP_PRIVATE on Linux, MapViewOfFile with FILE_MAP_READ on Windows). ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_019: [ The CONSTBUFFER_LARGE_HANDLE shall be created by calling CONSTBUFFER_LARGE_CreateWithCustomFree with the mapped bytes and a free function that unmaps the file. ]*/
+/*Tests_SRS_CONSTBUFFER_FILE_11_014: [ constbuffer_file_map, constbuffer_file_map_range and constbuffer_file_map_large shall close the file before returning, the mapping stays valid after that. ]*/
+TEST_FUNCTION(constbuffer_file_map_large_succeeds)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    setup_map_large(1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_LARGE_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_016: [ constbuffer_file_map_large shall map all the bytes of the file. ]*/
+TEST_FUNCTION(constbuffer_file_map_large_with_a_file_of_more_than_UINT32_MAX_bytes_succeeds)
+{
+    ///arrange
+    uint64_t file_size = (uint64_t)UINT32_MAX * 2 + 10;
+    setup_open_and_fstat(file_size);
+    setup_map_large(file_size);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_LARGE_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    unmap_test_buffer();
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_018: [ If the file is empty then constbuffer_file_map_large shall return an empty CONSTBUFFER_LARGE_HANDLE created by calling CONSTBUFFER_LARGE_Create with NULL and 0. ]*/
+TEST_FUNCTION(constbuffer_file_map_large_with_an_empty_file_creates_an_empty_CONSTBUFFER_LARGE)
+{
+    ///arrange
+    setup_open_and_fstat(0);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_LARGE_Create(NULL, 0));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_LARGE_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_open_fails_constbuffer_file_map_large_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC))
+        .SetReturn(-1);
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_fstat_fails_constbuffer_file_map_large_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mocked_fstat(TEST_FD, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_constbuffer_file_map_large_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_mmap_fails_constbuffer_file_map_large_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 1000, PROT_READ, MAP_PRIVATE, TEST_FD, 0))
+        .SetReturn(MAP_FAILED);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_CONSTBUFFER_LARGE_CreateWithCustomFree_fails_constbuffer_file_map_large_unmaps_and_fails)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 1000, PROT_READ, MAP_PRIVATE, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_LARGE_CreateWithCustomFree(test_mapped_bytes, 1000, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, 1000));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_020: [ If there are any failures then constbuffer_file_map_large shall fail and return NULL. ]*/
+TEST_FUNCTION(when_CONSTBUFFER_LARGE_Create_fails_constbuffer_file_map_large_fails)
+{
+    ///arrange
+    setup_open_and_fstat(0);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_LARGE_Create(NULL, 0))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_file_unmap */
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the handle (CONSTBUFFER_HANDLE or CONSTBUFFER_LARGE_HANDLE) is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+TEST_FUNCTION(the_free_function_unmaps_the_whole_mapping)
+{
+    ///arrange
+    setup_open_and_fstat(10 * TEST_PAGE_SIZE);
+    setup_map(TEST_PAGE_SIZE + 100, 10);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+    CONSTBUFFER_HANDLE result = constbuffer_file_map_range(TEST_FILE_NAME, TEST_PAGE_SIZE + 100, 10);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(test_custom_free_func);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, 110));
+    STRICT_EXPECTED_CALL(free(test_custom_free_func_context));
+
+    ///act
+    test_custom_free_func(test_custom_free_func_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the handle (CONSTBUFFER_HANDLE or CONSTBUFFER_LARGE_HANDLE) is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+TEST_FUNCTION(when_munmap_fails_the_free_function_still_frees_the_mapping_context)
+{
+    ///arrange
+    setup_open_and_fstat(1000);
+    setup_map(0, 1000);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+    CONSTBUFFER_HANDLE result = constbuffer_file_map(TEST_FILE_NAME);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(test_custom_free_func);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, 1000))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(free(test_custom_free_func_context));
+
+    ///act
+    test_custom_free_func(test_custom_free_func_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_FILE_11_012: [ When the last reference to the handle (CONSTBUFFER_HANDLE or CONSTBUFFER_LARGE_HANDLE) is released the mapping shall be unmapped (munmap on Linux, UnmapViewOfFile on Windows). ]*/
+TEST_FUNCTION(the_free_function_of_constbuffer_file_map_large_unmaps_the_whole_file)
+{
+    ///arrange
+    uint64_t file_size = (uint64_t)UINT32_MAX + 1;
+    setup_open_and_fstat(file_size);
+    setup_map_large(file_size);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+    CONSTBUFFER_LARGE_HANDLE result = constbuffer_file_map_large(TEST_FILE_NAME);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(test_custom_free_func);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_munmap(test_mapped_bytes, (size_t)file_size));
+    STRICT_EXPECTED_CALL(free(test_custom_free_func_context));
+
+    ///act
+    test_custom_free_func(test_custom_free_func_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
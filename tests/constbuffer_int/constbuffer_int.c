@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cinttypes>
+#include <cstdlib>
+#else
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/threadapi.h"
+
+#include "c_util/constbuffer.h"
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+#define N_THREADS 8
+#define N_INIT_DEINIT_ROUNDS 200
+
+static const unsigned char TEST_CONTENT[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+typedef struct HEADER_POOL_THREADS_TAG
+{
+    volatile_atomic int32_t threads_should_start;
+    volatile_atomic int32_t threads_should_finish;
+    volatile_atomic int32_t n_inits_succeeded;
+    volatile_atomic int32_t n_buffers;
+}HEADER_POOL_THREADS;
+
+static void do_not_free(void* context)
+{
+    (void)context;
+}
+
+/*creates and destroys buffers whose headers go through the header pool, if there is one*/
+static int creates_and_destroys_buffers(void* context)
+{
+    HEADER_POOL_THREADS* data = context;
+    while (interlocked_add(&data->threads_should_finish, 0) == 0)
+    {
+        CONSTBUFFER_HANDLE buffers[4];
+        for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(buffers); i++)
+        {
+            buffers[i] = CONSTBUFFER_CreateWithCustomFree(TEST_CONTENT, sizeof(TEST_CONTENT), do_not_free, NULL);
+            ASSERT_IS_NOT_NULL(buffers[i]);
+        }
+        for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(buffers); i++)
+        {
+            ASSERT_ARE_EQUAL(uint32_t, sizeof(TEST_CONTENT), CONSTBUFFER_GetContent(buffers[i])->size);
+            CONSTBUFFER_DecRef(buffers[i]);
+        }
+        (void)interlocked_add(&data->n_buffers, (int32_t)MU_COUNT_ARRAY_ITEMS(buffers));
+    }
+    return 0;
+}
+
+static int initializes_the_header_pool(void* context)
+{
+    HEADER_POOL_THREADS* data = context;
+    while (interlocked_add(&data->threads_should_start, 0) == 0)
+    {
+        ThreadAPI_Sleep(0);
+    }
+    if (CONSTBUFFER_header_pool_init() == 0)
+    {
+        (void)interlocked_increment(&data->n_inits_succeeded);
+    }
+    return 0;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(function_initialize)
+{
+}
+
+TEST_FUNCTION_CLEANUP(function_cleanup)
+{
+}
+
+TEST_FUNCTION(CONSTBUFFER_header_pool_init_and_deinit_while_other_threads_create_and_destroy_buffers)
+{
+    ///arrange
+    HEADER_POOL_THREADS data;
+    THREAD_HANDLE threads[N_THREADS];
+    (void)interlocked_exchange(&data.threads_should_finish, 0);
+    (void)interlocked_exchange(&data.n_buffers, 0);
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&threads[i], creates_and_destroys_buffers, &data));
+    }
+
+    ///act
+    for (uint32_t i = 0; i < N_INIT_DEINIT_ROUNDS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+        ThreadAPI_Sleep(1);
+        CONSTBUFFER_header_pool_deinit();
+    }
+    (void)interlocked_exchange(&data.threads_should_finish, 1);
+
+    ///assert
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        int dont_care;
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(threads[i], &dont_care));
+    }
+    LogInfo("%" PRId32 " buffers were created and destroyed during %d header pool init/deinit rounds", interlocked_add(&data.n_buffers, 0), N_INIT_DEINIT_ROUNDS);
+}
+
+TEST_FUNCTION(CONSTBUFFER_header_pool_init_from_many_threads_succeeds_once)
+{
+    ///arrange
+    HEADER_POOL_THREADS data;
+    THREAD_HANDLE threads[N_THREADS];
+    (void)interlocked_exchange(&data.threads_should_start, 0);
+    (void)interlocked_exchange(&data.n_inits_succeeded, 0);
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&threads[i], initializes_the_header_pool, &data));
+    }
+
+    ///act
+    (void)interlocked_exchange(&data.threads_should_start, 1);
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        int dont_care;
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(threads[i], &dont_care));
+    }
+
+    ///assert
+    ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&data.n_inits_succeeded, 0));
+
+    ///cleanup
+    CONSTBUFFER_header_pool_deinit();
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
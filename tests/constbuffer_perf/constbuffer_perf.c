@@ -0,0 +1,397 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/timer.h"
+
+#include "c_util/buffer_.h"
+#include "c_util/constbuffer.h"
+
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+#define N_ROUNDS 200000 /*number of rounds every thread does, a round creates and destroys N_HANDLES_PER_ROUND handles*/
+#define N_HANDLES_PER_ROUND 16 /*handles that are alive at the same time in a thread*/
+#define N_MAX_THREADS 8 /*the runs go from 1 to this many threads*/
+#define LARGE_BUFFER_SIZE (4 * 1024 * 1024) /*size of a buffer headed to a socket or a file*/
+#define N_SERIALIZATIONS 100 /*number of times the large buffer is serialized (or deserialized)*/
+#define SLICE_DEPTH 1000 /*levels of slices of slices, like a parser that slices what the previous level sliced*/
+#define N_DEEP_SLICINGS 1000 /*number of times the SLICE_DEPTH levels are built and released*/
+#define MAX_DEEPEST_RELEASE_RATIO 10 /*releasing the deepest level can cost at most this many times releasing a slice of depth 1, with a chain of live intermediate levels it costs about SLICE_DEPTH times*/
+#define N_BUILDS 100000 /*number of buffers built from chunks of source, like a serializer producing messages*/
+#define N_CHUNKS_PER_BUILD 16 /*a built buffer has N_CHUNKS_PER_BUILD * sizeof(source) bytes*/
+
+static const unsigned char source[64] = { 0 };
+static const unsigned char deep_source[SLICE_DEPTH + 1] = { 0 };
+
+typedef struct CREATE_DESTROY_RUN_TAG
+{
+    CONSTBUFFER_HANDLE origin; /*what the CONSTBUFFER_CreateFromOffsetAndSize handles are slices of*/
+    volatile_atomic int32_t n_failures;
+}CREATE_DESTROY_RUN;
+
+static void do_not_free(void* context)
+{
+    (void)context;
+}
+
+static int create_destroy_thread(void* context)
+{
+    CREATE_DESTROY_RUN* run = context;
+    CONSTBUFFER_HANDLE handles[N_HANDLES_PER_ROUND];
+    for (uint32_t i = 0; i < N_ROUNDS; i++)
+    {
+        /*half of the handles are slices, the other half wrap memory the caller owns: the 2 ways of making a CONSTBUFFER_HANDLE without copying*/
+        for (uint32_t j = 0; j < N_HANDLES_PER_ROUND; j += 2)
+        {
+            handles[j] = CONSTBUFFER_CreateFromOffsetAndSize(run->origin, j, sizeof(source) - j);
+            handles[j + 1] = CONSTBUFFER_CreateWithCustomFree(source + j, sizeof(source) - j, do_not_free, NULL);
+        }
+        for (uint32_t j = 0; j < N_HANDLES_PER_ROUND; j++)
+        {
+            if (handles[j] == NULL)
+            {
+                (void)interlocked_increment(&run->n_failures);
+            }
+            else
+            {
+                CONSTBUFFER_DecRef(handles[j]);
+            }
+        }
+    }
+    return 0;
+}
+
+/*returns the number of handles created and destroyed per ms by n_threads threads*/
+static double run_create_destroy(uint32_t n_threads)
+{
+    CREATE_DESTROY_RUN run;
+    run.origin = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(run.origin);
+    (void)interlocked_exchange(&run.n_failures, 0);
+
+    THREAD_HANDLE threads[N_MAX_THREADS];
+
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < n_threads; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&threads[i], create_destroy_thread, &run));
+    }
+
+    int dont_care;
+    for (uint32_t i = 0; i < n_threads; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(threads[i], &dont_care));
+    }
+    double elapsed_ms = timer_global_get_elapsed_ms() - start;
+
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&run.n_failures, 0));
+    CONSTBUFFER_DecRef(run.origin);
+    return (double)n_threads * N_ROUNDS * N_HANDLES_PER_ROUND / elapsed_ms;
+}
+
+static void measure_create_destroy(void)
+{
+    for (uint32_t n_threads = 1; n_threads <= N_MAX_THREADS; n_threads *= 2)
+    {
+        ///arrange
+        double malloc_per_ms;
+        double pool_per_ms;
+
+        ///act
+        malloc_per_ms = run_create_destroy(n_threads);
+
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+        pool_per_ms = run_create_destroy(n_threads);
+        CONSTBUFFER_header_pool_deinit();
+
+        ///assert
+        LogInfo("%" PRIu32 " threads: headers from malloc: %.0f creates+destroys/ms, headers from the header pool: %.0f creates+destroys/ms, %.2fx",
+            n_threads, malloc_per_ms, pool_per_ms, pool_per_ms / malloc_per_ms);
+    }
+}
+
+static void count_frees(void* context)
+{
+    (void)interlocked_increment(context);
+}
+
+static void measure_deep_slicing(void)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE* slices = malloc_2(SLICE_DEPTH, sizeof(CONSTBUFFER_HANDLE));
+    ASSERT_IS_NOT_NULL(slices);
+    volatile_atomic int32_t n_origin_frees;
+    (void)interlocked_exchange(&n_origin_frees, 0);
+    volatile_atomic int32_t n_single_origin_frees;
+    (void)interlocked_exchange(&n_single_origin_frees, 0);
+    double create_ms = 0;
+    double release_intermediate_ms = 0;
+    double release_deepest_ms = 0;
+    double release_single_ms = 0;
+
+    ///act
+    for (uint32_t i = 0; i < N_DEEP_SLICINGS; i++)
+    {
+        CONSTBUFFER_HANDLE origin = CONSTBUFFER_CreateWithCustomFree(deep_source, sizeof(deep_source), count_frees, (void*)&n_origin_frees);
+        ASSERT_IS_NOT_NULL(origin);
+
+        double start = timer_global_get_elapsed_ms();
+        slices[0] = CONSTBUFFER_CreateFromOffsetAndSize(origin, 1, sizeof(deep_source) - 1);
+        for (uint32_t j = 1; j < SLICE_DEPTH; j++)
+        {
+            slices[j] = CONSTBUFFER_CreateFromOffsetAndSize(slices[j - 1], 1, SLICE_DEPTH - j);
+        }
+        double created = timer_global_get_elapsed_ms();
+        create_ms += created - start;
+        CONSTBUFFER_DecRef(origin);
+
+        /*the intermediate levels are released first, only the deepest slice is kept (and with it whatever it references)*/
+        start = timer_global_get_elapsed_ms();
+        for (uint32_t j = 0; j < SLICE_DEPTH - 1; j++)
+        {
+            CONSTBUFFER_DecRef(slices[j]);
+        }
+        double released = timer_global_get_elapsed_ms();
+        release_intermediate_ms += released - start;
+
+        ASSERT_ARE_EQUAL(int32_t, i, interlocked_add(&n_origin_frees, 0));
+        ASSERT_ARE_EQUAL(uint32_t, 1, CONSTBUFFER_GetContent(slices[SLICE_DEPTH - 1])->size);
+
+        /*only 2 headers are alive: the deepest slice and the origin, releasing the deepest slice frees both*/
+        start = timer_global_get_elapsed_ms();
+        CONSTBUFFER_DecRef(slices[SLICE_DEPTH - 1]);
+        release_deepest_ms += timer_global_get_elapsed_ms() - start;
+        ASSERT_ARE_EQUAL(int32_t, i + 1, interlocked_add(&n_origin_frees, 0));
+
+        /*the same work with a slice of depth 1: releasing it frees the slice and its origin*/
+        origin = CONSTBUFFER_CreateWithCustomFree(deep_source, sizeof(deep_source), count_frees, (void*)&n_single_origin_frees);
+        ASSERT_IS_NOT_NULL(origin);
+        CONSTBUFFER_HANDLE single = CONSTBUFFER_CreateFromOffsetAndSize(origin, SLICE_DEPTH, 1);
+        ASSERT_IS_NOT_NULL(single);
+        CONSTBUFFER_DecRef(origin);
+
+        start = timer_global_get_elapsed_ms();
+        CONSTBUFFER_DecRef(single);
+        release_single_ms += timer_global_get_elapsed_ms() - start;
+    }
+
+    ///assert
+    ASSERT_ARE_EQUAL(int32_t, N_DEEP_SLICINGS, interlocked_add(&n_origin_frees, 0));
+    ASSERT_ARE_EQUAL(int32_t, N_DEEP_SLICINGS, interlocked_add(&n_single_origin_frees, 0));
+    LogInfo("%d times %d levels of slices of slices: creating a level took %.1f ns, releasing an intermediate level took %.1f ns, releasing the deepest level took %.1f ns, releasing a slice of depth 1 took %.1f ns",
+        N_DEEP_SLICINGS, SLICE_DEPTH,
+        create_ms * 1000000.0 / ((double)N_DEEP_SLICINGS * SLICE_DEPTH),
+        release_intermediate_ms * 1000000.0 / ((double)N_DEEP_SLICINGS * (SLICE_DEPTH - 1)),
+        release_deepest_ms * 1000000.0 / N_DEEP_SLICINGS,
+        release_single_ms * 1000000.0 / N_DEEP_SLICINGS);
+    /*the intermediate levels were freed when they were released, the deepest slice does not keep them alive*/
+    ASSERT_IS_TRUE(release_deepest_ms < MAX_DEEPEST_RELEASE_RATIO * release_single_ms, "releasing the deepest level took %.3f ms, releasing a slice of depth 1 took %.3f ms", release_deepest_ms, release_single_ms);
+
+    ///cleanup
+    free(slices);
+}
+
+static void measure_building(void)
+{
+    ///arrange
+    const uint32_t built_size = N_CHUNKS_PER_BUILD * sizeof(source);
+
+    ///act
+    /*the content is written in a BUFFER_HANDLE which is then copied by CONSTBUFFER_CreateFromBuffer*/
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_BUILDS; i++)
+    {
+        BUFFER_HANDLE buffer = BUFFER_create_with_size(built_size);
+        ASSERT_IS_NOT_NULL(buffer);
+        unsigned char* destination = BUFFER_u_char(buffer);
+        for (uint32_t j = 0; j < N_CHUNKS_PER_BUILD; j++)
+        {
+            (void)memcpy(destination + j * sizeof(source), source, sizeof(source));
+        }
+        CONSTBUFFER_HANDLE built = CONSTBUFFER_CreateFromBuffer(buffer);
+        ASSERT_IS_NOT_NULL(built);
+        BUFFER_delete(buffer);
+        CONSTBUFFER_DecRef(built);
+    }
+    double from_buffer_ms = timer_global_get_elapsed_ms() - start;
+
+    /*the content is written in place and sealed*/
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_BUILDS; i++)
+    {
+        CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(built_size);
+        ASSERT_IS_NOT_NULL(writable);
+        unsigned char* destination = CONSTBUFFER_GetWritableBuffer(writable);
+        for (uint32_t j = 0; j < N_CHUNKS_PER_BUILD; j++)
+        {
+            (void)memcpy(destination + j * sizeof(source), source, sizeof(source));
+        }
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_SetWritableBufferSize(writable, built_size));
+        CONSTBUFFER_HANDLE built = CONSTBUFFER_SealWritableHandle(writable);
+        ASSERT_IS_NOT_NULL(built);
+        ASSERT_ARE_EQUAL(uint32_t, built_size, CONSTBUFFER_GetContent(built)->size);
+        CONSTBUFFER_DecRef(built);
+    }
+    double sealed_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    LogInfo("%d buffers of %" PRIu32 " bytes: BUFFER_HANDLE + CONSTBUFFER_CreateFromBuffer took %.1f ns per buffer, CONSTBUFFER_WRITABLE_HANDLE + CONSTBUFFER_SealWritableHandle took %.1f ns per buffer",
+        N_BUILDS, built_size, from_buffer_ms * 1000000.0 / N_BUILDS, sealed_ms * 1000000.0 / N_BUILDS);
+}
+
+static void measure_serialization(void)
+{
+    ///arrange
+    unsigned char* content = malloc(LARGE_BUFFER_SIZE);
+    ASSERT_IS_NOT_NULL(content);
+    (void)memset(content, 0x42, LARGE_BUFFER_SIZE);
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithMoveMemory(content, LARGE_BUFFER_SIZE);
+    ASSERT_IS_NOT_NULL(source);
+
+    uint32_t destination_size = CONSTBUFFER_get_serialization_size(source);
+    unsigned char* destination = malloc(destination_size);
+    ASSERT_IS_NOT_NULL(destination);
+
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        uint32_t serialized_size;
+        ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, CONSTBUFFER_to_fixed_size_buffer(source, destination, destination_size, &serialized_size));
+    }
+    double copy_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_to_segments(source, header, segments, &segment_count));
+    }
+    double segments_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 2, segment_count);
+    ASSERT_ARE_EQUAL(uint32_t, destination_size, segments[0].size + segments[1].size);
+    ASSERT_IS_TRUE(memcmp(destination, segments[0].buffer, segments[0].size) == 0);
+    ASSERT_IS_TRUE(memcmp(destination + segments[0].size, segments[1].buffer, segments[1].size) == 0);
+    LogInfo("%d serializations of %d bytes: CONSTBUFFER_to_fixed_size_buffer took %.3f ms, CONSTBUFFER_to_segments took %.3f ms",
+        N_SERIALIZATIONS, LARGE_BUFFER_SIZE, copy_ms, segments_ms);
+
+    ///cleanup
+    free(destination);
+    CONSTBUFFER_DecRef(source);
+}
+
+static void measure_deserialization(void)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE content = CONSTBUFFER_CreateWithMoveMemory(malloc(LARGE_BUFFER_SIZE), LARGE_BUFFER_SIZE);
+    ASSERT_IS_NOT_NULL(content);
+    uint32_t serialized_size;
+    unsigned char* serialized = CONSTBUFFER_to_buffer(content, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    /*the receive buffer*/
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_CreateWithMoveMemory(serialized, serialized_size);
+    ASSERT_IS_NOT_NULL(parent);
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        uint32_t consumed;
+        CONSTBUFFER_HANDLE destination;
+        ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, CONSTBUFFER_from_buffer(serialized, serialized_size, &consumed, &destination));
+        CONSTBUFFER_DecRef(destination);
+    }
+    double copy_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        uint32_t consumed;
+        CONSTBUFFER_HANDLE destination;
+        ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination));
+        ASSERT_ARE_EQUAL(uint32_t, serialized_size, consumed);
+        CONSTBUFFER_DecRef(destination);
+    }
+    double no_copy_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    LogInfo("%d deserializations of %d bytes: CONSTBUFFER_from_buffer took %.3f ms, CONSTBUFFER_from_buffer_no_copy took %.3f ms",
+        N_SERIALIZATIONS, LARGE_BUFFER_SIZE, copy_ms, no_copy_ms);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(parent);
+    CONSTBUFFER_DecRef(content);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(function_initialize)
+{
+}
+
+TEST_FUNCTION_CLEANUP(function_cleanup)
+{
+}
+
+TEST_FUNCTION(constbuffer_perf_create_destroy_from_1_to_8_threads)
+{
+    measure_create_destroy();
+}
+
+TEST_FUNCTION(constbuffer_perf_releasing_1000_levels_of_slices)
+{
+    measure_deep_slicing();
+}
+
+TEST_FUNCTION(constbuffer_perf_building_1KB_buffers)
+{
+    measure_building();
+}
+
+TEST_FUNCTION(constbuffer_perf_serialization_of_4MB)
+{
+    measure_serialization();
+}
+
+TEST_FUNCTION(constbuffer_perf_deserialization_of_4MB)
+{
+    measure_deserialization();
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
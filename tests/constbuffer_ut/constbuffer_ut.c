@@ -48,6 +48,8 @@ MOCKABLE_FUNCTION(, void*, test_alloc, size_t, size, void*, context);
 #include "real_gballoc_hl.h"
 
 #include "c_util/memory_data.h"
+#include "c_util/crc32c.h"
+#include "c_util/xxhash64.h"
 
 #include "c_util/constbuffer_format.h"
 #include "c_util/constbuffer_version.h"
@@ -71,6 +73,8 @@ static const char* buffer3 = "three";
 #define BUFFER3_u_char ((unsigned char*)buffer3)
 #define BUFFER3_length ((uint32_t)0)
 
+#define SLICE_DEPTH 1000 /*how many levels of slices of slices the deep slicing test builds*/
+
 unsigned char* my_BUFFER_u_char(BUFFER_HANDLE handle)
 {
     unsigned char* result;
@@ -117,6 +121,20 @@ static void* test_alloc_impl(size_t size, void* context)
     return my_gballoc_malloc(size);
 }
 
+static bool g_init_header_pool_in_malloc;
+static void* malloc_that_inits_the_header_pool(size_t size)
+{
+    void* result = real_gballoc_hl_malloc(size);
+    if (g_init_header_pool_in_malloc)
+    {
+        /*another thread makes its header pool used while this one is being allocated, this one is expected to be freed*/
+        g_init_header_pool_in_malloc = false;
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+        STRICT_EXPECTED_CALL(free(result));
+    }
+    return result;
+}
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -799,7 +817,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
     /*Tests_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
-    /*Tests_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
     /*Tests_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds_1)
     {
@@ -831,7 +849,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
     /*Tests_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
-    /*Tests_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
     /*Tests_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds_2)
     {
@@ -862,7 +880,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
     /*Tests_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
-    /*Tests_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
     /*Tests_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds_3)
     {
@@ -893,7 +911,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
     /*Tests_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
-    /*Tests_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
     /*Tests_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds_4)
     {
@@ -925,7 +943,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_CONSTBUFFER_02_028: [ CONSTBUFFER_CreateFromOffsetAndSize shall allocate memory for a new CONSTBUFFER_HANDLE's content. ]*/
     /*Tests_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
-    /*Tests_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_030: [ Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
     /*Tests_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds_5)
     {
@@ -1055,6 +1073,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     }
 
     /*Tests_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
+    /*Tests_SRS_CONSTBUFFER_11_037: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of the original handle of handle (and not of handle) so that slices of slices never form chains. ]*/
     TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_CreateFromOffsetAndSize_succeeds_3)
     {
         ///arrange
@@ -1081,19 +1100,24 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         CONSTBUFFER_DecRef(origin);
         umock_c_reset_all_calls();
 
-        /*note: no expected calls - after the below call all buffers are at ref count == 1*/
+        STRICT_EXPECTED_CALL(free(result1)); /*result2 has a ref to origin, not to result1*/
 
         ///act
-        CONSTBUFFER_DecRef(result1); /*at this time result 2 has a ref to result1, which has a ref to origin. Nothing is freed*/
+        CONSTBUFFER_DecRef(result1);
 
         ///assert 
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(result2);
+        ASSERT_ARE_EQUAL(size_t, 1, content->size);
+        ASSERT_ARE_EQUAL(uint8_t, source[1], content->buffer[0]);
+
         ///cleanup
-        CONSTBUFFER_DecRef(result2); /*triggers the release of result1, which triggers the release of origin*/
+        CONSTBUFFER_DecRef(result2); /*triggers the release of origin*/
     }
 
     /*Tests_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
+    /*Tests_SRS_CONSTBUFFER_11_037: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of the original handle of handle (and not of handle) so that slices of slices never form chains. ]*/
     TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_CreateFromOffsetAndSize_succeeds_4)
     {
         ///arrange
@@ -1118,17 +1142,14 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         umock_c_reset_all_calls();
 
         CONSTBUFFER_DecRef(origin);
-        CONSTBUFFER_DecRef(result1); /*at this time result 2 has a ref to result1, which has a ref to origin. Nothing is freed*/
+        CONSTBUFFER_DecRef(result1); /*at this time result 2 has a ref to origin. result1 is freed*/
         umock_c_reset_all_calls();
 
-        /*note: no expected calls - after the below call all buffers are at ref count == 1*/
-
         STRICT_EXPECTED_CALL(free(origin));
-        STRICT_EXPECTED_CALL(free(result1));
         STRICT_EXPECTED_CALL(free(result2));
 
         ///act
-        CONSTBUFFER_DecRef(result2); /*triggers the release of result1, which triggers the release of origin*/
+        CONSTBUFFER_DecRef(result2); /*triggers the release of origin*/
 
         ///assert 
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -1137,6 +1158,56 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         
     }
 
+    /*Tests_SRS_CONSTBUFFER_11_037: [ If handle was itself created by CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of the original handle of handle (and not of handle) so that slices of slices never form chains. ]*/
+    TEST_FUNCTION(CONSTBUFFER_DecRef_for_1000_levels_of_CONSTBUFFER_CreateFromOffsetAndSize_frees_every_level_when_released)
+    {
+        ///arrange
+        unsigned char source[SLICE_DEPTH + 1];
+        for (uint32_t i = 0; i < sizeof(source); i++)
+        {
+            source[i] = (unsigned char)i;
+        }
+        CONSTBUFFER_HANDLE origin = CONSTBUFFER_Create(source, sizeof(source));
+        ASSERT_IS_NOT_NULL(origin);
+
+        CONSTBUFFER_HANDLE slices[SLICE_DEPTH];
+        slices[0] = CONSTBUFFER_CreateFromOffsetAndSize(origin, 1, sizeof(source) - 1);
+        ASSERT_IS_NOT_NULL(slices[0]);
+        for (uint32_t i = 1; i < SLICE_DEPTH; i++)
+        {
+            /*every level drops the first byte of the level above*/
+            slices[i] = CONSTBUFFER_CreateFromOffsetAndSize(slices[i - 1], 1, CONSTBUFFER_GetContent(slices[i - 1])->size - 1);
+            ASSERT_IS_NOT_NULL(slices[i]);
+        }
+        CONSTBUFFER_DecRef(origin);
+        umock_c_reset_all_calls();
+
+        for (uint32_t i = 0; i < SLICE_DEPTH - 1; i++)
+        {
+            STRICT_EXPECTED_CALL(free(slices[i]));
+        }
+
+        ///act
+        for (uint32_t i = 0; i < SLICE_DEPTH - 1; i++)
+        {
+            CONSTBUFFER_DecRef(slices[i]);
+        }
+
+        ///assert - every intermediate level is gone, the deepest one still has its content
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(slices[SLICE_DEPTH - 1]);
+        ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+        ASSERT_ARE_EQUAL(uint8_t, source[SLICE_DEPTH], content->buffer[0]);
+
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(free(origin));
+        STRICT_EXPECTED_CALL(free(slices[SLICE_DEPTH - 1]));
+
+        CONSTBUFFER_DecRef(slices[SLICE_DEPTH - 1]);
+
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
     /* CONSTBUFFER_IncRef */
 
     /*Tests_SRS_CONSTBUFFER_02_013: [If constbufferHandle is NULL then CONSTBUFFER_IncRef shall return.]*/
@@ -1434,6 +1505,272 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         CONSTBUFFER_DecRef(right);
     }
 
+    /*Tests_SRS_CONSTBUFFER_11_060: [ If left and right are the same handle then CONSTBUFFER_HANDLE_contain_same shall return true without comparing the bytes. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_left_and_right_the_same_handle_returns_true)
+    {
+        ///arrange
+        bool result;
+        unsigned char source[2] = { '1', '2' };
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(source, sizeof(source));
+        ASSERT_IS_NOT_NULL(handle);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(handle, handle);
+
+        ///assert
+        ASSERT_IS_TRUE(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_061: [ If the content hashes of both left and right have already been computed by CONSTBUFFER_get_content_hash and they are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_different_content_hashes_returns_false)
+    {
+        ///arrange
+        bool result;
+        uint64_t left_hash;
+        uint64_t right_hash;
+        unsigned char leftSource[2] = { 'l', 'l' };
+        CONSTBUFFER_HANDLE left = CONSTBUFFER_Create(leftSource, sizeof(leftSource));
+        ASSERT_IS_NOT_NULL(left);
+
+        unsigned char rightSource[2] = { 'r', 'r' };
+        CONSTBUFFER_HANDLE right = CONSTBUFFER_Create(rightSource, sizeof(rightSource));
+        ASSERT_IS_NOT_NULL(right);
+
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(left, &left_hash));
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(right, &right_hash));
+        ASSERT_ARE_NOT_EQUAL(uint64_t, left_hash, right_hash);
+
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(left, right);
+
+        ///assert
+        ASSERT_IS_FALSE(result);
+
+        ///clean
+        CONSTBUFFER_DecRef(left);
+        CONSTBUFFER_DecRef(right);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_061: [ If the content hashes of both left and right have already been computed by CONSTBUFFER_get_content_hash and they are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_different_content_hashes_does_not_compare_the_bytes)
+    {
+        ///arrange
+        bool result;
+        uint64_t left_hash;
+        uint64_t right_hash;
+        unsigned char leftSource[2] = { 'l', 'l' };
+        CONSTBUFFER_HANDLE left = CONSTBUFFER_CreateWithCustomFree(leftSource, sizeof(leftSource), test_free_func, NULL);
+        ASSERT_IS_NOT_NULL(left);
+
+        unsigned char rightSource[2] = { 'r', 'r' };
+        CONSTBUFFER_HANDLE right = CONSTBUFFER_CreateWithCustomFree(rightSource, sizeof(rightSource), test_free_func, NULL);
+        ASSERT_IS_NOT_NULL(right);
+
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(left, &left_hash));
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(right, &right_hash));
+
+        /*the stored hashes are the only thing that still knows the contents were different*/
+        rightSource[0] = 'l';
+        rightSource[1] = 'l';
+
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(left, right);
+
+        ///assert
+        ASSERT_IS_FALSE(result);
+
+        ///clean
+        CONSTBUFFER_DecRef(left);
+        CONSTBUFFER_DecRef(right);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_02_023: [ CONSTBUFFER_HANDLE_contain_same shall return true. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_equal_content_hashes_returns_true)
+    {
+        ///arrange
+        bool result;
+        uint64_t left_hash;
+        uint64_t right_hash;
+        unsigned char leftSource[2] = { '1', '2' };
+        CONSTBUFFER_HANDLE left = CONSTBUFFER_Create(leftSource, sizeof(leftSource));
+        ASSERT_IS_NOT_NULL(left);
+
+        unsigned char rightSource[2] = { '1', '2' };
+        CONSTBUFFER_HANDLE right = CONSTBUFFER_Create(rightSource, sizeof(rightSource));
+        ASSERT_IS_NOT_NULL(right);
+
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(left, &left_hash));
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(right, &right_hash));
+
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(left, right);
+
+        ///assert
+        ASSERT_IS_TRUE(result);
+        ASSERT_ARE_EQUAL(uint64_t, left_hash, right_hash);
+
+        ///clean
+        CONSTBUFFER_DecRef(left);
+        CONSTBUFFER_DecRef(right);
+    }
+
+    /* CONSTBUFFER_get_content_hash */
+
+    /*Tests_SRS_CONSTBUFFER_11_062: [ If source is NULL then CONSTBUFFER_get_content_hash shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_with_source_NULL_fails)
+    {
+        ///arrange
+        uint64_t content_hash;
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(NULL, &content_hash);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_063: [ If content_hash is NULL then CONSTBUFFER_get_content_hash shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_with_content_hash_NULL_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_064: [ If the content hash of source has not been computed yet then CONSTBUFFER_get_content_hash shall compute it by calling xxhash64 with the content of source and seed 0 and store it in source. ]*/
+    /*Tests_SRS_CONSTBUFFER_11_066: [ CONSTBUFFER_get_content_hash shall write the content hash in content_hash, succeed and return 0. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_succeeds)
+    {
+        ///arrange
+        uint64_t content_hash;
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, &content_hash);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, xxhash64(BUFFER1_u_char, BUFFER1_length, 0), content_hash);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_064: [ If the content hash of source has not been computed yet then CONSTBUFFER_get_content_hash shall compute it by calling xxhash64 with the content of source and seed 0 and store it in source. ]*/
+    /*Tests_SRS_CONSTBUFFER_11_066: [ CONSTBUFFER_get_content_hash shall write the content hash in content_hash, succeed and return 0. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_with_empty_content_succeeds)
+    {
+        ///arrange
+        uint64_t content_hash;
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, &content_hash);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, xxhash64(NULL, 0, 0), content_hash);
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_064: [ If the content hash of source has not been computed yet then CONSTBUFFER_get_content_hash shall compute it by calling xxhash64 with the content of source and seed 0 and store it in source. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_of_a_slice_is_the_hash_of_the_slice_content)
+    {
+        ///arrange
+        uint64_t content_hash;
+        CONSTBUFFER_HANDLE origin = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(origin);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(origin, &content_hash));
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateFromOffsetAndSize(origin, 1, BUFFER1_length - 2);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, &content_hash);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, xxhash64(BUFFER1_u_char + 1, BUFFER1_length - 2, 0), content_hash);
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+        CONSTBUFFER_DecRef(origin);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_065: [ Otherwise CONSTBUFFER_get_content_hash shall use the content hash stored in source. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_the_second_time_returns_the_stored_hash)
+    {
+        ///arrange
+        uint64_t first_hash;
+        uint64_t content_hash;
+        unsigned char source_bytes[3] = { '1', '2', '3' };
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithCustomFree(source_bytes, sizeof(source_bytes), test_free_func, NULL);
+        ASSERT_IS_NOT_NULL(source);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_get_content_hash(source, &first_hash));
+
+        /*a recomputed hash would see these bytes*/
+        source_bytes[0] = '4';
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, &content_hash);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, first_hash, content_hash);
+        ASSERT_ARE_EQUAL(uint64_t, xxhash64((const unsigned char*)"123", 3, 0), content_hash);
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_11_064: [ If the content hash of source has not been computed yet then CONSTBUFFER_get_content_hash shall compute it by calling xxhash64 with the content of source and seed 0 and store it in source. ]*/
+    TEST_FUNCTION(CONSTBUFFER_get_content_hash_of_a_sealed_writable_handle_is_the_hash_of_the_written_content)
+    {
+        ///arrange
+        uint64_t content_hash;
+        CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(writable);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_AppendToWritableBuffer(writable, BUFFER1_u_char, BUFFER1_length));
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_SealWritableHandle(writable);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_get_content_hash(source, &content_hash);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, xxhash64(BUFFER1_u_char, BUFFER1_length, 0), content_hash);
+
+        ///clean
+        CONSTBUFFER_DecRef(source);
+    }
+
 
 /*Tests_SRS_CONSTBUFFER_02_034: [ If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
 TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_handle_NULL_fails)
@@ -1589,994 +1926,4267 @@ TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_unhappy_path) /*this f
     CONSTBUFFER_DecRef(origin);
 }
 
-/*small tests that check code integrity*/
-TEST_FUNCTION(CONSBUFFER_HANDLE_serialization_constants)
+/* CONSTBUFFER_CreateWithAlignment */
+
+/*Tests_SRS_CONSTBUFFER_11_067: [ If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_with_source_NULL_and_size_1_fails)
 {
     ///arrange
 
     ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(NULL, 1, 64);
 
     ///assert
-    ASSERT_ARE_EQUAL(size_t, 1, CONSTBUFFER_VERSION_SIZE);
-    ASSERT_ARE_EQUAL(size_t, sizeof(uint32_t), CONSTBUFFER_SIZE_SIZE);
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* CONSTBUFFER_get_serialization_size */
-
-/*Tests_SRS_CONSTBUFFER_02_041: [ If source is NULL then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_source_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_068: [ If alignment is 0 or is not a power of 2 then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_with_alignment_0_fails)
 {
     ///arrange
-    uint32_t result;
 
     ///act
-    result = CONSTBUFFER_get_serialization_size(NULL);
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(BUFFER1_u_char, BUFFER1_length, 0);
 
     ///assert
-    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_too_big_size_fails)
+/*Tests_SRS_CONSTBUFFER_11_068: [ If alignment is 0 or is not a power of 2 then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_with_alignment_not_a_power_of_2_fails)
 {
     ///arrange
-    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. It would not fit.*/
-    unsigned char* toobig = my_gballoc_malloc(almost4GB);
-    if (toobig == NULL)
-    {
-        /*do nothing, let the test pass - not a fault in this module*/
-    }
-    else
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(BUFFER1_u_char, BUFFER1_length, 48);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_069: [ CONSTBUFFER_CreateWithAlignment shall allocate memory for the handle and size + alignment - 1 bytes of content in a single allocation. ]*/
+/*Tests_SRS_CONSTBUFFER_11_072: [ CONSTBUFFER_CreateWithAlignment shall copy the size bytes of source at the first address in the allocated content that is a multiple of alignment. ]*/
+/*Tests_SRS_CONSTBUFFER_11_073: [ CONSTBUFFER_CreateWithAlignment shall set the ref count of the handle to 1, succeed and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_succeeds)
+{
+    uint32_t alignments[] = { 1, 2, 8, 64, 4096 };
+    for (uint32_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++)
     {
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
-        ASSERT_IS_NOT_NULL(toobig_h);
-        uint32_t result;
+        ///arrange
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length + alignments[i] - 1, 1));
 
         ///act
-        result = CONSTBUFFER_get_serialization_size(toobig_h);
+        CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(BUFFER1_u_char, BUFFER1_length, alignments[i]);
 
         ///assert
-        ASSERT_ARE_EQUAL(uint32_t, 0, result);
+        ASSERT_IS_NOT_NULL(result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+        ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, content->size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER1_u_char, content->buffer, BUFFER1_length));
+        ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)content->buffer % alignments[i]));
 
-        ///clean
-        CONSTBUFFER_DecRef(toobig_h);
+        ///cleanup
+        /*the content is in the same allocation as the handle, so there is just 1 free*/
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(free(result));
+        CONSTBUFFER_DecRef(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        umock_c_reset_all_calls();
     }
 }
 
-/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_11_071: [ If size is 0 then CONSTBUFFER_CreateWithAlignment shall set the buffer of the content to NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_073: [ CONSTBUFFER_CreateWithAlignment shall set the ref count of the handle to 1, succeed and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_with_size_0_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(NULL, 0, 4096);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+    ASSERT_IS_NULL(content->buffer);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_070: [ If there are any failures then CONSTBUFFER_CreateWithAlignment shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_when_malloc_flex_fails_it_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length + 63, 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateWithAlignment(BUFFER1_u_char, BUFFER1_length, 64);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_072: [ CONSTBUFFER_CreateWithAlignment shall copy the size bytes of source at the first address in the allocated content that is a multiple of alignment. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithAlignment_slices_see_the_aligned_content)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE origin = CONSTBUFFER_CreateWithAlignment(BUFFER1_u_char, BUFFER1_length, 64);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSize(origin, 3, 4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(origin)->buffer + 3, CONSTBUFFER_GetContent(result)->buffer);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER1_u_char + 3, CONSTBUFFER_GetContent(result)->buffer, 4));
+
+    ///cleanup
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(origin);
+}
+
+/* CONSTBUFFER_CreateWritableHandle */
+
+/*Tests_SRS_CONSTBUFFER_11_038: [ CONSTBUFFER_CreateWritableHandle shall allocate memory for the handle and capacity bytes of content in a single allocation. ]*/
+/*Tests_SRS_CONSTBUFFER_11_040: [ CONSTBUFFER_CreateWritableHandle shall set the size of the content to 0 and succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 10, 1));
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE result = CONSTBUFFER_CreateWritableHandle(10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 10, CONSTBUFFER_GetWritableBufferCapacity(result));
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferSize(result));
+    ASSERT_IS_NOT_NULL(CONSTBUFFER_GetWritableBuffer(result));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_038: [ CONSTBUFFER_CreateWritableHandle shall allocate memory for the handle and capacity bytes of content in a single allocation. ]*/
+/*Tests_SRS_CONSTBUFFER_11_040: [ CONSTBUFFER_CreateWritableHandle shall set the size of the content to 0 and succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_with_capacity_0_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE result = CONSTBUFFER_CreateWritableHandle(0);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferCapacity(result));
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferSize(result));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_039: [ If there are any failures then CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_when_malloc_flex_fails_it_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 10, 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE result = CONSTBUFFER_CreateWritableHandle(10);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* CONSTBUFFER_GetWritableBuffer */
+
+/*Tests_SRS_CONSTBUFFER_11_041: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBuffer shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    unsigned char* result = CONSTBUFFER_GetWritableBuffer(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_042: [ CONSTBUFFER_GetWritableBuffer shall return the address of the capacity bytes of content of writableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_returns_the_same_address_every_time)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    unsigned char* result1 = CONSTBUFFER_GetWritableBuffer(writableHandle);
+    unsigned char* result2 = CONSTBUFFER_GetWritableBuffer(writableHandle);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result1);
+    ASSERT_ARE_EQUAL(void_ptr, result1, result2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/* CONSTBUFFER_GetWritableBufferCapacity */
+
+/*Tests_SRS_CONSTBUFFER_11_043: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBufferCapacity shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferCapacity_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    uint32_t result = CONSTBUFFER_GetWritableBufferCapacity(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_044: [ CONSTBUFFER_GetWritableBufferCapacity shall return the capacity passed to CONSTBUFFER_CreateWritableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferCapacity_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(42);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    uint32_t result = CONSTBUFFER_GetWritableBufferCapacity(writableHandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 42, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/* CONSTBUFFER_GetWritableBufferSize */
+
+/*Tests_SRS_CONSTBUFFER_11_045: [ If writableHandle is NULL then CONSTBUFFER_GetWritableBufferSize shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    uint32_t result = CONSTBUFFER_GetWritableBufferSize(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_046: [ CONSTBUFFER_GetWritableBufferSize shall return the size of the content of writableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_AppendToWritableBuffer(writableHandle, BUFFER1_u_char, BUFFER1_length));
+    umock_c_reset_all_calls();
+
+    ///act
+    uint32_t result = CONSTBUFFER_GetWritableBufferSize(writableHandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/* CONSTBUFFER_SetWritableBufferSize */
+
+/*Tests_SRS_CONSTBUFFER_11_047: [ If writableHandle is NULL then CONSTBUFFER_SetWritableBufferSize shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_SetWritableBufferSize_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    int result = CONSTBUFFER_SetWritableBufferSize(NULL, 1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_048: [ If size is greater than the capacity of writableHandle then CONSTBUFFER_SetWritableBufferSize shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_SetWritableBufferSize_with_size_greater_than_capacity_fails)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_SetWritableBufferSize(writableHandle, 11);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferSize(writableHandle));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_049: [ CONSTBUFFER_SetWritableBufferSize shall set the size of the content of writableHandle to size, succeed and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_SetWritableBufferSize_with_size_equal_to_capacity_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_SetWritableBufferSize(writableHandle, 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 10, CONSTBUFFER_GetWritableBufferSize(writableHandle));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/* CONSTBUFFER_AppendToWritableBuffer */
+
+/*Tests_SRS_CONSTBUFFER_11_050: [ If writableHandle is NULL then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_AppendToWritableBuffer_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    int result = CONSTBUFFER_AppendToWritableBuffer(NULL, BUFFER1_u_char, BUFFER1_length);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_051: [ If source is NULL and size is not 0 then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_AppendToWritableBuffer_with_source_NULL_and_size_not_0_fails)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_AppendToWritableBuffer(writableHandle, NULL, 1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferSize(writableHandle));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_053: [ CONSTBUFFER_AppendToWritableBuffer shall copy size bytes from source after the content of writableHandle, add size to the size of the content, succeed and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_AppendToWritableBuffer_with_source_NULL_and_size_0_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_AppendToWritableBuffer(writableHandle, NULL, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetWritableBufferSize(writableHandle));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_052: [ If size exceeds the capacity of writableHandle that is not used by its content then CONSTBUFFER_AppendToWritableBuffer shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_AppendToWritableBuffer_exceeding_capacity_fails)
+{
+    ///arrange
+    const unsigned char more[] = { 'm', 'o', 'r', 'e' };
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length + (uint32_t)sizeof(more) - 1);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_AppendToWritableBuffer(writableHandle, BUFFER1_u_char, BUFFER1_length));
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_AppendToWritableBuffer(writableHandle, more, (uint32_t)sizeof(more));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, CONSTBUFFER_GetWritableBufferSize(writableHandle));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_053: [ CONSTBUFFER_AppendToWritableBuffer shall copy size bytes from source after the content of writableHandle, add size to the size of the content, succeed and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_AppendToWritableBuffer_appends_until_capacity_is_reached)
+{
+    ///arrange
+    const unsigned char more[] = { 'm', 'o', 'r', 'e' };
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length + (uint32_t)sizeof(more));
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result1 = CONSTBUFFER_AppendToWritableBuffer(writableHandle, BUFFER1_u_char, BUFFER1_length);
+    int result2 = CONSTBUFFER_AppendToWritableBuffer(writableHandle, more, (uint32_t)sizeof(more));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result1);
+    ASSERT_ARE_EQUAL(int, 0, result2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length + (uint32_t)sizeof(more), CONSTBUFFER_GetWritableBufferSize(writableHandle));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(CONSTBUFFER_GetWritableBuffer(writableHandle), BUFFER1_u_char, BUFFER1_length));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(CONSTBUFFER_GetWritableBuffer(writableHandle) + BUFFER1_length, more, sizeof(more)));
+
+    ///cleanup
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+}
+
+/* CONSTBUFFER_SealWritableHandle */
+
+/*Tests_SRS_CONSTBUFFER_11_054: [ If writableHandle is NULL then CONSTBUFFER_SealWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_with_writableHandle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_SealWritableHandle(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_055: [ CONSTBUFFER_SealWritableHandle shall turn writableHandle into a CONSTBUFFER_HANDLE with the content of writableHandle, without allocating memory and without copying the content. ]*/
+/*Tests_SRS_CONSTBUFFER_11_057: [ CONSTBUFFER_SealWritableHandle shall succeed and return the CONSTBUFFER_HANDLE. writableHandle shall not be used after this call. ]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    unsigned char* writableBuffer = CONSTBUFFER_GetWritableBuffer(writableHandle);
+    (void)memcpy(writableBuffer, BUFFER1_u_char, BUFFER1_length);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_SetWritableBufferSize(writableHandle, BUFFER1_length));
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_SealWritableHandle(writableHandle);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_ARE_EQUAL(void_ptr, writableBuffer, content->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(content->buffer, BUFFER1_u_char, BUFFER1_length));
+
+    ///cleanup
+    CONSTBUFFER_DecRef(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_056: [ If the size of the content is 0 then CONSTBUFFER_SealWritableHandle shall set the buffer of the CONSTBUFFER_HANDLE to NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_with_size_0_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_SealWritableHandle(writableHandle);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_IS_NULL(content->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_057: [ CONSTBUFFER_SealWritableHandle shall succeed and return the CONSTBUFFER_HANDLE. writableHandle shall not be used after this call. ]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_returns_a_handle_that_is_freed_by_the_last_CONSTBUFFER_DecRef)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_AppendToWritableBuffer(writableHandle, BUFFER1_u_char, BUFFER1_length));
+    CONSTBUFFER_HANDLE sealed = CONSTBUFFER_SealWritableHandle(writableHandle);
+    ASSERT_IS_NOT_NULL(sealed);
+    CONSTBUFFER_IncRef(sealed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(sealed));
+
+    ///act
+    CONSTBUFFER_DecRef(sealed);
+    CONSTBUFFER_DecRef(sealed);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* CONSTBUFFER_DestroyWritableHandle */
+
+/*Tests_SRS_CONSTBUFFER_11_058: [ If writableHandle is NULL then CONSTBUFFER_DestroyWritableHandle shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_DestroyWritableHandle_with_writableHandle_NULL_returns)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_DestroyWritableHandle(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_059: [ CONSTBUFFER_DestroyWritableHandle shall free the memory used by writableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_DestroyWritableHandle_frees)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writableHandle = CONSTBUFFER_CreateWritableHandle(10);
+    ASSERT_IS_NOT_NULL(writableHandle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(writableHandle));
+
+    ///act
+    CONSTBUFFER_DestroyWritableHandle(writableHandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*small tests that check code integrity*/
+TEST_FUNCTION(CONSBUFFER_HANDLE_serialization_constants)
+{
+    ///arrange
+
+    ///act
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 1, CONSTBUFFER_VERSION_SIZE);
+    ASSERT_ARE_EQUAL(size_t, sizeof(uint32_t), CONSTBUFFER_SIZE_SIZE);
+    ASSERT_ARE_EQUAL(size_t, sizeof(uint32_t), CONSTBUFFER_CRC32C_SIZE);
+    ASSERT_ARE_EQUAL(size_t, CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + CONSTBUFFER_CRC32C_SIZE, CONSTBUFFER_V2_CONTENT_OFFSET);
+}
+
+/* CONSTBUFFER_get_serialization_size */
+
+/*Tests_SRS_CONSTBUFFER_02_041: [ If source is NULL then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_too_big_size_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. It would not fit.*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+        uint32_t result;
+
+        ///act
+        result = CONSTBUFFER_get_serialization_size(toobig_h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint32_t, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
 /*Tests_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
 TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_biggest_size_succeeds)
 {
     ///arrange
-    uint32_t almost4GB = UINT32_MAX - 5; /*this is 5 bytes shy of 4GB. This is the greatest size for which serialization still works*/
-    unsigned char* toobig = my_gballoc_malloc(almost4GB);
-    if (toobig == NULL)
-    {
-        /*do nothing, let the test pass - not a fault in this module*/
-    }
-    else
-    {
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
-        ASSERT_IS_NOT_NULL(toobig_h);
-        uint32_t result;
+    uint32_t almost4GB = UINT32_MAX - 5; /*this is 5 bytes shy of 4GB. This is the greatest size for which serialization still works*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+        uint32_t result;
+
+        ///act
+        result = CONSTBUFFER_get_serialization_size(toobig_h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_0_size_succeeds)
+{
+    ///arrange
+    
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(smallest);
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size(smallest);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(smallest);
+    
+}
+
+/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_2_size_succeeds)
+{
+    ///arrange
+    unsigned char source[2] = { 1,2 };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
+    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(smallest);
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size(smallest);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(source), result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(smallest);
+
+}
+
+/* CONSTBUFFER_to_buffer */
+
+/*Tests_SRS_CONSTBUFFER_02_044: [ If source is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t size;
+    unsigned char* result;
+
+    ///act
+    result = CONSTBUFFER_to_buffer(NULL, my_gballoc_malloc_with_context, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_045: [ If serialized_size is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_NULL_fails)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, my_gballoc_malloc_with_context, NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_exceeding_UINT32_MAX_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+
+        ///arrange
+        uint32_t serialized_size;
+
+        ///act
+        unsigned char* result;
+
+        ///act
+        result = CONSTBUFFER_to_buffer(toobig_h, NULL, NULL, &serialized_size);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+
+        ///clean
+
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_1_with_malloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG,sizeof(s), 1));
+    
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t)+sizeof(uint32_t) + sizeof(uint8_t))); /*we only serialize a CONSTBUFFER of 1 character*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, NULL, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_0_with_malloc_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t) + sizeof(uint32_t))); /*we only serialize an empty CONSTBUFFER*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, NULL, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, 0, size_from_serialization);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_1_with_custom_alloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 1 character*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_2_with_custom_alloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 2 characters*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_2_with_custom_alloc_unhappy_path)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + 2 * sizeof(uint8_t), TEST_ALLOC_CONTEXT)) /*we only serialize a CONSTBUFFER of 2 characters*/
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_to_fixed_size_buffer */
+
+/*Tests_SRS_CONSTBUFFER_02_055: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_source_NULL_fails)
+{
+    ///arrange
+    unsigned char destination[100];
+    uint32_t size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(NULL, destination, sizeof(destination), &size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+}
+
+/*Tests_SRS_CONSTBUFFER_02_056: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_destination_NULL_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    uint32_t size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, NULL, 0, &size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_057: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_serialized_size_NULL_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[100];
+
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_074: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_when_serialized_size_overflows_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+
+        unsigned char* destination = my_gballoc_malloc(UINT32_MAX);
+        if (destination == NULL)
+        {
+            /*not really a fault of this test, let the test pass*/
+        }
+        else
+        {
+            ///arrange
+            uint32_t serialized_size;
+
+            ///act
+            CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+            ///act
+            result = CONSTBUFFER_to_fixed_size_buffer(toobig_h, destination, UINT32_MAX, &serialized_size);
+
+            ///assert
+            ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, result);
+            
+            ///clean
+            my_gballoc_free(destination);
+        }
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_02_058: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_that_would_overflow_destination_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[5]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER, result);
+    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
+/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_1) /*in this case, the size of the buffer matches perfectly the serialization size*/
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[6]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 1, size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
+/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_2) /*in this case, the size of the buffer exceeds the serialization size*/
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[7]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 1, size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
+/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
+/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_3) /*in this case, an empty constbuffer_handle is serialized*/
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[7]; /*the above CONSTBUFFER_HANDLE requires 5 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 5, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, size);
+
+    /*content*/
+    /*doesn't have*/
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_get_serialization_size_v2 */
+
+/*Tests_SRS_CONSTBUFFER_11_135: [ If source is NULL then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size_v2(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_136: [ If sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_too_big_size_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 8; /*this is 8 bytes shy of 4GB. It would not fit.*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+        uint32_t result;
+
+        ///act
+        result = CONSTBUFFER_get_serialization_size_v2(toobig_h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint32_t, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_11_136: [ If sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_11_137: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_biggest_size_succeeds)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 9; /*this is 9 bytes shy of 4GB. This is the greatest size for which serialization still works*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+        uint32_t result;
+
+        ///act
+        result = CONSTBUFFER_get_serialization_size_v2(toobig_h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_11_136: [ If sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_11_137: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_0_size_succeeds)
+{
+    ///arrange
+    
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(smallest);
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size_v2(smallest);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t), result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(smallest);
+    
+}
+
+/*Tests_SRS_CONSTBUFFER_11_136: [ If sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+/*Tests_SRS_CONSTBUFFER_11_137: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + 2 * sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_2_size_succeeds)
+{
+    ///arrange
+    unsigned char source[2] = { 1,2 };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
+    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(smallest);
+    uint32_t result;
+
+    ///act
+    result = CONSTBUFFER_get_serialization_size_v2(smallest);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(source), result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(smallest);
+
+}
+
+/* CONSTBUFFER_to_buffer_v2 */
+
+/*Tests_SRS_CONSTBUFFER_11_138: [ If source is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t size;
+    unsigned char* result;
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(NULL, my_gballoc_malloc_with_context, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_139: [ If serialized_size is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_NULL_fails)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, my_gballoc_malloc_with_context, NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_145: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_exceeding_UINT32_MAX_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 8; /*this is 8 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+
+        ///arrange
+        uint32_t serialized_size;
+
+        ///act
+        unsigned char* result;
+
+        ///act
+        result = CONSTBUFFER_to_buffer_v2(toobig_h, NULL, NULL, &serialized_size);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+
+        ///clean
+
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_11_140: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_11_141: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_11_142: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2) and at offsets 1-4 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_032: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_143: [ CONSTBUFFER_to_buffer_v2 shall write starting at offset 9 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_11_144: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_1_with_malloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG,sizeof(s), 1));
+    
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t))); /*we only serialize a CONSTBUFFER of 1 character*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_update(0, s, sizeof(s)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_140: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_11_141: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_11_142: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2) and at offsets 1-4 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_032: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_143: [ CONSTBUFFER_to_buffer_v2 shall write starting at offset 9 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_11_144: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_0_with_malloc_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t))); /*we only serialize an empty CONSTBUFFER*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, 0, size_from_serialization);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, 0, crc32c_from_serialization);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_140: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_11_141: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_11_142: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2) and at offsets 1-4 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_032: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_143: [ CONSTBUFFER_to_buffer_v2 shall write starting at offset 9 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_11_144: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_1_with_custom_alloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 1 character*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_update(0, s, sizeof(s)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_140: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_11_141: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_11_142: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2) and at offsets 1-4 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_032: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_143: [ CONSTBUFFER_to_buffer_v2 shall write starting at offset 9 of the allocated memory the bytes of source->alias.buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_11_144: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_2_with_custom_alloc_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 2 characters*/
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), size);
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_update(0, s, sizeof(s)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_145: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_2_with_custom_alloc_unhappy_path)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + 2 * sizeof(uint8_t), TEST_ALLOC_CONTEXT)) /*we only serialize a CONSTBUFFER of 2 characters*/
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_to_fixed_size_buffer_v2 */
+
+/*Tests_SRS_CONSTBUFFER_11_146: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_with_source_NULL_fails)
+{
+    ///arrange
+    unsigned char destination[100];
+    uint32_t size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(NULL, destination, sizeof(destination), &size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+}
+
+/*Tests_SRS_CONSTBUFFER_11_147: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_with_destination_NULL_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    uint32_t size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, NULL, 0, &size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_148: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_with_serialized_size_NULL_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[100];
+
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_153: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_when_serialized_size_overflows_fails)
+{
+    ///arrange
+    uint32_t almost4GB = UINT32_MAX - 8; /*this is 8 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
+    unsigned char* toobig = my_gballoc_malloc(almost4GB);
+    if (toobig == NULL)
+    {
+        /*do nothing, let the test pass - not a fault in this module*/
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
+        ASSERT_IS_NOT_NULL(toobig_h);
+
+        unsigned char* destination = my_gballoc_malloc(UINT32_MAX);
+        if (destination == NULL)
+        {
+            /*not really a fault of this test, let the test pass*/
+        }
+        else
+        {
+            ///arrange
+            uint32_t serialized_size;
+
+            ///act
+            CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+            ///act
+            result = CONSTBUFFER_to_fixed_size_buffer_v2(toobig_h, destination, UINT32_MAX, &serialized_size);
+
+            ///assert
+            ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, result);
+            
+            ///clean
+            my_gballoc_free(destination);
+        }
+        CONSTBUFFER_DecRef(toobig_h);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_11_149: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_that_would_overflow_destination_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[9]; /*the above CONSTBUFFER_HANDLE requires 10 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER, result);
+    ASSERT_ARE_EQUAL(uint32_t, 10, serialized_size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_150: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2) and at offset 1 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_033: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_151: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall copy all the bytes of source->alias.buffer in destination starting at offset 9. ]*/
+/*Tests_SRS_CONSTBUFFER_11_152: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_succeeds_1) /*in this case, the size of the buffer matches perfectly the serialization size*/
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[10]; /*the above CONSTBUFFER_HANDLE requires 10 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 10, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 1, size);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_update(0, source_bytes, sizeof(source_bytes)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_150: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2) and at offset 1 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_033: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_151: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall copy all the bytes of source->alias.buffer in destination starting at offset 9. ]*/
+/*Tests_SRS_CONSTBUFFER_11_152: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_succeeds_2) /*in this case, the size of the buffer exceeds the serialization size*/
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[11]; /*the above CONSTBUFFER_HANDLE requires 10 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 10, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 1, size);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_update(0, source_bytes, sizeof(source_bytes)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_150: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2) and at offset 1 the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_033: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C of the bytes of source->alias.buffer, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_151: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall copy all the bytes of source->alias.buffer in destination starting at offset 9. ]*/
+/*Tests_SRS_CONSTBUFFER_11_152: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_succeeds_3) /*in this case, an empty constbuffer_handle is serialized*/
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[11]; /*the above CONSTBUFFER_HANDLE requires 9 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 9, serialized_size);
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, size);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, 0, crc32c_from_serialization);
+
+    /*content*/
+    /*doesn't have*/
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_from_buffer */
+
+/*Tests_SRS_CONSTBUFFER_02_063: [ If source is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_from_buffer(NULL, 6, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_064: [ If consumed is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_consumed_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 6, NULL, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_065: [ If destination is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_destination_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 6, &consumed, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_size_0_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 or 2 (the known versions) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_version_0_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 }; /*note first byte to be 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_insufficient_bytes_fails_1) /*in this case there are not enough bytes for version and size*/
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 1 }; /*note first byte to be 1, rest are 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(uint8_t) + sizeof(uint32_t) - 1, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_0_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = { 
+        1, /*version*/
+        0,0,0,0 /*size = 0*/
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content= CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_0_size_from_bigger_buffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,0, /*size = 0*/
+        8 /*extra byte*/
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_070: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_from_insufficient_buffer_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,1 /*size = 1*/
+    };
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,1,/*size = 1*/
+        0x42
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size)==0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_from_greater_size_buffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,1,/*size = 1*/
+        0x42, 0x43 /*0x43 is extraneous*/
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size)==0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_2_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,2,/*size = 2*/
+        0x42, 0x43
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_2_size_unhappy_path)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        1, /*version*/
+        0,0,0,2,/*size = 2*/
+        0x42, 0x43
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, 1))
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 or 2 (the known versions) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_version_3_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 3 }; /*note first byte to be 3, rest are 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_034: [ If the version is 2 and source's size is less than sizeof(uint8_t) + 2 * sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_insufficient_bytes_fails) /*in this case there are not enough bytes for version, size and crc32c*/
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 2 }; /*note first byte to be 2, rest are 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(uint8_t) + 2 * sizeof(uint32_t) - 1, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_035: [ If the version is 2 and source's size is less than sizeof(uint8_t) + 2 * sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_1_size_from_insufficient_buffer_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,1, /*size = 1*/
+        0,0,0,0 /*crc32c*/
+    };
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_corrupted_content_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,2, /*size = 2*/
+        0,0,0,0, /*crc32c, written below*/
+        0x42, 0x43
+    };
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_update(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 2));
+    source[CONSTBUFFER_V2_CONTENT_OFFSET + 1] ^= 0x01; /*a single flipped bit*/
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_corrupted_crc32c_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,0, /*size = 0*/
+        0,0,0,1 /*crc32c of no bytes is 0*/
+    };
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_0_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,0, /*size = 0*/
+        0,0,0,0, /*crc32c of no bytes is 0*/
+        8 /*extra byte*/
+    };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + 2 * sizeof(uint32_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the content bytes of source (at offset 5 for version 1, at offset 9 for version 2). ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_version_2_with_2_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,2, /*size = 2*/
+        0,0,0,0, /*crc32c, written below*/
+        0x42, 0x43,
+        0x44 /*extraneous*/
+    };
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_update(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 2));
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + 2 * sizeof(uint32_t) + 2 * sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*size*/
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_V2_CONTENT_OFFSET, content->buffer, content->size) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_reads_what_CONSTBUFFER_to_buffer_wrote)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t serialized_size;
+    unsigned char* serialized = CONSTBUFFER_to_buffer(source, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer(serialized, serialized_size, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, serialized_size, consumed);
+    ASSERT_IS_TRUE(CONSTBUFFER_HANDLE_contain_same(source, destination));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_DecRef(source);
+    free(serialized);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_036: [ If the version is 2 then CONSTBUFFER_from_buffer shall compute the CRC32C of the content bytes by calling crc32c_update and if it is different than the CRC32C read from offset 5 of source then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_reads_what_CONSTBUFFER_to_buffer_v2_wrote)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t serialized_size;
+    unsigned char* serialized = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer(serialized, serialized_size, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, serialized_size, consumed);
+    ASSERT_IS_TRUE(CONSTBUFFER_HANDLE_contain_same(source, destination));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_DecRef(source);
+    free(serialized);
+}
+
+/* CONSTBUFFER_from_buffer_no_copy */
+
+/*Tests_SRS_CONSTBUFFER_11_024: [ If parent is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_parent_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(NULL, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_025: [ If consumed is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_consumed_NULL_fails)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 0 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, NULL, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_026: [ If destination is NULL then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_destination_NULL_fails)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 0 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_027: [ If offset is greater than or equal to the size of parent then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_offset_equal_to_size_fails)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 0 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_028: [ CONSTBUFFER_from_buffer_no_copy shall validate the version, the size and (for version 2) the CRC32C of the serialization starting at offset in parent the same way as CONSTBUFFER_from_buffer does and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA if they are not valid. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_unknown_version_fails)
+{
+    ///arrange
+    unsigned char source[] = { 3, 0, 0, 0, 0, 0, 0, 0, 0 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_028: [ CONSTBUFFER_from_buffer_no_copy shall validate the version, the size and (for version 2) the CRC32C of the serialization starting at offset in parent the same way as CONSTBUFFER_from_buffer does and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA if they are not valid. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_truncated_size_fails)
+{
+    ///arrange
+    unsigned char source[] = { 0x42, 0x43, 1, 0, 0, 0 }; /*the serialization at offset 2 misses 1 byte of its size*/
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 2, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_028: [ CONSTBUFFER_from_buffer_no_copy shall validate the version, the size and (for version 2) the CRC32C of the serialization starting at offset in parent the same way as CONSTBUFFER_from_buffer does and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA if they are not valid. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_truncated_content_fails)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 3, 0x42, 0x43 }; /*3 bytes of content announced, only 2 present*/
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_029: [ CONSTBUFFER_from_buffer_no_copy shall create the CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateFromOffsetAndSize with parent, offset + the offset of the content (5 for version 1, 9 for version 2) and the number of content bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_11_031: [ CONSTBUFFER_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_succeeds)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 2, 0x42, 0x43 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*only the header, the content is not copied*/
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source), consumed);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(parent)->buffer + CONSTBUFFER_CONTENT_OFFSET, content->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*destination keeps parent alive*/
+    umock_c_reset_all_calls();
+    CONSTBUFFER_DecRef(parent);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, 0x42, content->buffer[0]);
+    ASSERT_ARE_EQUAL(uint8_t, 0x43, content->buffer[1]);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_029: [ CONSTBUFFER_from_buffer_no_copy shall create the CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateFromOffsetAndSize with parent, offset + the offset of the content (5 for version 1, 9 for version 2) and the number of content bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_11_031: [ CONSTBUFFER_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_with_2_serializations_succeeds)
+{
+    ///arrange
+    unsigned char source[] = {
+        1, 0, 0, 0, 1, 0x42, /*first serialization, 1 byte of content*/
+        1, 0, 0, 0, 0 /*second serialization, empty*/
+    };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE first;
+    CONSTBUFFER_HANDLE second;
+    uint32_t first_consumed;
+    uint32_t second_consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result_1 = CONSTBUFFER_from_buffer_no_copy(parent, 0, &first_consumed, &first);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_2 = CONSTBUFFER_from_buffer_no_copy(parent, first_consumed, &second_consumed, &second);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result_2);
+    ASSERT_ARE_EQUAL(uint32_t, 6, first_consumed);
+    ASSERT_ARE_EQUAL(uint32_t, 5, second_consumed);
+    ASSERT_ARE_EQUAL(uint32_t, 1, CONSTBUFFER_GetContent(first)->size);
+    ASSERT_ARE_EQUAL(uint8_t, 0x42, CONSTBUFFER_GetContent(first)->buffer[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetContent(second)->size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(first);
+    CONSTBUFFER_DecRef(second);
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_028: [ CONSTBUFFER_from_buffer_no_copy shall validate the version, the size and (for version 2) the CRC32C of the serialization starting at offset in parent the same way as CONSTBUFFER_from_buffer does and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA if they are not valid. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_version_2_with_corrupted_content_fails)
+{
+    ///arrange
+    unsigned char source[] = { 2, 0, 0, 0, 2, 0, 0, 0, 0, 0x42, 0x43 };
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_update(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 2));
+    source[CONSTBUFFER_V2_CONTENT_OFFSET] ^= 0x80; /*a single flipped bit*/
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_029: [ CONSTBUFFER_from_buffer_no_copy shall create the CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateFromOffsetAndSize with parent, offset + the offset of the content (5 for version 1, 9 for version 2) and the number of content bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_11_031: [ CONSTBUFFER_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_no_copy_version_2_succeeds)
+{
+    ///arrange
+    unsigned char source[] = { 2, 0, 0, 0, 2, 0, 0, 0, 0, 0x42, 0x43 };
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_update(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 2));
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*only the header, the content is not copied*/
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source), consumed);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(parent)->buffer + CONSTBUFFER_V2_CONTENT_OFFSET, content->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_DecRef(parent);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_030: [ If there are any failures then CONSTBUFFER_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(when_malloc_fails_CONSTBUFFER_from_buffer_no_copy_fails)
+{
+    ///arrange
+    unsigned char source[] = { 1, 0, 0, 0, 2, 0x42, 0x43 };
+    CONSTBUFFER_HANDLE parent = CONSTBUFFER_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_HANDLE destination;
+    uint32_t consumed;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_from_buffer_no_copy(parent, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*parent was not referenced*/
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(parent));
+    CONSTBUFFER_DecRef(parent);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* CONSTBUFFER_to_segments */
+
+/*Tests_SRS_CONSTBUFFER_11_014: [ If source is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_source_NULL_fails)
+{
+    ///arrange
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    int result;
+
+    ///act
+    result = CONSTBUFFER_to_segments(NULL, header, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_015: [ If header is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_header_NULL_fails)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, NULL, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_016: [ If segments is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_segments_NULL_fails)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    uint32_t segment_count;
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, header, NULL, &segment_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_017: [ If segment_count is NULL then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_segment_count_NULL_fails)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, header, segments, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_018: [ If the size of the serialization exceeds UINT32_MAX then CONSTBUFFER_to_segments shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_size_that_overflows_the_serialization_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithCustomFree((const unsigned char*)0x42, UINT32_MAX - CONSTBUFFER_SEGMENTS_HEADER_SIZE + 1, test_free_func, NULL); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, header, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_019: [ CONSTBUFFER_to_segments shall write in header the version of serialization (currently 1) followed by the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_020: [ CONSTBUFFER_to_segments shall set the first segment to header and CONSTBUFFER_SEGMENTS_HEADER_SIZE bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_11_022: [ Otherwise CONSTBUFFER_to_segments shall set the second segment to source->alias.buffer and source->alias.size bytes, without copying them, and set segment_count to 2. ]*/
+/*Tests_SRS_CONSTBUFFER_11_023: [ CONSTBUFFER_to_segments shall succeed and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_size_2_succeeds)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, header, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, segment_count);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_CONTENT_OFFSET, CONSTBUFFER_SEGMENTS_HEADER_SIZE);
+
+    /*header*/
+    ASSERT_ARE_EQUAL(void_ptr, header, segments[0].buffer);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_SEGMENTS_HEADER_SIZE, segments[0].size);
+
+    uint8_t version_from_serialization;
+    read_uint8_t(header + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+
+    uint32_t size_from_serialization;
+    read_uint32_t(header + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*content is not copied*/
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(source)->buffer, segments[1].buffer);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), segments[1].size);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_021: [ If the size of source is 0 then CONSTBUFFER_to_segments shall set segment_count to 1. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_with_size_0_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    int result;
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_to_segments(source, header, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, segment_count);
+    ASSERT_ARE_EQUAL(void_ptr, header, segments[0].buffer);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_SEGMENTS_HEADER_SIZE, segments[0].size);
+
+    uint32_t size_from_serialization;
+    read_uint32_t(header + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, 0, size_from_serialization);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_019: [ CONSTBUFFER_to_segments shall write in header the version of serialization (currently 1) followed by the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_022: [ Otherwise CONSTBUFFER_to_segments shall set the second segment to source->alias.buffer and source->alias.size bytes, without copying them, and set segment_count to 2. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_segments_produces_the_same_bytes_as_CONSTBUFFER_to_buffer)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2, 3, 4, 5, 6, 7 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t serialized_size;
+    unsigned char* serialized = CONSTBUFFER_to_buffer(source, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    unsigned char header[CONSTBUFFER_SEGMENTS_HEADER_SIZE];
+    CONSTBUFFER segments[CONSTBUFFER_SEGMENTS_MAX_COUNT];
+    uint32_t segment_count;
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_to_segments(source, header, segments, &segment_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, serialized_size, segments[0].size + segments[1].size);
+    ASSERT_IS_TRUE(memcmp(serialized, segments[0].buffer, segments[0].size) == 0);
+    ASSERT_IS_TRUE(memcmp(serialized + segments[0].size, segments[1].buffer, segments[1].size) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    free(serialized);
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_header_pool_init */
+
+/*Tests_SRS_CONSTBUFFER_11_002: [ CONSTBUFFER_header_pool_init shall allocate memory for the header pool. ]*/
+/*Tests_SRS_CONSTBUFFER_11_004: [ CONSTBUFFER_header_pool_init shall set all the slots of all the shards to empty, make the header pool used by all the following creates and destroys by calling interlocked_compare_exchange_pointer and succeed and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_header_pool_init_succeeds)
+{
+    ///arrange
+    int result;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    result = CONSTBUFFER_header_pool_init();
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_header_pool_deinit();
+}
+
+/*Tests_SRS_CONSTBUFFER_11_001: [ If the header pool is already initialized then CONSTBUFFER_header_pool_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_header_pool_init_after_init_fails)
+{
+    ///arrange
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_header_pool_init();
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_header_pool_deinit();
+}
+
+/*Tests_SRS_CONSTBUFFER_11_003: [ If there are any failures then CONSTBUFFER_header_pool_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_malloc_fails_CONSTBUFFER_header_pool_init_fails)
+{
+    ///arrange
+    int result;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_header_pool_init();
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*the headers still come from malloc and go back to free*/
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(NULL));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(NULL, 0);
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_132: [ If another header pool was made used in the meantime then CONSTBUFFER_header_pool_init shall free the memory it allocated and fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_another_header_pool_is_made_used_concurrently_CONSTBUFFER_header_pool_init_frees_its_header_pool_and_fails)
+{
+    ///arrange
+    int result;
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, malloc_that_inits_the_header_pool);
+    g_init_header_pool_in_malloc = true;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*the header pool that loses*/
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*the header pool that wins*/
+
+    ///act
+    result = CONSTBUFFER_header_pool_init();
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(g_init_header_pool_in_malloc);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    CONSTBUFFER_header_pool_deinit();
+}
+
+/* CONSTBUFFER_header_pool_deinit */
+
+/*Tests_SRS_CONSTBUFFER_11_005: [ If the header pool is not initialized then CONSTBUFFER_header_pool_deinit shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_header_pool_deinit_without_init_returns)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_header_pool_deinit();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_133: [ CONSTBUFFER_header_pool_deinit shall stop the creates and destroys from using the header pool by calling interlocked_exchange_pointer with NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_134: [ CONSTBUFFER_header_pool_deinit shall wait for the count of users of every shard to be 0. ]*/
+/*Tests_SRS_CONSTBUFFER_11_006: [ CONSTBUFFER_header_pool_deinit shall free all the cached headers and the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_header_pool_deinit_frees_the_header_pool)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_header_pool_deinit();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_006: [ CONSTBUFFER_header_pool_deinit shall free all the cached headers and the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_header_pool_deinit_frees_the_cached_headers)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(NULL, 0);
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_DecRef(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(handle));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_header_pool_deinit();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_007: [ After CONSTBUFFER_header_pool_deinit headers shall be allocated by calling malloc and freed by calling free. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_after_CONSTBUFFER_header_pool_deinit_frees_the_header)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(NULL, 0);
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_header_pool_deinit();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(NULL));
+    STRICT_EXPECTED_CALL(free(handle));
+
+    ///act
+    CONSTBUFFER_DecRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Header pool */
+
+/*Tests_SRS_CONSTBUFFER_11_008: [ The shard shall be picked by hashing the address of the stack of the calling thread. ]*/
+/*Tests_SRS_CONSTBUFFER_11_011: [ If the shard has an empty slot then the header shall be cached in the slot by calling interlocked_compare_exchange_pointer. ]*/
+/*Tests_SRS_CONSTBUFFER_11_013: [ If the header pool is initialized then CONSTBUFFER_DecRef shall return the headers of buffers created by CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_with_header_pool_caches_the_header_of_CONSTBUFFER_CreateWithMoveMemory)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    unsigned char* test_buffer = (unsigned char*)my_gballoc_malloc(2);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(test_buffer, 2);
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(test_buffer));
+
+    ///act
+    CONSTBUFFER_DecRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_header_pool_deinit();
+}
+
+/*Tests_SRS_CONSTBUFFER_11_009: [ If the shard has a cached header then the header shall be taken from the shard by calling interlocked_exchange_pointer with NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_130: [ Before using the header pool, the creates and destroys shall increment the count of users of the shard by calling interlocked_increment and read the header pool again. ]*/
+/*Tests_SRS_CONSTBUFFER_11_131: [ The creates and destroys shall decrement the count of users of the shard by calling interlocked_decrement when they no longer use the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_with_header_pool_reuses_a_cached_header)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    CONSTBUFFER_HANDLE cached = CONSTBUFFER_CreateWithMoveMemory(NULL, 0);
+    ASSERT_IS_NOT_NULL(cached);
+    CONSTBUFFER_DecRef(cached);
+    unsigned char* test_buffer = (unsigned char*)my_gballoc_malloc(2);
+    test_buffer[0] = 42;
+    test_buffer[1] = 43;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(test_buffer, 2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, cached, handle);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(handle);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffer, content->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+    CONSTBUFFER_header_pool_deinit();
+}
+
+/*Tests_SRS_CONSTBUFFER_11_009: [ If the shard has a cached header then the header shall be taken from the shard by calling interlocked_exchange_pointer with NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_013: [ If the header pool is initialized then CONSTBUFFER_DecRef shall return the headers of buffers created by CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_with_header_pool_reuses_a_cached_header)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    unsigned char test_buffer[] = { 42, 43 };
+    CONSTBUFFER_HANDLE cached = CONSTBUFFER_CreateWithCustomFree(test_buffer, sizeof(test_buffer), test_free_func, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(cached);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+    CONSTBUFFER_DecRef(cached);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(test_buffer, sizeof(test_buffer), test_free_func, (void*)0x4343);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, cached, handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4343));
+    CONSTBUFFER_DecRef(handle);
+    CONSTBUFFER_header_pool_deinit();
+}
 
-        ///act
-        result = CONSTBUFFER_get_serialization_size(toobig_h);
+/*Tests_SRS_CONSTBUFFER_11_009: [ If the shard has a cached header then the header shall be taken from the shard by calling interlocked_exchange_pointer with NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_013: [ If the header pool is initialized then CONSTBUFFER_DecRef shall return the headers of buffers created by CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_header_pool_reuses_a_cached_header)
+{
+    ///arrange
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    const char source[] = "source";
+    CONSTBUFFER_HANDLE origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
+    ASSERT_IS_NOT_NULL(origin);
+    CONSTBUFFER_HANDLE cached = CONSTBUFFER_CreateFromOffsetAndSize(origin, 1, 2);
+    ASSERT_IS_NOT_NULL(cached);
+    umock_c_reset_all_calls();
 
-        ///assert
-        ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, result);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    CONSTBUFFER_DecRef(cached);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        ///clean
-        CONSTBUFFER_DecRef(toobig_h);
-    }
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSize(origin, 2, 3);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, cached, handle);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(handle);
+    ASSERT_ARE_EQUAL(uint32_t, 3, content->size);
+    ASSERT_IS_TRUE(memcmp(content->buffer, source + 2, 3) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+    CONSTBUFFER_DecRef(origin);
+    CONSTBUFFER_header_pool_deinit();
 }
 
-/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-/*Tests_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
-TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_0_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_013: [ If the header pool is initialized then CONSTBUFFER_DecRef shall return the headers of buffers created by CONSTBUFFER_CreateWithMoveMemory, CONSTBUFFER_CreateWithCustomFree and CONSTBUFFER_CreateFromOffsetAndSize to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_with_header_pool_frees_the_header_of_CONSTBUFFER_Create)
 {
     ///arrange
-    
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
-    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(NULL, 0);
-    ASSERT_IS_NOT_NULL(smallest);
-    uint32_t result;
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    const char source[] = "source";
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(handle));
 
     ///act
-    result = CONSTBUFFER_get_serialization_size(smallest);
+    CONSTBUFFER_DecRef(handle);
 
     ///assert
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(smallest);
-    
+    CONSTBUFFER_header_pool_deinit();
 }
 
-/*Tests_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-/*Tests_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
-TEST_FUNCTION(CONSTBUFFER_get_serialization_size_with_2_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_010: [ Otherwise the header shall be allocated by calling malloc. ]*/
+/*Tests_SRS_CONSTBUFFER_11_012: [ Otherwise the header shall be freed by calling free. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_with_header_pool_frees_the_header_when_the_shard_is_full)
 {
     ///arrange
-    unsigned char source[2] = { 1,2 };
+    CONSTBUFFER_HANDLE handles[17]; /*1 more than a shard can cache*/
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
-    CONSTBUFFER_HANDLE smallest = CONSTBUFFER_Create(source, sizeof(source));
-    ASSERT_IS_NOT_NULL(smallest);
-    uint32_t result;
+    for (uint32_t i = 0; i < sizeof(handles) / sizeof(handles[0]); i++)
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    }
+    for (uint32_t i = 0; i < sizeof(handles) / sizeof(handles[0]); i++)
+    {
+        handles[i] = CONSTBUFFER_CreateWithMoveMemory(NULL, 0);
+        ASSERT_IS_NOT_NULL(handles[i]);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    for (uint32_t i = 0; i < sizeof(handles) / sizeof(handles[0]) - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(free(NULL));
+    }
+    STRICT_EXPECTED_CALL(free(NULL));
+    STRICT_EXPECTED_CALL(free(handles[sizeof(handles) / sizeof(handles[0]) - 1]));
 
     ///act
-    result = CONSTBUFFER_get_serialization_size(smallest);
+    for (uint32_t i = 0; i < sizeof(handles) / sizeof(handles[0]); i++)
+    {
+        CONSTBUFFER_DecRef(handles[i]);
+    }
 
     ///assert
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(source), result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(smallest);
-
+    CONSTBUFFER_header_pool_deinit();
 }
 
-/* CONSTBUFFER_to_buffer */
+/* CONSTBUFFER_LARGE */
 
-/*Tests_SRS_CONSTBUFFER_02_044: [ If source is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_source_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_074: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_Create_with_source_NULL_and_size_not_0_fails)
 {
     ///arrange
-    uint32_t size;
-    unsigned char* result;
 
     ///act
-    result = CONSTBUFFER_to_buffer(NULL, my_gballoc_malloc_with_context, NULL, &size);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(NULL, 1);
 
     ///assert
-    ASSERT_IS_NULL(result);
+    ASSERT_IS_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_045: [ If serialized_size is NULL then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_075: [ CONSTBUFFER_LARGE_Create shall allocate memory for the handle, its CONSTBUFFER_LARGE and size bytes of content in a single allocation. ]*/
+/*Tests_SRS_CONSTBUFFER_11_076: [ CONSTBUFFER_LARGE_Create shall copy the size bytes of source in the allocated content, set the ref count of the handle to 1 and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_Create_succeeds)
 {
     ///arrange
-    unsigned char s[] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
-    ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
+    const unsigned char source[] = { 0x42, 0x43 };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE) + sizeof(source), 1));
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, my_gballoc_malloc_with_context, NULL, NULL);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
 
     ///assert
-    ASSERT_IS_NULL(result);
+    ASSERT_IS_NOT_NULL(handle);
+    const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_GetContent(handle);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(source), content->size);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, source, content->buffer);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, content->buffer, sizeof(source)));
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_exceeding_UINT32_MAX_fails)
+/*Tests_SRS_CONSTBUFFER_11_077: [ If size is 0 then CONSTBUFFER_LARGE_Create shall set the buffer of the content to NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_Create_with_size_0_succeeds)
 {
     ///arrange
-    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
-    unsigned char* toobig = my_gballoc_malloc(almost4GB);
-    if (toobig == NULL)
-    {
-        /*do nothing, let the test pass - not a fault in this module*/
-    }
-    else
-    {
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
-        ASSERT_IS_NOT_NULL(toobig_h);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1));
 
-        ///arrange
-        uint32_t serialized_size;
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(NULL, 0);
 
-        ///act
-        unsigned char* result;
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(uint64_t, 0, CONSTBUFFER_LARGE_GetContent(handle)->size);
+    ASSERT_IS_NULL(CONSTBUFFER_LARGE_GetContent(handle)->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        ///act
-        result = CONSTBUFFER_to_buffer(toobig_h, NULL, NULL, &serialized_size);
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
+}
 
-        ///assert
-        ASSERT_IS_NULL(result);
+/*Tests_SRS_CONSTBUFFER_11_078: [ If there are any failures then CONSTBUFFER_LARGE_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_LARGE_Create_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
 
-        ///clean
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE) + sizeof(source), 1))
+        .SetReturn(NULL);
 
-        CONSTBUFFER_DecRef(toobig_h);
-    }
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
-/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
-/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_1_with_malloc_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_079: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_CreateWithMoveMemory shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateWithMoveMemory_with_source_NULL_and_size_not_0_fails)
 {
     ///arrange
-    unsigned char s[] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG,sizeof(s), 1));
-    
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithMoveMemory(NULL, 1);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_080: [ CONSTBUFFER_LARGE_CreateWithMoveMemory shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+/*Tests_SRS_CONSTBUFFER_11_081: [ CONSTBUFFER_LARGE_CreateWithMoveMemory shall store source and size, take the ownership of source (it is freed with free when the handle is destroyed), set the ref count of the handle to 1 and return it. ]*/
+/*Tests_SRS_CONSTBUFFER_11_103: [ Otherwise CONSTBUFFER_LARGE_DecRef shall decrement the reference count and when it reaches 0 free the resources the same way CONSTBUFFER_DecRef does. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateWithMoveMemory_succeeds)
+{
+    ///arrange
+    unsigned char* source = (unsigned char*)my_gballoc_malloc(2);
     ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
-    uint32_t size;
 
-    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t)+sizeof(uint32_t) + sizeof(uint8_t))); /*we only serialize a CONSTBUFFER of 1 character*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1));
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, NULL, NULL, &size);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithMoveMemory(source, 2);
 
     ///assert
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(uint64_t, 2, CONSTBUFFER_LARGE_GetContent(handle)->size);
+    ASSERT_ARE_EQUAL(void_ptr, source, CONSTBUFFER_LARGE_GetContent(handle)->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*version*/
-    uint8_t version_from_serialization;
-    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(handle));
+    CONSTBUFFER_LARGE_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    /*size*/
-    uint32_t size_from_serialization;
-    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+/*Tests_SRS_CONSTBUFFER_11_082: [ If there are any failures then CONSTBUFFER_LARGE_CreateWithMoveMemory shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_LARGE_CreateWithMoveMemory_fails)
+{
+    ///arrange
+    unsigned char* source = (unsigned char*)my_gballoc_malloc(2);
+    ASSERT_IS_NOT_NULL(source);
 
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithMoveMemory(source, 2);
 
+    ///assert
+    ASSERT_IS_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
-    free(result);
+    my_gballoc_free(source);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
-/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
-/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_0_with_malloc_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_083: [ If source is NULL and size is different than 0 then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateWithCustomFree_with_source_NULL_and_size_not_0_fails)
 {
     ///arrange
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
-    ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
-    uint32_t size;
 
-    STRICT_EXPECTED_CALL(malloc(sizeof(uint8_t) + sizeof(uint32_t))); /*we only serialize an empty CONSTBUFFER*/
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree(NULL, 1, test_free_func, (void*)0x4242);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_084: [ If customFreeFunc is NULL then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateWithCustomFree_with_customFreeFunc_NULL_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, NULL, NULL, &size);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), NULL, (void*)0x4242);
 
     ///assert
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), size);
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    /*version*/
-    uint8_t version_from_serialization;
-    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+/*Tests_SRS_CONSTBUFFER_11_085: [ CONSTBUFFER_LARGE_CreateWithCustomFree shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+/*Tests_SRS_CONSTBUFFER_11_086: [ CONSTBUFFER_LARGE_CreateWithCustomFree shall store source, size, customFreeFunc and customFreeFuncContext (customFreeFunc is called with customFreeFuncContext when the handle is destroyed), set the ref count of the handle to 1 and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateWithCustomFree_succeeds)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
 
-    /*size*/
-    uint32_t size_from_serialization;
-    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
-    ASSERT_ARE_EQUAL(uint32_t, 0, size_from_serialization);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1));
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, (void*)0x4242);
 
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(source), CONSTBUFFER_LARGE_GetContent(handle)->size);
+    ASSERT_ARE_EQUAL(void_ptr, source, CONSTBUFFER_LARGE_GetContent(handle)->buffer);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///clean
-    CONSTBUFFER_DecRef(source);
-    free(result);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+    STRICT_EXPECTED_CALL(free(handle));
+    CONSTBUFFER_LARGE_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
-/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
-/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_1_with_custom_alloc_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_087: [ If there are any failures then CONSTBUFFER_LARGE_CreateWithCustomFree shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_LARGE_CreateWithCustomFree_fails)
 {
     ///arrange
-    unsigned char s[] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
-    ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
-    uint32_t size;
+    const unsigned char source[] = { 0x42, 0x43 };
 
-    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 1 character*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1))
+        .SetReturn(NULL);
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, (void*)0x4242);
 
     ///assert
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), size);
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    /*version*/
-    uint8_t version_from_serialization;
-    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+/*Tests_SRS_CONSTBUFFER_11_088: [ If handle is NULL then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateFromOffsetAndSize_with_handle_NULL_fails)
+{
+    ///arrange
 
-    /*size*/
-    uint32_t size_from_serialization;
-    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(NULL, 0, 0);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_089: [ If offset is greater than the size of handle then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateFromOffsetAndSize_with_offset_greater_than_size_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(origin, sizeof(source) + 1, 0);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(origin);
+}
 
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+/*Tests_SRS_CONSTBUFFER_11_090: [ If offset + size exceed the size of handle then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateFromOffsetAndSize_with_offset_plus_size_overflowing_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
 
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle_1 = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(origin, 1, sizeof(source));
+    CONSTBUFFER_LARGE_HANDLE handle_2 = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(origin, 1, UINT64_MAX);
+
+    ///assert
+    ASSERT_IS_NULL(handle_1);
+    ASSERT_IS_NULL(handle_2);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
-    free(result);
+    CONSTBUFFER_LARGE_DecRef(origin);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_046: [ If alloc is NULL then CONSTBUFFER_to_buffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
-/*Tests_SRS_CONSTBUFFER_02_049: [ CONSTBUFFER_to_buffer shall allocate memory using alloc for holding the complete serialization. ]*/
-/*Tests_SRS_CONSTBUFFER_02_050: [ CONSTBUFFER_to_buffer shall write at offset 0 of the allocated memory the version of the serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_051: [ CONSTBUFFER_to_buffer shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_052: [ CONSTBUFFER_to_buffer shall write starting at offset 5 of the allocated memory the bytes of source->alias.buffer. ]*/
-/*Tests_SRS_CONSTBUFFER_02_053: [ CONSTBUFFER_to_buffer shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_2_with_custom_alloc_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_091: [ CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall allocate memory for the handle and its CONSTBUFFER_LARGE. ]*/
+/*Tests_SRS_CONSTBUFFER_11_092: [ CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall set the content to the size bytes of handle starting at offset, keep alive the original handle the same way CONSTBUFFER_CreateFromOffsetAndSize does, set the ref count of the new handle to 1 and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_CreateFromOffsetAndSize_of_a_slice_keeps_alive_the_original_handle)
 {
     ///arrange
-    unsigned char s[] = { 1, 2 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
-    ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
-    uint32_t size;
+    const unsigned char source[] = { 0x40, 0x41, 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(origin);
+    CONSTBUFFER_LARGE_HANDLE slice = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(origin, 1, 3);
+    ASSERT_IS_NOT_NULL(slice);
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), TEST_ALLOC_CONTEXT)); /*we only serialize a CONSTBUFFER of 2 characters*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1));
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(slice, 1, 2);
 
     ///assert
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), size);
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(uint64_t, 2, CONSTBUFFER_LARGE_GetContent(handle)->size);
+    ASSERT_ARE_EQUAL(void_ptr, source + 2, CONSTBUFFER_LARGE_GetContent(handle)->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*version*/
-    uint8_t version_from_serialization;
-    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, version_from_serialization);
+    /*the new handle keeps origin alive, not slice*/
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(slice));
+    CONSTBUFFER_LARGE_DecRef(origin);
+    CONSTBUFFER_LARGE_DecRef(slice);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*size*/
-    uint32_t size_from_serialization;
-    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+    STRICT_EXPECTED_CALL(free(origin));
+    STRICT_EXPECTED_CALL(free(handle));
+    CONSTBUFFER_LARGE_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_CONTENT_OFFSET, sizeof(s)) == 0);
+/*Tests_SRS_CONSTBUFFER_11_093: [ If there are any failures then CONSTBUFFER_LARGE_CreateFromOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_LARGE_CreateFromOffsetAndSize_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(origin, 0, 1);
 
+    ///assert
+    ASSERT_IS_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
-    free(result);
+    CONSTBUFFER_LARGE_DecRef(origin);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_054: [ If there are any failures then CONSTBUFFER_to_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_buffer_with_size_2_with_custom_alloc_unhappy_path)
+/*Tests_SRS_CONSTBUFFER_11_094: [ If handle is NULL then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromLargeOffsetAndSize_with_handle_NULL_fails)
 {
     ///arrange
-    unsigned char s[] = { 1, 2 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
-    ASSERT_IS_NOT_NULL(source);
-    unsigned char* result;
-    uint32_t size;
 
-    STRICT_EXPECTED_CALL(test_alloc(sizeof(uint8_t) + sizeof(uint32_t) + 2 * sizeof(uint8_t), TEST_ALLOC_CONTEXT)) /*we only serialize a CONSTBUFFER of 2 characters*/
-        .SetReturn(NULL);
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromLargeOffsetAndSize(NULL, 0, 0);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_095: [ If offset is greater than the size of handle then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_11_096: [ If offset + size exceed the size of handle then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromLargeOffsetAndSize_with_invalid_offset_and_size_fails)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_to_buffer(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+    CONSTBUFFER_HANDLE handle_1 = CONSTBUFFER_CreateFromLargeOffsetAndSize(origin, sizeof(source) + 1, 0);
+    CONSTBUFFER_HANDLE handle_2 = CONSTBUFFER_CreateFromLargeOffsetAndSize(origin, 1, sizeof(source));
 
     ///assert
-    ASSERT_IS_NULL(result);
+    ASSERT_IS_NULL(handle_1);
+    ASSERT_IS_NULL(handle_2);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(origin);
 }
 
-/* CONSTBUFFER_to_fixed_size_buffer */
-
-/*Tests_SRS_CONSTBUFFER_02_055: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_source_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_097: [ CONSTBUFFER_CreateFromLargeOffsetAndSize shall allocate the header of a CONSTBUFFER_HANDLE the same way CONSTBUFFER_CreateFromOffsetAndSize does. ]*/
+/*Tests_SRS_CONSTBUFFER_11_098: [ CONSTBUFFER_CreateFromLargeOffsetAndSize shall set the content to the size bytes of handle starting at offset, keep alive the original handle the same way CONSTBUFFER_CreateFromOffsetAndSize does, set the ref count of the new handle to 1 and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromLargeOffsetAndSize_succeeds)
 {
     ///arrange
-    unsigned char destination[100];
-    uint32_t size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    const unsigned char source[] = { 0x40, 0x41, 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, (void*)0x4242);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(NULL, destination, sizeof(destination), &size);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromLargeOffsetAndSize(origin, 1, 2);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(uint32_t, 2, CONSTBUFFER_GetContent(handle)->size);
+    ASSERT_ARE_EQUAL(void_ptr, source + 1, CONSTBUFFER_GetContent(handle)->buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*handle keeps origin alive*/
+    umock_c_reset_all_calls();
+    CONSTBUFFER_LARGE_DecRef(origin);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+    STRICT_EXPECTED_CALL(free(origin));
+    STRICT_EXPECTED_CALL(free(handle));
+    CONSTBUFFER_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_056: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_destination_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_099: [ If there are any failures then CONSTBUFFER_CreateFromLargeOffsetAndSize shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_CONSTBUFFER_CreateFromLargeOffsetAndSize_fails)
 {
     ///arrange
-    unsigned char source_bytes[1] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
-    ASSERT_IS_NOT_NULL(source);
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE origin = CONSTBUFFER_LARGE_CreateWithCustomFree(source, sizeof(source), test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(origin);
+    umock_c_reset_all_calls();
 
-    uint32_t size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, NULL, 0, &size);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromLargeOffsetAndSize(origin, 0, 1);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(origin);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_057: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_with_serialized_size_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_100: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_IncRef shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_IncRef_with_NULL_returns)
 {
     ///arrange
-    unsigned char source_bytes[1] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
-    ASSERT_IS_NOT_NULL(source);
 
-    unsigned char destination[100];
+    ///act
+    CONSTBUFFER_LARGE_IncRef(NULL);
 
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_11_101: [ Otherwise CONSTBUFFER_LARGE_IncRef shall increment the reference count. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_IncRef_increments_the_reference_count)
+{
+    ///arrange
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), NULL);
+    CONSTBUFFER_LARGE_IncRef(handle);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
+    CONSTBUFFER_LARGE_DecRef(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_074: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_when_serialized_size_overflows_fails)
+/*Tests_SRS_CONSTBUFFER_11_102: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_DecRef shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_DecRef_with_NULL_returns)
 {
     ///arrange
-    uint32_t almost4GB = UINT32_MAX - 4; /*this is 4 bytes shy of 4GB. Serialization_size is UINT32_MAX + 1 for almost4GB, which cannot be represented as a uint32_t type*/
-    unsigned char* toobig = my_gballoc_malloc(almost4GB);
-    if (toobig == NULL)
-    {
-        /*do nothing, let the test pass - not a fault in this module*/
-    }
-    else
-    {
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-        CONSTBUFFER_HANDLE toobig_h = CONSTBUFFER_CreateWithMoveMemory(toobig, almost4GB);
-        ASSERT_IS_NOT_NULL(toobig_h);
-
-        unsigned char* destination = my_gballoc_malloc(UINT32_MAX);
-        if (destination == NULL)
-        {
-            /*not really a fault of this test, let the test pass*/
-        }
-        else
-        {
-            ///arrange
-            uint32_t serialized_size;
-
-            ///act
-            CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
 
-            ///act
-            result = CONSTBUFFER_to_fixed_size_buffer(toobig_h, destination, UINT32_MAX, &serialized_size);
+    ///act
+    CONSTBUFFER_LARGE_DecRef(NULL);
 
-            ///assert
-            ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, result);
-            
-            ///clean
-            my_gballoc_free(destination);
-        }
-        CONSTBUFFER_DecRef(toobig_h);
-    }
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_058: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_that_would_overflow_destination_fails)
+/*Tests_SRS_CONSTBUFFER_11_154: [ CONSTBUFFER_LARGE_DecRef shall free the header of the handle by calling free, it shall never return it to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_DecRef_with_header_pool_frees_the_header_of_CONSTBUFFER_LARGE_CreateWithMoveMemory)
 {
     ///arrange
-    unsigned char source_bytes[1] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    unsigned char* source = (unsigned char*)my_gballoc_malloc(2);
     ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithMoveMemory(source, 2);
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
 
-    unsigned char destination[5]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
-    uint32_t serialized_size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(handle));
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+    CONSTBUFFER_LARGE_DecRef(handle);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER, result);
-    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_header_pool_deinit();
 }
 
-/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
-/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_1) /*in this case, the size of the buffer matches perfectly the serialization size*/
+/*Tests_SRS_CONSTBUFFER_11_154: [ CONSTBUFFER_LARGE_DecRef shall free the header of the handle by calling free, it shall never return it to the header pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_DecRef_with_header_pool_frees_the_headers_of_CONSTBUFFER_LARGE_CreateFromOffsetAndSize_and_its_original)
 {
     ///arrange
-    unsigned char source_bytes[1] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
-    ASSERT_IS_NOT_NULL(source);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_header_pool_init());
+    CONSTBUFFER_LARGE_HANDLE original = CONSTBUFFER_LARGE_CreateWithCustomFree((const unsigned char*)0x42, (uint64_t)UINT32_MAX + 1, test_free_func, (void*)0x4242); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(original);
+    CONSTBUFFER_LARGE_HANDLE slice = CONSTBUFFER_LARGE_CreateFromOffsetAndSize(original, 1, UINT32_MAX);
+    ASSERT_IS_NOT_NULL(slice);
+    CONSTBUFFER_LARGE_DecRef(original);
+    umock_c_reset_all_calls();
 
-    unsigned char destination[6]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
-    uint32_t serialized_size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+    STRICT_EXPECTED_CALL(free(original));
+    STRICT_EXPECTED_CALL(free(slice));
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+    CONSTBUFFER_LARGE_DecRef(slice);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
-    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
-
-    /*version*/
-    uint8_t serialized_version;
-    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
-
-    /*size*/
-    uint32_t size;
-    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
-    ASSERT_ARE_EQUAL(uint32_t, 1, size);
-
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_header_pool_deinit();
 }
 
-/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
-/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_2) /*in this case, the size of the buffer exceeds the serialization size*/
+/*Tests_SRS_CONSTBUFFER_11_104: [ If constbufferHandle is NULL then CONSTBUFFER_LARGE_GetContent shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_GetContent_with_NULL_fails)
 {
     ///arrange
-    unsigned char source_bytes[1] = { 1 };
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
-    ASSERT_IS_NOT_NULL(source);
-
-    unsigned char destination[7]; /*the above CONSTBUFFER_HANDLE requires 6 bytes...*/
-    uint32_t serialized_size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+    const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_GetContent(NULL);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
-    ASSERT_ARE_EQUAL(uint32_t, 6, serialized_size);
+    ASSERT_IS_NULL(content);
+}
 
-    /*version*/
-    uint8_t serialized_version;
-    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
+/*Tests_SRS_CONSTBUFFER_11_105: [ Otherwise CONSTBUFFER_LARGE_GetContent shall return the buffer and the 64 bit size of the content of constbufferHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_GetContent_returns_a_size_above_UINT32_MAX)
+{
+    ///arrange
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree((const unsigned char*)0x42, (uint64_t)UINT32_MAX + 1, test_free_func, NULL); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
 
-    /*size*/
-    uint32_t size;
-    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
-    ASSERT_ARE_EQUAL(uint32_t, 1, size);
+    ///act
+    const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_GetContent(handle);
 
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)UINT32_MAX + 1, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, (const unsigned char*)0x42, content->buffer);
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(handle);
+}
+
+/*Tests_SRS_CONSTBUFFER_11_106: [ If source is NULL then CONSTBUFFER_LARGE_get_serialization_size shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_get_serialization_size_with_source_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    uint64_t result = CONSTBUFFER_LARGE_get_serialization_size(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 0, result);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_059: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (currently 1). ]*/
-/*Tests_SRS_CONSTBUFFER_02_060: [ CONSTBUFFER_to_fixed_size_buffer shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
-/*Tests_SRS_CONSTBUFFER_02_061: [ CONSTBUFFER_to_fixed_size_buffer shall copy all the bytes of source->alias.buffer in destination starting at offset 5. ]*/
-/*Tests_SRS_CONSTBUFFER_02_062: [ CONSTBUFFER_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_3) /*in this case, an empty constbuffer_handle is serialized*/
+/*Tests_SRS_CONSTBUFFER_11_107: [ If sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + source's size exceed UINT64_MAX then CONSTBUFFER_LARGE_get_serialization_size shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_get_serialization_size_with_overflow_fails)
 {
     ///arrange
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
-    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
-    ASSERT_IS_NOT_NULL(source);
-
-    unsigned char destination[7]; /*the above CONSTBUFFER_HANDLE requires 5 bytes...*/
-    uint32_t serialized_size;
-    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree((const unsigned char*)0x42, UINT64_MAX - CONSTBUFFER_V3_CONTENT_OFFSET + 1, test_free_func, NULL); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(handle);
 
     ///act
-    result = CONSTBUFFER_to_fixed_size_buffer(source, destination, sizeof(destination), &serialized_size);
+    uint64_t result = CONSTBUFFER_LARGE_get_serialization_size(handle);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
-    ASSERT_ARE_EQUAL(uint32_t, 5, serialized_size);
+    ASSERT_ARE_EQUAL(uint64_t, 0, result);
 
-    /*version*/
-    uint8_t serialized_version;
-    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
-    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V1, serialized_version);
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
+}
 
-    /*size*/
-    uint32_t size;
-    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
-    ASSERT_ARE_EQUAL(uint32_t, 0, size);
+/*Tests_SRS_CONSTBUFFER_11_108: [ Otherwise CONSTBUFFER_LARGE_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_get_serialization_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree((const unsigned char*)0x42, (uint64_t)UINT32_MAX + 1, test_free_func, NULL); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(handle);
 
-    /*content*/
-    /*doesn't have*/
+    ///act
+    uint64_t result = CONSTBUFFER_LARGE_get_serialization_size(handle);
 
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + (uint64_t)UINT32_MAX + 1, result);
 
     ///clean
-    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/* CONSTBUFFER_from_buffer */
-
-/*Tests_SRS_CONSTBUFFER_02_063: [ If source is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_source_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_109: [ If source is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_to_fixed_size_buffer_with_source_NULL_fails)
 {
     ///arrange
-    uint32_t consumed;
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    unsigned char destination[CONSTBUFFER_V3_CONTENT_OFFSET];
+    uint64_t serialized_size;
 
     ///act
-    result = CONSTBUFFER_from_buffer(NULL, 6, &consumed, &destination);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result = CONSTBUFFER_LARGE_to_fixed_size_buffer(NULL, destination, sizeof(destination), &serialized_size);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_064: [ If consumed is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_consumed_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_110: [ If destination is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_11_111: [ If serialized_size is NULL then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_to_fixed_size_buffer_with_destination_NULL_or_serialized_size_NULL_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    unsigned char source[10] = { 0 };
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(handle);
+    unsigned char destination[CONSTBUFFER_V3_CONTENT_OFFSET + sizeof(source)];
+    uint64_t serialized_size;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 6, NULL, &destination);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result_1 = CONSTBUFFER_LARGE_to_fixed_size_buffer(handle, NULL, sizeof(destination), &serialized_size);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result_2 = CONSTBUFFER_LARGE_to_fixed_size_buffer(handle, destination, sizeof(destination), NULL);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result_2);
+
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_065: [ If destination is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_destination_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_11_112: [ If the size of the serialization exceeds UINT64_MAX then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_to_fixed_size_buffer_with_overflow_fails)
 {
     ///arrange
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 };
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_CreateWithCustomFree((const unsigned char*)0x42, UINT64_MAX - CONSTBUFFER_V3_CONTENT_OFFSET + 1, test_free_func, NULL); /*the content is never read*/
+    ASSERT_IS_NOT_NULL(handle);
+    unsigned char destination[CONSTBUFFER_V3_CONTENT_OFFSET];
+    uint64_t serialized_size;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 6, &consumed, NULL);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result = CONSTBUFFER_LARGE_to_fixed_size_buffer(handle, destination, UINT64_MAX, &serialized_size);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, result);
+
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_size_0_fails)
+/*Tests_SRS_CONSTBUFFER_11_113: [ If the size of the serialization exceeds destination_size then CONSTBUFFER_LARGE_to_fixed_size_buffer shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_to_fixed_size_buffer_with_insufficient_destination_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 };
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(handle);
+    unsigned char destination[CONSTBUFFER_V3_CONTENT_OFFSET + sizeof(source)];
+    uint64_t serialized_size;
+    umock_c_reset_all_calls();
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 0, &consumed, &destination);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result = CONSTBUFFER_LARGE_to_fixed_size_buffer(handle, destination, sizeof(destination) - 1, &serialized_size);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER, result);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(destination), serialized_size);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 (current version) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_version_0_fails)
+/*Tests_SRS_CONSTBUFFER_11_114: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offset 0 of destination the version of serialization (3). ]*/
+/*Tests_SRS_CONSTBUFFER_11_115: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offsets 1-8 of destination the size of the content of source in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_116: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall write at offsets 9-12 of destination the CRC32C of the content of source, computed by calling crc32c_update, in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_11_117: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall copy the content of source in destination starting at offset 13. ]*/
+/*Tests_SRS_CONSTBUFFER_11_118: [ CONSTBUFFER_LARGE_to_fixed_size_buffer shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_to_fixed_size_buffer_succeeds)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 }; /*note first byte to be 0*/
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE handle = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(handle);
+    unsigned char destination[CONSTBUFFER_V3_CONTENT_OFFSET + sizeof(source)];
+    uint64_t serialized_size;
+    umock_c_reset_all_calls();
+
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result = CONSTBUFFER_LARGE_to_fixed_size_buffer(handle, destination, sizeof(destination), &serialized_size);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(destination), serialized_size);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V3, destination[0]);
+    ASSERT_ARE_EQUAL(uint8_t, sizeof(source), destination[8]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, destination + CONSTBUFFER_V3_CONTENT_OFFSET, sizeof(source)));
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_LARGE_DecRef(handle);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_insufficient_bytes_fails_1) /*in this case there are not enough bytes for version and size*/
+/*Tests_SRS_CONSTBUFFER_11_119: [ If parent is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_parent_NULL_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 1 }; /*note first byte to be 1, rest are 0*/
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(uint8_t) + sizeof(uint32_t) - 1, &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(NULL, 0, &consumed, &destination);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_0_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_120: [ If consumed is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_11_121: [ If destination is NULL then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_11_122: [ If offset is greater than or equal to the size of parent then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_invalid_args_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = { 
-        1, /*version*/
-        0,0,0,0 /*size = 0*/
-    };
-
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET] = { CONSTBUFFER_VERSION_V3 };
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_1 = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, NULL, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_2 = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, NULL);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_3 = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, sizeof(source), &consumed, &destination);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
-    ASSERT_IS_NOT_NULL(destination);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), consumed);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_2);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_3);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*size*/
-    const CONSTBUFFER* content= CONSTBUFFER_GetContent(destination);
-    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
-
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_0_size_from_bigger_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_123: [ If there are less than sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) bytes in parent after offset then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_truncated_header_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,0, /*size = 0*/
-        8 /*extra byte*/
-    };
-
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET - 1] = { CONSTBUFFER_VERSION_V3 };
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, &destination);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
-    ASSERT_IS_NOT_NULL(destination);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t), consumed);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*size*/
-    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
-    ASSERT_ARE_EQUAL(uint32_t, 0, content->size);
-
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_070: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_from_insufficient_buffer_fails)
+/*Tests_SRS_CONSTBUFFER_11_124: [ If the byte at offset in parent is not 3 then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_version_2_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,1 /*size = 1*/
-    };
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET] = { CONSTBUFFER_VERSION_V2 };
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
+
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, &destination);
 
     ///assert
     ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_125: [ If the size read from offset + 1 in parent exceeds the bytes that follow the header then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_truncated_content_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,1,/*size = 1*/
-        0x42
-    };
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET + 1] = { CONSTBUFFER_VERSION_V3 };
+    write_uint64_t(source + CONSTBUFFER_SIZE_OFFSET, 2);
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, 1));
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, &destination);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
-    ASSERT_IS_NOT_NULL(destination);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*size*/
-    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
-    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
-
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size)==0);
-
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_1_size_from_greater_size_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_126: [ If the CRC32C of the content (computed by calling crc32c_update) is different than the CRC32C read from offset + 9 in parent then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_with_corrupted_content_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,1,/*size = 1*/
-        0x42, 0x43 /*0x43 is extraneous*/
-    };
-
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, 1));
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET + 2] = { CONSTBUFFER_VERSION_V3 };
+    write_uint64_t(source + CONSTBUFFER_SIZE_OFFSET, 2);
+    source[CONSTBUFFER_V3_CONTENT_OFFSET] = 0x42;
+    source[CONSTBUFFER_V3_CONTENT_OFFSET + 1] = 0x43;
+    write_uint32_t(source + CONSTBUFFER_V3_CRC32C_OFFSET, crc32c_update(0, source + CONSTBUFFER_V3_CONTENT_OFFSET, 2));
+    source[CONSTBUFFER_V3_CONTENT_OFFSET] ^= 0x80; /*a single flipped bit*/
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, &destination);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
-    ASSERT_IS_NOT_NULL(destination);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t), consumed);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    /*size*/
-    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
-    ASSERT_ARE_EQUAL(uint32_t, 1, content->size);
-
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size)==0);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
 
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_069: [ CONSTBUFFER_from_buffer shall read the number of serialized content bytes from offset 1 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
-/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_2_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_11_127: [ CONSTBUFFER_LARGE_from_buffer_no_copy shall create the CONSTBUFFER_LARGE_HANDLE by calling CONSTBUFFER_LARGE_CreateFromOffsetAndSize with parent, offset + 13 and the number of content bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_11_129: [ CONSTBUFFER_LARGE_from_buffer_no_copy shall succeed, write in consumed the total number of consumed bytes from parent starting at offset, write in destination the constructed CONSTBUFFER_LARGE_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_LARGE_from_buffer_no_copy_reads_what_CONSTBUFFER_LARGE_to_fixed_size_buffer_wrote)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,2,/*size = 2*/
-        0x42, 0x43
-    };
+    const unsigned char source[] = { 0x42, 0x43 };
+    CONSTBUFFER_LARGE_HANDLE original = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(original);
+    unsigned char serialization[1 + CONSTBUFFER_V3_CONTENT_OFFSET + sizeof(source)]; /*1 byte of something else in front*/
+    uint64_t serialized_size;
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, CONSTBUFFER_LARGE_to_fixed_size_buffer(original, serialization + 1, sizeof(serialization) - 1, &serialized_size));
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(serialization, sizeof(serialization));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, 1));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1)); /*only the header, the content is not copied*/
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 1, &consumed, &destination);
 
     ///assert
     ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
-    ASSERT_IS_NOT_NULL(destination);
-    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + 2*sizeof(uint8_t), consumed);
+    ASSERT_ARE_EQUAL(uint64_t, serialized_size, consumed);
+    const CONSTBUFFER_LARGE* content = CONSTBUFFER_LARGE_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(source), content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_LARGE_GetContent(parent)->buffer + 1 + CONSTBUFFER_V3_CONTENT_OFFSET, content->buffer);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, content->buffer, sizeof(source)));
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    /*size*/
-    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
-    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
-
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(source + CONSTBUFFER_CONTENT_OFFSET, content->buffer, content->size) == 0);
-
     ///clean
-    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(destination);
+    CONSTBUFFER_LARGE_DecRef(parent);
+    CONSTBUFFER_LARGE_DecRef(original);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_2_size_unhappy_path)
+/*Tests_SRS_CONSTBUFFER_11_128: [ If there are any failures then CONSTBUFFER_LARGE_from_buffer_no_copy shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_LARGE_from_buffer_no_copy_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination = NULL;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[] = {
-        1, /*version*/
-        0,0,0,2,/*size = 2*/
-        0x42, 0x43
-    };
+    unsigned char source[CONSTBUFFER_V3_CONTENT_OFFSET] = { CONSTBUFFER_VERSION_V3 };
+    write_uint32_t(source + CONSTBUFFER_V3_CRC32C_OFFSET, crc32c_update(0, NULL, 0));
+    CONSTBUFFER_LARGE_HANDLE parent = CONSTBUFFER_LARGE_Create(source, sizeof(source));
+    ASSERT_IS_NOT_NULL(parent);
+    CONSTBUFFER_LARGE_HANDLE destination;
+    uint64_t consumed;
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, 1))
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(CONSTBUFFER_LARGE), 1))
         .SetReturn(NULL);
 
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_LARGE_from_buffer_no_copy(parent, 0, &consumed, &destination);
 
     ///assert
     ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
-    ASSERT_IS_NULL(destination);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
+    CONSTBUFFER_LARGE_DecRef(parent);
 }
 
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
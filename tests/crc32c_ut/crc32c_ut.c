@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#include "c_util/crc32c.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+#define TEST_BUFFER_SIZE 1000
+
+static void fill_test_buffer(unsigned char* buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        buffer[i] = (unsigned char)(i * 7 + 3);
+    }
+}
+
+/*computes the CRC one bit at a time, straight from the definition*/
+static uint32_t crc32c_bitwise(const unsigned char* buffer, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= buffer[i];
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+        }
+    }
+    return ~crc;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* crc32c_update */
+
+/*Tests_SRS_CRC32C_11_001: [ If buffer is NULL and size is not 0 then crc32c_update shall fail and return crc. ]*/
+TEST_FUNCTION(crc32c_update_with_buffer_NULL_and_size_1_fails)
+{
+    ///arrange
+
+    ///act
+    uint32_t result = crc32c_update(0x12345678, NULL, 1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x12345678, result);
+}
+
+/*Tests_SRS_CRC32C_11_005: [ crc32c_update shall complement crc before and after processing buffer, so that the CRC of 2 consecutive buffers is crc32c_update(crc32c_update(0, first...), second...). ]*/
+TEST_FUNCTION(crc32c_update_with_0_bytes_returns_crc)
+{
+    ///arrange
+    unsigned char byte = 42;
+
+    ///act
+    uint32_t result_1 = crc32c_update(0, NULL, 0);
+    uint32_t result_2 = crc32c_update(0xE3069283, &byte, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result_1);
+    ASSERT_ARE_EQUAL(uint32_t, 0xE3069283, result_2);
+}
+
+/*Tests_SRS_CRC32C_11_002: [ crc32c_update shall use the CRC32 instructions of the processor (SSE4.2 on x64, the CRC extension on ARM64) when the processor has them. ]*/
+/*Tests_SRS_CRC32C_11_003: [ The hardware CRC shall be computed 8 bytes at a time and the remaining bytes 1 byte at a time. ]*/
+/*Tests_SRS_CRC32C_11_004: [ Otherwise crc32c_update shall compute the CRC 8 bytes at a time with the slicing-by-8 tables and the remaining bytes 1 byte at a time. ]*/
+TEST_FUNCTION(crc32c_update_of_123456789_returns_the_check_value)
+{
+    ///arrange
+    const char* check = "123456789";
+
+    ///act
+    uint32_t result = crc32c_update(0, (const unsigned char*)check, strlen(check));
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0xE3069283, result);
+}
+
+/*Tests_SRS_CRC32C_11_003: [ The hardware CRC shall be computed 8 bytes at a time and the remaining bytes 1 byte at a time. ]*/
+/*Tests_SRS_CRC32C_11_004: [ Otherwise crc32c_update shall compute the CRC 8 bytes at a time with the slicing-by-8 tables and the remaining bytes 1 byte at a time. ]*/
+TEST_FUNCTION(crc32c_update_returns_the_RFC_3720_values)
+{
+    ///arrange
+    unsigned char zeroes[32];
+    unsigned char ones[32];
+    unsigned char increasing[32];
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        zeroes[i] = 0;
+        ones[i] = 0xFF;
+        increasing[i] = (unsigned char)i;
+    }
+
+    ///act
+    uint32_t result_zeroes = crc32c_update(0, zeroes, sizeof(zeroes));
+    uint32_t result_ones = crc32c_update(0, ones, sizeof(ones));
+    uint32_t result_increasing = crc32c_update(0, increasing, sizeof(increasing));
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x8A9136AA, result_zeroes);
+    ASSERT_ARE_EQUAL(uint32_t, 0x62A8AB43, result_ones);
+    ASSERT_ARE_EQUAL(uint32_t, 0x46DD794E, result_increasing);
+}
+
+/*Tests_SRS_CRC32C_11_003: [ The hardware CRC shall be computed 8 bytes at a time and the remaining bytes 1 byte at a time. ]*/
+/*Tests_SRS_CRC32C_11_004: [ Otherwise crc32c_update shall compute the CRC 8 bytes at a time with the slicing-by-8 tables and the remaining bytes 1 byte at a time. ]*/
+TEST_FUNCTION(crc32c_update_matches_the_bitwise_CRC_for_all_sizes_and_alignments)
+{
+    ///arrange
+    unsigned char buffer[8 + 64];
+    fill_test_buffer(buffer, sizeof(buffer));
+
+    for (size_t start = 0; start < 8; start++)
+    {
+        for (size_t size = 0; size <= 64; size++)
+        {
+            ///act
+            uint32_t result = crc32c_update(0, buffer + start, size);
+
+            ///assert
+            ASSERT_ARE_EQUAL(uint32_t, crc32c_bitwise(buffer + start, size), result);
+        }
+    }
+}
+
+/*Tests_SRS_CRC32C_11_005: [ crc32c_update shall complement crc before and after processing buffer, so that the CRC of 2 consecutive buffers is crc32c_update(crc32c_update(0, first...), second...). ]*/
+TEST_FUNCTION(crc32c_update_in_2_pieces_is_the_CRC_of_the_whole_buffer)
+{
+    ///arrange
+    unsigned char buffer[TEST_BUFFER_SIZE];
+    fill_test_buffer(buffer, sizeof(buffer));
+    uint32_t whole = crc32c_update(0, buffer, sizeof(buffer));
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_bitwise(buffer, sizeof(buffer)), whole);
+
+    for (size_t split = 0; split <= sizeof(buffer); split++)
+    {
+        ///act
+        uint32_t result = crc32c_update(crc32c_update(0, buffer, split), buffer + split, sizeof(buffer) - split);
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint32_t, whole, result);
+    }
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
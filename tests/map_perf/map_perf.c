@@ -0,0 +1,668 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/string_utils.h"
+#include "c_pal/timer.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/map.h"
+#include "c_util/rc_string.h"
+#include "c_util/strings.h"
+
+TEST_DEFINE_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_VALUES);
+
+#define N_LOOKUPS 10000 /*number of lookups that are timed for every map size*/
+#define N_SNAPSHOTS 500 /*number of clones that are held at the same time*/
+#define N_SERIALIZATIONS 100 /*number of times the map is serialized to JSON (or to binary)*/
+#define N_LIFETIMES 1000 /*number of times a map is created, filled, iterated and destroyed*/
+#define N_FILLS 100 /*number of times a map is filled with values the caller already holds as THANDLE(RC_STRING)*/
+#define N_BULK_BUILDS 100 /*number of times a map is built from arrays of keys and values*/
+#define LARGE_VALUE_SIZE 4096 /*size of a value the size of a certificate*/
+
+/*the way Map used to find keys before it had a key index: a strcmp scan over keys*/
+static const char* linear_find_value(const char* const* keys, const char* const* values, size_t count, const char* key)
+{
+    const char* result = NULL;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        if (strcmp(keys[i], key) == 0)
+        {
+            result = values[i];
+            break;
+        }
+    }
+    return result;
+}
+
+static char** create_keys(size_t count)
+{
+    char** result = malloc_2(count, sizeof(char*));
+    ASSERT_IS_NOT_NULL(result);
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = sprintf_char("property_%zu", i);
+        ASSERT_IS_NOT_NULL(result[i]);
+    }
+    return result;
+}
+
+static void destroy_keys(char** keys, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        free(keys[i]);
+    }
+    free(keys);
+}
+
+static void measure_lookups(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+    double add_ms = timer_global_get_elapsed_ms() - start;
+
+    const char* const* map_keys;
+    const char* const* map_values;
+    size_t map_count;
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(map, &map_keys, &map_values, &map_count));
+    ASSERT_ARE_EQUAL(size_t, count, map_count);
+
+    ///act
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LOOKUPS; i++)
+    {
+        const char* key = keys[(i * 7919) % count];
+        ASSERT_IS_NOT_NULL(linear_find_value(map_keys, map_values, map_count, key));
+    }
+    double linear_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LOOKUPS; i++)
+    {
+        const char* key = keys[(i * 7919) % count];
+        ASSERT_IS_NOT_NULL(Map_GetValueFromKey(map, key));
+    }
+    double indexed_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    LogInfo("%zu keys: Map_Add took %.3f ms in total. %d lookups took %.3f ms with a linear scan and %.3f ms with Map_GetValueFromKey (%.1f ns vs %.1f ns per lookup)",
+        count, add_ms, N_LOOKUPS, linear_ms, indexed_ms, linear_ms * 1000000 / N_LOOKUPS, indexed_ms * 1000000 / N_LOOKUPS);
+
+    ///cleanup
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+static double build_and_delete(MAP_HANDLE map, char** keys, size_t count)
+{
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+    for (size_t i = 0; i < count; i += 2)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(map, keys[i]));
+    }
+    return timer_global_get_elapsed_ms() - start;
+}
+
+static void measure_build_and_delete(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+    MAP_HANDLE presized_map = Map_CreateWithCapacity(NULL, count);
+    ASSERT_IS_NOT_NULL(presized_map);
+
+    ///act
+    double grown_ms = build_and_delete(map, keys, count);
+    double presized_ms = build_and_delete(presized_map, keys, count);
+
+    ///assert
+    LogInfo("%zu keys: adding all of them and deleting every other one took %.3f ms with Map_Create and %.3f ms with Map_CreateWithCapacity",
+        count, grown_ms, presized_ms);
+
+    ///cleanup
+    Map_Destroy(presized_map);
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+static void measure_contains_value(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    char** values = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+    MAP_HANDLE indexed_map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(indexed_map);
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(indexed_map));
+
+    /*maintenance cost: the same adds and overwrites with and without the value index*/
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], values[i]));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(map, keys[i], values[(i * 7919) % count]));
+    }
+    double plain_build_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(indexed_map, keys[i], values[i]));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(indexed_map, keys[i], values[(i * 7919) % count]));
+    }
+    double indexed_build_ms = timer_global_get_elapsed_ms() - start;
+
+    ///act
+    bool exists;
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LOOKUPS; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(map, values[(i * 7919) % count], &exists));
+        ASSERT_IS_TRUE(exists);
+    }
+    double plain_lookup_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LOOKUPS; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(indexed_map, values[(i * 7919) % count], &exists));
+        ASSERT_IS_TRUE(exists);
+    }
+    double indexed_lookup_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    LogInfo("%zu values: adding and overwriting took %.3f ms without and %.3f ms with the value index. %d Map_ContainsValue calls took %.3f ms without and %.3f ms with the value index",
+        count, plain_build_ms, indexed_build_ms, N_LOOKUPS, plain_lookup_ms, indexed_lookup_ms);
+
+    ///cleanup
+    Map_Destroy(indexed_map);
+    Map_Destroy(map);
+    destroy_keys(values, count);
+    destroy_keys(keys, count);
+}
+
+static void measure_snapshots(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+    MAP_HANDLE* snapshots = malloc_2(N_SNAPSHOTS, sizeof(MAP_HANDLE));
+    ASSERT_IS_NOT_NULL(snapshots);
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SNAPSHOTS; i++)
+    {
+        snapshots[i] = Map_Clone(map);
+        ASSERT_IS_NOT_NULL(snapshots[i]);
+    }
+    double clone_ms = timer_global_get_elapsed_ms() - start;
+
+    /*the first change to the map copies the store, the snapshots keep the old content*/
+    start = timer_global_get_elapsed_ms();
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(map, keys[0], "changed"));
+    double first_write_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(map, keys[1], "changed"));
+    double second_write_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    for (size_t i = 0; i < N_SNAPSHOTS; i++)
+    {
+        ASSERT_ARE_EQUAL(char_ptr, keys[0], Map_GetValueFromKey(snapshots[i], keys[0]));
+    }
+    ASSERT_ARE_EQUAL(char_ptr, "changed", Map_GetValueFromKey(map, keys[0]));
+    LogInfo("%zu keys: %d Map_Clone calls took %.3f ms (%.1f ns per clone). The first Map_AddOrUpdate after cloning took %.3f ms, the second one %.3f ms",
+        count, N_SNAPSHOTS, clone_ms, clone_ms * 1000000 / N_SNAPSHOTS, first_write_ms, second_write_ms);
+
+    ///cleanup
+    for (size_t i = 0; i < N_SNAPSHOTS; i++)
+    {
+        Map_Destroy(snapshots[i]);
+    }
+    free(snapshots);
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+static void measure_to_json(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+    size_t required_size;
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, Map_ToJSONBuffer(map, NULL, 0, &required_size));
+    char* buffer = malloc(required_size);
+    ASSERT_IS_NOT_NULL(buffer);
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        STRING_HANDLE json = Map_ToJSON(map);
+        ASSERT_IS_NOT_NULL(json);
+        STRING_delete(json);
+    }
+    double string_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ToJSONBuffer(map, buffer, required_size, &required_size));
+    }
+    double buffer_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        CONSTBUFFER_HANDLE json = Map_ToJSONConstBuffer(map);
+        ASSERT_IS_NOT_NULL(json);
+        CONSTBUFFER_DecRef(json);
+    }
+    double constbuffer_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    STRING_HANDLE json = Map_ToJSON(map);
+    ASSERT_IS_NOT_NULL(json);
+    ASSERT_ARE_EQUAL(char_ptr, STRING_c_str(json), buffer);
+    LogInfo("%zu keys (%zu bytes of JSON): %d serializations took %.3f ms with Map_ToJSON, %.3f ms with Map_ToJSONBuffer and %.3f ms with Map_ToJSONConstBuffer",
+        count, required_size, N_SERIALIZATIONS, string_ms, buffer_ms, constbuffer_ms);
+
+    ///cleanup
+    STRING_delete(json);
+    free(buffer);
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+static void measure_to_buffer(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    MAP_HANDLE map = Map_Create(NULL);
+    ASSERT_IS_NOT_NULL(map);
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+    const char* const* map_keys;
+    const char* const* map_values;
+    size_t map_count;
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(map, &map_keys, &map_values, &map_count));
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        STRING_HANDLE json = Map_ToJSON(map);
+        ASSERT_IS_NOT_NULL(json);
+        STRING_delete(json);
+    }
+    double json_ms = timer_global_get_elapsed_ms() - start;
+
+    uint32_t serialized_size = 0;
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        unsigned char* serialized = Map_ToBuffer(map, NULL, NULL, &serialized_size);
+        ASSERT_IS_NOT_NULL(serialized);
+        free(serialized);
+    }
+    double to_buffer_ms = timer_global_get_elapsed_ms() - start;
+
+    /*there is no JSON parser, the alternative to Map_FromBuffer is adding the pairs one by one*/
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        MAP_HANDLE copy = Map_Create(NULL);
+        ASSERT_IS_NOT_NULL(copy);
+        for (size_t j = 0; j < map_count; j++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(copy, map_keys[j], map_values[j]));
+        }
+        Map_Destroy(copy);
+    }
+    double add_ms = timer_global_get_elapsed_ms() - start;
+
+    unsigned char* serialized = Map_ToBuffer(map, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_SERIALIZATIONS; i++)
+    {
+        uint32_t consumed;
+        MAP_HANDLE copy;
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, Map_FromBuffer(serialized, serialized_size, &consumed, &copy));
+        Map_Destroy(copy);
+    }
+    double from_buffer_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    uint32_t consumed;
+    MAP_HANDLE copy;
+    ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, Map_FromBuffer(serialized, serialized_size, &consumed, &copy));
+    ASSERT_ARE_EQUAL(uint32_t, serialized_size, consumed);
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(char_ptr, keys[i], Map_GetValueFromKey(copy, keys[i]));
+    }
+    LogInfo("%zu keys (%" PRIu32 " bytes serialized): %d serializations took %.3f ms with Map_ToJSON and %.3f ms with Map_ToBuffer, %d rebuilds took %.3f ms with Map_Add and %.3f ms with Map_FromBuffer",
+        count, serialized_size, N_SERIALIZATIONS, json_ms, to_buffer_ms, N_SERIALIZATIONS, add_ms, from_buffer_ms);
+
+    ///cleanup
+    Map_Destroy(copy);
+    free(serialized);
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+/*a filter that accepts everything, so that both ways of building a map pay for calling it*/
+static int accept_all_filter(const char* mapProperty, const char* mapValue)
+{
+    (void)mapProperty;
+    (void)mapValue;
+    return 0;
+}
+
+static void measure_create_from_arrays(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_BULK_BUILDS; i++)
+    {
+        MAP_HANDLE map = Map_Create(accept_all_filter);
+        ASSERT_IS_NOT_NULL(map);
+        for (size_t j = 0; j < count; j++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[j], keys[j]));
+        }
+        Map_Destroy(map);
+    }
+    double add_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_BULK_BUILDS; i++)
+    {
+        MAP_HANDLE map = Map_CreateFromArrays(accept_all_filter, (const char* const*)keys, (const char* const*)keys, count);
+        ASSERT_IS_NOT_NULL(map);
+        Map_Destroy(map);
+    }
+    double bulk_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    MAP_HANDLE map = Map_CreateFromArrays(accept_all_filter, (const char* const*)keys, (const char* const*)keys, count);
+    ASSERT_IS_NOT_NULL(map);
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(char_ptr, keys[i], Map_GetValueFromKey(map, keys[i]));
+    }
+    LogInfo("%zu keys: %d builds took %.3f ms with Map_Create + Map_Add and %.3f ms with Map_CreateFromArrays",
+        count, N_BULK_BUILDS, add_ms, bulk_ms);
+
+    ///cleanup
+    Map_Destroy(map);
+    destroy_keys(keys, count);
+}
+
+static double fill_iterate_and_destroy(MAP_HANDLE map, char** keys, size_t count, size_t* total_length)
+{
+    const char* const* map_keys;
+    const char* const* map_values;
+    size_t map_count;
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, keys[i], keys[i]));
+    }
+    ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(map, &map_keys, &map_values, &map_count));
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < map_count; i++)
+    {
+        *total_length += strlen(map_keys[i]) + strlen(map_values[i]);
+    }
+    double iterate_ms = timer_global_get_elapsed_ms() - start;
+    Map_Destroy(map);
+    return iterate_ms;
+}
+
+static void measure_arena(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    size_t arena_size = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        arena_size += 2 * (strlen(keys[i]) + 1);
+    }
+    size_t plain_length = 0;
+    size_t arena_length = 0;
+    double plain_iterate_ms = 0;
+    double arena_iterate_ms = 0;
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LIFETIMES; i++)
+    {
+        MAP_HANDLE map = Map_CreateWithCapacity(NULL, count);
+        ASSERT_IS_NOT_NULL(map);
+        plain_iterate_ms += fill_iterate_and_destroy(map, keys, count, &plain_length);
+    }
+    double plain_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_LIFETIMES; i++)
+    {
+        MAP_HANDLE map = Map_CreateWithArena(NULL, count, arena_size);
+        ASSERT_IS_NOT_NULL(map);
+        arena_iterate_ms += fill_iterate_and_destroy(map, keys, count, &arena_length);
+    }
+    double arena_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, plain_length, arena_length);
+    LogInfo("%zu keys: %d create/fill/iterate/destroy cycles took %.3f ms with Map_CreateWithCapacity and %.3f ms with Map_CreateWithArena (iterating took %.3f ms vs %.3f ms)",
+        count, N_LIFETIMES, plain_ms, arena_ms, plain_iterate_ms, arena_iterate_ms);
+
+    ///cleanup
+    destroy_keys(keys, count);
+}
+
+static void measure_rc_strings(size_t count)
+{
+    ///arrange
+    char** keys = create_keys(count);
+    char* large_value = malloc(LARGE_VALUE_SIZE + 1);
+    ASSERT_IS_NOT_NULL(large_value);
+    (void)memset(large_value, 'a', LARGE_VALUE_SIZE);
+    large_value[LARGE_VALUE_SIZE] = '\0';
+    THANDLE(RC_STRING)* rc_keys = malloc_2(count, sizeof(THANDLE(RC_STRING)));
+    ASSERT_IS_NOT_NULL(rc_keys);
+    THANDLE(RC_STRING) rc_value = rc_string_create(large_value);
+    ASSERT_IS_NOT_NULL(rc_value);
+    for (size_t i = 0; i < count; i++)
+    {
+        THANDLE(RC_STRING) temp = rc_string_create(keys[i]);
+        ASSERT_IS_NOT_NULL(temp);
+        THANDLE_INITIALIZE_MOVE(RC_STRING)(&rc_keys[i], &temp);
+    }
+
+    ///act
+    double start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_FILLS; i++)
+    {
+        MAP_HANDLE map = Map_CreateWithCapacity(NULL, count);
+        ASSERT_IS_NOT_NULL(map);
+        for (size_t j = 0; j < count; j++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(map, rc_keys[j]->string, rc_value->string));
+        }
+        Map_Destroy(map);
+    }
+    double copy_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (size_t i = 0; i < N_FILLS; i++)
+    {
+        MAP_HANDLE map = Map_CreateWithRcStrings(NULL, count);
+        ASSERT_IS_NOT_NULL(map);
+        for (size_t j = 0; j < count; j++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddRcString(map, rc_keys[j], rc_value));
+        }
+        Map_Destroy(map);
+    }
+    double reference_ms = timer_global_get_elapsed_ms() - start;
+
+    ///assert
+    LogInfo("%zu keys with %d byte values: %d fills took %.3f ms with Map_Add (copies) and %.3f ms with Map_AddRcString (references)",
+        count, LARGE_VALUE_SIZE, N_FILLS, copy_ms, reference_ms);
+
+    ///cleanup
+    for (size_t i = 0; i < count; i++)
+    {
+        THANDLE_ASSIGN(RC_STRING)(&rc_keys[i], NULL);
+    }
+    free((void*)rc_keys);
+    THANDLE_ASSIGN(RC_STRING)(&rc_value, NULL);
+    free(large_value);
+    destroy_keys(keys, count);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(function_initialize)
+{
+}
+
+TEST_FUNCTION_CLEANUP(function_cleanup)
+{
+}
+
+TEST_FUNCTION(map_perf_lookup_with_10_keys)
+{
+    measure_lookups(10);
+}
+
+TEST_FUNCTION(map_perf_lookup_with_1000_keys)
+{
+    measure_lookups(1000);
+}
+
+TEST_FUNCTION(map_perf_lookup_with_100000_keys)
+{
+    measure_lookups(100000);
+}
+
+TEST_FUNCTION(map_perf_build_and_delete_with_100000_keys)
+{
+    measure_build_and_delete(100000);
+}
+
+TEST_FUNCTION(map_perf_contains_value_with_1000_values)
+{
+    measure_contains_value(1000);
+}
+
+TEST_FUNCTION(map_perf_contains_value_with_100000_values)
+{
+    measure_contains_value(100000);
+}
+
+TEST_FUNCTION(map_perf_snapshots_with_1000_keys)
+{
+    measure_snapshots(1000);
+}
+
+TEST_FUNCTION(map_perf_snapshots_with_100000_keys)
+{
+    measure_snapshots(100000);
+}
+
+TEST_FUNCTION(map_perf_to_json_with_100_keys)
+{
+    measure_to_json(100);
+}
+
+TEST_FUNCTION(map_perf_to_json_with_10000_keys)
+{
+    measure_to_json(10000);
+}
+
+TEST_FUNCTION(map_perf_to_buffer_with_10000_keys)
+{
+    measure_to_buffer(10000);
+}
+
+TEST_FUNCTION(map_perf_create_from_arrays_with_10000_keys)
+{
+    measure_create_from_arrays(10000);
+}
+
+TEST_FUNCTION(map_perf_arena_with_500_keys)
+{
+    measure_arena(500);
+}
+
+TEST_FUNCTION(map_perf_rc_strings_with_1000_keys)
+{
+    measure_rc_strings(1000);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
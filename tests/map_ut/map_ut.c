@@ -3,8 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstring>
 #else
 #include <stdlib.h>
+#include <string.h>
 #endif
 
 #include "macro_utils/macro_utils.h"
@@ -22,13 +24,16 @@ static void my_gballoc_free(void* ptr)
 
 static TEST_MUTEX_HANDLE g_testByTest;
 
+#include "c_pal/interlocked.h" /*included for mocking reasons - it will prohibit creation of mocks belonging to interlocked.h*/
+
 #define ENABLE_MOCKS
 
 #include "c_util/strings.h"
 
-STRING_HANDLE my_STRING_construct(const char* psz)
+static const char* g_STRING_new_with_memory_memory;
+static STRING_HANDLE my_STRING_new_with_memory(const char* memory)
 {
-    (void)psz;
+    g_STRING_new_with_memory_memory = memory;
     return (STRING_HANDLE)malloc(1);
 }
 
@@ -37,23 +42,43 @@ static void my_STRING_delete(STRING_HANDLE handle)
     free(handle);
 }
 
-STRING_HANDLE my_STRING_new_JSON(const char* source)
+#include "c_util/constbuffer.h"
+
+static unsigned char* g_CONSTBUFFER_CreateWithMoveMemory_source;
+static CONSTBUFFER_HANDLE my_CONSTBUFFER_CreateWithMoveMemory(unsigned char* source, uint32_t size)
 {
-    (void)source;
-    return (STRING_HANDLE)malloc(1);
+    (void)size;
+    g_CONSTBUFFER_CreateWithMoveMemory_source = source;
+    return (CONSTBUFFER_HANDLE)malloc(1);
+}
+
+static void my_CONSTBUFFER_DecRef(CONSTBUFFER_HANDLE constbufferHandle)
+{
+    free(constbufferHandle);
 }
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_util/rc_string.h"
 
 #undef ENABLE_MOCKS
 
+// Must include umock_c_prod so mocks are not expanded in real_rc_string
+#include "umock_c/umock_c_prod.h"
+
 #include "real_gballoc_hl.h"
+#include "real_rc_string.h"
+#include "c_util/thandle.h"
+
+#include "c_util/memory_data.h"
 
+#include "c_util/map_format.h"
+#include "c_util/map_version.h"
 #include "c_util/map.h"
 
 TEST_DEFINE_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_VALUES)
 
 static int DontAllowCapitalsFilters(const char* mapProperty, const char* mapValue)
 {
@@ -100,6 +125,83 @@ static const char* TEST_BLUEVALUE = "cyan";
 static const char* TEST_GREENKEY = "testgreenkey";
 static const char* TEST_GREENVALUE = "green";
 
+/*enough keys to have the map build its key index (it is built when the 8th key is added)*/
+static const char* TEST_MANY_KEYS[] = { "key0", "key1", "key2", "key3", "key4", "key5", "key6", "key7", "key8", "key9" };
+static const char* TEST_MANY_VALUES[] = { "value0", "value1", "value2", "value3", "value4", "value5", "value6", "value7", "value8", "value9" };
+#define TEST_MANY_COUNT (sizeof(TEST_MANY_KEYS) / sizeof(TEST_MANY_KEYS[0]))
+
+/*the serialization of a map with TEST_REDKEY/TEST_REDVALUE and TEST_YELLOWKEY/TEST_YELLOWVALUE*/
+static const unsigned char TEST_SERIALIZED_RED_YELLOW[] =
+{
+    MAP_VERSION_V1,
+    0, 0, 0, 2,
+    0, 0, 0, 10, 't', 'e', 's', 't', 'R', 'e', 'd', 'K', 'e', 'y',
+    0, 0, 0, 12, 't', 'e', 's', 't', 'R', 'e', 'd', 'V', 'a', 'l', 'u', 'e',
+    0, 0, 0, 13, 't', 'e', 's', 't', 'Y', 'e', 'l', 'l', 'o', 'w', 'K', 'e', 'y',
+    0, 0, 0, 15, 't', 'e', 's', 't', 'Y', 'e', 'l', 'l', 'o', 'w', 'V', 'a', 'l', 'u', 'e'
+};
+
+/*number of bytes of the keys and values of TEST_SERIALIZED_RED_YELLOW with their null terminators*/
+#define TEST_SERIALIZED_RED_YELLOW_STRINGS_SIZE (sizeof("testRedKey") + sizeof("testRedValue") + sizeof("testYellowKey") + sizeof("testYellowValue"))
+
+static size_t g_test_alloc_size;
+static void* g_test_alloc_context;
+static void* test_alloc(size_t size, void* context)
+{
+    g_test_alloc_size = size;
+    g_test_alloc_context = context;
+    return real_gballoc_hl_malloc(size);
+}
+
+static void add_many_keys(MAP_HANDLE handle, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, TEST_MANY_KEYS[i], TEST_MANY_VALUES[i]));
+    }
+}
+
+static void test_rc_string_no_free(void* context)
+{
+    (void)context;
+}
+
+/*adds pairs to handle that bring the size of its serialization to exactly size, their values are bigValue or a suffix of it*/
+static void test_fill_serialization(MAP_HANDLE handle, const char* bigValue, uint32_t bigValueLength, uint64_t size)
+{
+    const uint64_t bigPairSize = MAP_MIN_PAIR_SIZE + 4 + (uint64_t)bigValueLength; /*keys are "kNNN"*/
+    uint64_t remaining = size - MAP_MIN_SERIALIZATION_SIZE;
+    uint32_t i = 0;
+    char key[5];
+    while (remaining > 2 * bigPairSize)
+    {
+        THANDLE(RC_STRING) rcKey;
+        THANDLE(RC_STRING) rcValue = real_rc_string_create_with_custom_free(bigValue, test_rc_string_no_free, NULL);
+        (void)snprintf(key, sizeof(key), "k%03u", (unsigned int)i++);
+        rcKey = real_rc_string_create(key);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddRcString(handle, rcKey, rcValue));
+        THANDLE_ASSIGN(real_RC_STRING)(&rcKey, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&rcValue, NULL);
+        remaining -= bigPairSize;
+    }
+    while (remaining != 0)
+    {
+        /*at most 2 more pairs, each with a suffix of bigValue*/
+        uint64_t valueLength = (remaining > bigPairSize) ? (remaining / 2 - MAP_MIN_PAIR_SIZE - 4) : (remaining - MAP_MIN_PAIR_SIZE - 4);
+        THANDLE(RC_STRING) rcKey;
+        THANDLE(RC_STRING) rcValue;
+        ASSERT_IS_TRUE(valueLength <= bigValueLength);
+        rcValue = real_rc_string_create_with_custom_free(bigValue + (bigValueLength - valueLength), test_rc_string_no_free, NULL);
+        (void)snprintf(key, sizeof(key), "k%03u", (unsigned int)i++);
+        rcKey = real_rc_string_create(key);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddRcString(handle, rcKey, rcValue));
+        THANDLE_ASSIGN(real_RC_STRING)(&rcKey, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&rcValue, NULL);
+        remaining -= MAP_MIN_PAIR_SIZE + 4 + valueLength;
+    }
+}
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -125,11 +227,15 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(THANDLE(RC_STRING), void*);
 
         REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
-        REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
+        REGISTER_GLOBAL_MOCK_HOOK(STRING_new_with_memory, my_STRING_new_with_memory);
         REGISTER_GLOBAL_MOCK_HOOK(STRING_delete, my_STRING_delete);
-        REGISTER_GLOBAL_MOCK_HOOK(STRING_new_JSON, my_STRING_new_JSON);
+        REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_CreateWithMoveMemory, my_CONSTBUFFER_CreateWithMoveMemory);
+        REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_DecRef, my_CONSTBUFFER_DecRef);
+        REGISTER_RC_STRING_GLOBAL_MOCK_HOOKS();
     }
 
     TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -159,15 +265,20 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     /*Tests_SRS_MAP_02_001: [Map_Create shall create a new, empty map.]*/ /*this tests "create"*/
     /*Tests_SRS_MAP_02_003: [Otherwise, it shall return a non-NULL handle that can be used in subsequent calls.] */
     /*Tests_SRS_MAP_02_004: [Map_Destroy shall release all resources associated with the map.] */
+    /*Tests_SRS_MAP_11_023: [ Map_Create shall create a store for the pairs of the map. ]*/
     TEST_FUNCTION(Map_Create_Destroy_succeeds)
     {
         MAP_HANDLE handle;
 
         ///arrange
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handleData*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
 
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handleData*/
 
         ///act
@@ -198,6 +309,12 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free values array*/
 
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free key index*/
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free value index*/
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free store*/
+
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free handle*/
 
         ///act
@@ -228,6 +345,12 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free values array*/
 
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free key index*/
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free value index*/
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free store*/
+
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*free handle*/
 
         ///act
@@ -284,6 +407,24 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(handle);
     }
 
+    /*Tests_SRS_MAP_02_002: [If during creation there are any error, then Map_Create shall return NULL.]*/
+    TEST_FUNCTION(Map_Create_fails_when_creating_the_store_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handleData*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*store*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handleData*/
+
+        ///act
+        handle = Map_Create(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
 
     /*Tests_SRS_MAP_02_005: [If parameter handle is NULL then Map_Destroy shall take no action.]*/
     TEST_FUNCTION(Map_Destroy_with_NULL_argument_does_nothing)
@@ -369,9 +510,9 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
@@ -410,17 +551,17 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
 
@@ -460,17 +601,17 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
 
@@ -481,9 +622,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*undo copy of blue key*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
 
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing values*/
-
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
         result2 = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
@@ -516,24 +654,22 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)) /*copy of blue key*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing values*/
 
 
         ///act
@@ -568,21 +704,20 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))) /*growing values*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -616,15 +751,15 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))) /*growing keys*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
@@ -660,9 +795,9 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
 
@@ -672,8 +807,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*undo copy of red key*/
             .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing values*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -702,17 +835,14 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)) /*copy of red key*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
-
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing values*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -741,13 +871,12 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))) /*growing values*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -776,7 +905,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))) /*growing keys*/
             .SetReturn(NULL);
 
         /*below are undo actions*/ /*none*/
@@ -929,8 +1058,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
@@ -963,13 +1092,13 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of blue value*/
 
@@ -1007,13 +1136,13 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)) /*copy of blue value*/
             .SetReturn(NULL);
@@ -1021,9 +1150,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*undo blue key value*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
-
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing values*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1056,20 +1182,17 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)) /*copy of blue key*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
-
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing values*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1102,17 +1225,16 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))) /*growing values*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*undo growing keys*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1145,12 +1267,12 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, sizeof(const char*), 1, sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))) /*growing keys*/
             .SetReturn(NULL);
 
         /*below are undo actions*/ /*none*/
@@ -1185,8 +1307,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)) /*copy of red value*/
             .SetReturn(NULL);
@@ -1194,8 +1316,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*undo red key value*/
             .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG));/*undo growing values*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1223,15 +1343,13 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
 
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)) /*copy of red key*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing values*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1259,12 +1377,11 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))) /*growing values*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*undo growing keys*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1292,7 +1409,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_HANDLE handle = Map_Create(NULL);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))) /*growing keys*/
             .SetReturn(NULL);
 
         /*below are undo actions*/
@@ -1550,10 +1667,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*ungrowing values*/
-
-        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*ungowing keys*/
-
         ///act
         result1 = Map_Delete(handle, TEST_YELLOWKEY);
         result3 = Map_GetInternals(handle, &keys, &values, &count);
@@ -1589,10 +1702,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*ungrowing values*/
-
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*ungrowing keys*/
-
         ///act
         result1 = Map_Delete(handle, TEST_YELLOWKEY);
         result3 = Map_GetInternals(handle, &keys, &values, &count);
@@ -1630,10 +1739,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*ungrowing values*/
-
-        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 1, sizeof(const char*))); /*ungrowing keys*/
-
         ///act
         result1 = Map_Delete(handle, TEST_REDKEY);
         result3 = Map_GetInternals(handle, &keys, &values, &count);
@@ -2043,6 +2148,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     }
 
     /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    /*Tests_SRS_MAP_11_025: [ Map_Clone shall not copy the pairs of the map, the clone shall share the store of the map indicated by handle. ]*/
     TEST_FUNCTION(Map_Clone_with_map_with_1_element_succeeds)
     {
         ///arrange
@@ -2056,14 +2162,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
 
-        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-
         ///act
         result = Map_Clone(handle);
 
@@ -2082,16 +2180,18 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_1)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_1_element_fails_when_gballoc_fails_1)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2108,27 +2208,29 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_2)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_1_element_fails_when_gballoc_fails_2)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2142,27 +2244,29 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_3)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_1_element_fails_when_gballoc_fails_3)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2173,42 +2277,44 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_4)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_1_element_fails_when_gballoc_fails_4)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))) /*this is creating a clone of the storage for keys*/
             .SetReturn(NULL);
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2236,6 +2342,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     }
 
     /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    /*Tests_SRS_MAP_11_025: [ Map_Clone shall not copy the pairs of the map, the clone shall share the store of the map indicated by handle. ]*/
     TEST_FUNCTION(Map_Clone_with_map_with_2_element_succeeds)
     {
         ///arrange
@@ -2250,16 +2357,6 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
 
-        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
-
-        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a clone of RED value*/
-
         ///act
         result = Map_Clone(handle);
 
@@ -2280,17 +2377,19 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_1)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_1)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2314,28 +2413,30 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_2)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_2)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2,  sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2355,28 +2456,30 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_3)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_3)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2393,28 +2496,30 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_4)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_4)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2428,28 +2533,30 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_5)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_5)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
 
@@ -2460,28 +2567,30 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_6)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_2_elements_fails_when_gballoc_fails_6)
     {
         ///arrange
-        MAP_HANDLE result;
+        MAP_RESULT result;
+        MAP_HANDLE clone;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
 
         STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))) /*this is creating a clone of the storage for keys*/
             .SetReturn(NULL);
@@ -2489,15 +2598,15 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2535,8 +2644,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_RESULT result3;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_GREENKEY) + 1)); /*copy of green key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_GREENVALUE) + 1)); /*copy of green value*/
 
@@ -2564,8 +2673,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         MAP_RESULT result2;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(realloc_flex(NULL, sizeof(const char*), 0, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_GREENKEY) + 1)); /*copy of green key*/
         STRICT_EXPECTED_CALL(malloc(strlen(TEST_GREENVALUE) + 1)); /*copy of green value*/
 
@@ -2599,6 +2708,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
     /*Tests_SRS_MAP_02_048: [Map_ToJSON shall produce a STRING_HANDLE representing the content of the MAP.]*/
     /*Tests_SRS_MAP_02_049: [If the MAP is empty, then Map_ToJSON shall produce the string "{}".] */
+    /*Tests_SRS_MAP_11_029: [ Map_ToJSON shall allocate memory for the JSON representation and its null terminator once and write the JSON representation there. ]*/
+    /*Tests_SRS_MAP_11_030: [ Map_ToJSON shall hand the memory over to a STRING_HANDLE by calling STRING_new_with_memory. ]*/
     TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON)
     {
         ///arrange
@@ -2606,35 +2717,34 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         STRING_HANDLE toJSON;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}"));
+        STRICT_EXPECTED_CALL(malloc_flex(1, 2, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
 
         ///assert
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "{}", g_STRING_new_with_memory_memory);
 
         ///cleanup
         Map_Destroy(handle);
         STRING_delete(toJSON);
+        real_gballoc_hl_free((void*)g_STRING_new_with_memory_memory);
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON_fails_when_STRING_concat_fails)
+    TEST_FUNCTION(Map_ToJSON_fails_when_malloc_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
+        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}"))
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc_flex(1, IGNORED_ARG, 1))
+            .SetReturn(NULL);
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2648,15 +2758,18 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON_fails_when_STRING_construct_fails)
+    TEST_FUNCTION(Map_ToJSON_fails_when_STRING_new_with_memory_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
+        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
+        STRICT_EXPECTED_CALL(malloc_flex(1, IGNORED_ARG, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG))
             .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2670,6 +2783,7 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
     }
 
     /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
+    /*Tests_SRS_MAP_11_028: [ Map_ToJSON shall compute the length of the JSON representation of the map, with keys and values escaped the way STRING_new_JSON escapes them. ]*/
     TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_succeeds)
     {
         ///arrange
@@ -2678,21 +2792,8 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-        
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}")); /*now JSON is {"redkey":"redoor"}*/
+        STRICT_EXPECTED_CALL(malloc_flex(1, sizeof("{\"redkey\":\"reddoor\"}") - 1, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2700,101 +2801,76 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         ///assert
         ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "{\"redkey\":\"reddoor\"}", g_STRING_new_with_memory_memory);
 
         ///cleanup
         Map_Destroy(handle);
         STRING_delete(toJSON);
+        real_gballoc_hl_free((void*)g_STRING_new_with_memory_memory);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_1)
+    /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
+    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}"))/*now JSON is {"redkey":"redoor"}*/
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc_flex(1, sizeof("{\"redkey\":\"reddoor\",\"yellowkey\":\"yellowdoor\"}") - 1, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "{\"redkey\":\"reddoor\",\"yellowkey\":\"yellowdoor\"}", g_STRING_new_with_memory_memory);
 
         ///cleanup
         Map_Destroy(handle);
+        STRING_delete(toJSON);
+        real_gballoc_hl_free((void*)g_STRING_new_with_memory_memory);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_2)
+    /*Tests_SRS_MAP_11_028: [ Map_ToJSON shall compute the length of the JSON representation of the map, with keys and values escaped the way STRING_new_JSON escapes them. ]*/
+    TEST_FUNCTION(Map_ToJSON_escapes_keys_and_values)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        (void)Map_AddOrUpdate(handle, "a\"b/c\\d", "\x01\x1F");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey":"reddoor"*/
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc_flex(1, sizeof("{\"a\\\"b\\/c\\\\d\":\"\\u0001\\u001F\"}") - 1, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "{\"a\\\"b\\/c\\\\d\":\"\\u0001\\u001F\"}", g_STRING_new_with_memory_memory);
 
         ///cleanup
         Map_Destroy(handle);
+        STRING_delete(toJSON);
+        real_gballoc_hl_free((void*)g_STRING_new_with_memory_memory);
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_3)
+    TEST_FUNCTION(Map_ToJSON_fails_when_a_value_is_not_ASCII)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        (void)Map_AddOrUpdate(handle, "redkey", "\xC3\xA9");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")) /*now JSON is {"redkey":*/
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
-
         ///act
         toJSON = Map_ToJSON(handle);
 
@@ -2806,306 +2882,264 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_4)
+    /* Map_ToJSONBuffer */
+
+    /*Tests_SRS_MAP_11_031: [ If handle is NULL or requiredSize is NULL then Map_ToJSONBuffer shall fail and return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_NULL_handle_fails)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        umock_c_reset_all_calls();
+        char buffer[16];
+        size_t requiredSize;
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey"*/
-            .SetReturn(1);
+        ///act
+        MAP_RESULT result = Map_ToJSONBuffer(NULL, buffer, sizeof(buffer), &requiredSize);
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+    /*Tests_SRS_MAP_11_031: [ If handle is NULL or requiredSize is NULL then Map_ToJSONBuffer shall fail and return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_NULL_requiredSize_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        char buffer[16];
+        MAP_RESULT result;
+        umock_c_reset_all_calls();
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_ToJSONBuffer(handle, buffer, sizeof(buffer), NULL);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_5)
+    /*Tests_SRS_MAP_11_032: [ If buffer is NULL and bufferSize is not 0 then Map_ToJSONBuffer shall fail and return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_NULL_buffer_and_non_zero_bufferSize_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        size_t requiredSize;
+        MAP_RESULT result;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor"))
-            .SetReturn(NULL); /*prepare the value*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
-
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_ToJSONBuffer(handle, NULL, 16, &requiredSize);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_6)
+    /*Tests_SRS_MAP_11_034: [ Map_ToJSONBuffer shall write in *requiredSize the size of the JSON representation of the map including its null terminator. ]*/
+    /*Tests_SRS_MAP_11_035: [ If bufferSize is smaller than *requiredSize then Map_ToJSONBuffer shall return MAP_ERROR and shall not write to buffer. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_NULL_buffer_and_0_bufferSize_produces_requiredSize)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
+        size_t requiredSize = 0;
+        MAP_RESULT result;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")) /*prepare the key*/
-            .SetReturn(NULL); 
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
-
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_ToJSONBuffer(handle, NULL, 0, &requiredSize);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(size_t, sizeof("{\"redkey\":\"reddoor\"}"), requiredSize);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_7)
+    /*Tests_SRS_MAP_11_034: [ Map_ToJSONBuffer shall write in *requiredSize the size of the JSON representation of the map including its null terminator. ]*/
+    /*Tests_SRS_MAP_11_035: [ If bufferSize is smaller than *requiredSize then Map_ToJSONBuffer shall return MAP_ERROR and shall not write to buffer. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_too_small_buffer_fails_and_does_not_write_to_buffer)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
+        char buffer[sizeof("{\"redkey\":\"reddoor\"}") - 1];
+        size_t requiredSize = 0;
+        MAP_RESULT result;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        (void)memset(buffer, 'x', sizeof(buffer));
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .SetReturn(NULL);
-
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_ToJSONBuffer(handle, buffer, sizeof(buffer), &requiredSize);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(size_t, sizeof(buffer) + 1, requiredSize);
+        ASSERT_ARE_EQUAL(int, 'x', buffer[0]);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_succeeds)
+    /*Tests_SRS_MAP_11_034: [ Map_ToJSONBuffer shall write in *requiredSize the size of the JSON representation of the map including its null terminator. ]*/
+    /*Tests_SRS_MAP_11_036: [ Otherwise Map_ToJSONBuffer shall write the null terminated JSON representation of the map in buffer, without allocating memory, and return MAP_OK. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_empty_MAP_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        char buffer[3];
+        size_t requiredSize = 0;
+        MAP_RESULT result;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","));
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}")); /*now JSON is {"redkey":"redoor"}*/
-
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_ToJSONBuffer(handle, buffer, sizeof(buffer), &requiredSize);
 
         ///assert
-        ASSERT_IS_NOT_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(size_t, 3, requiredSize);
+        ASSERT_ARE_EQUAL(char_ptr, "{}", buffer);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        ///cleanup 
+        ///cleanup
         Map_Destroy(handle);
-        STRING_delete(toJSON);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_1)
+    /*Tests_SRS_MAP_11_036: [ Otherwise Map_ToJSONBuffer shall write the null terminated JSON representation of the map in buffer, without allocating memory, and return MAP_OK. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_with_2_MAP_elements_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
+        char buffer[64];
+        size_t requiredSize = 0;
+        MAP_RESULT result;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        (void)Map_AddOrUpdate(handle, "yellow/key", "yellow\"door");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        ///act
+        result = Map_ToJSONBuffer(handle, buffer, sizeof(buffer), &requiredSize);
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(size_t, sizeof("{\"redkey\":\"reddoor\",\"yellow\\/key\":\"yellow\\\"door\"}"), requiredSize);
+        ASSERT_ARE_EQUAL(char_ptr, "{\"redkey\":\"reddoor\",\"yellow\\/key\":\"yellow\\\"door\"}", buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_033: [ If any key or value cannot be represented in JSON then Map_ToJSONBuffer shall fail and return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_ToJSONBuffer_fails_when_a_key_is_not_ASCII)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        char buffer[64];
+        size_t requiredSize = 0;
+        MAP_RESULT result;
+        (void)Map_AddOrUpdate(handle, "\xC3\xA9", "reddoor");
+        umock_c_reset_all_calls();
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","));
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
+        ///act
+        result = Map_ToJSONBuffer(handle, buffer, sizeof(buffer), &requiredSize);
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
 
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, "}")) /*now JSON is {"redkey":"redoor"}*/
-            .SetReturn(1);
+    /* Map_ToJSONConstBuffer */
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+    /*Tests_SRS_MAP_11_037: [ If handle is NULL then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_with_NULL_handle_fails)
+    {
+        ///arrange
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        CONSTBUFFER_HANDLE toJSON = Map_ToJSONConstBuffer(NULL);
 
         ///assert
         ASSERT_IS_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_2)
+    /*Tests_SRS_MAP_11_039: [ Map_ToJSONConstBuffer shall allocate memory for the JSON representation once and write the JSON representation there, without a null terminator. ]*/
+    /*Tests_SRS_MAP_11_040: [ Map_ToJSONConstBuffer shall hand the memory over to a CONSTBUFFER_HANDLE by calling CONSTBUFFER_CreateWithMoveMemory and return it. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
+        CONSTBUFFER_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","));
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .SetReturn(1);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc(sizeof("{\"redkey\":\"reddoor\"}") - 1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, sizeof("{\"redkey\":\"reddoor\"}") - 1));
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        toJSON = Map_ToJSONConstBuffer(handle);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, memcmp("{\"redkey\":\"reddoor\"}", g_CONSTBUFFER_CreateWithMoveMemory_source, sizeof("{\"redkey\":\"reddoor\"}") - 1));
 
         ///cleanup
         Map_Destroy(handle);
+        CONSTBUFFER_DecRef(toJSON);
+        real_gballoc_hl_free(g_CONSTBUFFER_CreateWithMoveMemory_source);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_3)
+    /*Tests_SRS_MAP_11_039: [ Map_ToJSONConstBuffer shall allocate memory for the JSON representation once and write the JSON representation there, without a null terminator. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_with_empty_MAP_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        CONSTBUFFER_HANDLE toJSON;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        STRICT_EXPECTED_CALL(malloc(2));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, 2));
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
+        ///act
+        toJSON = Map_ToJSONConstBuffer(handle);
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
+        ///assert
+        ASSERT_IS_NOT_NULL(toJSON);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, memcmp("{}", g_CONSTBUFFER_CreateWithMoveMemory_source, 2));
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","));
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")) /*now JSON is {"redkey":*/
-                .SetReturn(1);
+        ///cleanup
+        Map_Destroy(handle);
+        CONSTBUFFER_DecRef(toJSON);
+        real_gballoc_hl_free(g_CONSTBUFFER_CreateWithMoveMemory_source);
+    }
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
+    /*Tests_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_fails_when_malloc_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        CONSTBUFFER_HANDLE toJSON;
+        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+            .SetReturn(NULL);
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        toJSON = Map_ToJSONConstBuffer(handle);
 
         ///assert
         ASSERT_IS_NULL(toJSON);
@@ -3115,45 +3149,42 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_4)
+    /*Tests_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_fails_when_CONSTBUFFER_CreateWithMoveMemory_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
+        CONSTBUFFER_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        }
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, IGNORED_ARG))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","));
+        ///act
+        toJSON = Map_ToJSONConstBuffer(handle);
 
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey"*/
-                .SetReturn(1);
+        ///assert
+        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        }
+        ///cleanup
+        Map_Destroy(handle);
+    }
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+    /*Tests_SRS_MAP_11_041: [ If any error occurs then Map_ToJSONConstBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToJSONConstBuffer_fails_when_a_value_is_not_ASCII)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        CONSTBUFFER_HANDLE toJSON;
+        (void)Map_AddOrUpdate(handle, "redkey", "\xC3\xA9");
+        umock_c_reset_all_calls();
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        toJSON = Map_ToJSONConstBuffer(handle);
 
         ///assert
         ASSERT_IS_NULL(toJSON);
@@ -3163,348 +3194,3782 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_5)
+    /*Tests_SRS_MAP_11_001: [ When the number of keys reaches 8, Map_Add and Map_AddOrUpdate shall build a key index: an open addressing hash table that maps keys to their position in the keys array. ]*/
+    TEST_FUNCTION(Map_Add_builds_key_index_when_the_8th_key_is_added)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        MAP_RESULT result;
+        size_t i;
+        add_many_keys(handle, 7);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*key index*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[7]) + 1)); /*copy of the key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[7]) + 1)); /*copy of the value*/
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[7], TEST_MANY_VALUES[7]);
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < 8; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
         }
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ","))
-                .SetReturn(1);
+        ///cleanup
+        Map_Destroy(handle);
+    }
 
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        }
+    /*Tests_SRS_MAP_11_001: [ When the number of keys reaches 8, Map_Add and Map_AddOrUpdate shall build a key index: an open addressing hash table that maps keys to their position in the keys array. ]*/
+    TEST_FUNCTION(Map_Add_fails_when_building_the_key_index_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        add_many_keys(handle, 7);
+        umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))) /*key index*/
+            .SetReturn(NULL);
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_Add(handle, TEST_MANY_KEYS[7], TEST_MANY_VALUES[7]);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 7, count);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_MANY_KEYS[7]));
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_6)
+    /*Tests_SRS_MAP_11_002: [ Map_Add and Map_AddOrUpdate shall grow the key index so that it is never more than half full. ]*/
+    TEST_FUNCTION(Map_Add_grows_key_index_when_the_9th_key_is_added)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        MAP_RESULT result;
+        size_t i;
+        add_many_keys(handle, 8);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        STRICT_EXPECTED_CALL(malloc_2(32, sizeof(size_t))); /*new key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*old key index*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[8]) + 1)); /*copy of the key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[8]) + 1)); /*copy of the value*/
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        }
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[8], TEST_MANY_VALUES[8]);
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor"))
-                .SetReturn(NULL); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < 9; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
         }
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_003: [ Once the key index exists, Map_Add, Map_AddOrUpdate, Map_Delete, Map_ContainsKey and Map_GetValueFromKey shall locate keys by probing the key index. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_with_key_index_overwrites_the_value)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        add_many_keys(handle, TEST_MANY_COUNT);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, 1, strlen(TEST_REDVALUE), 1)); /*new value*/
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_AddOrUpdate(handle, TEST_MANY_KEYS[5], TEST_REDVALUE);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, TEST_MANY_COUNT, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[5], keys[5]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[5]);
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_7)
+    /*Tests_SRS_MAP_11_003: [ Once the key index exists, Map_Add, Map_AddOrUpdate, Map_Delete, Map_ContainsKey and Map_GetValueFromKey shall locate keys by probing the key index. ]*/
+    TEST_FUNCTION(Map_ContainsKey_with_key_index_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        bool exists1;
+        bool exists2;
+        MAP_RESULT result1;
+        MAP_RESULT result2;
+        add_many_keys(handle, TEST_MANY_COUNT);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        ///act
+        result1 = Map_ContainsKey(handle, TEST_MANY_KEYS[9], &exists1);
+        result2 = Map_ContainsKey(handle, TEST_REDKEY, &exists2);
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey":"reddoor"*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        }
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_IS_TRUE(exists1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_IS_FALSE(exists2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey"))
-                .SetReturn(NULL); /*prepare the key*/
-        }
+        ///cleanup
+        Map_Destroy(handle);
+    }
 
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+    /*Tests_SRS_MAP_11_005: [ Map_Delete shall leave the key index slot of the deleted key in place, probing for other keys shall continue past it. ]*/
+    TEST_FUNCTION(Map_Delete_with_key_index_keeps_the_other_keys_reachable)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        size_t i;
+        add_many_keys(handle, TEST_MANY_COUNT);
+        umock_c_reset_all_calls();
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_Delete(handle, TEST_MANY_KEYS[2]);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_MANY_KEYS[2]));
+        for (i = 0; i < TEST_MANY_COUNT; i++)
+        {
+            if (i != 2)
+            {
+                ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+            }
+        }
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, TEST_MANY_COUNT - 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[3], keys[2]); /*insertion order is kept*/
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_8)
+    /*Tests_SRS_MAP_11_004: [ If the map has a key index then the private copy of the store shall have a copy of the key index. ]*/
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_key_index_copies_the_key_index)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        MAP_HANDLE clone;
+        MAP_RESULT result;
+        size_t i;
+        add_many_keys(handle, 8);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[i]) + 1));
         }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[i]) + 1));
+        }
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*this is creating a clone of the key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*deleted key*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*deleted value*/
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_Delete(clone, TEST_MANY_KEYS[0]);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, TEST_MANY_KEYS[0]));
+        for (i = 1; i < 8; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(clone, TEST_MANY_KEYS[i]));
+        }
+        for (i = 0; i < 8; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+        }
 
         ///cleanup
         Map_Destroy(handle);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_9)
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_fails_when_copying_the_key_index_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        MAP_HANDLE clone;
+        MAP_RESULT result;
+        size_t i;
+        add_many_keys(handle, 8);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")); /*now JSON is {"redkey":*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[i]) + 1));
+        }
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[i]) + 1));
         }
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))) /*this is creating a clone of the key index*/
+            .SetReturn(NULL);
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key*/
+            STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value*/
+        }
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        result = Map_Delete(clone, TEST_MANY_KEYS[0]);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[0], Map_GetValueFromKey(clone, TEST_MANY_KEYS[0]));
 
         ///cleanup
         Map_Destroy(handle);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_10)
+    /*Tests_SRS_MAP_11_006: [ Map_CreateWithCapacity shall create a new, empty map that can hold capacity pairs without growing its storage. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_succeeds)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        MAP_HANDLE handle;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
 
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)); /*now JSON is {"redkey"*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_ARG, ":")) /*now JSON is {"redkey":*/
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-        }
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*values*/
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        handle = Map_CreateWithCapacity(NULL, 4);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(handle);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 0, count);
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_11)
+    /*Tests_SRS_MAP_11_006: [ Map_CreateWithCapacity shall create a new, empty map that can hold capacity pairs without growing its storage. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_Add_up_to_capacity_does_not_grow_the_storage)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        MAP_HANDLE handle = Map_CreateWithCapacity(NULL, 4);
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        size_t i;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_ARG, IGNORED_ARG)) /*now JSON is {"redkey"*/
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        for (i = 0; i < 4; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[i]) + 1)); /*copy of the key*/
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[i]) + 1)); /*copy of the value*/
         }
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        add_many_keys(handle, 4);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 4, count);
+        for (i = 0; i < 4; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[i], keys[i]);
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], values[i]);
+        }
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_12)
+    /*Tests_SRS_MAP_11_007: [ If capacity is 0 then Map_CreateWithCapacity shall not allocate storage for keys and values. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_with_0_capacity_succeeds)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
+        MAP_HANDLE handle;
 
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")).SetReturn(NULL); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG)); /*delete the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        handle = Map_CreateWithCapacity(NULL, 0);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(handle);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_13)
+    /*Tests_SRS_MAP_11_008: [ If capacity is at least 8 then Map_CreateWithCapacity shall also create a key index that can hold capacity keys. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_with_8_capacity_creates_the_key_index)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"));
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey"))
-            .SetReturn(NULL); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_ARG));
+        MAP_HANDLE handle;
+        size_t i;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*key index*/
+        for (i = 0; i < 8; i++)
+        {
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[i]) + 1)); /*copy of the key*/
+            STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[i]) + 1)); /*copy of the value*/
+        }
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        handle = Map_CreateWithCapacity(NULL, 8);
+        add_many_keys(handle, 8);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(handle);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < 8; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+        }
 
         ///cleanup
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_14)
+    /*Tests_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_fails_when_malloc_fails)
     {
         ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
+        MAP_HANDLE handle;
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*handle*/
             .SetReturn(NULL);
 
         ///act
-        toJSON = Map_ToJSON(handle);
+        handle = Map_CreateWithCapacity(NULL, 8);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_fails_when_allocating_keys_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))) /*keys*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        handle = Map_CreateWithCapacity(NULL, 8);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_fails_when_allocating_values_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))) /*values*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        handle = Map_CreateWithCapacity(NULL, 8);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_009: [ If there are any failures then Map_CreateWithCapacity shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithCapacity_fails_when_creating_the_key_index_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(8, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))) /*key index*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        handle = Map_CreateWithCapacity(NULL, 8);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_010: [ When the storage is full, Map_Add and Map_AddOrUpdate shall double the capacity of keys and values. ]*/
+    TEST_FUNCTION(Map_Add_doubles_the_capacity_when_the_storage_is_full)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        add_many_keys(handle, 2);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 4, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 4, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[2]) + 1)); /*copy of the key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[2]) + 1)); /*copy of the value*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[3]) + 1)); /*copy of the key, no growing needed*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[3]) + 1)); /*copy of the value*/
+
+        ///act
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, TEST_MANY_KEYS[2], TEST_MANY_VALUES[2]));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, TEST_MANY_KEYS[3], TEST_MANY_VALUES[3]));
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_012: [ Map_Delete shall leave a tombstone in the place of the deleted pair and shall not shrink the storage. ]*/
+    TEST_FUNCTION(Map_Delete_does_not_shrink_the_storage)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        add_many_keys(handle, 4);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*freeing the key*/
+            .ValidateArgumentBuffer(1, TEST_MANY_KEYS[1], strlen(TEST_MANY_KEYS[1]) + 1);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*freeing the value*/
+            .ValidateArgumentBuffer(1, TEST_MANY_VALUES[1], strlen(TEST_MANY_VALUES[1]) + 1);
+
+        ///act
+        result = Map_Delete(handle, TEST_MANY_KEYS[1]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_MANY_KEYS[1]));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[3], Map_GetValueFromKey(handle, TEST_MANY_KEYS[3]));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 3, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[0], keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[2], keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[3], keys[2]);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_012: [ Map_Delete shall leave a tombstone in the place of the deleted pair and shall not shrink the storage. ]*/
+    TEST_FUNCTION(Map_ContainsValue_skips_deleted_pairs)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        bool exists1;
+        bool exists2;
+        add_many_keys(handle, 4);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(handle, TEST_MANY_KEYS[1]));
+        umock_c_reset_all_calls();
+
+        ///act
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[1], &exists1));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[3], &exists2));
+
+        ///assert
+        ASSERT_IS_FALSE(exists1);
+        ASSERT_IS_TRUE(exists2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_011: [ When the storage is full and at least a quarter of it holds tombstones, Map_Add and Map_AddOrUpdate shall compact the storage instead of growing it. ]*/
+    TEST_FUNCTION(Map_Add_reuses_the_slots_of_deleted_pairs)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        add_many_keys(handle, 4);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(handle, TEST_MANY_KEYS[1]));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[4]) + 1)); /*copy of the key, no growing*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[4]) + 1)); /*copy of the value*/
+
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[4], TEST_MANY_VALUES[4]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 4, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[0], keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[2], keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[3], keys[2]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_KEYS[4], keys[3]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[4], values[3]);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_013: [ When more than half of the used slots of the storage are tombstones, Map_Delete shall compact the storage. ]*/
+    /*Tests_SRS_MAP_11_005: [ Map_Delete shall leave the key index slot of the deleted key in place, probing for other keys shall continue past it. ]*/
+    TEST_FUNCTION(Map_Delete_of_most_keys_keeps_the_rest_reachable)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        size_t i;
+        add_many_keys(handle, TEST_MANY_COUNT);
+        umock_c_reset_all_calls();
+
+        for (i = 0; i < TEST_MANY_COUNT - 1; i++)
+        {
+            STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing the key*/
+            STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing the value*/
+        }
+
+        ///act
+        for (i = 0; i < TEST_MANY_COUNT - 1; i++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(handle, TEST_MANY_KEYS[i]));
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[TEST_MANY_COUNT - 1], Map_GetValueFromKey(handle, TEST_MANY_KEYS[TEST_MANY_COUNT - 1]));
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < TEST_MANY_COUNT - 1; i++)
+        {
+            ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_014: [ Map_GetInternals, Map_ToJSON and Map_Clone shall first compact the storage so that keys and values contain no tombstones. ]*/
+    TEST_FUNCTION(Map_ToJSON_skips_deleted_pairs)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        STRING_HANDLE toJSON;
+        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
+        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        (void)Map_Delete(handle, "redkey");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(1, sizeof("{\"yellowkey\":\"yellowdoor\"}") - 1, 1));
+        STRICT_EXPECTED_CALL(STRING_new_with_memory(IGNORED_ARG));
+
+        ///act
+        toJSON = Map_ToJSON(handle);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(toJSON);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "{\"yellowkey\":\"yellowdoor\"}", g_STRING_new_with_memory_memory);
+
+        ///cleanup
+        Map_Destroy(handle);
+        STRING_delete(toJSON);
+        real_gballoc_hl_free((void*)g_STRING_new_with_memory_memory);
+    }
+
+    /*Tests_SRS_MAP_11_014: [ Map_GetInternals, Map_ToJSON and Map_Clone shall first compact the storage so that keys and values contain no tombstones. ]*/
+    TEST_FUNCTION(Map_Clone_skips_deleted_pairs)
+    {
+        ///arrange
+        MAP_HANDLE result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_AddOrUpdate(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        (void)Map_Delete(handle, TEST_REDKEY);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the HANDLE structure*/
+
+        ///act
+        result = Map_Clone(handle);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)Map_GetInternals(result, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, values[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, values[1]);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(result);
+    }
+
+    /*Tests_SRS_MAP_11_015: [ If parameter handle is NULL then Map_EnableValueIndex shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_with_NULL_handle_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+
+        ///act
+        result = Map_EnableValueIndex(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_017: [ Otherwise, Map_EnableValueIndex shall build a value index: an open addressing hash table that maps values to their positions in the values array, and return MAP_OK. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        add_many_keys(handle, 4);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*value index*/
+
+        ///act
+        result = Map_EnableValueIndex(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_016: [ If the map already has a value index then Map_EnableValueIndex shall return MAP_OK. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_twice_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_EnableValueIndex(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_022: [ If there are any failures then Map_EnableValueIndex shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_fails_when_malloc_2_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool exists;
+        add_many_keys(handle, 4);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))) /*value index*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_EnableValueIndex(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[3], &exists));
+        ASSERT_IS_TRUE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_018: [ If the map has a value index then Map_ContainsValue shall locate the value by probing the value index. ]*/
+    TEST_FUNCTION(Map_ContainsValue_with_value_index_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        bool exists[TEST_MANY_COUNT];
+        bool existsNot;
+        size_t i;
+        add_many_keys(handle, 4);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        umock_c_reset_all_calls();
+
+        ///act
+        for (i = 0; i < 4; i++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[i], &exists[i]));
+        }
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[4], &existsNot));
+
+        ///assert
+        for (i = 0; i < 4; i++)
+        {
+            ASSERT_IS_TRUE(exists[i]);
+        }
+        ASSERT_IS_FALSE(existsNot);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_Add_with_value_index_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool exists;
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_REDVALUE, &exists));
+        ASSERT_IS_TRUE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_Add_grows_the_value_index_when_it_is_half_full)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        size_t i;
+        bool exists;
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        add_many_keys(handle, 8);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_2(32, sizeof(size_t))); /*new key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*old key index*/
+        STRICT_EXPECTED_CALL(malloc_2(64, sizeof(size_t))); /*new value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*old value index*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_KEYS[8]) + 1)); /*copy of the key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_MANY_VALUES[8]) + 1)); /*copy of the value*/
+
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[8], TEST_MANY_VALUES[8]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < 9; i++)
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[i], &exists));
+            ASSERT_IS_TRUE(exists);
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_Add_fails_when_growing_the_value_index_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool exists;
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        add_many_keys(handle, 8);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_2(32, sizeof(size_t))); /*new key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*old key index*/
+        STRICT_EXPECTED_CALL(malloc_2(64, sizeof(size_t))) /*new value index*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_Add(handle, TEST_MANY_KEYS[8], TEST_MANY_VALUES[8]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[8], &exists));
+        ASSERT_IS_FALSE(exists);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[7], &exists));
+        ASSERT_IS_TRUE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_with_value_index_replaces_the_value)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool existsOld;
+        bool existsNew;
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, 1, strlen(TEST_YELLOWVALUE), 1)); /*changing redkey value to yellow*/
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_REDVALUE, &existsOld));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_YELLOWVALUE, &existsNew));
+        ASSERT_IS_FALSE(existsOld);
+        ASSERT_IS_TRUE(existsNew);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_with_value_index_drops_stale_slots_without_allocating)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool exists;
+        size_t i;
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        for (i = 0; i < 7; i++) /*every update leaves a stale slot behind, this fills half of the value index*/
+        {
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddOrUpdate(handle, TEST_REDKEY, TEST_MANY_VALUES[i]));
+        }
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, 1, strlen(TEST_YELLOWVALUE), 1)); /*changing redkey value to yellow*/
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_YELLOWVALUE, &exists));
+        ASSERT_IS_TRUE(exists);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_MANY_VALUES[6], &exists));
+        ASSERT_IS_FALSE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_019: [ Map_Add and Map_AddOrUpdate shall add the new value to the value index. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_fails_when_growing_the_value_index_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        add_many_keys(handle, 8);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_2(64, sizeof(size_t))) /*new value index*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_MANY_KEYS[0], TEST_MANY_VALUES[9]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[0], Map_GetValueFromKey(handle, TEST_MANY_KEYS[0]));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_020: [ Map_Delete shall leave the value index slot of the deleted value in place, probing for other values shall continue past it. ]*/
+    TEST_FUNCTION(Map_Delete_with_value_index_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        MAP_RESULT result;
+        bool exists1;
+        bool exists2;
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_AddOrUpdate(handle, TEST_YELLOWKEY, TEST_REDVALUE); /*same value, different key*/
+        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing red key*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing red value*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing blue key*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*freeing blue value*/
+
+        ///act
+        result = Map_Delete(handle, TEST_REDKEY);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_REDVALUE, &exists1));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(handle, TEST_BLUEKEY));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_BLUEVALUE, &exists2));
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_IS_TRUE(exists1); /*yellow key still has it*/
+        ASSERT_IS_FALSE(exists2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_021: [ If the map has a value index then the private copy of the store shall have a copy of the value index. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_value_index_copies_the_value_index)
+    {
+        ///arrange
+        MAP_HANDLE clone;
+        MAP_RESULT result;
+        bool exists;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*this is creating a clone of the value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*RED key*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*RED value*/
+
+        ///act
+        result = Map_Delete(clone, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(clone, TEST_REDVALUE, &exists));
+        ASSERT_IS_FALSE(exists);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsValue(handle, TEST_REDVALUE, &exists));
+        ASSERT_IS_TRUE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_fails_when_copying_the_value_index_fails)
+    {
+        ///arrange
+        MAP_HANDLE clone;
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_EnableValueIndex(handle));
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))) /*this is creating a clone of the value index*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*RED key*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*RED value*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+
+        ///act
+        result = Map_Delete(clone, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_025: [ Map_Clone shall not copy the pairs of the map, the clone shall share the store of the map indicated by handle. ]*/
+    TEST_FUNCTION(Map_Clone_shares_the_keys_and_values_of_the_map)
+    {
+        ///arrange
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        const char*const* cloneKeys;
+        const char*const* cloneValues;
+        size_t cloneCount;
+        MAP_HANDLE clone;
+        MAP_HANDLE cloneOfClone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*clone*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*clone of the clone*/
+
+        ///act
+        clone = Map_Clone(handle);
+        cloneOfClone = Map_Clone(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(clone, &cloneKeys, &cloneValues, &cloneCount));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)keys, (void*)cloneKeys);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)values, (void*)cloneValues);
+        ASSERT_ARE_EQUAL(size_t, count, cloneCount);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(cloneOfClone, &cloneKeys, &cloneValues, &cloneCount));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)keys, (void*)cloneKeys);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)values, (void*)cloneValues);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        Map_Destroy(cloneOfClone);
+    }
+
+    /*Tests_SRS_MAP_11_024: [ Map_Destroy shall release the store of the map only if no clone of the map shares it. ]*/
+    TEST_FUNCTION(Map_Destroy_of_a_map_with_a_clone_keeps_the_store)
+    {
+        ///arrange
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        Map_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_024: [ Map_Destroy shall release the store of the map only if no clone of the map shares it. ]*/
+    TEST_FUNCTION(Map_Destroy_of_the_last_clone_releases_the_store)
+    {
+        ///arrange
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        Map_Destroy(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*free the red key*/
+            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*free the red value*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*clone*/
+
+        ///act
+        Map_Destroy(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_Add_on_a_clone_does_not_change_the_map)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of BLUE key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of BLUE value*/
+
+        ///act
+        result = Map_Add(clone, TEST_BLUEKEY, TEST_BLUEVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(clone, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_Add_on_a_clone_fails_when_copying_the_store_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*this is creating the private copy of the store*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_Add(clone, TEST_BLUEKEY, TEST_BLUEVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, TEST_BLUEKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_on_a_map_with_a_clone_does_not_change_the_clone)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, 1, strlen(TEST_YELLOWVALUE), 1)) /*changing the copy of redkey value to yellow*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_AddOrUpdate_on_a_map_with_a_clone_fails_when_copying_the_store_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*this is creating the private copy of the store*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_does_not_change_the_map)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a clone of BLUE value*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*free the copy of the red key*/
+            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)) /*free the copy of the red value*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
+
+        ///act
+        result = Map_Delete(clone, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(clone, TEST_BLUEKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(handle, TEST_BLUEKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_Delete_of_a_missing_key_on_a_clone_does_not_copy_the_store)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_Delete(clone, TEST_BLUEKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYNOTFOUND, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_Add_after_the_clone_is_destroyed_does_not_copy_the_store)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        Map_Destroy(Map_Clone(handle));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of BLUE key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of BLUE value*/
+
+        ///act
+        result = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_026: [ Before changing a map that shares its store with other maps, Map_Add, Map_AddOrUpdate, Map_Delete and Map_EnableValueIndex shall give the map a private copy of the store. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_on_a_clone_copies_the_store)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(malloc_2(1, sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(malloc_2(16, sizeof(size_t))); /*value index*/
+
+        ///act
+        result = Map_EnableValueIndex(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_022: [ If there are any failures then Map_EnableValueIndex shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_EnableValueIndex_on_a_clone_fails_when_copying_the_store_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*this is creating the private copy of the store*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_EnableValueIndex(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /* Map_CreateWithArena */
+
+    /*Tests_SRS_MAP_11_042: [ Map_CreateWithArena shall create a new, empty map like Map_CreateWithCapacity does, whose keys and values are stored in an arena of arenaSize bytes owned by the map. ]*/
+    TEST_FUNCTION(Map_CreateWithArena_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 64, 1)); /*arena*/
+
+        ///act
+        handle = Map_CreateWithArena(NULL, 4, 64);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 0, count);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_050: [ If arenaSize is 0 then Map_CreateWithArena shall not allocate the arena, the first key added allocates it. ]*/
+    TEST_FUNCTION(Map_CreateWithArena_with_0_arenaSize_does_not_allocate_the_arena)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+
+        ///act
+        handle = Map_CreateWithArena(NULL, 0, 0);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_049: [ If there are any failures then Map_CreateWithArena shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithArena_fails_when_malloc_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*handle*/
+            .SetReturn(NULL);
+
+        ///act
+        handle = Map_CreateWithArena(NULL, 4, 64);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_049: [ If there are any failures then Map_CreateWithArena shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithArena_fails_when_allocating_the_arena_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 64, 1)) /*arena*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        handle = Map_CreateWithArena(NULL, 4, 64);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_043: [ Map_Add and Map_AddOrUpdate shall copy the keys and values of a map created by Map_CreateWithArena into its arena instead of allocating them one by one. ]*/
+    TEST_FUNCTION(Map_Add_on_arena_map_does_not_allocate_keys_and_values)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 64);
+        size_t i;
+        umock_c_reset_all_calls();
+
+        ///act
+        add_many_keys(handle, 4);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < 4; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(handle, TEST_MANY_KEYS[i]));
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_044: [ When the arena has no room for a key or value, the map shall add a chunk of at least twice the size of the last chunk to the arena. ]*/
+    TEST_FUNCTION(Map_Add_on_arena_map_adds_a_chunk_when_the_arena_is_full)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 8);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 16, 1)); /*"key0" fits in the first chunk, "value0" does not*/
+
+        ///act
+        result = Map_Add(handle, "key0", "value0");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "value0", Map_GetValueFromKey(handle, "key0"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_050: [ If arenaSize is 0 then Map_CreateWithArena shall not allocate the arena, the first key added allocates it. ]*/
+    TEST_FUNCTION(Map_Add_on_arena_map_with_0_arenaSize_allocates_the_arena)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 0, 0);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 256, 1)); /*arena*/
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_Add_on_arena_map_fails_when_adding_a_chunk_for_the_key_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        bool exists;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 0);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 256, 1)) /*arena*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_REDKEY, &exists));
+        ASSERT_IS_FALSE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_Add_on_arena_map_fails_when_adding_a_chunk_for_the_value_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        bool exists;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 8);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 16, 1)) /*"key0" fits in the first chunk, "value0" does not*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_Add(handle, "key0", "value0");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, "key0", &exists));
+        ASSERT_IS_FALSE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_045: [ Map_Destroy shall free the chunks of the arena instead of freeing keys and values one by one. ]*/
+    TEST_FUNCTION(Map_Destroy_on_arena_map_frees_the_chunks)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 8);
+        (void)Map_Add(handle, "key0", "value0"); /*"key0" fits in the first chunk, "value0" goes in a second one*/
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*second chunk*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*first chunk*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        Map_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_048: [ Map_AddOrUpdate shall overwrite the value of a map created by Map_CreateWithArena in place when the new value is not longer than the old one. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_on_arena_map_overwrites_a_value_that_is_not_longer_in_place)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char* oldValue;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 64);
+        (void)Map_Add(handle, "redkey", "reddoor");
+        oldValue = Map_GetValueFromKey(handle, "redkey");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdate(handle, "redkey", "red");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_TRUE(oldValue == Map_GetValueFromKey(handle, "redkey"));
+        ASSERT_ARE_EQUAL(char_ptr, "red", Map_GetValueFromKey(handle, "redkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_043: [ Map_Add and Map_AddOrUpdate shall copy the keys and values of a map created by Map_CreateWithArena into its arena instead of allocating them one by one. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_on_arena_map_copies_a_longer_value_in_the_arena)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 64);
+        (void)Map_Add(handle, "redkey", "red");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdate(handle, "redkey", "reddoor");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "reddoor", Map_GetValueFromKey(handle, "redkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_AddOrUpdate_on_arena_map_fails_when_adding_a_chunk_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 16);
+        (void)Map_Add(handle, "redkey", "red");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 32, 1))
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_AddOrUpdate(handle, "redkey", "reddoor");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "red", Map_GetValueFromKey(handle, "redkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_046: [ Map_Delete and Map_AddOrUpdate shall not move the keys and values of a map created by Map_CreateWithArena, the bytes of the keys and values they release stay in the arena until Map_CompactArena is called. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_on_arena_map_does_not_move_the_other_pairs)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char* yellowValue;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", "b");
+        (void)Map_Add(handle, "yellowkey", "yellowdoor");
+        (void)Map_AddOrUpdate(handle, "a", longValue);
+        yellowValue = Map_GetValueFromKey(handle, "yellowkey");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdate(handle, "a", "c");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "c", Map_GetValueFromKey(handle, "a"));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)yellowValue, (void*)Map_GetValueFromKey(handle, "yellowkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_043: [ Map_Add and Map_AddOrUpdate shall copy the keys and values of a map created by Map_CreateWithArena into its arena instead of allocating them one by one. ]*/
+    TEST_FUNCTION(Map_Delete_on_arena_map_does_not_free_the_key_and_the_value)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 4, 64);
+        (void)Map_Add(handle, "redkey", "reddoor");
+        (void)Map_Add(handle, "yellowkey", "yellowdoor");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_Delete(handle, "redkey");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "redkey"));
+        ASSERT_ARE_EQUAL(char_ptr, "yellowdoor", Map_GetValueFromKey(handle, "yellowkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_046: [ Map_Delete and Map_AddOrUpdate shall not move the keys and values of a map created by Map_CreateWithArena, the bytes of the keys and values they release stay in the arena until Map_CompactArena is called. ]*/
+    TEST_FUNCTION(Map_Delete_on_arena_map_does_not_move_the_other_pairs)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char* value;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", longValue);
+        (void)Map_Add(handle, "b", "c");
+        value = Map_GetValueFromKey(handle, "b");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_Delete(handle, "a");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, (void*)value, (void*)Map_GetValueFromKey(handle, "b"));
+        ASSERT_ARE_EQUAL(char_ptr, "c", value);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_046: [ Map_Delete and Map_AddOrUpdate shall not move the keys and values of a map created by Map_CreateWithArena, the bytes of the keys and values they release stay in the arena until Map_CompactArena is called. ]*/
+    TEST_FUNCTION(Map_Delete_of_the_last_pair_of_arena_map_does_not_free_the_chunks)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 1, 0);
+        (void)Map_Add(handle, "a", "b");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_Delete(handle, "a");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_094: [ If parameter handle is NULL then Map_CompactArena shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_CompactArena_with_NULL_handle_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+
+        ///act
+        result = Map_CompactArena(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_095: [ If the map was not created by Map_CreateWithArena or if it shares its store with other maps then Map_CompactArena shall return MAP_OK without changing the map. ]*/
+    TEST_FUNCTION(Map_CompactArena_on_a_map_without_arena_does_nothing)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_Add(handle, "redkey", "reddoor");
+        (void)Map_Add(handle, "yellowkey", "yellowdoor");
+        (void)Map_Delete(handle, "redkey");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "yellowdoor", Map_GetValueFromKey(handle, "yellowkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_095: [ If the map was not created by Map_CreateWithArena or if it shares its store with other maps then Map_CompactArena shall return MAP_OK without changing the map. ]*/
+    TEST_FUNCTION(Map_CompactArena_on_a_map_that_shares_its_store_does_nothing)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        const char* value;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", longValue);
+        (void)Map_Add(handle, "b", "c");
+        (void)Map_Delete(handle, "a");
+        clone = Map_Clone(handle);
+        value = Map_GetValueFromKey(handle, "b");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, (void*)value, (void*)Map_GetValueFromKey(handle, "b"));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)value, (void*)Map_GetValueFromKey(clone, "b"));
+
+        ///cleanup
+        Map_Destroy(clone);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_096: [ Otherwise, if the arena holds bytes of deleted or overwritten keys and values, Map_CompactArena shall move the keys and values to a single new chunk with as much free room as they take and free the old chunks. ]*/
+    /*Tests_SRS_MAP_11_098: [ Map_CompactArena shall return MAP_OK. ]*/
+    TEST_FUNCTION(Map_CompactArena_without_garbage_does_nothing)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)Map_Add(handle, "a", "b");
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "b", Map_GetValueFromKey(handle, "a"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_096: [ Otherwise, if the arena holds bytes of deleted or overwritten keys and values, Map_CompactArena shall move the keys and values to a single new chunk with as much free room as they take and free the old chunks. ]*/
+    /*Tests_SRS_MAP_11_098: [ Map_CompactArena shall return MAP_OK. ]*/
+    TEST_FUNCTION(Map_CompactArena_moves_the_pairs_to_a_new_chunk)
+    {
+        ///arrange
+        MAP_RESULT result;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", longValue); /*"a" goes in a first chunk of 256 bytes, the value in a second one of 512 bytes*/
+        (void)Map_Add(handle, "b", "c");
+        (void)Map_Delete(handle, "a");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 8, 1)); /*"b" and "c" and as much free room*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*second chunk*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*first chunk*/
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "c", Map_GetValueFromKey(handle, "b"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_096: [ Otherwise, if the arena holds bytes of deleted or overwritten keys and values, Map_CompactArena shall move the keys and values to a single new chunk with as much free room as they take and free the old chunks. ]*/
+    TEST_FUNCTION(Map_CompactArena_after_the_last_pair_is_deleted_frees_the_chunks)
+    {
+        ///arrange
+        MAP_RESULT result;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 1, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", longValue);
+        (void)Map_Delete(handle, "a");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*second chunk*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*first chunk*/
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_097: [ If there are any failures then Map_CompactArena shall keep the old chunks and return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_CompactArena_keeps_the_chunks_when_allocating_the_new_chunk_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char* value;
+        char longValue[301];
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        (void)Map_Add(handle, "a", longValue);
+        (void)Map_Add(handle, "b", "c");
+        (void)Map_Delete(handle, "a");
+        value = Map_GetValueFromKey(handle, "b");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 8, 1))
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_CompactArena(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, (void*)value, (void*)Map_GetValueFromKey(handle, "b"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_047: [ The private copy of the store of a map created by Map_CreateWithArena shall have its keys and values copied in a single chunk. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_of_arena_map_copies_the_keys_and_values_in_a_single_chunk)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)Map_Add(handle, "redkey", "reddoor");
+        (void)Map_Add(handle, "yellowkey", "yellowdoor");
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof("redkey") + sizeof("reddoor") + sizeof("yellowkey") + sizeof("yellowdoor"), 1)); /*arena*/
+
+        ///act
+        result = Map_Delete(clone, "redkey");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, "redkey"));
+        ASSERT_ARE_EQUAL(char_ptr, "yellowdoor", Map_GetValueFromKey(clone, "yellowkey"));
+        ASSERT_ARE_EQUAL(char_ptr, "reddoor", Map_GetValueFromKey(handle, "redkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_of_arena_map_fails_when_allocating_the_chunk_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_CreateWithArena(NULL, 2, 0);
+        (void)Map_Add(handle, "redkey", "reddoor");
+        (void)Map_Add(handle, "yellowkey", "yellowdoor");
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, 1)) /*arena*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+
+        ///act
+        result = Map_Delete(clone, "redkey");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, "reddoor", Map_GetValueFromKey(clone, "redkey"));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_051: [ Map_CreateWithRcStrings shall create a new, empty map like Map_CreateWithCapacity does, whose keys and values are stored as THANDLE(RC_STRING). ]*/
+    /*Tests_SRS_MAP_11_052: [ If capacity is not 0 then Map_CreateWithRcStrings shall allocate room for capacity THANDLE(RC_STRING) keys and values. ]*/
+    TEST_FUNCTION(Map_CreateWithRcStrings_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 4, sizeof(THANDLE(RC_STRING)))); /*references to the keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 4, sizeof(THANDLE(RC_STRING)))); /*references to the values*/
+
+        ///act
+        handle = Map_CreateWithRcStrings(NULL, 4);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 0, count);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_052: [ If capacity is not 0 then Map_CreateWithRcStrings shall allocate room for capacity THANDLE(RC_STRING) keys and values. ]*/
+    TEST_FUNCTION(Map_CreateWithRcStrings_with_0_capacity_does_not_allocate_the_references)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+
+        ///act
+        handle = Map_CreateWithRcStrings(NULL, 0);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_053: [ If there are any failures then Map_CreateWithRcStrings shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithRcStrings_fails_when_malloc_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*handle*/
+            .SetReturn(NULL);
+
+        ///act
+        handle = Map_CreateWithRcStrings(NULL, 4);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_053: [ If there are any failures then Map_CreateWithRcStrings shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateWithRcStrings_fails_when_allocating_the_references_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(4, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 4, sizeof(THANDLE(RC_STRING)))) /*references to the keys*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*references to the keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*references to the values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        handle = Map_CreateWithRcStrings(NULL, 4);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_060: [ If parameter handle, key or value is NULL then Map_AddRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddRcString_with_NULL_handle_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddRcString(NULL, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_060: [ If parameter handle, key or value is NULL then Map_AddRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddRcString_with_NULL_key_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddRcString(handle, NULL, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_060: [ If parameter handle, key or value is NULL then Map_AddRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddRcString_with_NULL_value_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddRcString(handle, key, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_054: [ Map_AddRcString and Map_AddOrUpdateRcString shall store in a map created by Map_CreateWithRcStrings new references to key and value obtained by calling THANDLE_INITIALIZE(RC_STRING) instead of copying them. ]*/
+    /*Tests_SRS_MAP_11_061: [ Otherwise, Map_AddRcString shall behave like Map_Add called with the strings of key and value. ]*/
+    TEST_FUNCTION(Map_AddRcString_on_rc_string_map_stores_references)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, key));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, value));
+
+        ///act
+        result = Map_AddRcString(handle, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_TRUE(Map_GetValueFromKey(handle, TEST_REDKEY) == value->string);
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_02_009: [If the key already exists, then Map_Add shall return MAP_KEYEXISTS.] */
+    TEST_FUNCTION(Map_AddRcString_on_rc_string_map_with_an_existing_key_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_YELLOWVALUE);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddRcString(handle, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_061: [ Otherwise, Map_AddRcString shall behave like Map_Add called with the strings of key and value. ]*/
+    TEST_FUNCTION(Map_AddRcString_on_a_map_not_created_by_Map_CreateWithRcStrings_copies_the_strings)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
+
+        ///act
+        result = Map_AddRcString(handle, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_IS_TRUE(Map_GetValueFromKey(handle, TEST_REDKEY) != value->string);
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_055: [ Map_Add and Map_AddOrUpdate shall store in a map created by Map_CreateWithRcStrings the THANDLE(RC_STRING)s created by calling rc_string_create with key and value. ]*/
+    TEST_FUNCTION(Map_Add_on_rc_string_map_creates_rc_strings)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 0);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(THANDLE(RC_STRING)))); /*growing references to the keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(THANDLE(RC_STRING)))); /*growing references to the values*/
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDKEY));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDVALUE));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_Add_on_rc_string_map_fails_when_growing_the_references_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        bool exists;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 0);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(THANDLE(RC_STRING)))); /*growing references to the keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 1, sizeof(THANDLE(RC_STRING)))) /*growing references to the values*/
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_REDKEY, &exists));
+        ASSERT_IS_FALSE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_011: [If adding the pair <key,value> fails then Map_Add shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_Add_on_rc_string_map_fails_when_rc_string_create_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        bool exists;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDKEY));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDVALUE))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*the key*/
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_ContainsKey(handle, TEST_REDKEY, &exists));
+        ASSERT_IS_FALSE(exists);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_062: [ If parameter handle, key or value is NULL then Map_AddOrUpdateRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddOrUpdateRcString_with_NULL_handle_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdateRcString(NULL, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_062: [ If parameter handle, key or value is NULL then Map_AddOrUpdateRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddOrUpdateRcString_with_NULL_key_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdateRcString(handle, NULL, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_062: [ If parameter handle, key or value is NULL then Map_AddOrUpdateRcString shall return MAP_INVALIDARG. ]*/
+    TEST_FUNCTION(Map_AddOrUpdateRcString_with_NULL_value_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_AddOrUpdateRcString(handle, key, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_054: [ Map_AddRcString and Map_AddOrUpdateRcString shall store in a map created by Map_CreateWithRcStrings new references to key and value obtained by calling THANDLE_INITIALIZE(RC_STRING) instead of copying them. ]*/
+    /*Tests_SRS_MAP_11_063: [ Otherwise, Map_AddOrUpdateRcString shall behave like Map_AddOrUpdate called with the strings of key and value. ]*/
+    TEST_FUNCTION(Map_AddOrUpdateRcString_on_rc_string_map_adds_references_to_a_new_key)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, key));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, value));
+
+        ///act
+        result = Map_AddOrUpdateRcString(handle, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_TRUE(Map_GetValueFromKey(handle, TEST_REDKEY) == value->string);
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_057: [ Map_AddOrUpdate and Map_AddOrUpdateRcString shall release the reference to the value they overwrite in a map created by Map_CreateWithRcStrings by calling THANDLE_MOVE(RC_STRING). ]*/
+    TEST_FUNCTION(Map_AddOrUpdateRcString_on_rc_string_map_replaces_the_reference_to_the_value)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_YELLOWVALUE);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, value));
+        STRICT_EXPECTED_CALL(THANDLE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG)); /*releases the old value*/
+
+        ///act
+        result = Map_AddOrUpdateRcString(handle, key, value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_TRUE(Map_GetValueFromKey(handle, TEST_REDKEY) == value->string);
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_055: [ Map_Add and Map_AddOrUpdate shall store in a map created by Map_CreateWithRcStrings the THANDLE(RC_STRING)s created by calling rc_string_create with key and value. ]*/
+    /*Tests_SRS_MAP_11_057: [ Map_AddOrUpdate and Map_AddOrUpdateRcString shall release the reference to the value they overwrite in a map created by Map_CreateWithRcStrings by calling THANDLE_MOVE(RC_STRING). ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_on_rc_string_map_replaces_the_value_with_a_new_rc_string)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_YELLOWVALUE));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(THANDLE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG)); /*releases the old value*/
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_018: [If there are any failures then Map_AddOrUpdate shall return MAP_ERROR.] */
+    TEST_FUNCTION(Map_AddOrUpdate_on_rc_string_map_fails_when_rc_string_create_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_YELLOWVALUE))
+            .SetReturn(NULL);
+
+        ///act
+        result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_056: [ Map_Delete shall release the references to the key and value it deletes from a map created by Map_CreateWithRcStrings by calling THANDLE_ASSIGN(RC_STRING) with NULL. ]*/
+    TEST_FUNCTION(Map_Delete_on_rc_string_map_releases_the_references)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*the key*/
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*the value*/
+
+        ///act
+        result = Map_Delete(handle, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(handle, TEST_YELLOWKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_059: [ Map_Destroy shall release the references to the keys and values of a map created by Map_CreateWithRcStrings by calling THANDLE_ASSIGN(RC_STRING) with NULL. ]*/
+    TEST_FUNCTION(Map_Destroy_on_rc_string_map_releases_the_references)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*the key*/
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*the value*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*references to the keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*references to the values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        Map_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_058: [ The private copy of the store of a map created by Map_CreateWithRcStrings shall take new references to the keys and values of the shared store by calling THANDLE_INITIALIZE(RC_STRING) instead of copying them. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_of_rc_string_map_takes_references_to_the_keys_and_values)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 2);
+        THANDLE(RC_STRING) redKey = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) redValue = real_rc_string_create(TEST_REDVALUE);
+        THANDLE(RC_STRING) yellowKey = real_rc_string_create(TEST_YELLOWKEY);
+        THANDLE(RC_STRING) yellowValue = real_rc_string_create(TEST_YELLOWVALUE);
+        (void)Map_AddRcString(handle, redKey, redValue);
+        (void)Map_AddRcString(handle, yellowKey, yellowValue);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 2, sizeof(THANDLE(RC_STRING)))); /*references to the keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 2, sizeof(THANDLE(RC_STRING)))); /*references to the values*/
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, redKey));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, redValue));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, yellowKey));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, yellowValue));
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*red key of the clone*/
+        STRICT_EXPECTED_CALL(THANDLE_ASSIGN(RC_STRING)(IGNORED_ARG, NULL)); /*red value of the clone*/
+
+        ///act
+        result = Map_Delete(clone, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, TEST_REDKEY));
+        ASSERT_IS_TRUE(Map_GetValueFromKey(clone, TEST_YELLOWKEY) == yellowValue->string);
+        ASSERT_IS_TRUE(Map_GetValueFromKey(handle, TEST_REDKEY) == redValue->string);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        THANDLE_ASSIGN(real_RC_STRING)(&redKey, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&redValue, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&yellowKey, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&yellowValue, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_027: [ If giving the map a private copy of the store fails then Map_Delete shall return MAP_ERROR. ]*/
+    TEST_FUNCTION(Map_Delete_on_a_clone_of_rc_string_map_fails_when_allocating_the_references_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 2);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*this is creating the private copy of the store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 2, sizeof(THANDLE(RC_STRING)))); /*references to the keys*/
+        STRICT_EXPECTED_CALL(realloc_2(NULL, 2, sizeof(THANDLE(RC_STRING)))) /*references to the values*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*references to the keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+
+        ///act
+        result = Map_Delete(clone, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    /*Tests_SRS_MAP_11_064: [ If parameter handle or key is NULL then Map_GetRcStringFromKey shall return NULL. ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_with_NULL_handle_returns_NULL)
+    {
+        ///arrange
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(NULL, TEST_REDKEY);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_064: [ If parameter handle or key is NULL then Map_GetRcStringFromKey shall return NULL. ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_with_NULL_key_returns_NULL)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        umock_c_reset_all_calls();
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(handle, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_065: [ If the key is not found, then Map_GetRcStringFromKey shall return NULL. ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_with_a_missing_key_returns_NULL)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(handle, TEST_YELLOWKEY);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_066: [ If the map was created by Map_CreateWithRcStrings then Map_GetRcStringFromKey shall return a new reference to the stored value obtained by calling THANDLE_INITIALIZE(RC_STRING). ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_on_rc_string_map_returns_a_reference_to_the_value)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 4);
+        THANDLE(RC_STRING) key = real_rc_string_create(TEST_REDKEY);
+        THANDLE(RC_STRING) value = real_rc_string_create(TEST_REDVALUE);
+        (void)Map_AddRcString(handle, key, value);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(RC_STRING)(IGNORED_ARG, value));
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(handle, TEST_REDKEY);
+
+        ///assert
+        ASSERT_IS_TRUE(result == value);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        THANDLE_ASSIGN(real_RC_STRING)(&result, NULL);
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&key, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&value, NULL);
+    }
+
+    /*Tests_SRS_MAP_11_067: [ Otherwise, Map_GetRcStringFromKey shall return the THANDLE(RC_STRING) created by calling rc_string_create with the key's value. ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_on_a_map_not_created_by_Map_CreateWithRcStrings_returns_a_copy_of_the_value)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDVALUE));
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(handle, TEST_REDKEY);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, result->string);
+
+        ///cleanup
+        THANDLE_ASSIGN(real_RC_STRING)(&result, NULL);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_068: [ If rc_string_create fails then Map_GetRcStringFromKey shall return NULL. ]*/
+    TEST_FUNCTION(Map_GetRcStringFromKey_fails_when_rc_string_create_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(rc_string_create(TEST_REDVALUE))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(RC_STRING)(IGNORED_ARG, IGNORED_ARG));
+
+        ///act
+        THANDLE(RC_STRING) result = Map_GetRcStringFromKey(handle, TEST_REDKEY);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /* Map_ToBuffer */
+
+    /*Tests_SRS_MAP_11_069: [ If handle is NULL or serializedSize is NULL then Map_ToBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToBuffer_with_NULL_handle_fails)
+    {
+        ///arrange
+        uint32_t serializedSize;
+
+        ///act
+        unsigned char* result = Map_ToBuffer(NULL, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_069: [ If handle is NULL or serializedSize is NULL then Map_ToBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToBuffer_with_NULL_serializedSize_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        umock_c_reset_all_calls();
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_070: [ If alloc is NULL then Map_ToBuffer shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+    /*Tests_SRS_MAP_11_072: [ Map_ToBuffer shall allocate memory for the complete serialization once, by calling alloc. ]*/
+    /*Tests_SRS_MAP_11_073: [ Map_ToBuffer shall write at offset 0 the version of the serialization (currently 1). ]*/
+    /*Tests_SRS_MAP_11_074: [ Map_ToBuffer shall write at offset 1 the number of pairs in network byte order. ]*/
+    /*Tests_SRS_MAP_11_075: [ Starting at offset 5, Map_ToBuffer shall write for every pair, in the order of Map_GetInternals, the length of the key in network byte order, the key without its null terminator, the length of the value in network byte order and the value without its null terminator. ]*/
+    /*Tests_SRS_MAP_11_076: [ Map_ToBuffer shall succeed, write in *serializedSize the size of the serialization and return the allocated memory. ]*/
+    TEST_FUNCTION(Map_ToBuffer_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(sizeof(TEST_SERIALIZED_RED_YELLOW)));
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint32_t, sizeof(TEST_SERIALIZED_RED_YELLOW), serializedSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(TEST_SERIALIZED_RED_YELLOW, result, sizeof(TEST_SERIALIZED_RED_YELLOW)));
+
+        ///cleanup
+        free(result);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_072: [ Map_ToBuffer shall allocate memory for the complete serialization once, by calling alloc. ]*/
+    TEST_FUNCTION(Map_ToBuffer_calls_alloc)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, test_alloc, (void*)0x42, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(size_t, sizeof(TEST_SERIALIZED_RED_YELLOW), g_test_alloc_size);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)0x42, g_test_alloc_context);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(TEST_SERIALIZED_RED_YELLOW, result, sizeof(TEST_SERIALIZED_RED_YELLOW)));
+
+        ///cleanup
+        real_gballoc_hl_free(result);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_073: [ Map_ToBuffer shall write at offset 0 the version of the serialization (currently 1). ]*/
+    /*Tests_SRS_MAP_11_074: [ Map_ToBuffer shall write at offset 1 the number of pairs in network byte order. ]*/
+    TEST_FUNCTION(Map_ToBuffer_with_empty_map_succeeds)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        uint8_t version;
+        uint32_t count;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(MAP_MIN_SERIALIZATION_SIZE));
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint32_t, MAP_MIN_SERIALIZATION_SIZE, serializedSize);
+        read_uint8_t(result + MAP_VERSION_OFFSET, &version);
+        ASSERT_ARE_EQUAL(uint8_t, MAP_VERSION_V1, version);
+        read_uint32_t(result + MAP_COUNT_OFFSET, &count);
+        ASSERT_ARE_EQUAL(uint32_t, 0, count);
+
+        ///cleanup
+        free(result);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_075: [ Starting at offset 5, Map_ToBuffer shall write for every pair, in the order of Map_GetInternals, the length of the key in network byte order, the key without its null terminator, the length of the value in network byte order and the value without its null terminator. ]*/
+    TEST_FUNCTION(Map_ToBuffer_skips_deleted_pairs)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        (void)Map_Add(handle, TEST_GREENKEY, TEST_GREENVALUE);
+        (void)Map_Delete(handle, TEST_BLUEKEY); /*leaves a tombstone*/
+        (void)Map_Delete(handle, TEST_GREENKEY);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(sizeof(TEST_SERIALIZED_RED_YELLOW)));
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint32_t, sizeof(TEST_SERIALIZED_RED_YELLOW), serializedSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(TEST_SERIALIZED_RED_YELLOW, result, sizeof(TEST_SERIALIZED_RED_YELLOW)));
+
+        ///cleanup
+        free(result);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_077: [ If there are any failures then Map_ToBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToBuffer_fails_when_malloc_fails)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+            .SetReturn(NULL);
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_071: [ If the serialization of the map would be larger than UINT32_MAX bytes then Map_ToBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToBuffer_fails_when_a_pair_takes_the_size_just_past_UINT32_MAX)
+    {
+        ///arrange
+        const uint32_t bigValueLength = 64 * 1024 * 1024;
+        char* bigValue = real_gballoc_hl_malloc(bigValueLength + 1);
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 0);
+        uint32_t serializedSize;
+        THANDLE(RC_STRING) rcKey = real_rc_string_create("z");
+        THANDLE(RC_STRING) rcValue = real_rc_string_create("");
+        ASSERT_IS_NOT_NULL(bigValue);
+        (void)memset(bigValue, 'x', bigValueLength);
+        bigValue[bigValueLength] = '\0';
+        /*less than MAP_MIN_PAIR_SIZE short of UINT32_MAX, then one more pair of 9 bytes*/
+        test_fill_serialization(handle, bigValue, bigValueLength, (uint64_t)UINT32_MAX - 3);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_AddRcString(handle, rcKey, rcValue));
+        umock_c_reset_all_calls();
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        THANDLE_ASSIGN(real_RC_STRING)(&rcKey, NULL);
+        THANDLE_ASSIGN(real_RC_STRING)(&rcValue, NULL);
+        real_gballoc_hl_free(bigValue);
+    }
+
+    /*Tests_SRS_MAP_11_071: [ If the serialization of the map would be larger than UINT32_MAX bytes then Map_ToBuffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_ToBuffer_fails_when_the_size_is_UINT32_MAX_plus_1)
+    {
+        ///arrange
+        const uint32_t bigValueLength = 64 * 1024 * 1024;
+        char* bigValue = real_gballoc_hl_malloc(bigValueLength + 1);
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 0);
+        uint32_t serializedSize;
+        ASSERT_IS_NOT_NULL(bigValue);
+        (void)memset(bigValue, 'x', bigValueLength);
+        bigValue[bigValueLength] = '\0';
+        test_fill_serialization(handle, bigValue, bigValueLength, (uint64_t)UINT32_MAX + 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        unsigned char* result = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        real_gballoc_hl_free(bigValue);
+    }
+
+    /* Map_FromBuffer */
+
+    /*Tests_SRS_MAP_11_078: [ If source, consumed or destination is NULL then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_NULL_source_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(NULL, sizeof(TEST_SERIALIZED_RED_YELLOW), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_078: [ If source, consumed or destination is NULL then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_NULL_consumed_fails)
+    {
+        ///arrange
+        MAP_HANDLE destination;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW), NULL, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_078: [ If source, consumed or destination is NULL then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_NULL_destination_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW), &consumed, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_079: [ If size is less than sizeof(uint8_t) + sizeof(uint32_t) then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_size_less_than_the_header_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, MAP_MIN_SERIALIZATION_SIZE - 1, &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_080: [ If the byte at offset 0 of source is not 1 (current version) then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_unknown_version_fails)
+    {
+        ///arrange
+        unsigned char source[sizeof(TEST_SERIALIZED_RED_YELLOW)];
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        (void)memcpy(source, TEST_SERIALIZED_RED_YELLOW, sizeof(source));
+        source[MAP_VERSION_OFFSET] = MAP_VERSION_V1 + 1;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_a_count_that_cannot_fit_fails)
+    {
+        ///arrange
+        unsigned char source[sizeof(TEST_SERIALIZED_RED_YELLOW)];
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        (void)memcpy(source, TEST_SERIALIZED_RED_YELLOW, sizeof(source));
+        write_uint32_t(source + MAP_COUNT_OFFSET, UINT32_MAX);
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_a_key_past_size_fails)
+    {
+        ///arrange
+        unsigned char source[sizeof(TEST_SERIALIZED_RED_YELLOW)];
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        (void)memcpy(source, TEST_SERIALIZED_RED_YELLOW, sizeof(source));
+        write_uint32_t(source + MAP_PAIRS_OFFSET, sizeof(source));
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_the_last_value_cut_short_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW) - 1, &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_082: [ If the remaining bytes of source cannot hold the lengths of all the pairs, a key or a value extends past size or a key or a value contains a null character then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_a_null_character_in_a_value_fails)
+    {
+        ///arrange
+        unsigned char source[sizeof(TEST_SERIALIZED_RED_YELLOW)];
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        (void)memcpy(source, TEST_SERIALIZED_RED_YELLOW, sizeof(source));
+        source[sizeof(source) - 1] = '\0';
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_081: [ Map_FromBuffer shall read the number of pairs from offset 1 of source. ]*/
+    /*Tests_SRS_MAP_11_083: [ Map_FromBuffer shall create the map by calling Map_CreateWithArena with no filter, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    /*Tests_SRS_MAP_11_084: [ Map_FromBuffer shall copy the keys and values in the arena, adding their null terminators, without allocating memory. ]*/
+    /*Tests_SRS_MAP_11_087: [ Map_FromBuffer shall succeed, write in *consumed the number of bytes of the serialization, write in *destination the map and return MAP_FROM_BUFFER_RESULT_OK. ]*/
+    TEST_FUNCTION(Map_FromBuffer_succeeds)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_SERIALIZED_RED_YELLOW_STRINGS_SIZE, 1)); /*arena*/
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint32_t, sizeof(TEST_SERIALIZED_RED_YELLOW), consumed);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(destination, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWKEY, keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, values[1]);
+
+        ///cleanup
+        Map_Destroy(destination);
+    }
+
+    /*Tests_SRS_MAP_11_087: [ Map_FromBuffer shall succeed, write in *consumed the number of bytes of the serialization, write in *destination the map and return MAP_FROM_BUFFER_RESULT_OK. ]*/
+    TEST_FUNCTION(Map_FromBuffer_does_not_consume_the_bytes_after_the_serialization)
+    {
+        ///arrange
+        unsigned char source[sizeof(TEST_SERIALIZED_RED_YELLOW) + 3];
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        (void)memcpy(source, TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW));
+        (void)memset(source + sizeof(TEST_SERIALIZED_RED_YELLOW), 0xFF, 3);
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, result);
+        ASSERT_ARE_EQUAL(uint32_t, sizeof(TEST_SERIALIZED_RED_YELLOW), consumed);
+
+        ///cleanup
+        Map_Destroy(destination);
+    }
+
+    /*Tests_SRS_MAP_11_083: [ Map_FromBuffer shall create the map by calling Map_CreateWithArena with no filter, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_empty_map_succeeds)
+    {
+        ///arrange
+        unsigned char source[MAP_MIN_SERIALIZATION_SIZE] = { MAP_VERSION_V1, 0, 0, 0, 0 };
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint32_t, MAP_MIN_SERIALIZATION_SIZE, consumed);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(destination, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 0, count);
+
+        ///cleanup
+        Map_Destroy(destination);
+    }
+
+    /*Tests_SRS_MAP_11_083: [ Map_FromBuffer shall create the map by calling Map_CreateWithArena with no filter, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    /*Tests_SRS_MAP_11_084: [ Map_FromBuffer shall copy the keys and values in the arena, adding their null terminators, without allocating memory. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_many_pairs_builds_the_key_index)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_Create(NULL);
+        uint32_t serializedSize;
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        size_t stringsSize = 0;
+        size_t i;
+        add_many_keys(handle, TEST_MANY_COUNT);
+        unsigned char* source = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+        ASSERT_IS_NOT_NULL(source);
+        for (i = 0; i < TEST_MANY_COUNT; i++)
+        {
+            stringsSize += strlen(TEST_MANY_KEYS[i]) + 1 + strlen(TEST_MANY_VALUES[i]) + 1;
+        }
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(TEST_MANY_COUNT, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(TEST_MANY_COUNT, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_2(32, sizeof(size_t))); /*key index*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, stringsSize, 1)); /*arena*/
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, serializedSize, &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < TEST_MANY_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(destination, TEST_MANY_KEYS[i]));
+        }
+
+        ///cleanup
+        Map_Destroy(destination);
+        free(source);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_11_085: [ If a key appears more than once then Map_FromBuffer shall destroy the map and return MAP_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+    TEST_FUNCTION(Map_FromBuffer_with_a_repeated_key_fails)
+    {
+        ///arrange
+        static const unsigned char source[] =
+        {
+            MAP_VERSION_V1,
+            0, 0, 0, 2,
+            0, 0, 0, 1, 'a',
+            0, 0, 0, 1, 'b',
+            0, 0, 0, 1, 'a',
+            0, 0, 0, 1, 'c'
+        };
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 8, 1)); /*arena*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*arena*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, sizeof(source), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_086: [ If there are any failures then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_ERROR. ]*/
+    TEST_FUNCTION(Map_FromBuffer_fails_when_allocating_the_arena_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_SERIALIZED_RED_YELLOW_STRINGS_SIZE, 1)) /*arena*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_086: [ If there are any failures then Map_FromBuffer shall fail and return MAP_FROM_BUFFER_RESULT_ERROR. ]*/
+    TEST_FUNCTION(Map_FromBuffer_fails_when_malloc_fails)
+    {
+        ///arrange
+        uint32_t consumed;
+        MAP_HANDLE destination;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*handle*/
+            .SetReturn(NULL);
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(TEST_SERIALIZED_RED_YELLOW, sizeof(TEST_SERIALIZED_RED_YELLOW), &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_075: [ Starting at offset 5, Map_ToBuffer shall write for every pair, in the order of Map_GetInternals, the length of the key in network byte order, the key without its null terminator, the length of the value in network byte order and the value without its null terminator. ]*/
+    /*Tests_SRS_MAP_11_087: [ Map_FromBuffer shall succeed, write in *consumed the number of bytes of the serialization, write in *destination the map and return MAP_FROM_BUFFER_RESULT_OK. ]*/
+    TEST_FUNCTION(Map_FromBuffer_of_Map_ToBuffer_of_rc_string_map_has_the_same_pairs)
+    {
+        ///arrange
+        MAP_HANDLE handle = Map_CreateWithRcStrings(NULL, 0);
+        uint32_t serializedSize;
+        uint32_t consumed;
+        MAP_HANDLE destination;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        (void)Map_Add(handle, "", "");
+        unsigned char* source = Map_ToBuffer(handle, NULL, NULL, &serializedSize);
+        ASSERT_IS_NOT_NULL(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        MAP_FROM_BUFFER_RESULT result = Map_FromBuffer(source, serializedSize, &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_FROM_BUFFER_RESULT, MAP_FROM_BUFFER_RESULT_OK, result);
+        ASSERT_ARE_EQUAL(uint32_t, serializedSize, consumed);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(destination, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 3, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, values[1]);
+        ASSERT_ARE_EQUAL(char_ptr, "", keys[2]);
+        ASSERT_ARE_EQUAL(char_ptr, "", values[2]);
 
         ///cleanup
+        Map_Destroy(destination);
+        free(source);
         Map_Destroy(handle);
     }
 
+    /* Map_CreateFromArrays */
+
+    /*Tests_SRS_MAP_11_088: [ If count is not 0 and keys or values is NULL then Map_CreateFromArrays shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_NULL_keys_fails)
+    {
+        ///arrange
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, NULL, TEST_MANY_VALUES, TEST_MANY_COUNT);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_088: [ If count is not 0 and keys or values is NULL then Map_CreateFromArrays shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_NULL_values_fails)
+    {
+        ///arrange
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, TEST_MANY_KEYS, NULL, TEST_MANY_COUNT);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_090: [ Map_CreateFromArrays shall create the map by calling Map_CreateWithArena with mapFilterFunc, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_0_count_creates_an_empty_map)
+    {
+        ///arrange
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, NULL, NULL, 0);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(result, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, 0, count);
+
+        ///cleanup
+        Map_Destroy(result);
+    }
+
+    /*Tests_SRS_MAP_11_089: [ Before allocating any memory, Map_CreateFromArrays shall fail and return NULL if any key or value is NULL or if mapFilterFunc is not NULL and returns non-zero for any pair. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_a_NULL_key_fails)
+    {
+        ///arrange
+        const char* keys[] = { TEST_REDKEY, NULL };
+        const char* values[] = { TEST_REDVALUE, TEST_YELLOWVALUE };
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_089: [ Before allocating any memory, Map_CreateFromArrays shall fail and return NULL if any key or value is NULL or if mapFilterFunc is not NULL and returns non-zero for any pair. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_a_NULL_value_fails)
+    {
+        ///arrange
+        const char* keys[] = { TEST_REDKEY, TEST_YELLOWKEY };
+        const char* values[] = { TEST_REDVALUE, NULL };
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_089: [ Before allocating any memory, Map_CreateFromArrays shall fail and return NULL if any key or value is NULL or if mapFilterFunc is not NULL and returns non-zero for any pair. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_fails_when_the_filter_rejects_a_pair)
+    {
+        ///arrange
+        const char* keys[] = { TEST_GREENKEY, TEST_REDKEY };
+        const char* values[] = { TEST_GREENVALUE, TEST_REDVALUE };
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(DontAllowCapitalsFilters, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_090: [ Map_CreateFromArrays shall create the map by calling Map_CreateWithArena with mapFilterFunc, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    /*Tests_SRS_MAP_11_091: [ Map_CreateFromArrays shall copy the keys and values in the arena and add them to the map in the order of the arrays, without allocating memory. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_succeeds)
+    {
+        ///arrange
+        const char* keys[] = { TEST_REDKEY, TEST_YELLOWKEY };
+        const char* values[] = { TEST_REDVALUE, TEST_YELLOWVALUE };
+        const char*const* mapKeys;
+        const char*const* mapValues;
+        size_t count;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_SERIALIZED_RED_YELLOW_STRINGS_SIZE, 1)); /*arena*/
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(result, &mapKeys, &mapValues, &count));
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, mapKeys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, mapValues[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWKEY, mapKeys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, mapValues[1]);
+
+        ///cleanup
+        Map_Destroy(result);
+    }
+
+    /*Tests_SRS_MAP_11_090: [ Map_CreateFromArrays shall create the map by calling Map_CreateWithArena with mapFilterFunc, count as capacity and the size of all the keys and values with their null terminators as arena size. ]*/
+    /*Tests_SRS_MAP_11_091: [ Map_CreateFromArrays shall copy the keys and values in the arena and add them to the map in the order of the arrays, without allocating memory. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_many_pairs_and_a_filter_succeeds)
+    {
+        ///arrange
+        size_t stringsSize = 0;
+        size_t i;
+        for (i = 0; i < TEST_MANY_COUNT; i++)
+        {
+            stringsSize += strlen(TEST_MANY_KEYS[i]) + 1 + strlen(TEST_MANY_VALUES[i]) + 1;
+        }
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(TEST_MANY_COUNT, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(TEST_MANY_COUNT, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_2(32, sizeof(size_t))); /*key index*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, stringsSize, 1)); /*arena*/
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(DontAllowCapitalsFilters, TEST_MANY_KEYS, TEST_MANY_VALUES, TEST_MANY_COUNT);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        for (i = 0; i < TEST_MANY_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(char_ptr, TEST_MANY_VALUES[i], Map_GetValueFromKey(result, TEST_MANY_KEYS[i]));
+        }
+        /*the map keeps the filter*/
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_FILTER_REJECT, Map_Add(result, TEST_REDKEY, TEST_REDVALUE));
+
+        ///cleanup
+        Map_Destroy(result);
+    }
+
+    /*Tests_SRS_MAP_11_092: [ If a key appears more than once then Map_CreateFromArrays shall destroy the map and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_a_repeated_key_fails)
+    {
+        ///arrange
+        const char* keys[] = { "a", "b", "a" };
+        const char* values[] = { "x", "y", "z" };
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(3, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(3, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 12, 1)); /*arena*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*arena*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 3);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_092: [ If a key appears more than once then Map_CreateFromArrays shall destroy the map and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_with_a_repeated_key_and_a_key_index_fails)
+    {
+        ///arrange
+        const char* keys[TEST_MANY_COUNT + 1];
+        const char* values[TEST_MANY_COUNT + 1];
+        (void)memcpy((void*)keys, TEST_MANY_KEYS, sizeof(TEST_MANY_KEYS));
+        (void)memcpy((void*)values, TEST_MANY_VALUES, sizeof(TEST_MANY_VALUES));
+        keys[TEST_MANY_COUNT] = TEST_MANY_KEYS[3];
+        values[TEST_MANY_COUNT] = TEST_MANY_VALUES[0];
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, TEST_MANY_COUNT + 1);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+    }
+
+    /*Tests_SRS_MAP_11_093: [ If there are any failures then Map_CreateFromArrays shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_fails_when_malloc_fails)
+    {
+        ///arrange
+        const char* keys[] = { TEST_REDKEY, TEST_YELLOWKEY };
+        const char* values[] = { TEST_REDVALUE, TEST_YELLOWVALUE };
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*handle*/
+            .SetReturn(NULL);
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_MAP_11_093: [ If there are any failures then Map_CreateFromArrays shall fail and return NULL. ]*/
+    TEST_FUNCTION(Map_CreateFromArrays_fails_when_allocating_the_arena_fails)
+    {
+        ///arrange
+        const char* keys[] = { TEST_REDKEY, TEST_YELLOWKEY };
+        const char* values[] = { TEST_REDVALUE, TEST_YELLOWVALUE };
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*handle*/
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*keys*/
+        STRICT_EXPECTED_CALL(malloc_2(2, sizeof(char*))); /*values*/
+        STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_SERIALIZED_RED_YELLOW_STRINGS_SIZE, 1)) /*arena*/
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*keys*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*values*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*key index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*value index*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*store*/
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*handle*/
+
+        ///act
+        MAP_HANDLE result = Map_CreateFromArrays(NULL, keys, values, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -23,15 +23,43 @@
         CONSTBUFFER_CreateWithMoveMemory, \
         CONSTBUFFER_CreateWithCustomFree, \
         CONSTBUFFER_CreateFromOffsetAndSizeWithCopy, \
+        CONSTBUFFER_CreateWithAlignment, \
+        CONSTBUFFER_CreateWritableHandle, \
+        CONSTBUFFER_GetWritableBuffer, \
+        CONSTBUFFER_GetWritableBufferCapacity, \
+        CONSTBUFFER_GetWritableBufferSize, \
+        CONSTBUFFER_SetWritableBufferSize, \
+        CONSTBUFFER_AppendToWritableBuffer, \
+        CONSTBUFFER_SealWritableHandle, \
+        CONSTBUFFER_DestroyWritableHandle, \
         CONSTBUFFER_IncRef, \
         CONSTBUFFER_GetContent, \
         CONSTBUFFER_DecRef, \
         CONSTBUFFER_HANDLE_contain_same, \
+        CONSTBUFFER_get_content_hash, \
         CONSTBUFFER_CreateFromOffsetAndSize, \
         CONSTBUFFER_get_serialization_size, \
         CONSTBUFFER_to_buffer, \
         CONSTBUFFER_to_fixed_size_buffer, \
-        CONSTBUFFER_from_buffer \
+        CONSTBUFFER_get_serialization_size_v2, \
+        CONSTBUFFER_to_buffer_v2, \
+        CONSTBUFFER_to_fixed_size_buffer_v2, \
+        CONSTBUFFER_from_buffer, \
+        CONSTBUFFER_from_buffer_no_copy, \
+        CONSTBUFFER_to_segments, \
+        CONSTBUFFER_header_pool_init, \
+        CONSTBUFFER_header_pool_deinit, \
+        CONSTBUFFER_LARGE_Create, \
+        CONSTBUFFER_LARGE_CreateWithMoveMemory, \
+        CONSTBUFFER_LARGE_CreateWithCustomFree, \
+        CONSTBUFFER_LARGE_CreateFromOffsetAndSize, \
+        CONSTBUFFER_CreateFromLargeOffsetAndSize, \
+        CONSTBUFFER_LARGE_IncRef, \
+        CONSTBUFFER_LARGE_DecRef, \
+        CONSTBUFFER_LARGE_GetContent, \
+        CONSTBUFFER_LARGE_get_serialization_size, \
+        CONSTBUFFER_LARGE_to_fixed_size_buffer, \
+        CONSTBUFFER_LARGE_from_buffer_no_copy \
 )
 
 #ifdef __cplusplus
@@ -55,6 +83,24 @@ CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateWithCustomFree(const unsigned char* so
 
 CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(CONSTBUFFER_HANDLE handle, uint32_t offset, uint32_t size);
 
+CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateWithAlignment(const unsigned char* source, uint32_t size, uint32_t alignment);
+
+CONSTBUFFER_WRITABLE_HANDLE real_CONSTBUFFER_CreateWritableHandle(uint32_t capacity);
+
+unsigned char* real_CONSTBUFFER_GetWritableBuffer(CONSTBUFFER_WRITABLE_HANDLE writableHandle);
+
+uint32_t real_CONSTBUFFER_GetWritableBufferCapacity(CONSTBUFFER_WRITABLE_HANDLE writableHandle);
+
+uint32_t real_CONSTBUFFER_GetWritableBufferSize(CONSTBUFFER_WRITABLE_HANDLE writableHandle);
+
+int real_CONSTBUFFER_SetWritableBufferSize(CONSTBUFFER_WRITABLE_HANDLE writableHandle, uint32_t size);
+
+int real_CONSTBUFFER_AppendToWritableBuffer(CONSTBUFFER_WRITABLE_HANDLE writableHandle, const unsigned char* source, uint32_t size);
+
+CONSTBUFFER_HANDLE real_CONSTBUFFER_SealWritableHandle(CONSTBUFFER_WRITABLE_HANDLE writableHandle);
+
+void real_CONSTBUFFER_DestroyWritableHandle(CONSTBUFFER_WRITABLE_HANDLE writableHandle);
+
 void real_CONSTBUFFER_IncRef(CONSTBUFFER_HANDLE constbufferHandle);
 
 const CONSTBUFFER* real_CONSTBUFFER_GetContent(CONSTBUFFER_HANDLE constbufferHandle);
@@ -63,6 +109,8 @@ void real_CONSTBUFFER_DecRef(CONSTBUFFER_HANDLE constbufferHandle);
 
 bool real_CONSTBUFFER_HANDLE_contain_same(CONSTBUFFER_HANDLE left, CONSTBUFFER_HANDLE right);
 
+int real_CONSTBUFFER_get_content_hash(CONSTBUFFER_HANDLE source, uint64_t* content_hash);
+
 CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle, uint32_t offset, uint32_t size);
 
 uint32_t real_CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source);
@@ -71,8 +119,44 @@ unsigned char* real_CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER
 
 CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_to_fixed_size_buffer(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size);
 
+uint32_t real_CONSTBUFFER_get_serialization_size_v2(CONSTBUFFER_HANDLE source);
+
+unsigned char* real_CONSTBUFFER_to_buffer_v2(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size);
+
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_to_fixed_size_buffer_v2(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size);
+
 CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_from_buffer(const unsigned char* source, uint32_t size, uint32_t* consumed, CONSTBUFFER_HANDLE* destination);
 
+CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_from_buffer_no_copy(CONSTBUFFER_HANDLE parent, uint32_t offset, uint32_t* consumed, CONSTBUFFER_HANDLE* destination);
+
+int real_CONSTBUFFER_to_segments(CONSTBUFFER_HANDLE source, unsigned char* header, CONSTBUFFER* segments, uint32_t* segment_count);
+
+int real_CONSTBUFFER_header_pool_init(void);
+
+void real_CONSTBUFFER_header_pool_deinit(void);
+
+CONSTBUFFER_LARGE_HANDLE real_CONSTBUFFER_LARGE_Create(const unsigned char* source, uint64_t size);
+
+CONSTBUFFER_LARGE_HANDLE real_CONSTBUFFER_LARGE_CreateWithMoveMemory(unsigned char* source, uint64_t size);
+
+CONSTBUFFER_LARGE_HANDLE real_CONSTBUFFER_LARGE_CreateWithCustomFree(const unsigned char* source, uint64_t size, CONSTBUFFER_CUSTOM_FREE_FUNC custom_free_func, void* custom_free_func_context);
+
+CONSTBUFFER_LARGE_HANDLE real_CONSTBUFFER_LARGE_CreateFromOffsetAndSize(CONSTBUFFER_LARGE_HANDLE handle, uint64_t offset, uint64_t size);
+
+CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromLargeOffsetAndSize(CONSTBUFFER_LARGE_HANDLE handle, uint64_t offset, uint32_t size);
+
+void real_CONSTBUFFER_LARGE_IncRef(CONSTBUFFER_LARGE_HANDLE constbufferHandle);
+
+void real_CONSTBUFFER_LARGE_DecRef(CONSTBUFFER_LARGE_HANDLE constbufferHandle);
+
+const CONSTBUFFER_LARGE* real_CONSTBUFFER_LARGE_GetContent(CONSTBUFFER_LARGE_HANDLE constbufferHandle);
+
+uint64_t real_CONSTBUFFER_LARGE_get_serialization_size(CONSTBUFFER_LARGE_HANDLE source);
+
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_LARGE_to_fixed_size_buffer(CONSTBUFFER_LARGE_HANDLE source, unsigned char* destination, uint64_t destination_size, uint64_t* serialized_size);
+
+CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_LARGE_from_buffer_no_copy(CONSTBUFFER_LARGE_HANDLE parent, uint64_t offset, uint64_t* consumed, CONSTBUFFER_LARGE_HANDLE* destination);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,8 +19,11 @@
         constbuffer_array_create, \
         constbuffer_array_create_with_move_buffers, \
         constbuffer_array_create_from_buffer_index_and_count, \
+        constbuffer_array_create_from_byte_offset_and_length, \
         constbuffer_array_create_empty, \
         constbuffer_array_create_from_array_array, \
+        constbuffer_array_create_from_serialized_buffers, \
+        constbuffer_array_create_coalesced, \
         constbuffer_array_inc_ref, \
         constbuffer_array_dec_ref, \
         constbuffer_array_add_front, \
@@ -29,6 +32,7 @@
         constbuffer_array_get_buffer, \
         constbuffer_array_get_buffer_content, \
         constbuffer_array_get_all_buffers_size, \
+        constbuffer_array_get_all_buffers_size_u64, \
         constbuffer_array_get_const_buffer_handle_array, \
         CONSTBUFFER_ARRAY_HANDLE_contain_same \
 )
@@ -44,7 +48,10 @@ CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create(const CONSTBUFFER_HANDLE*
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_empty(void);
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_with_move_buffers(CONSTBUFFER_HANDLE* buffers, uint32_t buffer_count);
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_buffer_index_and_count(CONSTBUFFER_ARRAY_HANDLE original, uint32_t start_buffer_index, uint32_t buffer_count);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_byte_offset_and_length(CONSTBUFFER_ARRAY_HANDLE original, uint64_t byte_offset, uint64_t byte_length);
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_array_array(const CONSTBUFFER_ARRAY_HANDLE* buffer_arrays, uint32_t buffer_array_count);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_from_serialized_buffers(CONSTBUFFER_HANDLE parent);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_coalesced(CONSTBUFFER_ARRAY_HANDLE original, uint32_t small_buffer_size);
 
 void real_constbuffer_array_inc_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
 void real_constbuffer_array_dec_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
@@ -60,6 +67,7 @@ int real_constbuffer_array_get_buffer_count(CONSTBUFFER_ARRAY_HANDLE constbuffer
 CONSTBUFFER_HANDLE real_constbuffer_array_get_buffer(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index);
 const CONSTBUFFER* real_constbuffer_array_get_buffer_content(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index);
 int real_constbuffer_array_get_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t* all_buffers_size);
+int real_constbuffer_array_get_all_buffers_size_u64(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t* all_buffers_size);
 const CONSTBUFFER_HANDLE* real_constbuffer_array_get_const_buffer_handle_array(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
 bool real_CONSTBUFFER_ARRAY_HANDLE_contain_same(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right);
 
@@ -5,7 +5,10 @@
 #define constbuffer_array_create_empty real_constbuffer_array_create_empty
 #define constbuffer_array_create_with_move_buffers real_constbuffer_array_create_with_move_buffers
 #define constbuffer_array_create_from_buffer_index_and_count real_constbuffer_array_create_from_buffer_index_and_count
+#define constbuffer_array_create_from_byte_offset_and_length real_constbuffer_array_create_from_byte_offset_and_length
 #define constbuffer_array_create_from_array_array real_constbuffer_array_create_from_array_array
+#define constbuffer_array_create_from_serialized_buffers real_constbuffer_array_create_from_serialized_buffers
+#define constbuffer_array_create_coalesced real_constbuffer_array_create_coalesced
 #define constbuffer_array_inc_ref real_constbuffer_array_inc_ref
 #define constbuffer_array_dec_ref real_constbuffer_array_dec_ref
 #define constbuffer_array_add_front real_constbuffer_array_add_front
@@ -14,5 +17,6 @@
 #define constbuffer_array_get_buffer real_constbuffer_array_get_buffer
 #define constbuffer_array_get_buffer_content real_constbuffer_array_get_buffer_content
 #define constbuffer_array_get_all_buffers_size real_constbuffer_array_get_all_buffers_size
+#define constbuffer_array_get_all_buffers_size_u64 real_constbuffer_array_get_all_buffers_size_u64
 #define constbuffer_array_get_const_buffer_handle_array real_constbuffer_array_get_const_buffer_handle_array
 #define CONSTBUFFER_ARRAY_HANDLE_contain_same real_CONSTBUFFER_ARRAY_HANDLE_contain_same
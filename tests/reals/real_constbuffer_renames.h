@@ -9,15 +9,43 @@
 #define CONSTBUFFER_CreateWithMoveMemory real_CONSTBUFFER_CreateWithMoveMemory
 #define CONSTBUFFER_CreateWithCustomFree real_CONSTBUFFER_CreateWithCustomFree
 #define CONSTBUFFER_CreateFromOffsetAndSizeWithCopy real_CONSTBUFFER_CreateFromOffsetAndSizeWithCopy
+#define CONSTBUFFER_CreateWithAlignment real_CONSTBUFFER_CreateWithAlignment
+#define CONSTBUFFER_CreateWritableHandle real_CONSTBUFFER_CreateWritableHandle
+#define CONSTBUFFER_GetWritableBuffer real_CONSTBUFFER_GetWritableBuffer
+#define CONSTBUFFER_GetWritableBufferCapacity real_CONSTBUFFER_GetWritableBufferCapacity
+#define CONSTBUFFER_GetWritableBufferSize real_CONSTBUFFER_GetWritableBufferSize
+#define CONSTBUFFER_SetWritableBufferSize real_CONSTBUFFER_SetWritableBufferSize
+#define CONSTBUFFER_AppendToWritableBuffer real_CONSTBUFFER_AppendToWritableBuffer
+#define CONSTBUFFER_SealWritableHandle real_CONSTBUFFER_SealWritableHandle
+#define CONSTBUFFER_DestroyWritableHandle real_CONSTBUFFER_DestroyWritableHandle
 #define CONSTBUFFER_IncRef real_CONSTBUFFER_IncRef
 #define CONSTBUFFER_GetContent real_CONSTBUFFER_GetContent
 #define CONSTBUFFER_DecRef real_CONSTBUFFER_DecRef
 #define CONSTBUFFER_HANDLE_contain_same real_CONSTBUFFER_HANDLE_contain_same
+#define CONSTBUFFER_get_content_hash real_CONSTBUFFER_get_content_hash
 #define CONSTBUFFER_CreateFromOffsetAndSize real_CONSTBUFFER_CreateFromOffsetAndSize
 #define CONSTBUFFER_get_serialization_size real_CONSTBUFFER_get_serialization_size
 #define CONSTBUFFER_to_buffer real_CONSTBUFFER_to_buffer
 #define CONSTBUFFER_to_fixed_size_buffer real_CONSTBUFFER_to_fixed_size_buffer
+#define CONSTBUFFER_get_serialization_size_v2 real_CONSTBUFFER_get_serialization_size_v2
+#define CONSTBUFFER_to_buffer_v2 real_CONSTBUFFER_to_buffer_v2
+#define CONSTBUFFER_to_fixed_size_buffer_v2 real_CONSTBUFFER_to_fixed_size_buffer_v2
 #define CONSTBUFFER_from_buffer real_CONSTBUFFER_from_buffer
+#define CONSTBUFFER_from_buffer_no_copy real_CONSTBUFFER_from_buffer_no_copy
+#define CONSTBUFFER_to_segments real_CONSTBUFFER_to_segments
+#define CONSTBUFFER_header_pool_init real_CONSTBUFFER_header_pool_init
+#define CONSTBUFFER_header_pool_deinit real_CONSTBUFFER_header_pool_deinit
+#define CONSTBUFFER_LARGE_Create real_CONSTBUFFER_LARGE_Create
+#define CONSTBUFFER_LARGE_CreateWithMoveMemory real_CONSTBUFFER_LARGE_CreateWithMoveMemory
+#define CONSTBUFFER_LARGE_CreateWithCustomFree real_CONSTBUFFER_LARGE_CreateWithCustomFree
+#define CONSTBUFFER_LARGE_CreateFromOffsetAndSize real_CONSTBUFFER_LARGE_CreateFromOffsetAndSize
+#define CONSTBUFFER_CreateFromLargeOffsetAndSize real_CONSTBUFFER_CreateFromLargeOffsetAndSize
+#define CONSTBUFFER_LARGE_IncRef real_CONSTBUFFER_LARGE_IncRef
+#define CONSTBUFFER_LARGE_DecRef real_CONSTBUFFER_LARGE_DecRef
+#define CONSTBUFFER_LARGE_GetContent real_CONSTBUFFER_LARGE_GetContent
+#define CONSTBUFFER_LARGE_get_serialization_size real_CONSTBUFFER_LARGE_get_serialization_size
+#define CONSTBUFFER_LARGE_to_fixed_size_buffer real_CONSTBUFFER_LARGE_to_fixed_size_buffer
+#define CONSTBUFFER_LARGE_from_buffer_no_copy real_CONSTBUFFER_LARGE_from_buffer_no_copy
 
 #define CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT
 #define CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_FROM_BUFFER_RESULT
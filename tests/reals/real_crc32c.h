@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CRC32C_H
+#define REAL_CRC32C_H
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_CRC32C_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        crc32c_update \
+    )
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+extern "C"
+{
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+    uint32_t real_crc32c_update(uint32_t crc, const unsigned char* buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //REAL_CRC32C_H
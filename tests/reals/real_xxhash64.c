@@ -0,0 +1,6 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_xxhash64_renames.h" // IWYU pragma: keep
+
+#include "../../src/xxhash64.c"
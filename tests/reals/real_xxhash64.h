@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_XXHASH64_H
+#define REAL_XXHASH64_H
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_XXHASH64_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        xxhash64 \
+    )
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+extern "C"
+{
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+    uint64_t real_xxhash64(const unsigned char* buffer, size_t size, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //REAL_XXHASH64_H
@@ -9,6 +9,7 @@
 #include "../reals/real_constbuffer.h"
 #include "../reals/real_constbuffer_array.h"
 #include "../reals/real_constbuffer_array_batcher_nv.h"
+#include "../reals/real_crc32c.h"
 #include "../reals/real_doublylinkedlist.h"
 #include "../reals/real_external_command_helper.h"
 #include "../reals/real_interlocked_hl.h"
@@ -17,10 +18,12 @@
 #include "../reals/real_rc_string_array.h"
 #include "../reals/real_singlylinkedlist.h"
 #include "../reals/real_uuid.h"
+#include "../reals/real_xxhash64.h"
 
 #include "c_util/constbuffer.h"
 #include "c_util/constbuffer_array.h"
 #include "c_util/constbuffer_array_batcher_nv.h"
+#include "c_util/crc32c.h"
 #include "c_util/doublylinkedlist.h"
 #include "c_util/external_command_helper.h"
 #include "c_util/interlocked_hl.h"
@@ -29,6 +32,7 @@
 #include "c_util/rc_string_array.h"
 #include "c_util/singlylinkedlist.h"
 #include "c_util/uuid.h"
+#include "c_util/xxhash64.h"
 
 #if defined _MSC_VER
 #include "../reals/real_sm.h"
@@ -47,6 +51,7 @@ TEST_FUNCTION(check_all_c_util_reals)
     REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_BATCHER_GLOBAL_MOCK_HOOK();
+    REGISTER_CRC32C_GLOBAL_MOCK_HOOK();
     REGISTER_DOUBLYLINKEDLIST_GLOBAL_MOCK_HOOKS();
     REGISTER_EXTERNAL_COMMAND_HELPER_GLOBAL_MOCK_HOOKS();
     REGISTER_INTERLOCKED_HL_GLOBAL_MOCK_HOOK();
@@ -54,6 +59,7 @@ TEST_FUNCTION(check_all_c_util_reals)
     REGISTER_RC_STRING_GLOBAL_MOCK_HOOKS();
     REGISTER_SINGLYLINKEDLIST_GLOBAL_MOCK_HOOKS();
     REGISTER_UUID_GLOBAL_MOCK_HOOK();
+    REGISTER_XXHASH64_GLOBAL_MOCK_HOOK();
 
 #if defined _MSC_VER
     REGISTER_SM_GLOBAL_MOCK_HOOK();
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#include "c_util/xxhash64.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+#define TEST_BUFFER_SIZE 1000
+
+static void fill_test_buffer(unsigned char* buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        buffer[i] = (unsigned char)(i * 7 + 3);
+    }
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* xxhash64 */
+
+/*Tests_SRS_XXHASH64_11_001: [ If buffer is NULL and size is not 0 then xxhash64 shall fail and return 0. ]*/
+TEST_FUNCTION(xxhash64_with_buffer_NULL_and_size_1_fails)
+{
+    ///arrange
+
+    ///act
+    uint64_t result = xxhash64(NULL, 1, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 0, result);
+}
+
+/*Tests_SRS_XXHASH64_11_004: [ xxhash64 shall finish the hash with the XXH64 avalanche and return it. ]*/
+TEST_FUNCTION(xxhash64_of_0_bytes_returns_the_reference_value)
+{
+    ///arrange
+    unsigned char byte = 42;
+
+    ///act
+    uint64_t result_1 = xxhash64(NULL, 0, 0);
+    uint64_t result_2 = xxhash64(&byte, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 0xEF46DB3751D8E999ULL, result_1);
+    ASSERT_ARE_EQUAL(uint64_t, 0xEF46DB3751D8E999ULL, result_2);
+}
+
+/*Tests_SRS_XXHASH64_11_003: [ xxhash64 shall mix in the remaining bytes 8 bytes at a time, then 4 bytes at a time, then 1 byte at a time. ]*/
+/*Tests_SRS_XXHASH64_11_004: [ xxhash64 shall finish the hash with the XXH64 avalanche and return it. ]*/
+TEST_FUNCTION(xxhash64_of_short_strings_returns_the_reference_values)
+{
+    ///arrange
+
+    ///act
+    uint64_t result_a = xxhash64((const unsigned char*)"a", 1, 0);
+    uint64_t result_abc = xxhash64((const unsigned char*)"abc", 3, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 0xD24EC4F1A98C6E5BULL, result_a);
+    ASSERT_ARE_EQUAL(uint64_t, 0x44BC2CF5AD770999ULL, result_abc);
+}
+
+/*Tests_SRS_XXHASH64_11_002: [ xxhash64 shall consume the bytes of buffer in stripes of 32 bytes with 4 independent accumulators and merge the accumulators into the hash. ]*/
+/*Tests_SRS_XXHASH64_11_003: [ xxhash64 shall mix in the remaining bytes 8 bytes at a time, then 4 bytes at a time, then 1 byte at a time. ]*/
+TEST_FUNCTION(xxhash64_of_a_string_longer_than_a_stripe_returns_the_reference_value)
+{
+    ///arrange
+    const char* source = "Nobody inspects the spammish repetition";
+
+    ///act
+    uint64_t result = xxhash64((const unsigned char*)source, strlen(source), 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint64_t, 0xFBCEA83C8A378BF1ULL, result);
+}
+
+/*Tests_SRS_XXHASH64_11_002: [ xxhash64 shall consume the bytes of buffer in stripes of 32 bytes with 4 independent accumulators and merge the accumulators into the hash. ]*/
+TEST_FUNCTION(xxhash64_does_not_depend_on_the_alignment_of_buffer)
+{
+    ///arrange
+    unsigned char source[TEST_BUFFER_SIZE];
+    unsigned char shifted[8 + TEST_BUFFER_SIZE];
+    fill_test_buffer(source, sizeof(source));
+
+    for (size_t start = 0; start < 8; start++)
+    {
+        (void)memcpy(shifted + start, source, sizeof(source));
+        for (size_t size = 0; size <= 100; size++)
+        {
+            ///act
+            uint64_t result = xxhash64(shifted + start, size, 0);
+
+            ///assert
+            ASSERT_ARE_EQUAL(uint64_t, xxhash64(source, size, 0), result);
+        }
+    }
+}
+
+/*Tests_SRS_XXHASH64_11_002: [ xxhash64 shall consume the bytes of buffer in stripes of 32 bytes with 4 independent accumulators and merge the accumulators into the hash. ]*/
+/*Tests_SRS_XXHASH64_11_003: [ xxhash64 shall mix in the remaining bytes 8 bytes at a time, then 4 bytes at a time, then 1 byte at a time. ]*/
+TEST_FUNCTION(xxhash64_changes_when_any_byte_changes)
+{
+    ///arrange
+    unsigned char source[TEST_BUFFER_SIZE];
+    fill_test_buffer(source, sizeof(source));
+    uint64_t original = xxhash64(source, sizeof(source), 0);
+
+    for (size_t i = 0; i < sizeof(source); i++)
+    {
+        source[i] ^= 1;
+
+        ///act
+        uint64_t result = xxhash64(source, sizeof(source), 0);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(uint64_t, original, result);
+
+        ///clean
+        source[i] ^= 1;
+    }
+}
+
+/*Tests_SRS_XXHASH64_11_002: [ xxhash64 shall consume the bytes of buffer in stripes of 32 bytes with 4 independent accumulators and merge the accumulators into the hash. ]*/
+TEST_FUNCTION(xxhash64_with_a_different_seed_returns_a_different_hash)
+{
+    ///arrange
+    unsigned char source[TEST_BUFFER_SIZE];
+    fill_test_buffer(source, sizeof(source));
+
+    ///act
+    uint64_t result_short_0 = xxhash64(source, 3, 0);
+    uint64_t result_short_1 = xxhash64(source, 3, 1);
+    uint64_t result_long_0 = xxhash64(source, sizeof(source), 0);
+    uint64_t result_long_1 = xxhash64(source, sizeof(source), 1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(uint64_t, result_short_0, result_short_1);
+    ASSERT_ARE_NOT_EQUAL(uint64_t, result_long_0, result_long_1);
+    ASSERT_ARE_EQUAL(uint64_t, result_long_0, xxhash64(source, sizeof(source), 0));
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)